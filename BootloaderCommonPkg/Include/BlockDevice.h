@@ -164,6 +164,63 @@ EFI_STATUS
   IN  UINTN               DevHcPciBase
   );
 
+/**
+  Start reading the requested number of blocks from the specified block device.
+
+  The function starts the read and returns without waiting for the data. Only one
+  asynchronous read can be outstanding on a device interface, and the buffer must
+  not be accessed until DEVICE_POLL_BLOCKS reports the read has finished.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            The caller is responsible for the ownership of the
+                            buffer.
+
+  @retval EFI_SUCCESS             The read was started.
+  @retval EFI_ALREADY_STARTED     An asynchronous read is already outstanding.
+  @retval EFI_INVALID_PARAMETER   The read request contains LBAs that are not
+                                  valid, or the buffer is not properly aligned.
+  @retval EFI_BAD_BUFFER_SIZE     The BufferSize parameter is not a multiple of
+                                  the intrinsic block size of the device.
+  @retval Others                  The read could not be started.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *DEVICE_READ_BLOCKS_ASYNC) (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  OUT VOID                           *Buffer
+  );
+
+/**
+  Check the asynchronous read started by DEVICE_READ_BLOCKS_ASYNC.
+
+  The function does not wait. It issues the next part of the read when the
+  previous one has completed, so it should be called regularly until it returns
+  a status other than EFI_NOT_READY.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+
+  @retval EFI_SUCCESS        The read has finished and all the data is in the buffer.
+  @retval EFI_NOT_READY      The read is still in progress.
+  @retval EFI_NOT_FOUND      No asynchronous read is outstanding.
+  @retval Others             The read has finished with an error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *DEVICE_POLL_BLOCKS) (
+  IN  UINTN                          DeviceIndex
+  );
+
 typedef struct {
   DEVICE_INITIALIZE                  DevInit;
   DEVICE_GET_INFO                    GetInfo;
@@ -171,6 +228,8 @@ typedef struct {
   DEVICE_WRITE_BLOCKS                WriteBlocks;
   DEVICE_WRITE_BLOCKS_EXT            WriteBlocksExt;
   DEVICE_TUNING                      DevTuning;
+  DEVICE_READ_BLOCKS_ASYNC           ReadBlocksAsync;
+  DEVICE_POLL_BLOCKS                 PollBlocks;
 } DEVICE_BLOCK_FUNC;
 
 #endif
@@ -0,0 +1,55 @@
+/** @file
+  This file defines the hob structure for the memory allocation trace.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ALLOC_TRACE_INFO_GUID_H__
+#define __ALLOC_TRACE_INFO_GUID_H__
+
+extern EFI_GUID gLoaderAllocTraceInfoGuid;
+
+#define ALLOC_TRACE_INFO_SIGNATURE   SIGNATURE_32 ('A', 'T', 'R', 'C')
+
+// For ALLOC_TRACE_ENTRY Type
+#define ALLOC_TRACE_TYPE_POOL        0
+#define ALLOC_TRACE_TYPE_PAGES       1
+#define ALLOC_TRACE_TYPE_TEMP        2
+
+// Stages are indexed by LOADER_STAGE
+#define ALLOC_TRACE_STAGE_COUNT      4
+
+// Histogram bin N counts the allocations of 2^(N+4) to 2^(N+5) - 1 bytes.
+// The first bin also counts the smaller ones, and the last bin the larger ones.
+#define ALLOC_TRACE_HISTOGRAM_COUNT  16
+
+#pragma pack(1)
+
+typedef struct {
+  UINT32    Caller;         // Return address of the allocation call
+  UINT32    Base;
+  UINT32    Size;
+  UINT8     Type;
+  UINT8     Stage;
+  UINT16    Reserved;
+} ALLOC_TRACE_ENTRY;
+
+typedef struct {
+  UINT32    Signature;
+  UINT8     Revision;
+  UINT8     Reserved[3];
+  UINT32    EntryCount;     // Number of entries the table can hold
+  UINT32    LiveCount;      // Number of live allocations in Entry[]
+  UINT32    Dropped;        // Allocations not recorded as the table was full
+  UINT32    LiveSize;       // Bytes of the recorded live allocations
+  UINT32    PeakSize[ALLOC_TRACE_STAGE_COUNT];     // Peak LiveSize in each stage
+  UINT32    Anchor[ALLOC_TRACE_STAGE_COUNT];       // Address of AllocatePool () in each stage
+  UINT32    Histogram[ALLOC_TRACE_HISTOGRAM_COUNT];
+  ALLOC_TRACE_ENTRY  Entry[0];
+} ALLOC_TRACE_INFO;
+
+#pragma pack()
+
+#endif
@@ -0,0 +1,54 @@
+/** @file
+  This file defines the hob structure for boot span profiling data.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __BOOT_SPAN_INFO_GUID_H__
+#define __BOOT_SPAN_INFO_GUID_H__
+
+extern EFI_GUID gLoaderBootSpanInfoGuid;
+
+#define BOOT_SPAN_INFO_SIGNATURE     SIGNATURE_32 ('B', 'S', 'P', 'N')
+
+// No span, used for the parent of a top level span
+#define BOOT_SPAN_NONE               0xFFFF
+
+// For BOOT_SPAN_INFO Flags
+#define BOOT_SPAN_INFO_FULL          BIT0
+
+// For BOOT_SPAN_RECORD Flags
+#define BOOT_SPAN_OPEN               BIT0
+
+#pragma pack(1)
+
+typedef struct {
+  UINT32    Signature;      // Signature of the component owning the span
+  UINT16    Id;             // Measure point Id describing the span
+  UINT16    Parent;         // Index of the enclosing span
+  UINT8     Depth;          // Nesting level, 0 for a top level span
+  UINT8     Flags;
+  UINT16    Reserved;
+  UINT32    DeviceId;       // Device the span worked on, 0 if none
+  UINT64    StartTsc;
+  UINT64    EndTsc;
+  UINT64    Bytes;          // Bytes processed in the span
+} BOOT_SPAN_RECORD;
+
+typedef struct {
+  UINT32    Signature;
+  UINT8     Revision;
+  UINT8     Flags;
+  UINT16    Current;        // Index of the innermost open span
+  UINT32    FreqKhz;
+  UINT32    TotalLength;    // Buffer length including this header
+  UINT32    Count;
+  UINT32    Reserved;
+  BOOT_SPAN_RECORD  Span[0];
+} BOOT_SPAN_INFO;
+
+#pragma pack()
+
+#endif
@@ -0,0 +1,41 @@
+/** @file
+  This file defines the hob structure for the GUID HOB index.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HOB_INDEX_GUID_H__
+#define __HOB_INDEX_GUID_H__
+
+extern EFI_GUID gLoaderHobIndexGuid;
+
+#define HOB_INDEX_INFO_SIGNATURE     SIGNATURE_32 ('H', 'I', 'D', 'X')
+
+// Maximum number of GUID HOBs in the index
+#define HOB_INDEX_MAX_ENTRIES        128
+
+#pragma pack(1)
+
+typedef struct {
+  EFI_GUID  Name;
+  UINT32    Offset;         // GUID HOB offset from the start of the HOB list
+} HOB_INDEX_ENTRY;
+
+//
+// The index HOB is built right after the PHIT HOB, and filled when the loader
+// hands off to the payload. The GUID HOBs after HobListSize are not indexed.
+//
+typedef struct {
+  UINT32    Signature;
+  UINT8     Revision;
+  UINT8     Reserved[3];
+  UINT32    HobListSize;    // Size of the HOB list start covered by the index
+  UINT32    Count;
+  HOB_INDEX_ENTRY  Entry[0];  // Sorted by GUID bytes, and then by offset
+} HOB_INDEX_INFO;
+
+#pragma pack()
+
+#endif
@@ -14,10 +14,11 @@
 ///
 extern EFI_GUID gLoaderPlatformDataGuid;
 
-#define  DEBUG_OUTPUT_DEVICE_LOG_BUFFER     BIT0
-#define  DEBUG_OUTPUT_DEVICE_SERIAL_PORT    BIT1
-#define  DEBUG_OUTPUT_DEVICE_DEBUG_PORT     BIT2
-#define  DEBUG_OUTPUT_DEVICE_CONSOLE        BIT7
+#define  DEBUG_OUTPUT_DEVICE_LOG_BUFFER      BIT0
+#define  DEBUG_OUTPUT_DEVICE_SERIAL_PORT     BIT1
+#define  DEBUG_OUTPUT_DEVICE_DEBUG_PORT      BIT2
+#define  DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED BIT3
+#define  DEBUG_OUTPUT_DEVICE_CONSOLE         BIT7
 
 
 typedef struct {
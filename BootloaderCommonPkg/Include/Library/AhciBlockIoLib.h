@@ -68,6 +68,57 @@ AhciWriteBlocks (
   OUT VOID                           *Buffer
   );
 
+/**
+  This function starts reading data from AHCI to Memory without waiting for
+  the data.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            It must not be touched until AhciPollBlocks () no
+                            longer returns EFI_NOT_READY.
+
+  @retval EFI_SUCCESS            The read was started.
+  @retval EFI_ALREADY_STARTED    An asynchronous read is already outstanding.
+  @retval EFI_NOT_FOUND          The device index cannot be found.
+  @retval EFI_UNSUPPORTED        AHCI system is not ready yet.
+  @retval EFI_INVALID_PARAMETER  Input parameters are not valid.
+  @retval EFI_DEVICE_ERROR       The read could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciReadBlocksAsync (
+  IN  UINTN                         DeviceIndex,
+  IN  EFI_LBA                       StartLBA,
+  IN  UINTN                         BufferSize,
+  OUT VOID                          *Buffer
+  );
+
+/**
+  This function checks the read started by AhciReadBlocksAsync () without
+  waiting.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+
+  @retval EFI_SUCCESS            The data was read correctly from the device.
+  @retval EFI_NOT_READY          The read is still in progress.
+  @retval EFI_NOT_FOUND          No read is outstanding on the device.
+  @retval EFI_UNSUPPORTED        AHCI system is not ready yet.
+  @retval EFI_DEVICE_ERROR       The read failed.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciPollBlocks (
+  IN  UINTN                         DeviceIndex
+  );
+
 /**
   Gets a block device's media information.
 
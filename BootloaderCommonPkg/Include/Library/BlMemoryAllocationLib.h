@@ -9,6 +9,7 @@
 #define __BL_MEMORY_ALLOCATION_LIB_H__
 
 #include <Library/MemoryAllocationLib.h>
+#include <Guid/AllocTraceInfoGuid.h>
 
 typedef struct {
   EFI_PHYSICAL_ADDRESS  BaseAddress;
@@ -42,4 +43,16 @@ FreeTemporaryMemory (
   IN VOID   *Buffer
   );
 
+/**
+  Get the memory allocation trace table.
+
+  @retval   The trace table, or NULL if the allocations are not traced.
+
+**/
+ALLOC_TRACE_INFO *
+EFIAPI
+GetAllocTraceInfo (
+  VOID
+  );
+
 #endif
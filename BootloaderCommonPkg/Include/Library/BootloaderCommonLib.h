@@ -14,6 +14,7 @@
 #include <Guid/LoaderPlatformDataGuid.h>
 #include <Guid/DeviceTableHobGuid.h>
 #include <Guid/KeyHashGuid.h>
+#include <Guid/AllocTraceInfoGuid.h>
 #include <Library/BaseLib.h>
 #include <Library/CryptoLib.h>
 
@@ -626,4 +627,59 @@ MatchHashInStore (
   IN       UINT8           *HashData
   );
 
+/**
+  Initialize a memory allocation trace table.
+
+  @param[out] TraceInfo     The trace table.
+  @param[in]  EntryCount    The number of entries following the table header.
+
+**/
+VOID
+EFIAPI
+AllocTraceInit (
+  OUT ALLOC_TRACE_INFO     *TraceInfo,
+  IN  UINT32                EntryCount
+  );
+
+/**
+  Record a memory allocation in a trace table.
+
+  @param[in,out]  TraceInfo     The trace table.
+  @param[in]      Caller        Return address of the allocation call.
+  @param[in]      Buffer        The allocated buffer.
+  @param[in]      Size          The allocated size in bytes.
+  @param[in]      Type          ALLOC_TRACE_TYPE_* of the allocation.
+  @param[in]      Stage         LOADER_STAGE of the allocation.
+
+**/
+VOID
+EFIAPI
+AllocTraceAdd (
+  IN OUT ALLOC_TRACE_INFO  *TraceInfo,
+  IN     VOID              *Caller,
+  IN     VOID              *Buffer,
+  IN     UINTN              Size,
+  IN     UINT8              Type,
+  IN     UINT8              Stage
+  );
+
+/**
+  Remove freed memory allocations from a trace table.
+
+  @param[in,out]  TraceInfo     The trace table.
+  @param[in]      Type          ALLOC_TRACE_TYPE_* of the freed allocations.
+  @param[in]      Base          Base of the freed range.
+  @param[in]      Length        Length of the freed range, the allocations
+                                starting in this range are removed.
+
+**/
+VOID
+EFIAPI
+AllocTraceRemove (
+  IN OUT ALLOC_TRACE_INFO  *TraceInfo,
+  IN     UINT8              Type,
+  IN     VOID              *Base,
+  IN     UINTN              Length
+  );
+
 #endif
@@ -222,6 +222,24 @@ AddConfigData (
   IN  UINT8                *CfgAddPtr
   );
 
+/**
+  Build the tag index of the config database.
+
+  The index is kept in the free space of the config database, and is
+  rebuilt when config data is added.
+
+  @retval EFI_SUCCESS               The index was built successfully.
+  @retval EFI_NOT_FOUND             The config database is not available.
+  @retval EFI_BUFFER_TOO_SMALL      Not enough free space for the index.
+  @retval EFI_UNSUPPORTED           The config database is too large to index.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigDataIndex (
+  VOID
+  );
+
 /**
   Build a full set of CFGDATA for current platform.
 
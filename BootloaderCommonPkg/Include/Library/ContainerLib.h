@@ -89,6 +89,21 @@ typedef struct {
   UINT8            HashData[0];
 } COMPONENT_ENTRY;
 
+typedef struct {
+  // Container signature or component type
+  UINT32                   ContainerSig;
+  // Component name
+  UINT32                   ComponentName;
+  // Destination buffer on input or NULL, component base on output
+  VOID                    *Buffer;
+  // Destination buffer size on input or 0, component size on output
+  UINT32                   Length;
+  // Optional callback function pointer
+  LOAD_COMPONENT_CALLBACK  Callback;
+  // Load status of this component
+  EFI_STATUS               Status;
+} LOAD_COMPONENT_REQUEST;
+
 
 /**
   Load a component from a container or flahs map to memory and call callback
@@ -164,6 +179,29 @@ LoadComponent (
   IN OUT UINT32   *Length
   );
 
+/**
+  Load multiple components from containers or flash map to memory.
+
+  The components are copied, hashed and decompressed in parallel on the idle
+  processors, while authentication and the callbacks run on the BSP in the
+  order of the requests.
+
+  @param[in,out] Requests        Array of component load requests.
+  @param[in]     Count           Number of requests.
+
+  @retval EFI_INVALID_PARAMETER    Requests is NULL.
+  @retval EFI_OUT_OF_RESOURCES     Cannot allocate the load contexts.
+  @retval EFI_SUCCESS              All components were loaded.
+  @retval Others                   Status of the first request that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponents (
+  IN OUT LOAD_COMPONENT_REQUEST  *Requests,
+  IN     UINT32                   Count
+  );
+
 /**
   Locate a component information from a container.
 
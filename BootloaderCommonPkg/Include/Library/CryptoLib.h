@@ -153,6 +153,32 @@ Sha384 (
   OUT       UINT8          *Digest
   );
 
+/**
+  Computes the SHA-384 message digests of several input data buffers.
+
+  Up to four buffers are hashed together when the multi-buffer kernel is
+  enabled in PcdCryptoShaOptMask, otherwise the buffers are hashed one by one.
+
+  @param[in]   Data        Array of pointers to the buffers to be hashed.
+  @param[in]   Length      Array of the lengths of the Data buffers in bytes.
+  @param[out]  Digest      Array of pointers to the buffers that receive the
+                           SHA-384 digest values (48 bytes each).
+  @param[in]   Count       Number of buffers to be hashed.
+
+  @retval  RETURN_SUCCESS             Success.
+  @retval  RETURN_INVALID_PARAMETER   Data, Length or Digest is NULL.
+  @retval  RETURN_UNSUPPORTED         SHA-384 is not supported.
+  @retval  RETURN_SECURITY_VIOLATION  All other errors.
+**/
+RETURN_STATUS
+EFIAPI
+Sha384Batch (
+  IN  CONST UINT8 * CONST  *Data,
+  IN  CONST UINT32         *Length,
+  OUT       UINT8 * CONST  *Digest,
+  IN        UINT32          Count
+  );
+
 /**
   Computes the SM3 message digest of a input data buffer.
 
@@ -20,9 +20,52 @@ typedef struct {
   UINT8   Reserved[2];
   UINT32  UsedLength;
   UINT32  TotalLength;
+  UINT32  SerialLength;
   UINT8   Buffer[0];
 } DEBUG_LOG_BUFFER_HEADER;
 
+#define  DEBUG_LOG_RING_SIGNATURE           SIGNATURE_32 ('D', 'L', 'R', 'G')
+
+#define  DEBUG_LOG_RING_FREE                0xFFFFFFFF
+#define  DEBUG_LOG_RECORD_PAD               0xFFFF
+
+//
+// One ring per CPU. Only the CPU owning the ring writes it, so no lock is
+// needed. Head and Tail are free running byte positions, the ring offset is
+// the position modulo the ring size.
+//
+typedef struct {
+  UINT32  ApicId;
+  UINT32  Head;
+  UINT32  Tail;
+  UINT32  Reserved;
+} DEBUG_LOG_RING;
+
+//
+// Followed by the ring data, RingCount rings of RingSize bytes
+//
+typedef struct {
+  UINT32          Signature;
+  UINT16          HeaderLength;
+  UINT16          RingCount;
+  UINT32          RingSize;
+  UINT32          BspApicId;
+  UINT32          FreqKhz;
+  UINT32          Reserved;
+  DEBUG_LOG_RING  Ring[0];
+} DEBUG_LOG_RING_HEADER;
+
+//
+// Followed by Length bytes of text, padded to 8 bytes. A record with
+// Length DEBUG_LOG_RECORD_PAD fills the ring up to its end.
+//
+typedef struct {
+  UINT64  TimeStamp;
+  UINT32  ErrorLevel;
+  UINT16  Length;
+  UINT16  Reserved;
+} DEBUG_LOG_RECORD;
+
 /**
   Write data from buffer to console buffer.
 
@@ -49,5 +92,102 @@ DebugLogBufferWrite (
   IN UINTN      NumberOfBytes
   );
 
+/**
+  Send the deferred serial output kept in the log buffer to the serial port.
+
+  It does nothing unless DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED is set in
+  PcdDebugOutputDeviceMask. SerialLength in the log buffer header tracks the
+  output sent so far.
+
+  @param  Wait             TRUE to send all pending output.
+                           FALSE to send only what the UART accepts without waiting.
+
+  @retval  The number of bytes sent.
+
+**/
+UINTN
+EFIAPI
+DebugLogBufferFlush (
+  IN BOOLEAN    Wait
+  );
+
+/**
+  Write a debug message to the log buffer.
+
+  The BSP writes the message to the log buffer. When the per-CPU debug log
+  rings are initialized, the message is also recorded with its time stamp
+  and error level in the ring of the calling CPU. Messages from APs are only
+  recorded in the rings.
+
+  @param  ErrorLevel       The error level of the debug message.
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written.
+
+  @retval 0                NumberOfBytes is 0.
+  @retval >0               The number of bytes written.
+
+**/
+UINTN
+EFIAPI
+DebugLogBufferWriteLevel (
+  IN UINTN      ErrorLevel,
+  IN UINT8     *Buffer,
+  IN UINTN      NumberOfBytes
+  );
+
+/**
+  Initialize the per-CPU debug log rings.
+
+  The rings are kept as library data so that they are handed over to the
+  payload. This must be called by the BSP after memory is available and
+  before APs start to log. The ring size is set by PcdDebugLogRingSize.
+
+  @param  RingCount        Number of rings, the maximum number of CPUs.
+
+  @retval EFI_SUCCESS            The rings are initialized.
+  @retval EFI_ALREADY_STARTED    The rings have been initialized already.
+  @retval EFI_UNSUPPORTED        The rings are disabled.
+  @retval EFI_OUT_OF_RESOURCES   No enough memory for the rings.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogRingInit (
+  IN UINT32     RingCount
+  );
+
+/**
+  Get the per-CPU debug log rings.
+
+  @retval  The debug log rings, NULL if they are not initialized.
+
+**/
+DEBUG_LOG_RING_HEADER *
+EFIAPI
+GetDebugLogRing (
+  VOID
+  );
+
+/**
+  Get the next record in time order from the per-CPU debug log rings.
+
+  Position holds the read position of each ring. Initialize entry N with
+  Ring[N].Tail to read all records.
+
+  @param  LogRing          The debug log rings.
+  @param  Position         Read positions of all rings, RingCount entries.
+  @param  RingIndex        Index of the ring holding the record.
+
+  @retval  The next record, NULL if all records have been read.
+
+**/
+DEBUG_LOG_RECORD *
+EFIAPI
+GetNextDebugLogRecord (
+  IN     DEBUG_LOG_RING_HEADER  *LogRing,
+  IN OUT UINT32                 *Position,
+  OUT    UINT32                 *RingIndex
+  );
+
 #endif
 
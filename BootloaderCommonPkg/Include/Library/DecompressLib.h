@@ -18,6 +18,23 @@
 #define  LZ_SIGNATURE_16    SIGNATURE_16 ('L', 'Z')
 #define  IS_COMPRESSED(x)   (*(UINT16 *)(UINTN)(x) == LZ_SIGNATURE_16)
 
+//
+// Chunked LZMA. The compressed data starts with LZMB_BLOCK_INDEX, followed by
+// independent LZMA streams. Each block decompresses to BlockSize bytes except
+// the last one, so blocks can be decompressed in any order.
+//
+#define  LZMB_SIGNATURE     SIGNATURE_32 ('L', 'Z', 'M', 'B')
+
+#pragma pack(1)
+typedef struct {
+  // Decompressed size of each block except the last one
+  UINT32        BlockSize;
+  UINT32        BlockCount;
+  // BlockCount + 1 offsets relative to the start of this index
+  UINT32        BlockOffset[];
+} LZMB_BLOCK_INDEX;
+#pragma pack()
+
 
 /**
   Given a Lzma compressed source buffer, this function retrieves the size of
@@ -93,5 +110,58 @@ Decompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Get the number of blocks that can be decompressed independently.
+
+  @param  Signature       The signature to indicate the decompression algorithm.
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  BlockCount      A pointer to the number of blocks. It is 1 for the
+                          algorithms that do not support blocks.
+
+  @retval  RETURN_SUCCESS          The number of blocks was returned in BlockCount.
+  @retval  RETURN_UNSUPPORTED      The decompression is not supported.
+  @retval  RETURN_INVALID_PARAMETER The block index is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+DecompressGetBlockCount (
+  IN  UINT32       Signature,
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *BlockCount
+  );
+
+/**
+  Decompresses a single block of a compressed source buffer.
+
+  The block is extracted to its offset in Destination, so the blocks can be
+  decompressed in any order and in parallel as long as each caller uses its
+  own scratch buffer.
+
+  @param  Signature       The signature to indicate the decompression algorithm.
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size of source buffer.
+  @param  BlockIndex      The index of the block to decompress.
+  @param  Destination     The destination buffer for the whole decompressed data.
+  @param  Scratch         A temporary scratch buffer that is used to perform the decompression.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          or BlockIndex is out of range.
+**/
+RETURN_STATUS
+EFIAPI
+DecompressBlock (
+  IN UINT32      Signature,
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      BlockIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
 #endif
 
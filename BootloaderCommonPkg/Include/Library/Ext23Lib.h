@@ -116,6 +116,30 @@ ExtFsReadFile (
   OUT UINTN                                      *FileSizePtr
   );
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+ExtFsReadFilePart (
+  IN  EFI_HANDLE                                  FsHandle,
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  );
+
 /**
   Close a file by opened file handle
 
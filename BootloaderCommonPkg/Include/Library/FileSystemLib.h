@@ -112,6 +112,30 @@ EFI_STATUS
   OUT UINTN                                      *FileSize
   );
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FS_READ_FILE_PART) (
+  IN  EFI_HANDLE                                  FsHandle,
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  );
+
 /**
   Close a file by opened file handle
 
@@ -275,6 +299,32 @@ ReadFile (
   OUT UINTN                                      *FileSize
   );
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  It allows to read the parts of a file to different places, for example a
+  file header first and then the data it describes to its final address.
+
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+  @retval EFI_UNSUPPORTED         The file system does not support it.
+
+**/
+EFI_STATUS
+EFIAPI
+ReadFilePart (
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  );
+
 /**
   Close a file by opened file handle
 
@@ -315,6 +365,7 @@ typedef struct {
   FS_READ_FILE                        ReadFile;
   FS_CLOSE_FILE                       CloseFile;
   FS_LIST_DIR                         ListDir;
+  FS_READ_FILE_PART                   ReadFilePart;
 } FILE_SYSTEM_FUNC;
 
 #endif // _FAT_PEIM_H_
@@ -0,0 +1,100 @@
+/** @file
+  Directory entry lookup cache shared by the file system backends.
+
+Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _FS_DIR_CACHE_LIB_H_
+#define _FS_DIR_CACHE_LIB_H_
+
+#include <PiPei.h>
+
+//
+// Directory entry lookup cache shared by the file system backends.
+// Each mounted file system keeps its own cache, mapping a name in a
+// directory to backend specific data, or to nothing for a missing name.
+//
+typedef struct _FS_DIR_CACHE FS_DIR_CACHE;
+
+/**
+  Create a directory entry lookup cache for a mounted file system.
+
+  The number of entries is set by PcdFsDirCacheEntries.
+
+  @param[in]     DataSize         Size of the data kept for each name.
+  @param[out]    DirCache         Pointer to the created cache.
+
+  @retval EFI_SUCCESS             The cache was created.
+  @retval EFI_UNSUPPORTED         The cache is disabled.
+  @retval EFI_OUT_OF_RESOURCES    Insufficant memory resource pool.
+
+**/
+EFI_STATUS
+EFIAPI
+FsDirCacheCreate (
+  IN  UINT32                                      DataSize,
+  OUT FS_DIR_CACHE                              **DirCache
+  );
+
+/**
+  Free a directory entry lookup cache.
+
+  @param[in]     DirCache         Cache to free, could be NULL.
+
+**/
+VOID
+EFIAPI
+FsDirCacheDestroy (
+  IN  FS_DIR_CACHE                               *DirCache
+  );
+
+/**
+  Look up a name of a directory in the cache.
+
+  @param[in]     DirCache         Cache to look up, could be NULL.
+  @param[in]     DirId            Backend specific identifier of the directory.
+  @param[in]     Name             Name to look up.
+  @param[in]     NameSize         Size of the name in bytes.
+  @param[out]    Data             Buffer for the data kept for the name.
+
+  @retval EFI_SUCCESS             The name was found, its data is returned.
+  @retval EFI_NOT_FOUND           The name is known to be missing.
+  @retval EFI_NO_MAPPING          The name is not in the cache.
+
+**/
+EFI_STATUS
+EFIAPI
+FsDirCacheLookup (
+  IN  FS_DIR_CACHE                               *DirCache,
+  IN  UINT64                                      DirId,
+  IN  CONST VOID                                 *Name,
+  IN  UINT32                                      NameSize,
+  OUT VOID                                       *Data
+  );
+
+/**
+  Add a name of a directory to the cache.
+
+  The least recently used entry is replaced when the cache is full.
+  Names too long for the cache are ignored.
+
+  @param[in]     DirCache         Cache to update, could be NULL.
+  @param[in]     DirId            Backend specific identifier of the directory.
+  @param[in]     Name             Name to add.
+  @param[in]     NameSize         Size of the name in bytes.
+  @param[in]     Data             Data for the name, NULL if the name is missing.
+
+**/
+VOID
+EFIAPI
+FsDirCacheInsert (
+  IN  FS_DIR_CACHE                               *DirCache,
+  IN  UINT64                                      DirId,
+  IN  CONST VOID                                 *Name,
+  IN  UINT32                                      NameSize,
+  IN  CONST VOID                                 *Data        OPTIONAL
+  );
+
+#endif
@@ -58,7 +58,6 @@ extern UINT32 mNarrowFontSize;
 typedef struct {
   EFI_PEI_GRAPHICS_INFO_HOB     *GfxInfoHob;
   CHAR8                         *TextDisplayBuf;
-  CHAR8                         *TextSwapBuf;
   CHAR8                         *TextDrawBuf;
   UINTN                         OffX;
   UINTN                         OffY;
@@ -68,6 +67,9 @@ typedef struct {
   UINTN                         Cols;
   UINTN                         CursorX;
   UINTN                         CursorY;
+  UINTN                         DirtyRow;
+  UINTN                         DirtyStart;
+  UINTN                         DirtyEnd;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor;
 } FRAME_BUFFER_CONSOLE;
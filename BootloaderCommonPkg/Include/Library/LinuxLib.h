@@ -201,6 +201,26 @@ IsBzImage (
   IN  CONST VOID             *ImageBase
   );
 
+/**
+  Get the address to place the protected mode kernel of a bzImage.
+
+  A relocatable kernel is placed at its preferred address when the memory
+  it needs there is RAM, so that it does not have to move itself before
+  decompressing. Otherwise it is placed at LINUX_KERNEL_BASE.
+
+  @param[in]  ImageBase      Memory address of the bzImage, at least its setup sectors.
+  @param[out] SetupSize      Size of the setup sectors that precede the protected
+                             mode kernel in the bzImage. Optional.
+
+  @retval     The address for the protected mode kernel, 0 if it is not a bzImage.
+**/
+UINTN
+EFIAPI
+GetBzImageKernelBase (
+  IN  CONST VOID             *ImageBase,
+  OUT UINT32                 *SetupSize     OPTIONAL
+  );
+
 /**
   Load linux kernel image to specified address and setup boot parameters.
 
@@ -224,6 +244,30 @@ LoadBzImage (
   IN      UINT32                   CmdLineLen
   );
 
+/**
+  Setup boot parameters for a linux kernel whose protected mode kernel was
+  read to the address returned by GetBzImageKernelBase () already.
+
+  @param[in]  SetupBase      Memory address of the bzImage setup sectors.
+  @param[in]  InitRdBase     Memory address of an InitRd image.
+  @param[in]  InitRdLen      InitRd image size.
+  @param[in]  CmdLineBase    Memory address of command line buffer.
+  @param[in]  CmdLineLen     Command line buffer size.
+
+  @retval EFI_INVALID_PARAMETER   Input parameters are not valid.
+  @retval EFI_UNSUPPORTED         Unsupported binary type.
+  @retval EFI_SUCCESS             Boot parameters are setup successfully.
+**/
+EFI_STATUS
+EFIAPI
+SetupBzImage (
+  IN  CONST VOID                  *SetupBase,
+  IN  CONST VOID                  *InitRdBase,
+  IN      UINT32                   InitRdLen,
+  IN  CONST VOID                  *CmdLineBase,
+  IN      UINT32                   CmdLineLen
+  );
+
 /**
   Update linux kernel boot parameters.
 
@@ -8,6 +8,8 @@
 #ifndef _LOADER_PERF_LIB_H_
 #define _LOADER_PERF_LIB_H_
 
+#include <Guid/BootSpanInfoGuid.h>
+
 typedef CHAR8 * (EFIAPI *PERF_ID_TO_STR) (UINT32 Id);
 
 /**
@@ -34,6 +36,49 @@ AddMeasurePoint (
   IN  UINT16         Id
   );
 
+/**
+  Begin a boot span.
+
+  Spans begun before the current span ends are nested in it.
+
+  @param[in]  Id          Measure point Id describing the span
+  @param[in]  Signature   Signature of the component owning the span
+  @param[in]  DeviceId    Device the span works on, 0 if none
+
+  @retval     Handle of the span, BOOT_SPAN_NONE if it is not recorded.
+
+**/
+UINT16
+BeginSpan (
+  IN  UINT16         Id,
+  IN  UINT32         Signature,
+  IN  UINT32         DeviceId
+  );
+
+/**
+  End a boot span.
+
+  @param[in]  Span        Handle returned by BeginSpan
+  @param[in]  Bytes       Number of bytes processed in the span
+
+**/
+VOID
+EndSpan (
+  IN  UINT16         Span,
+  IN  UINT64         Bytes
+  );
+
+/**
+  Get the boot span buffer.
+
+  @retval     The boot span buffer, NULL if no span was recorded.
+
+**/
+BOOT_SPAN_INFO *
+GetBootSpanInfo (
+  VOID
+  );
+
 /**
   Print Bootloader Measure Point information.
 
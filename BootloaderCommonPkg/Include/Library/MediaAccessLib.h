@@ -11,6 +11,16 @@
 #include <BlockDevice.h>
 #include <Guid/OsBootOptionGuid.h>
 
+//
+// Tracks a read started by MediaReadBlocksAsync ().
+// It must stay valid until MediaPollBlocks () returns other than EFI_NOT_READY.
+//
+typedef struct {
+  OS_BOOT_MEDIUM_TYPE       MediaType;
+  UINTN                     DeviceIndex;
+  EFI_STATUS                Status;
+} MEDIA_READ_TOKEN;
+
 /**
   Get current media interface type.
 
@@ -83,6 +93,81 @@ MediaReadBlocks (
   );
 
 
+/**
+  Start reading the requested number of blocks from the specified block device.
+
+  The function returns as soon as the read is started, so that the caller can
+  process other data while the device transfers. MediaPollBlocks () or
+  MediaWaitBlocks () report when the data is in the buffer. Media interfaces
+  without asynchronous support complete the read before returning.
+
+  Only one asynchronous read is outstanding at a time. Starting another one, or
+  any other media access, waits for the outstanding read to finish first.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            It must not be accessed until the read has finished.
+  @param[out] Token         Tracks the read for MediaPollBlocks () and MediaWaitBlocks ().
+
+  @retval EFI_SUCCESS             The read was started or has already finished.
+  @retval EFI_UNSUPPORTED         The interface is not supported.
+  @retval EFI_NOT_READY           The MediaSetInterfaceType() has not been called yet.
+  @retval EFI_INVALID_PARAMETER   Token is NULL, the read request contains LBAs that are
+                                  not valid, or the buffer is not properly aligned.
+  @retval Others                  The read could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaReadBlocksAsync (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  OUT VOID                          *Buffer,
+  OUT MEDIA_READ_TOKEN              *Token
+  );
+
+
+/**
+  Check a read started by MediaReadBlocksAsync () without waiting.
+
+  @param[in, out]  Token    The token returned by MediaReadBlocksAsync ().
+
+  @retval EFI_SUCCESS             The data was read correctly from the device.
+  @retval EFI_NOT_READY           The read is still in progress.
+  @retval EFI_INVALID_PARAMETER   Token is NULL.
+  @retval Others                  The read has finished with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaPollBlocks (
+  IN OUT MEDIA_READ_TOKEN           *Token
+  );
+
+
+/**
+  Wait for a read started by MediaReadBlocksAsync () to finish.
+
+  @param[in, out]  Token    The token returned by MediaReadBlocksAsync ().
+
+  @retval EFI_SUCCESS             The data was read correctly from the device.
+  @retval EFI_INVALID_PARAMETER   Token is NULL.
+  @retval Others                  The read has finished with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaWaitBlocks (
+  IN OUT MEDIA_READ_TOKEN           *Token
+  );
+
+
 /**
   This function writes data from Memory to media
 
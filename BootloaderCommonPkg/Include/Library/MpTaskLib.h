@@ -0,0 +1,108 @@
+/** @file
+  Simple job scheduler to run short tasks on the idle application processors.
+
+  Jobs are queued by the BSP and picked up by the APs parked in the MP task
+  loop. A job runs on whichever processor takes it first, including the BSP
+  while it waits, so every submitted job always completes even when no AP is
+  available. Job functions must not allocate memory or print debug messages.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MP_TASK_LIB_H_
+#define _MP_TASK_LIB_H_
+
+#include <Guid/MpCpuTaskInfoHob.h>
+
+typedef enum {
+  EnumMpJobIdle = 0,
+  EnumMpJobQueued,
+  EnumMpJobRunning,
+  EnumMpJobDone
+} MP_JOB_STATE;
+
+typedef struct {
+  CPU_TASK_FUNC     TaskFunc;
+  UINT64            Argument;
+  UINT64            Result;
+  volatile UINT32   State;
+} MP_TASK_JOB;
+
+/**
+  Initialize the job scheduler with the processor task state.
+
+  @param[in]  SysCpuTask   Pointer to SYS_CPU_TASK structure for all CPUs.
+                           NULL to run all jobs on the BSP.
+
+  @retval EFI_SUCCESS      The scheduler was initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskInit (
+  IN  SYS_CPU_TASK   *SysCpuTask
+  );
+
+/**
+  Get the number of application processors available to run jobs.
+
+  @retval    The number of application processors.
+
+**/
+UINT32
+EFIAPI
+MpTaskGetWorkerCount (
+  VOID
+  );
+
+/**
+  Submit a job to the scheduler.
+
+  The job structure must stay valid until MpTaskWait () or MpTaskJoin ()
+  returns. If the queue is full, the job is run on the BSP immediately.
+
+  @param[in,out]  Job        Job to submit.
+  @param[in]      TaskFunc   Job function pointer.
+  @param[in]      Argument   Argument for the job function.
+
+  @retval EFI_INVALID_PARAMETER   Job or TaskFunc is NULL.
+  @retval EFI_SUCCESS             The job was queued or has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskSubmit (
+  IN OUT MP_TASK_JOB    *Job,
+  IN     CPU_TASK_FUNC   TaskFunc,
+  IN     UINT64          Argument
+  );
+
+/**
+  Wait for a submitted job to complete.
+
+  While waiting, the BSP runs queued jobs itself.
+
+  @param[in]  Job        Job to wait for.
+
+  @retval     The return value of the job function.
+
+**/
+UINT64
+EFIAPI
+MpTaskWait (
+  IN  MP_TASK_JOB   *Job
+  );
+
+/**
+  Wait for all submitted jobs to complete.
+
+**/
+VOID
+EFIAPI
+MpTaskJoin (
+  VOID
+  );
+
+#endif
@@ -79,6 +79,54 @@ NvmeReadBlocks (
   OUT VOID                          *Buffer
   );
 
+/**
+  Start reading the requested number of blocks from the specified Nvme device.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            It must not be accessed until NvmePollBlocks ()
+                            reports the read has finished.
+
+  @retval EFI_SUCCESS             The read was started.
+  @retval EFI_ALREADY_STARTED     An asynchronous read is already outstanding.
+  @retval EFI_INVALID_PARAMETER   The read request contains LBAs that are not
+                                  valid, or the buffer is not properly aligned.
+  @retval EFI_BAD_BUFFER_SIZE     The BufferSize parameter is not a multiple of
+                                  the intrinsic block size of the device.
+
+**/
+EFI_STATUS
+EFIAPI
+NvmeReadBlocksAsync (
+  IN  UINTN                         DeviceIndex,
+  IN  EFI_LBA                       StartLBA,
+  IN  UINTN                         BufferSize,
+  OUT VOID                          *Buffer
+  );
+
+/**
+  Check the read started by NvmeReadBlocksAsync () without waiting.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+
+  @retval EFI_SUCCESS        The read has finished and all the data is in the buffer.
+  @retval EFI_NOT_READY      The read is still in progress.
+  @retval EFI_NOT_FOUND      No asynchronous read is outstanding.
+  @retval Others             The read has finished with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+NvmePollBlocks (
+  IN  UINTN                         DeviceIndex
+  );
+
 /**
   This function writes data from Memory to Nvme device.
 
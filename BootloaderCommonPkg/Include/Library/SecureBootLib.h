@@ -14,6 +14,8 @@
 #define  SIG_TYPE_RSA2048_SHA256       0
 #define  SIG_TYPE_RSA3072_SHA384       1
 
+#define  HASH_MULTI_MAX                4
+
 /**
   Get hash to extend a firmware stage component
   Hash calculation to extend would be in either of ways
@@ -62,6 +64,145 @@ CalculateHash  (
   IN OUT   UINT8          *OutHash
   );
 
+/**
+  Initialize a hash context for incremental hashing.
+
+  @param[in]  HashCtx        Pointer to the hash context buffer.
+  @param[in]  HashAlg        Specify hash algrothsm.
+
+  @retval RETURN_SUCCESS             Hash context was initialized.
+  @retval RETURN_INVALID_PARAMETER   HashCtx is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashInit (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg
+  );
+
+/**
+  Consume a piece of data into a hash context.
+  This method can be called multiple times to hash separate pieces of data.
+
+  @param[in]  HashCtx        Pointer to the hash context buffer.
+  @param[in]  HashAlg        Hash algrothsm used in HashInit ().
+  @param[in]  Data           Data buffer pointer.
+  @param[in]  Length         Data buffer size.
+
+  @retval RETURN_SUCCESS             Data was hashed.
+  @retval RETURN_INVALID_PARAMETER   HashCtx is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashUpdate (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg,
+  IN CONST UINT8          *Data,
+  IN       UINT32          Length
+  );
+
+/**
+  Finalize a hash context and return the digest.
+
+  @param[in]      HashCtx    Pointer to the hash context buffer.
+  @param[in]      HashAlg    Hash algrothsm used in HashInit ().
+  @param[in,out]  OutHash    Hash of all data consumed by the context.
+
+  @retval RETURN_SUCCESS             Hash Calculation succeeded.
+  @retval RETURN_INVALID_PARAMETER   HashCtx or OutHash is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashFinal (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg,
+  IN OUT   UINT8          *OutHash
+  );
+
+/**
+  Calculate the digests of a data buffer for several hash algorithms at once.
+
+  The data is read only once, each chunk is consumed by all the requested
+  algorithms while it is still in cache.
+
+  @param[in]  Data           Data buffer pointer.
+  @param[in]  Length         Data buffer size.
+  @param[in]  HashCount      Number of entries in HashAlg and OutHash, up to HASH_MULTI_MAX.
+  @param[in]  HashAlg        Array of hash algorithms.
+  @param[in,out]  OutHash    Array of pointers to receive the digest for each HashAlg.
+
+  @retval RETURN_SUCCESS             All the digests were calculated.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_UNSUPPORTED         One or more Hash Alg types are not supported,
+                                     the digests of the supported ones are still valid.
+
+**/
+RETURN_STATUS
+EFIAPI
+CalculateHashMulti (
+  IN CONST UINT8          *Data,
+  IN       UINT32          Length,
+  IN       UINT32          HashCount,
+  IN CONST UINT8          *HashAlg,
+  IN OUT   UINT8  * CONST *OutHash
+  );
+
+/**
+  Calculate the digests of several independent data buffers.
+
+  Buffers are hashed in parallel lanes when the hash algorithm has a
+  multi-buffer implementation, otherwise they are hashed one by one.
+
+  @param[in]  Data           Array of data buffer pointers.
+  @param[in]  Length         Array of data buffer sizes.
+  @param[in]  Count          Number of data buffers.
+  @param[in]  HashAlg        Specify hash algrothsm.
+  @param[in,out]  OutHash    Array of pointers to receive the digest of each buffer.
+
+  @retval RETURN_SUCCESS             Hash Calculation succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+CalculateHashBatch (
+  IN CONST UINT8  * CONST *Data,
+  IN CONST UINT32         *Length,
+  IN       UINT32          Count,
+  IN       UINT8           HashAlg,
+  IN OUT   UINT8  * CONST *OutHash
+  );
+
+/**
+  Verify a pre-calculated data digest with the built-in one.
+
+  @param[in]  Digest         Digest of the data to verify.
+  @param[in]  Usage          Hash component usage.
+  @param[in]  HashAlg        Specify hash algorithm.
+  @param[in,out]  Hash       On input,  expected hash value when hash component usage is 0.
+                             On output, digest value when verification succeeds.
+
+  @retval RETURN_SUCCESS             Hash verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_SECURITY_VIOLATION  Hash verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoDigestVerify (
+  IN CONST UINT8           *Digest,
+  IN       HASH_COMP_USAGE  Usage,
+  IN       UINT8            HashAlg,
+  IN OUT   UINT8           *Hash
+  );
+
 /**
   Verify data block hash with the built-in one.
 
@@ -122,6 +263,34 @@ DoRsaVerify (
   OUT      UINT8           *OutHash         OPTIONAL
   );
 
+/**
+  Verifies the RSA PKCS1-v1_5 signature against a pre-calculated data digest.
+  RSA PSS signatures are not supported since they require the whole message.
+
+  @param[in]  Digest          Digest of the signed data.
+  @param[in]  Usage           Hash usage.
+  @param[in]  Signature       Signature header for singanture data.
+  @param[in]  PubKeyHdr       Public key header for key data
+  @param[in]  PubKeyHashAlg   Hash Alg for PubKeyHash.
+  @param[in]  PubKeyHash      Public key hash value when hash component usage is 0.
+
+  @retval RETURN_SUCCESS             RSA verification succeeded.
+  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
+  @retval RETURN_UNSUPPORTED         Signing type is not supported.
+  @retval RETURN_SECURITY_VIOLATION  PubKey or Signature verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoRsaVerifyDigest (
+  IN CONST UINT8           *Digest,
+  IN       HASH_COMP_USAGE  Usage,
+  IN CONST SIGNATURE_HDR   *SignatureHdr,
+  IN       PUB_KEY_HDR     *PubKeyHdr,
+  IN       UINT8            PubKeyHashAlg,
+  IN       UINT8           *PubKeyHash      OPTIONAL
+  );
+
 /**
   Generate RandomNumbers.
 
@@ -8,6 +8,8 @@
 
 #include "AhciDevice.h"
 
+AHCI_ASYNC_READ      mAhciAsyncRead;
+
 /**
   Calculate max transfer sector count.
 
@@ -45,6 +47,48 @@ GetMaxTransferSector (
   return BlkCnt;
 }
 
+/**
+  Build the ATA command block for a read or write DMA command.
+
+  @param[in]  AtaDevice     ATA device instance.
+  @param[in]  StartLba      The starting logical block address (LBA) to read from
+                            on the device.
+  @param[in]  SectorCount   The sector count to read or write.
+  @param[out] AtaCmdBlk     The ATA command block to fill.
+
+**/
+STATIC
+VOID
+AhciBuildReadWriteCommand (
+  IN     EFI_ATA_DEVICE_INFO   *AtaDevice,
+  IN     EFI_LBA                StartLba,
+  IN     UINT32                 SectorCount,
+  OUT    EFI_ATA_COMMAND_BLOCK *AtaCmdBlk
+  )
+{
+  //
+  // Prepare for ATA command block.
+  //
+  ZeroMem (AtaCmdBlk, sizeof (EFI_ATA_COMMAND_BLOCK));
+
+  AtaCmdBlk->AtaCommand = (AtaDevice->DeviceFeature & DEVICE_LBA_48_SUPPORT) ? ATA_CMD_READ_DMA_EXT : ATA_CMD_READ_DMA;
+  AtaCmdBlk->AtaSectorNumber = (UINT8) StartLba;
+  AtaCmdBlk->AtaCylinderLow = (UINT8) RShiftU64 (StartLba, 8);
+  AtaCmdBlk->AtaCylinderHigh = (UINT8) RShiftU64 (StartLba, 16);
+  AtaCmdBlk->AtaDeviceHead = (UINT8) (BIT7 | BIT6 | BIT5 | \
+                                      (AtaDevice->PortMultiplier == 0xFFFF ? 0 : (AtaDevice->PortMultiplier << 4)));
+  AtaCmdBlk->AtaSectorCount = (UINT8) SectorCount;
+
+  if (AtaDevice->DeviceFeature & DEVICE_LBA_48_SUPPORT) {
+    AtaCmdBlk->AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
+    AtaCmdBlk->AtaCylinderLowExp = (UINT8) RShiftU64 (StartLba, 32);
+    AtaCmdBlk->AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
+    AtaCmdBlk->AtaSectorCountExp = (UINT8) (SectorCount >> 8);
+  } else {
+    AtaCmdBlk->AtaDeviceHead = (UINT8) (AtaCmdBlk->AtaDeviceHead | RShiftU64 (StartLba, 24));
+  }
+}
+
 /**
   Block read/write to ATA device.
 
@@ -79,27 +123,7 @@ AhciAtaDeviceReadWrite (
 
   AhciController     = AtaDevice->Controller;
 
-  //
-  // Prepare for ATA command block.
-  //
-  ZeroMem (&AtaCmdBlk, sizeof (EFI_ATA_COMMAND_BLOCK));
-
-  AtaCmdBlk.AtaCommand = (AtaDevice->DeviceFeature & DEVICE_LBA_48_SUPPORT) ? ATA_CMD_READ_DMA_EXT : ATA_CMD_READ_DMA;
-  AtaCmdBlk.AtaSectorNumber = (UINT8) StartLba;
-  AtaCmdBlk.AtaCylinderLow = (UINT8) RShiftU64 (StartLba, 8);
-  AtaCmdBlk.AtaCylinderHigh = (UINT8) RShiftU64 (StartLba, 16);
-  AtaCmdBlk.AtaDeviceHead = (UINT8) (BIT7 | BIT6 | BIT5 | \
-                                     (AtaDevice->PortMultiplier == 0xFFFF ? 0 : (AtaDevice->PortMultiplier << 4)));
-  AtaCmdBlk.AtaSectorCount = (UINT8) SectorCount;
-
-  if (AtaDevice->DeviceFeature & DEVICE_LBA_48_SUPPORT) {
-    AtaCmdBlk.AtaSectorNumberExp = (UINT8) RShiftU64 (StartLba, 24);
-    AtaCmdBlk.AtaCylinderLowExp = (UINT8) RShiftU64 (StartLba, 32);
-    AtaCmdBlk.AtaCylinderHighExp = (UINT8) RShiftU64 (StartLba, 40);
-    AtaCmdBlk.AtaSectorCountExp = (UINT8) (SectorCount >> 8);
-  } else {
-    AtaCmdBlk.AtaDeviceHead = (UINT8) (AtaCmdBlk.AtaDeviceHead | RShiftU64 (StartLba, 24));
-  }
+  AhciBuildReadWriteCommand (AtaDevice, StartLba, SectorCount, &AtaCmdBlk);
 
   return AhciDmaTransfer (
            AhciController,
@@ -118,51 +142,31 @@ AhciAtaDeviceReadWrite (
 }
 
 /**
-  Block read/write to ATA device.
-
-  The function performs read or write operation to the ATA device.
+  Check the parameters of a block read/write request.
 
   @param[in]  AtaDevice     ATA device instance.
-  @param[in]  Read          Read or write.
   @param[in]  Lba           The starting logical block address (LBA) to read from
                             on the device.
-  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
-                            a multiple of the intrinsic block size of the device.
-  @param[out] Buffer        A pointer to the destination buffer for the data.
-                            The caller is responsible for the ownership of the
-                            buffer.
+  @param[in]  BufferSize    The size of the Buffer in bytes.
+  @param[in]  Buffer        A pointer to the buffer for the data.
 
+  @retval EFI_SUCCESS            The request is valid, or BufferSize is 0.
   @retval EFI_INVALID_PARAMETER  Inpurt parameters are not valid.
-  @retval EFI_DEVICE_ERROR       The DMA data transfer abort with error occurs.
-  @retval EFI_TIMEOUT            The operation is time out.
-  @retval EFI_UNSUPPORTED        The device is not ready for transfer.
-  @retval EFI_SUCCESS            The DMA data transfer executes successfully.
+  @retval EFI_BAD_BUFFER_SIZE    BufferSize is not a multiple of the block size.
 
 **/
+STATIC
 EFI_STATUS
-AhciReadWriteBlock (
+AhciCheckBlockRequest (
   IN     EFI_ATA_DEVICE_INFO  *AtaDevice,
-  IN     BOOLEAN               Read,
   IN     EFI_LBA               Lba,
   IN     UINTN                 BufferSize,
-  OUT    VOID                 *Buffer
+  IN     VOID                 *Buffer
   )
 {
-  EFI_STATUS                     Status;
-  EFI_LBA                        LbaIndex;
-  UINT8                          *ReadBuf;
   UINTN                          BlockSize;
   UINTN                          NumberOfBlocks;
   UINT32                         IoAlign;
-  UINT32                         MaxTransferSector;
-  UINT32                         RemainSectorCount;
-
-  if (AtaDevice == NULL) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  ReadBuf               = Buffer;
-  LbaIndex              = Lba;
 
   if (AtaDevice == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -200,8 +204,236 @@ AhciReadWriteBlock (
     return EFI_INVALID_PARAMETER;
   }
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Issue the next read DMA command of the asynchronous read.
+
+  @retval EFI_SUCCESS            The command is running.
+  @retval Others                 The command could not be issued.
+
+**/
+STATIC
+EFI_STATUS
+AhciAsyncReadNext (
+  VOID
+  )
+{
+  EFI_ATA_DEVICE_INFO            *AtaDevice;
+  EFI_AHCI_CONTROLLER            *AhciController;
+  EFI_ATA_COMMAND_BLOCK          AtaCmdBlk;
+
+  AtaDevice      = mAhciAsyncRead.AtaDevice;
+  AhciController = AtaDevice->Controller;
+
+  mAhciAsyncRead.SectorCount = MIN (mAhciAsyncRead.RemainSectorCount, GetMaxTransferSector (AtaDevice));
+  mAhciAsyncRead.StartTime   = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+  AhciBuildReadWriteCommand (AtaDevice, mAhciAsyncRead.Lba, mAhciAsyncRead.SectorCount, &AtaCmdBlk);
+
+  return AhciDmaTransferStart (
+           AhciController,
+           &AhciController->AhciRegisters,
+           (UINT8)AtaDevice->Port,
+           (UINT8)AtaDevice->PortMultiplier,
+           NULL,
+           0,
+           TRUE,
+           &AtaCmdBlk,
+           NULL,
+           mAhciAsyncRead.Buffer,
+           mAhciAsyncRead.SectorCount * AtaDevice->BlockSize,
+           DMA_WAIT_TIMEOUT_MS * 1000 * 10,
+           &mAhciAsyncRead.MapData
+           );
+}
+
+/**
+  Start a block read from ATA device without waiting for the data.
+
+  The read is split into DMA commands like AhciReadWriteBlock (), the next one
+  is issued by AhciPollReadBlock () when the previous one completes.
+
+  @param[in]  AtaDevice     ATA device instance.
+  @param[in]  Lba           The starting logical block address (LBA) to read from
+                            on the device.
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS            The read was started.
+  @retval EFI_ALREADY_STARTED    An asynchronous read is already outstanding.
+  @retval EFI_INVALID_PARAMETER  Inpurt parameters are not valid.
+  @retval EFI_DEVICE_ERROR       The first DMA command could not be issued.
+
+**/
+EFI_STATUS
+AhciReadBlockAsync (
+  IN     EFI_ATA_DEVICE_INFO  *AtaDevice,
+  IN     EFI_LBA               Lba,
+  IN     UINTN                 BufferSize,
+  OUT    VOID                 *Buffer
+  )
+{
+  EFI_STATUS                     Status;
+
+  if (mAhciAsyncRead.AtaDevice != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  Status = AhciCheckBlockRequest (AtaDevice, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  mAhciAsyncRead.AtaDevice         = AtaDevice;
+  mAhciAsyncRead.Lba               = Lba;
+  mAhciAsyncRead.Buffer            = Buffer;
+  mAhciAsyncRead.RemainSectorCount = (UINT32) (BufferSize / AtaDevice->BlockSize);
+  mAhciAsyncRead.SectorCount       = 0;
+  mAhciAsyncRead.MapData           = NULL;
+  if (mAhciAsyncRead.RemainSectorCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = AhciAsyncReadNext ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AhciReadBlockAsync Status = %r\n", Status));
+    mAhciAsyncRead.AtaDevice = NULL;
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the read started by AhciReadBlockAsync () without waiting.
+
+  @param[in]  AtaDevice     ATA device instance the read was started on, or
+                            NULL to check the outstanding read of any device.
+
+  @retval EFI_SUCCESS            The data was read correctly from the device.
+  @retval EFI_NOT_READY          The read is still in progress.
+  @retval EFI_NOT_FOUND          No read is outstanding on the device.
+  @retval EFI_DEVICE_ERROR       The DMA data transfer abort with error or timed out.
+
+**/
+EFI_STATUS
+AhciPollReadBlock (
+  IN     EFI_ATA_DEVICE_INFO  *AtaDevice  OPTIONAL
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_AHCI_CONTROLLER            *AhciController;
+
+  if ((mAhciAsyncRead.AtaDevice == NULL) ||
+      ((AtaDevice != NULL) && (AtaDevice != mAhciAsyncRead.AtaDevice))) {
+    return EFI_NOT_FOUND;
+  }
+  AtaDevice = mAhciAsyncRead.AtaDevice;
+
+  if (mAhciAsyncRead.SectorCount != 0) {
+    AhciController = AtaDevice->Controller;
+    Status = AhciDmaTransferCheck (&AhciController->AhciRegisters, (UINT8)AtaDevice->Port);
+    if ((Status == EFI_NOT_READY) &&
+        ((GetTimeInNanoSecond (GetPerformanceCounter ()) - mAhciAsyncRead.StartTime) <
+         MultU64x32 (DMA_WAIT_TIMEOUT_MS, 1000 * 1000))) {
+      return EFI_NOT_READY;
+    }
+
+    //
+    // Completed, or out of time in which case the command gets a last timeout
+    // period before it is stopped.
+    //
+    Status = AhciDmaTransferFinish (
+               AhciController,
+               &AhciController->AhciRegisters,
+               (UINT8)AtaDevice->Port,
+               mAhciAsyncRead.MapData,
+               NULL,
+               DMA_WAIT_TIMEOUT_MS * 1000 * 10
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "AhciDeviceRead Status = %r\n", Status));
+      mAhciAsyncRead.AtaDevice = NULL;
+      return EFI_DEVICE_ERROR;
+    }
+
+    mAhciAsyncRead.Buffer            += mAhciAsyncRead.SectorCount * AtaDevice->BlockSize;
+    mAhciAsyncRead.Lba               += mAhciAsyncRead.SectorCount;
+    mAhciAsyncRead.RemainSectorCount -= mAhciAsyncRead.SectorCount;
+  }
+
+  if (mAhciAsyncRead.RemainSectorCount == 0) {
+    mAhciAsyncRead.AtaDevice = NULL;
+    return EFI_SUCCESS;
+  }
+
+  Status = AhciAsyncReadNext ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AhciDeviceRead Status = %r\n", Status));
+    mAhciAsyncRead.AtaDevice = NULL;
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Block read/write to ATA device.
+
+  The function performs read or write operation to the ATA device.
+
+  @param[in]  AtaDevice     ATA device instance.
+  @param[in]  Read          Read or write.
+  @param[in]  Lba           The starting logical block address (LBA) to read from
+                            on the device.
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            The caller is responsible for the ownership of the
+                            buffer.
+
+  @retval EFI_INVALID_PARAMETER  Inpurt parameters are not valid.
+  @retval EFI_DEVICE_ERROR       The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT            The operation is time out.
+  @retval EFI_UNSUPPORTED        The device is not ready for transfer.
+  @retval EFI_SUCCESS            The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+AhciReadWriteBlock (
+  IN     EFI_ATA_DEVICE_INFO  *AtaDevice,
+  IN     BOOLEAN               Read,
+  IN     EFI_LBA               Lba,
+  IN     UINTN                 BufferSize,
+  OUT    VOID                 *Buffer
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_LBA                        LbaIndex;
+  UINT8                          *ReadBuf;
+  UINT32                         MaxTransferSector;
+  UINT32                         RemainSectorCount;
+
+  Status = AhciCheckBlockRequest (AtaDevice, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status) || (BufferSize == 0)) {
+    return Status;
+  }
+
+  //
+  // The port runs one command at a time, finish the asynchronous read first.
+  //
+  while (AhciPollReadBlock (NULL) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+
+  ReadBuf               = Buffer;
+  LbaIndex              = Lba;
+
   MaxTransferSector = GetMaxTransferSector (AtaDevice);
-  RemainSectorCount = (UINT32)NumberOfBlocks;
+  RemainSectorCount = (UINT32) (BufferSize / AtaDevice->BlockSize);
   while (RemainSectorCount != 0) {
     Status = AhciAtaDeviceReadWrite (
                AtaDevice,
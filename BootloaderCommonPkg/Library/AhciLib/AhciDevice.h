@@ -53,6 +53,19 @@ typedef struct {
   EFI_AHCI_CONTROLLER              *Controller;
 } EFI_ATA_DEVICE_INFO;
 
+//
+// Read started by AhciReadBlockAsync ()
+//
+typedef struct {
+  EFI_ATA_DEVICE_INFO              *AtaDevice;          // NULL when idle
+  EFI_LBA                           Lba;                // Start of the running command
+  UINT8                            *Buffer;
+  UINT32                            RemainSectorCount;
+  UINT32                            SectorCount;        // Sectors of the running command
+  VOID                             *MapData;
+  UINT64                            StartTime;          // Start of the running command in ns
+} AHCI_ASYNC_READ;
+
 /**
   Block read/write to ATA device.
 
@@ -84,4 +97,48 @@ AhciReadWriteBlock (
   OUT    VOID                 *Buffer
   );
 
+/**
+  Start a block read from ATA device without waiting for the data.
+
+  The read is split into DMA commands like AhciReadWriteBlock (), the next one
+  is issued by AhciPollReadBlock () when the previous one completes.
+
+  @param[in]  AtaDevice     ATA device instance.
+  @param[in]  Lba           The starting logical block address (LBA) to read from
+                            on the device.
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS            The read was started.
+  @retval EFI_ALREADY_STARTED    An asynchronous read is already outstanding.
+  @retval EFI_INVALID_PARAMETER  Inpurt parameters are not valid.
+  @retval EFI_DEVICE_ERROR       The first DMA command could not be issued.
+
+**/
+EFI_STATUS
+AhciReadBlockAsync (
+  IN     EFI_ATA_DEVICE_INFO  *AtaDevice,
+  IN     EFI_LBA               Lba,
+  IN     UINTN                 BufferSize,
+  OUT    VOID                 *Buffer
+  );
+
+/**
+  Check the read started by AhciReadBlockAsync () without waiting.
+
+  @param[in]  AtaDevice     ATA device instance the read was started on, or
+                            NULL to check the outstanding read of any device.
+
+  @retval EFI_SUCCESS            The data was read correctly from the device.
+  @retval EFI_NOT_READY          The read is still in progress.
+  @retval EFI_NOT_FOUND          No read is outstanding on the device.
+  @retval EFI_DEVICE_ERROR       The DMA data transfer abort with error or timed out.
+
+**/
+EFI_STATUS
+AhciPollReadBlock (
+  IN     EFI_ATA_DEVICE_INFO  *AtaDevice  OPTIONAL
+  );
+
 #endif
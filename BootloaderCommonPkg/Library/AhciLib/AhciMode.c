@@ -832,7 +832,55 @@ Exit:
 }
 
 /**
-  Start a DMA data transfer on specific port
+  Stop the DMA data transfer on specific port and release its resources.
+
+  @param[in]       AhciController      The AHCI controller instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       MapData             The mapping of the data buffer.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in]       Timeout             The timeout value of stop, uses 100ns as a unit.
+
+**/
+STATIC
+VOID
+AhciDmaTransferStop (
+  IN     EFI_AHCI_CONTROLLER        *AhciController,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     VOID                       *MapData,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN     UINT64                     Timeout
+  )
+{
+  //
+  // For Blocking mode, the command should be stopped, the Fis should be disabled
+  // and the AhciController should be unmapped.
+  // For non-blocking mode, only when a error is happened (if the return status is
+  // EFI_NOT_READY that means the command doesn't finished, try again.), first do the
+  // context cleanup, then set the packet's Asb status.
+  //
+  AhciStopCommand (
+    AhciController,
+    Port,
+    Timeout
+    );
+
+  AhciDisableFisReceive (
+    AhciController,
+    Port,
+    Timeout
+    );
+
+  if (MapData != NULL) {
+    IoMmuUnmap (MapData);
+  }
+
+  AhciDumpPortStatus (AhciController, AhciRegisters, Port, AtaStatusBlock);
+}
+
+/**
+  Issue a DMA data transfer on specific port without waiting for it.
 
   @param[in]       AhciController      The AHCI controller instance.
   @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
@@ -846,17 +894,18 @@ Exit:
   @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
   @param[in, out]  MemoryAddr          The pointer to the data buffer.
   @param[in]       DataCount           The data count to be transferred.
-  @param[in]       Timeout             The timeout value of non data transfer, uses 100ns as a unit.
+  @param[in]       Timeout             The timeout value of command start, uses 100ns as a unit.
+  @param[out]      MapData             The mapping of the data buffer, to be passed
+                                       to AhciDmaTransferFinish ().
 
-  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
-  @retval EFI_TIMEOUT         The operation is time out.
-  @retval EFI_UNSUPPORTED     The device is not ready for transfer.
-  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+  @retval EFI_OUT_OF_RESOURCES The data buffer could not be mapped.
+  @retval EFI_TIMEOUT          The operation is time out.
+  @retval EFI_SUCCESS          The DMA data transfer is running.
 
 **/
 EFI_STATUS
 EFIAPI
-AhciDmaTransfer (
+AhciDmaTransferStart (
   IN     EFI_AHCI_CONTROLLER        *AhciController,
   IN     EFI_AHCI_REGISTERS         *AhciRegisters,
   IN     UINT8                      Port,
@@ -868,18 +917,15 @@ AhciDmaTransfer (
   IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
   IN OUT VOID                       *MemoryAddr,
   IN     UINT32                     DataCount,
-  IN     UINT64                     Timeout
+  IN     UINT64                     Timeout,
+  OUT    VOID                       **MapData
   )
 {
   EFI_STATUS                    Status;
-  UINTN                         Offset;
   EFI_PHYSICAL_ADDRESS          PhyAddr;
   EFI_AHCI_COMMAND_FIS          CFis;
   EFI_AHCI_COMMAND_LIST         CmdList;
-  UINTN                         FisBaseAddr;
-  UINT32                        PortTfd;
   UINTN                         MapLength;
-  VOID                          *MapData;
 
   if (AhciController == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -888,14 +934,14 @@ AhciDmaTransfer (
   //
   // construct command list and command table with pci bus address
   //
-  MapData   = NULL;
+  *MapData  = NULL;
   MapLength = DataCount;
   Status    = IoMmuMap (
                 Read ? EdkiiIoMmuOperationBusMasterWrite : EdkiiIoMmuOperationBusMasterRead,
                 MemoryAddr,
                 &MapLength,
                 &PhyAddr,
-                &MapData
+                MapData
                 );
   if (EFI_ERROR (Status) || (MapLength != DataCount)) {
     return EFI_OUT_OF_RESOURCES;
@@ -932,9 +978,71 @@ AhciDmaTransfer (
              Timeout
              );
   if (EFI_ERROR (Status)) {
-    goto Exit;
+    AhciDmaTransferStop (AhciController, AhciRegisters, Port, *MapData, AtaStatusBlock, Timeout);
   }
 
+  return Status;
+}
+
+/**
+  Check if the DMA data transfer issued by AhciDmaTransferStart () has completed.
+
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+
+  @retval EFI_NOT_READY       The DMA data transfer is still running.
+  @retval EFI_SUCCESS         The DMA data transfer has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransferCheck (
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port
+  )
+{
+  UINTN                         FisBaseAddr;
+
+  FisBaseAddr = (UINTN)AhciRegisters->AhciRFis + Port * sizeof (EFI_AHCI_RECEIVED_FIS);
+
+  return AhciCheckMemSet (
+           FisBaseAddr + EFI_AHCI_D2H_FIS_OFFSET,
+           EFI_AHCI_FIS_TYPE_MASK,
+           EFI_AHCI_FIS_REGISTER_D2H
+           );
+}
+
+/**
+  Wait for the DMA data transfer issued by AhciDmaTransferStart () to complete.
+
+  @param[in]       AhciController      The AHCI controller instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       MapData             The mapping returned by AhciDmaTransferStart ().
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransferFinish (
+  IN     EFI_AHCI_CONTROLLER        *AhciController,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     VOID                       *MapData,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN     UINT64                     Timeout
+  )
+{
+  EFI_STATUS                    Status;
+  UINTN                         Offset;
+  UINTN                         FisBaseAddr;
+  UINT32                        PortTfd;
+
   //
   // Wait for command compelte
   //
@@ -948,42 +1056,81 @@ AhciDmaTransfer (
              Timeout
              );
 
-  if (EFI_ERROR (Status)) {
-    goto Exit;
+  if (!EFI_ERROR (Status)) {
+    Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+    PortTfd = AhciReadReg (AhciController, (UINT32) Offset);
+    if ((PortTfd & EFI_AHCI_PORT_TFD_ERR) != 0) {
+      Status = EFI_DEVICE_ERROR;
+    }
   }
 
-  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
-  PortTfd = AhciReadReg (AhciController, (UINT32) Offset);
-  if ((PortTfd & EFI_AHCI_PORT_TFD_ERR) != 0) {
-    Status = EFI_DEVICE_ERROR;
-  }
+  AhciDmaTransferStop (AhciController, AhciRegisters, Port, MapData, AtaStatusBlock, Timeout);
+  return Status;
+}
 
-Exit:
-  //
-  // For Blocking mode, the command should be stopped, the Fis should be disabled
-  // and the AhciController should be unmapped.
-  // For non-blocking mode, only when a error is happened (if the return status is
-  // EFI_NOT_READY that means the command doesn't finished, try again.), first do the
-  // context cleanup, then set the packet's Asb status.
-  //
-  AhciStopCommand (
-    AhciController,
-    Port,
-    Timeout
-    );
+/**
+  Start a DMA data transfer on specific port
 
-  AhciDisableFisReceive (
-    AhciController,
-    Port,
-    Timeout
-    );
+  @param[in]       AhciController      The AHCI controller instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The timeout value of stop.
+  @param[in]       AtapiCommand        The atapi command will be used for the
+                                       transfer.
+  @param[in]       AtapiCommandLength  The length of the atapi command.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of non data transfer, uses 100ns as a unit.
 
-  if (MapData != NULL) {
-    IoMmuUnmap (MapData);
+  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_UNSUPPORTED     The device is not ready for transfer.
+  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransfer (
+  IN     EFI_AHCI_CONTROLLER        *AhciController,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     UINT8                      PortMultiplier,
+  IN     EFI_AHCI_ATAPI_COMMAND     *AtapiCommand OPTIONAL,
+  IN     UINT8                      AtapiCommandLength,
+  IN     BOOLEAN                    Read,
+  IN     EFI_ATA_COMMAND_BLOCK      *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN OUT VOID                       *MemoryAddr,
+  IN     UINT32                     DataCount,
+  IN     UINT64                     Timeout
+  )
+{
+  EFI_STATUS                    Status;
+  VOID                          *MapData;
+
+  Status = AhciDmaTransferStart (
+             AhciController,
+             AhciRegisters,
+             Port,
+             PortMultiplier,
+             AtapiCommand,
+             AtapiCommandLength,
+             Read,
+             AtaCommandBlock,
+             AtaStatusBlock,
+             MemoryAddr,
+             DataCount,
+             Timeout,
+             &MapData
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  AhciDumpPortStatus (AhciController, AhciRegisters, Port, AtaStatusBlock);
-  return Status;
+  return AhciDmaTransferFinish (AhciController, AhciRegisters, Port, MapData, AtaStatusBlock, Timeout);
 }
 
 /**
@@ -614,6 +614,91 @@ CreateNewDeviceInfo (
   );
 
 
+/**
+  Issue a DMA data transfer on specific port without waiting for it.
+
+  @param[in]       AhciController      The AHCI controller instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The timeout value of stop.
+  @param[in]       AtapiCommand        The atapi command will be used for the
+                                       transfer.
+  @param[in]       AtapiCommandLength  The length of the atapi command.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of command start, uses 100ns as a unit.
+  @param[out]      MapData             The mapping of the data buffer, to be passed
+                                       to AhciDmaTransferFinish ().
+
+  @retval EFI_OUT_OF_RESOURCES The data buffer could not be mapped.
+  @retval EFI_TIMEOUT          The operation is time out.
+  @retval EFI_SUCCESS          The DMA data transfer is running.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransferStart (
+  IN     EFI_AHCI_CONTROLLER        *AhciController,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     UINT8                      PortMultiplier,
+  IN     EFI_AHCI_ATAPI_COMMAND     *AtapiCommand OPTIONAL,
+  IN     UINT8                      AtapiCommandLength,
+  IN     BOOLEAN                    Read,
+  IN     EFI_ATA_COMMAND_BLOCK      *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN OUT VOID                       *MemoryAddr,
+  IN     UINT32                     DataCount,
+  IN     UINT64                     Timeout,
+  OUT    VOID                       **MapData
+  );
+
+/**
+  Check if the DMA data transfer issued by AhciDmaTransferStart () has completed.
+
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+
+  @retval EFI_NOT_READY       The DMA data transfer is still running.
+  @retval EFI_SUCCESS         The DMA data transfer has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransferCheck (
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port
+  );
+
+/**
+  Wait for the DMA data transfer issued by AhciDmaTransferStart () to complete.
+
+  @param[in]       AhciController      The AHCI controller instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       MapData             The mapping returned by AhciDmaTransferStart ().
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR    The DMA data transfer abort with error occurs.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_SUCCESS         The DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciDmaTransferFinish (
+  IN     EFI_AHCI_CONTROLLER        *AhciController,
+  IN     EFI_AHCI_REGISTERS         *AhciRegisters,
+  IN     UINT8                      Port,
+  IN     VOID                       *MapData,
+  IN OUT EFI_ATA_STATUS_BLOCK       *AtaStatusBlock,
+  IN     UINT64                     Timeout
+  );
+
 /**
   Start a DMA data transfer on specific port
 
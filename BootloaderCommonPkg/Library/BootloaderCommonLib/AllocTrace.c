@@ -0,0 +1,127 @@
+/** @file
+  Memory allocation trace shared by the memory allocation libraries.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi/UefiBaseType.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BootloaderCommonLib.h>
+
+/**
+  Initialize a memory allocation trace table.
+
+  @param[out] TraceInfo     The trace table.
+  @param[in]  EntryCount    The number of entries following the table header.
+
+**/
+VOID
+EFIAPI
+AllocTraceInit (
+  OUT ALLOC_TRACE_INFO     *TraceInfo,
+  IN  UINT32                EntryCount
+  )
+{
+  ZeroMem (TraceInfo, sizeof (ALLOC_TRACE_INFO));
+  TraceInfo->Signature  = ALLOC_TRACE_INFO_SIGNATURE;
+  TraceInfo->Revision   = 1;
+  TraceInfo->EntryCount = EntryCount;
+}
+
+/**
+  Record a memory allocation in a trace table.
+
+  The size is always counted in the histogram. The allocation is not
+  recorded if the table is full.
+
+  @param[in,out]  TraceInfo     The trace table.
+  @param[in]      Caller        Return address of the allocation call.
+  @param[in]      Buffer        The allocated buffer.
+  @param[in]      Size          The allocated size in bytes.
+  @param[in]      Type          ALLOC_TRACE_TYPE_* of the allocation.
+  @param[in]      Stage         LOADER_STAGE of the allocation.
+
+**/
+VOID
+EFIAPI
+AllocTraceAdd (
+  IN OUT ALLOC_TRACE_INFO  *TraceInfo,
+  IN     VOID              *Caller,
+  IN     VOID              *Buffer,
+  IN     UINTN              Size,
+  IN     UINT8              Type,
+  IN     UINT8              Stage
+  )
+{
+  ALLOC_TRACE_ENTRY  *Entry;
+  INTN                Bin;
+
+  if ((TraceInfo == NULL) || (Buffer == NULL)) {
+    return;
+  }
+
+  Bin = (Size == 0) ? 0 : HighBitSet32 ((UINT32)MIN (Size, MAX_UINT32)) - 4;
+  Bin = MAX (Bin, 0);
+  Bin = MIN (Bin, ALLOC_TRACE_HISTOGRAM_COUNT - 1);
+  TraceInfo->Histogram[Bin]++;
+
+  if (TraceInfo->LiveCount >= TraceInfo->EntryCount) {
+    TraceInfo->Dropped++;
+    return;
+  }
+
+  Entry = &TraceInfo->Entry[TraceInfo->LiveCount++];
+  Entry->Caller   = (UINT32)(UINTN)Caller;
+  Entry->Base     = (UINT32)(UINTN)Buffer;
+  Entry->Size     = (UINT32)Size;
+  Entry->Type     = Type;
+  Entry->Stage    = Stage;
+  Entry->Reserved = 0;
+
+  TraceInfo->LiveSize += (UINT32)Size;
+  if ((Stage < ALLOC_TRACE_STAGE_COUNT) && (TraceInfo->PeakSize[Stage] < TraceInfo->LiveSize)) {
+    TraceInfo->PeakSize[Stage] = TraceInfo->LiveSize;
+  }
+}
+
+/**
+  Remove freed memory allocations from a trace table.
+
+  @param[in,out]  TraceInfo     The trace table.
+  @param[in]      Type          ALLOC_TRACE_TYPE_* of the freed allocations.
+  @param[in]      Base          Base of the freed range.
+  @param[in]      Length        Length of the freed range, the allocations
+                                starting in this range are removed.
+
+**/
+VOID
+EFIAPI
+AllocTraceRemove (
+  IN OUT ALLOC_TRACE_INFO  *TraceInfo,
+  IN     UINT8              Type,
+  IN     VOID              *Base,
+  IN     UINTN              Length
+  )
+{
+  ALLOC_TRACE_ENTRY  *Entry;
+  UINT32              Index;
+  UINTN               Offset;
+
+  if (TraceInfo == NULL) {
+    return;
+  }
+
+  Index = 0;
+  while (Index < TraceInfo->LiveCount) {
+    Entry  = &TraceInfo->Entry[Index];
+    Offset = (UINTN)Entry->Base - (UINTN)Base;
+    if ((Entry->Type == Type) && (Entry->Base >= (UINTN)Base) && (Offset < Length)) {
+      TraceInfo->LiveSize -= Entry->Size;
+      CopyMem (Entry, &TraceInfo->Entry[--TraceInfo->LiveCount], sizeof (ALLOC_TRACE_ENTRY));
+    } else {
+      Index++;
+    }
+  }
+}
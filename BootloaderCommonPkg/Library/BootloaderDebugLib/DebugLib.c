@@ -77,10 +77,16 @@ DebugPrint (
   // Send the print string to debug output handler
   //
   if (PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_LOG_BUFFER) {
-    DebugLogBufferWrite  ((UINT8 *)Buffer, Length);
+    DebugLogBufferWriteLevel (ErrorLevel, (UINT8 *)Buffer, Length);
   }
 
   OutputToSerial = (PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_SERIAL_PORT) ? TRUE : FALSE;
+  if ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_LOG_BUFFER) &&
+      (PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED)) {
+    // Serial output is drained from the log buffer, only send what the UART takes now
+    DebugLogBufferFlush (FALSE);
+    OutputToSerial = FALSE;
+  }
   if (PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_CONSOLE) {
     ConsoleWrite ((UINT8 *)Buffer, Length);
 
@@ -10,6 +10,125 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/ConfigDataLib.h>
 #include <Library/BaseMemoryLib.h>
 
+#define CDATA_INDEX_SIGNATURE   SIGNATURE_32 ('C', 'I', 'D', 'X')
+
+//
+// The tag index is kept in the free space right after the used config data,
+// so that it moves along with the config database to the later stages.
+// It is valid only as long as the config database is not changed.
+//
+typedef struct {
+  UINT16  Tag;
+  UINT16  Offset;       // Header offset in DWORD from the start of data blob
+  UINT16  Target;       // Resolved header offset in DWORD of a reference, 0 if not found
+  UINT16  Reserved;
+} CDATA_INDEX_ENTRY;
+
+typedef struct {
+  UINT32             Signature;
+  UINT32             UsedLength;            // CDATA_BLOB.UsedLength the index is built for
+  UINT16             InternalDataOffset;    // CDATA_BLOB.InternalDataOffset the index is built for
+  UINT16             Count;
+  CDATA_INDEX_ENTRY  Entry[0];              // Sorted by tag, then by offset
+} CDATA_INDEX;
+
+/**
+  Get the tag index of the configuration data blob.
+
+  @param[in] CdataBlob   Configuration data blob.
+
+  @retval                Tag index pointer.
+                         NULL if there is no valid index.
+
+**/
+STATIC
+CDATA_INDEX *
+GetConfigDataIndex (
+  IN  CDATA_BLOB      *CdataBlob
+  )
+{
+  CDATA_INDEX         *Index;
+
+  if ((CdataBlob == NULL) || (CdataBlob->TotalLength < CdataBlob->UsedLength + sizeof (CDATA_INDEX))) {
+    return NULL;
+  }
+
+  Index = (CDATA_INDEX *) ((UINT8 *)CdataBlob + CdataBlob->UsedLength);
+  if ((Index->Signature != CDATA_INDEX_SIGNATURE) || (Index->UsedLength != CdataBlob->UsedLength) ||
+      (Index->InternalDataOffset != CdataBlob->ExtraInfo.InternalDataOffset)) {
+    return NULL;
+  }
+
+  return Index;
+}
+
+/**
+  Find configuration data header by its tag and platform ID using the tag index.
+
+  @param[in] CdataBlob   Configuration data blob.
+  @param[in] Index       Tag index of the blob.
+  @param[in] PidMask     Platform ID mask.
+  @param[in] Tag         Configuration TAG ID to find.
+  @param[in] Start       Offset of the first header to search.
+  @param[in] Level       Nested call level.
+
+  @retval             Configuration data header pointer.
+                      NULL if the tag cannot be found.
+
+**/
+STATIC
+CDATA_HEADER *
+FindConfigHdrInIndex (
+  IN  CDATA_BLOB      *CdataBlob,
+  IN  CDATA_INDEX     *Index,
+  IN  UINT32           PidMask,
+  IN  UINT32           Tag,
+  IN  UINT32           Start,
+  IN  UINT32           Level
+  )
+{
+  CDATA_INDEX_ENTRY   *Entry;
+  CDATA_HEADER        *CdataHdr;
+  UINT32               Low;
+  UINT32               High;
+  UINT32               Mid;
+  UINT8                Idx;
+
+  Low  = 0;
+  High = Index->Count;
+  while (Low < High) {
+    Mid = (Low + High) >> 1;
+    if (Index->Entry[Mid].Tag < Tag) {
+      Low  = Mid + 1;
+    } else {
+      High = Mid;
+    }
+  }
+
+  for (; (Low < Index->Count) && (Index->Entry[Low].Tag == Tag); Low++) {
+    Entry = &Index->Entry[Low];
+    if ((Entry->Offset << 2) < Start) {
+      continue;
+    }
+    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + (Entry->Offset << 2));
+    for (Idx = 0; Idx < CdataHdr->ConditionNum; Idx++) {
+      if ((PidMask & CdataHdr->Condition[Idx].Value) != 0) {
+        // Found a match
+        if ((CdataHdr->Flags & CDATA_FLAG_TYPE_MASK) == CDATA_FLAG_TYPE_REFER) {
+          // Prevent multiple level nesting
+          if ((Level > 0) || (Entry->Target == 0)) {
+            return NULL;
+          }
+          return (CDATA_HEADER *) ((UINT8 *)CdataBlob + (Entry->Target << 2));
+        }
+        return CdataHdr;
+      }
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Find configuration data header by its tag and platform ID.
 
@@ -35,10 +154,16 @@ FindConfigHdrByPidMaskTag (
   UINT8                Idx;
   REFERENCE_CFG_DATA  *Refer;
   UINT32               Offset;
+  CDATA_INDEX         *Index;
 
   CdataBlob = (CDATA_BLOB *) GetConfigDataPtr ();
   Offset    = IsInternal > 0 ? (CdataBlob->ExtraInfo.InternalDataOffset * 4) : CdataBlob->HeaderLength;
 
+  Index = GetConfigDataIndex (CdataBlob);
+  if (Index != NULL) {
+    return FindConfigHdrInIndex (CdataBlob, Index, PidMask, Tag, Offset, Level);
+  }
+
   while (Offset < CdataBlob->UsedLength) {
     CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
     if (CdataHdr->Tag == Tag) {
@@ -169,6 +294,7 @@ AddConfigData (
   CDATA_BLOB               *LdrCfgBlob;
   CDATA_BLOB               *CfgAddBlob;
   INT32                    CfgAddSize;
+  CDATA_INDEX              *Index;
 
   LdrCfgBlob = (CDATA_BLOB *) GetConfigDataPtr ();
   CfgAddBlob = (CDATA_BLOB *) CfgAddPtr;
@@ -183,6 +309,11 @@ AddConfigData (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Index = GetConfigDataIndex (LdrCfgBlob);
+  if (Index != NULL) {
+    Index->Signature = 0;
+  }
+
   if (LdrCfgBlob->ExtraInfo.InternalDataOffset == 0) {
     // Append new config data before internal config data is available.
     CopyMem ((UINT8 *)LdrCfgBlob + LdrCfgBlob->UsedLength,
@@ -205,6 +336,106 @@ AddConfigData (
   }
   LdrCfgBlob->UsedLength += CfgAddSize;
 
+  if (Index != NULL) {
+    BuildConfigDataIndex ();
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the tag index of the config database.
+
+  The index is stored in the free space of the config database right after
+  the used config data, and carried along with the database to the later
+  stages. Tag lookups use a binary search of the index instead of walking
+  the whole database, and the reference entries are resolved up front.
+  The lookups fall back to the database walk if there is no space for the
+  index, or if the database is changed afterwards.
+
+  @retval EFI_SUCCESS               The index was built successfully.
+  @retval EFI_NOT_FOUND             The config database is not available.
+  @retval EFI_BUFFER_TOO_SMALL      Not enough free space for the index.
+  @retval EFI_UNSUPPORTED           The config database is too large to index.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigDataIndex (
+  VOID
+  )
+{
+  CDATA_BLOB          *CdataBlob;
+  CDATA_HEADER        *CdataHdr;
+  CDATA_HEADER        *Target;
+  CDATA_INDEX         *Index;
+  CDATA_INDEX_ENTRY   *Entry;
+  REFERENCE_CFG_DATA  *Refer;
+  UINT32               Offset;
+  UINT32               Count;
+  UINT32               Pos;
+
+  CdataBlob = (CDATA_BLOB *) GetConfigDataPtr ();
+  if ((CdataBlob == NULL) || (CdataBlob->Signature != CFG_DATA_SIGNATURE)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (CdataBlob->UsedLength > (MAX_UINT16 << 2)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (CdataBlob->TotalLength < CdataBlob->UsedLength + sizeof (CDATA_INDEX)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  //
+  // Insert the headers sorted by tag. Headers of the same tag stay in the
+  // database order, which is their priority order.
+  //
+  Index  = (CDATA_INDEX *) ((UINT8 *)CdataBlob + CdataBlob->UsedLength);
+  Index->Signature = 0;
+  Count  = 0;
+  Offset = CdataBlob->HeaderLength;
+  while (Offset < CdataBlob->UsedLength) {
+    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + Offset);
+    if (CdataHdr->Length == 0) {
+      return EFI_UNSUPPORTED;
+    }
+    if (CdataBlob->UsedLength + sizeof (CDATA_INDEX) + (Count + 1) * sizeof (CDATA_INDEX_ENTRY) > CdataBlob->TotalLength) {
+      return EFI_BUFFER_TOO_SMALL;
+    }
+    for (Pos = Count; (Pos > 0) && (Index->Entry[Pos - 1].Tag > CdataHdr->Tag); Pos--) {
+      CopyMem (&Index->Entry[Pos], &Index->Entry[Pos - 1], sizeof (CDATA_INDEX_ENTRY));
+    }
+    Entry = &Index->Entry[Pos];
+    Entry->Tag      = (UINT16)CdataHdr->Tag;
+    Entry->Offset   = (UINT16)(Offset >> 2);
+    Entry->Target   = 0;
+    Entry->Reserved = 0;
+    Count++;
+    Offset += (CdataHdr->Length << 2);
+  }
+
+  Index->Count              = (UINT16)Count;
+  Index->UsedLength         = CdataBlob->UsedLength;
+  Index->InternalDataOffset = CdataBlob->ExtraInfo.InternalDataOffset;
+  Index->Signature          = CDATA_INDEX_SIGNATURE;
+
+  // Resolve the reference entries
+  for (Pos = 0; Pos < Count; Pos++) {
+    Entry    = &Index->Entry[Pos];
+    CdataHdr = (CDATA_HEADER *) ((UINT8 *)CdataBlob + (Entry->Offset << 2));
+    if ((CdataHdr->Flags & CDATA_FLAG_TYPE_MASK) == CDATA_FLAG_TYPE_REFER) {
+      Refer  = (REFERENCE_CFG_DATA *) ((UINT8 *)CdataHdr + sizeof (CDATA_HEADER) + sizeof (
+                                         CDATA_COND) * CdataHdr->ConditionNum);
+      Offset = (Refer->IsInternal > 0) ? (CdataBlob->ExtraInfo.InternalDataOffset * 4) : CdataBlob->HeaderLength;
+      Target = FindConfigHdrInIndex (CdataBlob, Index, PID_TO_MASK (Refer->PlatformId), Refer->Tag, Offset, 1);
+      if (Target != NULL) {
+        Entry->Target = (UINT16)(((UINT8 *)Target - (UINT8 *)CdataBlob) >> 2);
+      }
+    }
+  }
+
   return EFI_SUCCESS;
 }
 
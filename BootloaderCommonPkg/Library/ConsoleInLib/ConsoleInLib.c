@@ -11,6 +11,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/SerialPortLib.h>
 #include <Library/ConsoleInLib.h>
 #include <Library/DebugPortLib.h>
+#include <Library/DebugLogBufferLib.h>
 
 /**
   Poll a console to see if there is any data waiting to be read.
@@ -25,6 +26,8 @@ ConsolePoll (
   VOID
   )
 {
+  // Console polling is idle time, drain the deferred serial output
+  DebugLogBufferFlush (FALSE);
 
   if (FeaturePcdGet (PcdSourceDebugEnabled) != TRUE) {
     if ((PcdGet32 (PcdConsoleInDeviceMask) & ConsoleInSerialPort) != 0) {
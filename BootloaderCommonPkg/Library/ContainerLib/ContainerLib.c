@@ -17,12 +17,52 @@
 #include <Library/CryptoLib.h>
 #include <Library/SecureBootLib.h>
 #include <Library/DecompressLib.h>
+#include <Library/MpTaskLib.h>
 
 #define  TEMP_BUF_ALIGN    0x10
 #define  AUTH_DATA_ALIGN   0x04
+#define  HASH_CHUNK_SIZE   SIZE_32KB
+#define  MAX_BLOCK_JOBS    4
 
 #define  IS_FLASH_ADDRESS(x)   (((UINT32)(UINTN)(x)) >= 0xF0000000)
 
+typedef struct _COMPONENT_LOAD_CONTEXT  COMPONENT_LOAD_CONTEXT;
+
+typedef struct {
+  MP_TASK_JOB               Job;
+  COMPONENT_LOAD_CONTEXT   *Ctx;
+  UINT32                    Index;
+  EFI_STATUS                Status;
+} COMPONENT_BLOCK_JOB;
+
+struct _COMPONENT_LOAD_CONTEXT {
+  UINT8                    *CompData;
+  UINT8                    *CompBuf;
+  UINT8                    *HashData;
+  UINT8                    *AuthData;
+  VOID                     *AllocBuf;
+  VOID                     *ScrBuf;
+  VOID                     *ReqCompBase;
+  VOID                     *CompBase;
+  UINT32                    ComponentId;
+  UINT32                    Usage;
+  UINT32                    SignedDataLen;
+  UINT32                    DecompressedLen;
+  UINT32                    ScrLen;
+  UINT32                    BlockCount;
+  UINT32                    BlockJobCount;
+  UINT8                     AuthType;
+  UINT8                     HashAlg;
+  BOOLEAN                   IsInFlash;
+  BOOLEAN                   IsDecompressed;
+  EFI_STATUS                Status;
+  EFI_STATUS                DecompressStatus;
+  UINT8                     Digest[HASH_DIGEST_MAX];
+  UINT8                     CompressHdr[sizeof (LOADER_COMPRESSED_HEADER)];
+  MP_TASK_JOB               Job;
+  COMPONENT_BLOCK_JOB       BlockJob[MAX_BLOCK_JOBS];
+};
+
 /**
   Get the container pointer by the container signature
 
@@ -320,6 +360,573 @@ AuthenticateComponent (
   return Status;
 }
 
+/**
+  Get the hash algorithm to authenticate a component from its digest.
+
+  @param[in]  AuthType     Authentication type.
+  @param[in]  AuthData     Authentication data buffer.
+  @param[out] HashAlg      Hash algorithm to calculate the digest.
+
+  @retval EFI_UNSUPPORTED          AuthType cannot be verified from a digest.
+  @retval EFI_SUCCESS              HashAlg is returned.
+
+**/
+STATIC
+EFI_STATUS
+GetComponentHashAlg (
+  IN  UINT8     AuthType,
+  IN  UINT8    *AuthData,
+  OUT UINT8    *HashAlg
+  )
+{
+  if (!FeaturePcdGet (PcdVerifiedBootEnabled)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((AuthType == AUTH_TYPE_SHA2_256) || (AuthType == AUTH_TYPE_SHA2_384)) {
+    *HashAlg = GetHashAlg (AuthType);
+  } else if ((AuthType == AUTH_TYPE_SIG_RSA2048_PKCSI1_SHA256) || (AuthType == AUTH_TYPE_SIG_RSA3072_PKCSI1_SHA384)) {
+    *HashAlg = ((SIGNATURE_HDR *)AuthData)->HashAlg;
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Hash a component, copying it into memory first if required.
+
+  When Dst differs from Src, each chunk is hashed right after it has been copied
+  while it is still in the cache. Only the in-memory copy is hashed, so the result
+  is the same as copying the whole component first and hashing it afterwards.
+
+  @param[in]  Dst          Memory buffer to receive the component.
+  @param[in]  Src          Component data source.
+  @param[in]  Length       Data length to be copied and hashed.
+  @param[in]  AuthType     Authentication type.
+  @param[in]  AuthData     Authentication data buffer.
+  @param[out] HashAlg      Hash algorithm used to calculate the digest.
+  @param[out] Digest       Buffer to receive the digest.
+
+  @retval EFI_UNSUPPORTED          AuthType cannot be verified from a digest.
+  @retval EFI_SECURITY_VIOLATION   Hash calculation failed.
+  @retval EFI_SUCCESS              Digest was calculated.
+
+**/
+STATIC
+EFI_STATUS
+HashComponent (
+  IN  UINT8    *Dst,
+  IN  UINT8    *Src,
+  IN  UINT32    Length,
+  IN  UINT8     AuthType,
+  IN  UINT8    *AuthData,
+  OUT UINT8    *HashAlg,
+  OUT UINT8    *Digest
+  )
+{
+  EFI_STATUS                Status;
+  HASH_CTX                  HashCtx;
+  UINT32                    Offset;
+  UINT32                    ChunkLen;
+
+  if (EFI_ERROR (GetComponentHashAlg (AuthType, AuthData, HashAlg))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (EFI_ERROR (HashInit (&HashCtx, *HashAlg))) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Offset = 0; Offset < Length; Offset += ChunkLen) {
+    ChunkLen = MIN (Length - Offset, HASH_CHUNK_SIZE);
+    if (Dst != Src) {
+      CopyMem (Dst + Offset, Src + Offset, ChunkLen);
+    }
+    Status = HashUpdate (&HashCtx, *HashAlg, Dst + Offset, ChunkLen);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = HashFinal (&HashCtx, *HashAlg, Digest);
+  }
+
+  return EFI_ERROR (Status) ? EFI_SECURITY_VIOLATION : EFI_SUCCESS;
+}
+
+/**
+  Authenticate a component using a digest calculated by HashComponent ().
+
+  @param[in] Digest       Digest of the component data.
+  @param[in] HashAlg      Hash algorithm used to calculate the digest.
+  @param[in] AuthType     Authentication type.
+  @param[in] AuthData     Authentication data buffer.
+  @param[in] HashData     Hash data buffer.
+  @param[in] Usage        Hash usage.
+
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              Authentication succeeded.
+
+**/
+STATIC
+EFI_STATUS
+VerifyComponentDigest (
+  IN  UINT8    *Digest,
+  IN  UINT8     HashAlg,
+  IN  UINT8     AuthType,
+  IN  UINT8    *AuthData,
+  IN  UINT8    *HashData,
+  IN  UINT32    Usage
+  )
+{
+  EFI_STATUS                Status;
+  SIGNATURE_HDR            *SignHdr;
+  UINT8                    *KeyPtr;
+
+  if ((AuthType == AUTH_TYPE_SHA2_256) || (AuthType == AUTH_TYPE_SHA2_384)) {
+    Status = DoDigestVerify (Digest, Usage, HashAlg, HashData);
+    DEBUG ((DEBUG_INFO, "HASH verification for usage (0x%08X) with Hash Alg (0x%x): %r\n", Usage, HashAlg, Status));
+  } else {
+    SignHdr = (SIGNATURE_HDR *)AuthData;
+    KeyPtr  = (UINT8 *)SignHdr + sizeof(SIGNATURE_HDR) + SignHdr->SigSize;
+    Status  = DoRsaVerifyDigest (Digest, Usage, SignHdr, (PUB_KEY_HDR *)KeyPtr,
+                                 GetHashAlg (AuthType), HashData);
+  }
+
+  return Status;
+}
+
+/**
+  Decompress a component into the destination buffer.
+
+  This function can run on an application processor, so it must not allocate
+  memory or print debug messages.
+
+  @param[in]  Argument    Pointer to COMPONENT_LOAD_CONTEXT.
+
+  @retval     Always 0.
+
+**/
+STATIC
+UINT64
+EFIAPI
+DecompressComponentTask (
+  IN  UINT64    Argument
+  )
+{
+  COMPONENT_LOAD_CONTEXT   *Ctx;
+  LOADER_COMPRESSED_HEADER *CompressHdr;
+
+  Ctx = (COMPONENT_LOAD_CONTEXT *)(UINTN)Argument;
+  CompressHdr = (LOADER_COMPRESSED_HEADER *)Ctx->CompBuf;
+  Ctx->DecompressStatus = Decompress (CompressHdr->Signature, CompressHdr->Data, CompressHdr->CompressedSize,
+                                      Ctx->CompBase, Ctx->ScrBuf);
+
+  return 0;
+}
+
+/**
+  Decompress every BlockJobCount-th block of a component, starting from the
+  job index, using the scratch buffer of the job.
+
+  This function can run on an application processor, so it must not allocate
+  memory or print debug messages.
+
+  @param[in]  Argument    Pointer to COMPONENT_BLOCK_JOB.
+
+  @retval     Always 0.
+
+**/
+STATIC
+UINT64
+EFIAPI
+DecompressBlockTask (
+  IN  UINT64    Argument
+  )
+{
+  COMPONENT_BLOCK_JOB      *BlockJob;
+  COMPONENT_LOAD_CONTEXT   *Ctx;
+  LOADER_COMPRESSED_HEADER *CompressHdr;
+  UINT8                    *Scratch;
+  UINT32                    Block;
+  EFI_STATUS                Status;
+
+  BlockJob    = (COMPONENT_BLOCK_JOB *)(UINTN)Argument;
+  Ctx         = BlockJob->Ctx;
+  CompressHdr = (LOADER_COMPRESSED_HEADER *)Ctx->CompBuf;
+  Scratch     = (UINT8 *)Ctx->ScrBuf + BlockJob->Index * Ctx->ScrLen;
+
+  Status = EFI_SUCCESS;
+  for (Block = BlockJob->Index; (Block < Ctx->BlockCount) && !EFI_ERROR (Status); Block += Ctx->BlockJobCount) {
+    Status = DecompressBlock (CompressHdr->Signature, CompressHdr->Data, CompressHdr->CompressedSize,
+                              Block, Ctx->CompBase, Scratch);
+  }
+  BlockJob->Status = Status;
+
+  return 0;
+}
+
+/**
+  Check the copied component header before decompressing it.
+
+  The copy may differ from the data the buffers were allocated for, so make
+  sure it still fits into them.
+
+  @param[in,out]  Ctx      Component load context.
+
+  @retval EFI_SECURITY_VIOLATION   The header changed after it was located.
+  @retval EFI_BAD_BUFFER_SIZE      The data does not fit into the buffers.
+  @retval EFI_SUCCESS              The component can be decompressed.
+
+**/
+STATIC
+EFI_STATUS
+CheckDecompressInfo (
+  IN OUT COMPONENT_LOAD_CONTEXT   *Ctx
+  )
+{
+  EFI_STATUS                Status;
+  LOADER_COMPRESSED_HEADER *CompressHdr;
+  UINT32                    DstLen;
+  UINT32                    ScrLen;
+
+  CompressHdr = (LOADER_COMPRESSED_HEADER *)Ctx->CompBuf;
+  if (CompareMem (CompressHdr, Ctx->CompressHdr, sizeof (LOADER_COMPRESSED_HEADER)) != 0) {
+    return EFI_SECURITY_VIOLATION;
+  }
+
+  Ctx->BlockCount = 1;
+  if (CompressHdr->Size == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = DecompressGetInfo (CompressHdr->Signature, CompressHdr->Data,
+                              CompressHdr->CompressedSize, &DstLen, &ScrLen);
+  if (!EFI_ERROR (Status) && ((DstLen > Ctx->DecompressedLen) || (ScrLen > Ctx->ScrLen))) {
+    Status = EFI_BAD_BUFFER_SIZE;
+  }
+  if (!EFI_ERROR (Status)) {
+    Status = DecompressGetBlockCount (CompressHdr->Signature, CompressHdr->Data,
+                                      CompressHdr->CompressedSize, &Ctx->BlockCount);
+  }
+
+  return Status;
+}
+
+/**
+  Start decompressing a copied component.
+
+  @param[in,out]  Ctx        Component load context.
+  @param[in]      Parallel   Submit the decompression as jobs instead of
+                             running it on the calling processor.
+
+**/
+STATIC
+VOID
+StartDecompress (
+  IN OUT COMPONENT_LOAD_CONTEXT   *Ctx,
+  IN     BOOLEAN                   Parallel
+  )
+{
+  UINT32                    Index;
+
+  Ctx->IsDecompressed   = TRUE;
+  Ctx->DecompressStatus = CheckDecompressInfo (Ctx);
+  if (EFI_ERROR (Ctx->DecompressStatus)) {
+    return;
+  }
+
+  if (!Parallel) {
+    DecompressComponentTask ((UINT64)(UINTN)Ctx);
+    return;
+  }
+
+  // Spread the blocks over the scratch buffers allocated for this component
+  Ctx->BlockJobCount = MIN (Ctx->BlockJobCount, Ctx->BlockCount);
+  if (Ctx->BlockJobCount <= 1) {
+    MpTaskSubmit (&Ctx->Job, DecompressComponentTask, (UINT64)(UINTN)Ctx);
+    return;
+  }
+
+  for (Index = 0; Index < Ctx->BlockJobCount; Index++) {
+    Ctx->BlockJob[Index].Ctx   = Ctx;
+    Ctx->BlockJob[Index].Index = Index;
+    MpTaskSubmit (&Ctx->BlockJob[Index].Job, DecompressBlockTask, (UINT64)(UINTN)&Ctx->BlockJob[Index]);
+  }
+}
+
+/**
+  Check if a component should be decompressed while its signature is verified.
+
+  Only signed components are decompressed speculatively, since a digest check
+  is too cheap to overlap with. The copy must have been hashed already, and
+  CheckDecompressInfo () keeps the decompression inside the allocated buffers.
+
+  @param[in]  Ctx        Component load context.
+
+  @retval TRUE           Decompress the component before it is authenticated.
+  @retval FALSE          Decompress the component after it is authenticated.
+
+**/
+STATIC
+BOOLEAN
+IsSpeculativeDecompress (
+  IN COMPONENT_LOAD_CONTEXT   *Ctx
+  )
+{
+  if (!FeaturePcdGet (PcdSpeculativeDecompressEnabled) || (MpTaskGetWorkerCount () == 0)) {
+    return FALSE;
+  }
+
+  return (Ctx->Status == EFI_SUCCESS) && (Ctx->AuthType >= AUTH_TYPE_SIG_RSA2048_PKCSI1_SHA256);
+}
+
+/**
+  Copy a component into memory and hash it in one pass.
+
+  This function can run on an application processor, so it must not allocate
+  memory or print debug messages.
+
+  @param[in]  Argument    Pointer to COMPONENT_LOAD_CONTEXT.
+
+  @retval     Always 0.
+
+**/
+STATIC
+UINT64
+EFIAPI
+CopyComponentTask (
+  IN  UINT64    Argument
+  )
+{
+  COMPONENT_LOAD_CONTEXT   *Ctx;
+
+  Ctx = (COMPONENT_LOAD_CONTEXT *)(UINTN)Argument;
+  Ctx->Status = HashComponent (Ctx->CompBuf, Ctx->CompData, Ctx->SignedDataLen, Ctx->AuthType,
+                               Ctx->AuthData, &Ctx->HashAlg, Ctx->Digest);
+  if (Ctx->Status == EFI_UNSUPPORTED) {
+    // The whole message is needed for authentication, so only copy it
+    if (Ctx->IsInFlash) {
+      CopyMem (Ctx->CompBuf, Ctx->CompData, Ctx->SignedDataLen);
+    }
+  }
+
+  return 0;
+}
+
+/**
+  Copy components into memory and hash them in batches.
+
+  It is used when no processor is available to copy and hash the components
+  in parallel. The components with the same hash algorithm are hashed in one
+  CalculateHashBatch () call, so that a multi-buffer hash implementation can
+  process several of them at once.
+
+  @param[in,out]  Ctx        Array of component load contexts.
+  @param[in]      Requests   Array of component load requests.
+  @param[in]      Count      Number of requests.
+
+**/
+STATIC
+VOID
+HashComponentsBatch (
+  IN OUT COMPONENT_LOAD_CONTEXT   *Ctx,
+  IN     LOAD_COMPONENT_REQUEST   *Requests,
+  IN     UINT32                    Count
+  )
+{
+  EFI_STATUS                Status;
+  CONST UINT8             **Data;
+  UINT8                   **Digest;
+  UINT32                   *Length;
+  UINT32                   *Member;
+  UINT32                    Index;
+  UINT32                    First;
+  UINT32                    Batch;
+  UINT8                     HashAlg;
+
+  Data = AllocatePool (Count * (sizeof (UINT8 *) * 2 + sizeof (UINT32) * 2));
+  if (Data == NULL) {
+    for (Index = 0; Index < Count; Index++) {
+      if (!EFI_ERROR (Requests[Index].Status)) {
+        CopyComponentTask ((UINT64)(UINTN)&Ctx[Index]);
+      }
+    }
+    return;
+  }
+  Digest = (UINT8 **)(Data + Count);
+  Length = (UINT32 *)(Digest + Count);
+  Member = Length + Count;
+
+  // Copy the components, EFI_NOT_READY marks the ones still to be hashed
+  for (Index = 0; Index < Count; Index++) {
+    if (EFI_ERROR (Requests[Index].Status)) {
+      continue;
+    }
+    if (Ctx[Index].IsInFlash) {
+      CopyMem (Ctx[Index].CompBuf, Ctx[Index].CompData, Ctx[Index].SignedDataLen);
+    }
+    Ctx[Index].Status = GetComponentHashAlg (Ctx[Index].AuthType, Ctx[Index].AuthData, &Ctx[Index].HashAlg);
+    if (!EFI_ERROR (Ctx[Index].Status)) {
+      Ctx[Index].Status = EFI_NOT_READY;
+    }
+  }
+
+  for (First = 0; First < Count; First++) {
+    if (EFI_ERROR (Requests[First].Status) || (Ctx[First].Status != EFI_NOT_READY)) {
+      continue;
+    }
+
+    HashAlg = Ctx[First].HashAlg;
+    Batch   = 0;
+    for (Index = First; Index < Count; Index++) {
+      if (!EFI_ERROR (Requests[Index].Status) && (Ctx[Index].Status == EFI_NOT_READY) && (Ctx[Index].HashAlg == HashAlg)) {
+        Data[Batch]   = Ctx[Index].CompBuf;
+        Length[Batch] = Ctx[Index].SignedDataLen;
+        Digest[Batch] = Ctx[Index].Digest;
+        Member[Batch] = Index;
+        Batch++;
+      }
+    }
+
+    Status = CalculateHashBatch (Data, Length, Batch, HashAlg, Digest);
+    if (Status == RETURN_UNSUPPORTED) {
+      // Let the authentication report the unsupported algorithm
+      Status = EFI_UNSUPPORTED;
+    } else if (EFI_ERROR (Status)) {
+      Status = EFI_SECURITY_VIOLATION;
+    }
+    for (Index = 0; Index < Batch; Index++) {
+      Ctx[Member[Index]].Status = Status;
+    }
+  }
+
+  FreePool (Data);
+}
+
+/**
+  Authenticate a component copied by CopyComponentTask ().
+
+  @param[in,out]  Ctx                    Component load context.
+  @param[in]      LoadComponentCallback  Callback function pointer.
+
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              Authentication succeeded.
+
+**/
+STATIC
+EFI_STATUS
+AuthenticateLoadedComponent (
+  IN OUT COMPONENT_LOAD_CONTEXT   *Ctx,
+  IN     LOAD_COMPONENT_CALLBACK   LoadComponentCallback
+  )
+{
+  EFI_STATUS                Status;
+  COMPONENT_CALLBACK_INFO   CbInfo;
+
+  if (Ctx->IsInFlash && (LoadComponentCallback != NULL)) {
+    LoadComponentCallback (PROGESS_ID_COPY, NULL);
+  }
+
+  Status = Ctx->Status;
+  if (Status == EFI_UNSUPPORTED) {
+    Status = AuthenticateComponent (Ctx->CompBuf, Ctx->SignedDataLen, Ctx->AuthType,
+                                    Ctx->AuthData, Ctx->HashData, Ctx->Usage);
+  } else if (!EFI_ERROR (Status)) {
+    Status = VerifyComponentDigest (Ctx->Digest, Ctx->HashAlg, Ctx->AuthType,
+                                    Ctx->AuthData, Ctx->HashData, Ctx->Usage);
+  }
+
+  if (LoadComponentCallback != NULL) {
+    if(Status == EFI_SUCCESS){
+      // Update component Call back info after authenticaton is done
+      // This info will used by firmware stage to extend to TPM
+      CbInfo.ComponentType    = Ctx->ComponentId;
+      CbInfo.CompBuf          = Ctx->CompBuf;
+      CbInfo.CompLen          = Ctx->SignedDataLen;
+      CbInfo.HashAlg          = GetHashAlg(Ctx->AuthType);
+      CbInfo.HashData         = Ctx->HashData;
+      LoadComponentCallback (PROGESS_ID_AUTHENTICATE, &CbInfo);
+    } else {
+      LoadComponentCallback (PROGESS_ID_AUTHENTICATE, NULL);
+    }
+  }
+
+  Ctx->Status = EFI_ERROR (Status) ? EFI_SECURITY_VIOLATION : EFI_SUCCESS;
+  return Ctx->Status;
+}
+
+/**
+  Complete a component load and release the buffers on failure.
+
+  All the decompression jobs of the component must have completed. The
+  destination is zeroed on failure, so that nothing decompressed from data
+  that failed authentication is left behind. The temporary memory in the
+  context is not freed by this function.
+
+  @param[in,out]  Ctx                    Component load context.
+  @param[in]      LoadComponentCallback  Callback function pointer.
+  @param[out]     Buffer                 Pointer to receive component base.
+  @param[out]     Length                 Pointer to receive component size.
+
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              The component was loaded.
+  @retval Others                   Decompression failed.
+
+**/
+STATIC
+EFI_STATUS
+FinishComponentLoad (
+  IN OUT COMPONENT_LOAD_CONTEXT   *Ctx,
+  IN     LOAD_COMPONENT_CALLBACK   LoadComponentCallback,
+  OUT    VOID                    **Buffer,
+  OUT    UINT32                   *Length
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    Index;
+
+  if (Ctx->BlockJobCount > 1) {
+    for (Index = 0; Index < Ctx->BlockJobCount; Index++) {
+      if (EFI_ERROR (Ctx->BlockJob[Index].Status) && !EFI_ERROR (Ctx->DecompressStatus)) {
+        Ctx->DecompressStatus = Ctx->BlockJob[Index].Status;
+      }
+    }
+  }
+
+  Status = Ctx->Status;
+  if (!EFI_ERROR (Status)) {
+    Status = Ctx->DecompressStatus;
+    if (LoadComponentCallback != NULL) {
+      LoadComponentCallback (PROGESS_ID_DECOMPRESS, NULL);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    // Never leave unverified or partially decompressed content behind
+    if (Ctx->IsDecompressed) {
+      ZeroMem (Ctx->CompBase, Ctx->DecompressedLen);
+    }
+    if (Ctx->ReqCompBase == NULL) {
+      FreePages (Ctx->CompBase, EFI_SIZE_TO_PAGES ((UINTN) Ctx->DecompressedLen));
+    }
+    return Status;
+  }
+
+  if (Buffer != NULL) {
+    *Buffer = Ctx->CompBase;
+  }
+  if (Length != NULL) {
+    *Length = Ctx->DecompressedLen;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Return Containser Key Type based on its signature
 
@@ -686,30 +1293,34 @@ LocateComponent (
 }
 
 /**
-  Load a component from a container or flahs map to memory and call callback
-  function at predefined point.
+  Locate a component and allocate the buffers required to load it.
 
-  @param[in]     ContainerSig    Container signature or component type.
-  @param[in]     ComponentName   Component name.
-  @param[in,out] Buffer          Pointer to receive component base.
-  @param[in,out] Length          Pointer to receive component size.
-  @param[in,out] LoadComponentCallback  Callback function pointer.
+  @param[in]  ContainerSig           Container signature or component type.
+  @param[in]  ComponentName          Component name.
+  @param[in]  ReqCompBase            Caller provided destination buffer, or NULL.
+  @param[in]  ReqLength              Caller provided destination buffer size, or 0.
+  @param[in]  LoadComponentCallback  Callback function pointer.
+  @param[in]  MaxJobs                Maximum number of jobs to decompress the component.
+  @param[out] Ctx                    Component load context to initialize.
 
-  @retval EFI_UNSUPPORTED          Unsupported AuthType.
+  @retval EFI_UNSUPPORTED          Unsupported AuthType or compression.
   @retval EFI_NOT_FOUND            Cannot locate component.
   @retval EFI_BUFFER_TOO_SMALL     Specified buffer size is too small.
-  @retval EFI_SECURITY_VIOLATION   Authentication failed.
-  @retval EFI_SUCCESS              Authentication succeeded.
+  @retval EFI_BAD_BUFFER_SIZE      Decompressed size is 0.
+  @retval EFI_OUT_OF_RESOURCES     Cannot allocate the buffers.
+  @retval EFI_SUCCESS              The component is ready to be copied.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-LoadComponentWithCallback (
-  IN     UINT32                   ContainerSig,
-  IN     UINT32                   ComponentName,
-  IN OUT VOID                   **Buffer,
-  IN OUT UINT32                  *Length,
-  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
+PrepareComponentLoad (
+  IN  UINT32                    ContainerSig,
+  IN  UINT32                    ComponentName,
+  IN  VOID                     *ReqCompBase,
+  IN  UINT32                    ReqLength,
+  IN  LOAD_COMPONENT_CALLBACK   LoadComponentCallback,
+  IN  UINT32                    MaxJobs,
+  OUT COMPONENT_LOAD_CONTEXT   *Ctx
   )
 {
   EFI_STATUS                Status;
@@ -717,29 +1328,18 @@ LoadComponentWithCallback (
   CONTAINER_HDR            *ContainerHdr;
   CONTAINER_ENTRY          *ContainerEntry;
   COMPONENT_ENTRY          *CompEntry;
-  UINT8                    *CompData;
-  UINT8                    *CompBuf;
-  UINT8                    *HashData;
-  VOID                     *CompBase;
-  VOID                     *ScrBuf;
-  VOID                     *AllocBuf;
-  VOID                     *ReqCompBase;
-  UINT32                    Usage;
-  UINT8                     AuthType;
-  UINT32                    DecompressedLen;
   UINT32                    CompLen;
   UINT32                    CompLoc;
   UINT32                    AllocLen;
-  UINT32                    SignedDataLen;
   UINT32                    DstLen;
   UINT32                    ScrLen;
-  BOOLEAN                   IsInFlash;
-  COMPONENT_CALLBACK_INFO   CbInfo;
-  UINT32                    ComponentId;
+  UINT32                    BlockCount;
   UINT64                    ContainerIdBuf;
   UINT64                    ComponentIdBuf;
 
-  ComponentId = ContainerSig;
+  ZeroMem (Ctx, sizeof (COMPONENT_LOAD_CONTEXT));
+  Ctx->ComponentId      = ContainerSig;
+  Ctx->DecompressStatus = EFI_SUCCESS;
   CompLoc = 0;
 
   ComponentIdBuf = ComponentName;
@@ -752,25 +1352,25 @@ LoadComponentWithCallback (
 
   if (ContainerSig < COMP_TYPE_INVALID) {
     // Check if it is component type
-    Usage        =  1 << ContainerSig;
+    Ctx->Usage   =  1 << ContainerSig;
     ContainerSig = 0;
     Status = GetComponentInfo (ComponentName, &CompLoc, &CompLen);
     if (EFI_ERROR (Status)) {
       return EFI_NOT_FOUND;
     }
-    CompData = (VOID *)(UINTN)CompLoc;
+    Ctx->CompData = (VOID *)(UINTN)CompLoc;
     if (FeaturePcdGet (PcdVerifiedBootEnabled)) {
       if(FixedPcdGet8(PcdCompSignHashAlg) == HASH_TYPE_SHA256) {
-        AuthType = AUTH_TYPE_SHA2_256;
+        Ctx->AuthType = AUTH_TYPE_SHA2_256;
       } else if (FixedPcdGet8(PcdCompSignHashAlg) == HASH_TYPE_SHA384) {
-        AuthType = AUTH_TYPE_SHA2_384;
+        Ctx->AuthType = AUTH_TYPE_SHA2_384;
       } else {
         return EFI_UNSUPPORTED;
       }
     } else {
-      AuthType = AUTH_TYPE_NONE;
+      Ctx->AuthType = AUTH_TYPE_NONE;
     }
-    HashData = NULL;
+    Ctx->HashData = NULL;
   } else {
     // Find the component info
     Status = LocateComponentEntry (ContainerSig, ComponentName, &ContainerEntry, &CompEntry);
@@ -787,12 +1387,12 @@ LoadComponentWithCallback (
     }
 
     // Collect component info
-    ContainerHdr = (CONTAINER_HDR *)(UINTN)ContainerEntry->HeaderCache;
-    AuthType  = CompEntry->AuthType;
-    HashData  = CompEntry->HashData;
-    Usage     = 0;
-    CompData  = (UINT8 *)(UINTN)(ContainerEntry->Base + ContainerHdr->DataOffset + CompEntry->Offset);
-    CompLen   = CompEntry->Size;
+    ContainerHdr  = (CONTAINER_HDR *)(UINTN)ContainerEntry->HeaderCache;
+    Ctx->AuthType = CompEntry->AuthType;
+    Ctx->HashData = CompEntry->HashData;
+    Ctx->Usage    = 0;
+    Ctx->CompData = (UINT8 *)(UINTN)(ContainerEntry->Base + ContainerHdr->DataOffset + CompEntry->Offset);
+    CompLen       = CompEntry->Size;
   }
 
   if (LoadComponentCallback != NULL) {
@@ -801,19 +1401,19 @@ LoadComponentWithCallback (
 
   // Component must have LOADER_COMPRESSED_HEADER
   Status = EFI_UNSUPPORTED;
-  CompressHdr  = (LOADER_COMPRESSED_HEADER *)CompData;
+  CompressHdr  = (LOADER_COMPRESSED_HEADER *)Ctx->CompData;
   if (CompressHdr == NULL) {
     return EFI_NOT_FOUND;
   }
 
   if (IS_COMPRESSED (CompressHdr)) {
-    SignedDataLen = sizeof (LOADER_COMPRESSED_HEADER) + CompressHdr->CompressedSize;
+    Ctx->SignedDataLen = sizeof (LOADER_COMPRESSED_HEADER) + CompressHdr->CompressedSize;
     if (CompressHdr->Size == 0) {
       Status = EFI_SUCCESS;
       DstLen = 0;
       ScrLen = 0;
     } else {
-      if (SignedDataLen <= CompLen) {
+      if (Ctx->SignedDataLen <= CompLen) {
         Status = DecompressGetInfo (CompressHdr->Signature, CompressHdr->Data,
                                     CompressHdr->CompressedSize, &DstLen, &ScrLen);
       }
@@ -822,98 +1422,113 @@ LoadComponentWithCallback (
   if (EFI_ERROR (Status)) {
     return EFI_UNSUPPORTED;
   }
+  CopyMem (Ctx->CompressHdr, CompressHdr, sizeof (LOADER_COMPRESSED_HEADER));
+
+  // Blocks of a chunked stream can be decompressed in parallel, each with its own scratch buffer
+  Ctx->ScrLen        = ALIGN_UP (ScrLen, TEMP_BUF_ALIGN);
+  Ctx->BlockJobCount = 1;
+  if ((MaxJobs > 1) && (CompressHdr->Size != 0) &&
+      !EFI_ERROR (DecompressGetBlockCount (CompressHdr->Signature, CompressHdr->Data,
+                                           CompressHdr->CompressedSize, &BlockCount))) {
+    Ctx->BlockJobCount = MIN (MIN (MaxJobs, BlockCount), MAX_BLOCK_JOBS);
+  }
 
   // If it is required to use an existing buffer, verify the size
-  ReqCompBase = NULL;
-  DecompressedLen = CompressHdr->Size;
-  if ((Buffer != NULL) && (*Buffer != NULL)) {
-    ReqCompBase = *Buffer;
-    if ((Length != NULL) && (*Length != 0) && (*Length < DecompressedLen)) {
+  Ctx->DecompressedLen = CompressHdr->Size;
+  if (ReqCompBase != NULL) {
+    if ((ReqLength != 0) && (ReqLength < Ctx->DecompressedLen)) {
       return EFI_BUFFER_TOO_SMALL;
     }
+    Ctx->ReqCompBase = ReqCompBase;
+    Ctx->CompBase    = ReqCompBase;
+  } else {
+    Ctx->CompBase = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN) Ctx->DecompressedLen));
+    if (Ctx->CompBase == NULL) {
+      return (Ctx->DecompressedLen == 0) ? EFI_BAD_BUFFER_SIZE : EFI_OUT_OF_RESOURCES;
+    }
   }
 
   // If it is on flash, the data needs to be copied into memory first
   // before authentication for security concern.
-  IsInFlash = IS_FLASH_ADDRESS (CompData);
-  AllocLen  = ScrLen + TEMP_BUF_ALIGN * 2;
-  if (IsInFlash) {
-    AllocLen += SignedDataLen;
+  Ctx->IsInFlash = IS_FLASH_ADDRESS (Ctx->CompData);
+  AllocLen  = Ctx->ScrLen * Ctx->BlockJobCount + TEMP_BUF_ALIGN * 2;
+  if (Ctx->IsInFlash) {
+    AllocLen += Ctx->SignedDataLen;
   }
-  AllocBuf = AllocateTemporaryMemory (AllocLen);
-  if (AllocBuf == NULL) {
+  Ctx->AllocBuf = AllocateTemporaryMemory (AllocLen);
+  if (Ctx->AllocBuf == NULL) {
+    if (Ctx->ReqCompBase == NULL) {
+      FreePages (Ctx->CompBase, EFI_SIZE_TO_PAGES ((UINTN) Ctx->DecompressedLen));
+    }
     return EFI_OUT_OF_RESOURCES;
   }
-  if (IsInFlash) {
-    // Authenticate component and decompress it if required
-    CompBuf = AllocBuf;
-    ScrBuf  = (UINT8 *)AllocBuf + ALIGN_UP (SignedDataLen, TEMP_BUF_ALIGN);
-    CopyMem (CompBuf, CompData, SignedDataLen);
-    if (LoadComponentCallback != NULL) {
-      LoadComponentCallback (PROGESS_ID_COPY, NULL);
-    }
+  if (Ctx->IsInFlash) {
+    Ctx->CompBuf = Ctx->AllocBuf;
+    Ctx->ScrBuf  = (UINT8 *)Ctx->AllocBuf + ALIGN_UP (Ctx->SignedDataLen, TEMP_BUF_ALIGN);
   } else {
-    CompBuf = CompData;
-    ScrBuf  = AllocBuf;
+    Ctx->CompBuf = Ctx->CompData;
+    Ctx->ScrBuf  = Ctx->AllocBuf;
   }
+  Ctx->AuthData = Ctx->CompData + ALIGN_UP(Ctx->SignedDataLen, AUTH_DATA_ALIGN);
 
-  // Verify the component
-  Status = AuthenticateComponent (CompBuf, SignedDataLen, AuthType,
-             CompData + ALIGN_UP(SignedDataLen, AUTH_DATA_ALIGN),  HashData, Usage);
-  if (LoadComponentCallback != NULL) {
-    if(Status == EFI_SUCCESS){
-      // Update component Call back info after authenticaton is done
-      // This info will used by firmware stage to extend to TPM
-      CbInfo.ComponentType    = ComponentId;
-      CbInfo.CompBuf          = CompBuf;
-      CbInfo.CompLen          = SignedDataLen;
-      CbInfo.HashAlg          = GetHashAlg(AuthType);
-      CbInfo.HashData         = HashData;
-      LoadComponentCallback (PROGESS_ID_AUTHENTICATE, &CbInfo);
-    } else {
-      LoadComponentCallback (PROGESS_ID_AUTHENTICATE, NULL);
-    }
-  }
-  if (!EFI_ERROR (Status)) {
-    CompressHdr = (LOADER_COMPRESSED_HEADER *)CompBuf;
-    if (ReqCompBase == NULL) {
-      CompBase = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN) DecompressedLen));
-    } else {
-      CompBase = ReqCompBase;
-    }
+  return EFI_SUCCESS;
+}
 
-    if (CompBase != NULL) {
-      Status = Decompress (CompressHdr->Signature, CompressHdr->Data, CompressHdr->CompressedSize,
-                           CompBase, ScrBuf);
-      if (LoadComponentCallback != NULL) {
-        LoadComponentCallback (PROGESS_ID_DECOMPRESS, NULL);
-      }
-      if (EFI_ERROR (Status)) {
-        if (ReqCompBase == NULL) {
-          FreePages (CompBase, EFI_SIZE_TO_PAGES ((UINTN) DecompressedLen));
-        }
-      }
-    } else {
-      if (CompressHdr->Size == 0) {
-        Status = EFI_BAD_BUFFER_SIZE;
-      } else {
-        Status = EFI_OUT_OF_RESOURCES;
-      }
-    }
+/**
+  Load a component from a container or flahs map to memory and call callback
+  function at predefined point.
 
-  } else {
-    Status = EFI_SECURITY_VIOLATION;
+  @param[in]     ContainerSig    Container signature or component type.
+  @param[in]     ComponentName   Component name.
+  @param[in,out] Buffer          Pointer to receive component base.
+  @param[in,out] Length          Pointer to receive component size.
+  @param[in,out] LoadComponentCallback  Callback function pointer.
+
+  @retval EFI_UNSUPPORTED          Unsupported AuthType.
+  @retval EFI_NOT_FOUND            Cannot locate component.
+  @retval EFI_BUFFER_TOO_SMALL     Specified buffer size is too small.
+  @retval EFI_SECURITY_VIOLATION   Authentication failed.
+  @retval EFI_SUCCESS              Authentication succeeded.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponentWithCallback (
+  IN     UINT32                   ContainerSig,
+  IN     UINT32                   ComponentName,
+  IN OUT VOID                   **Buffer,
+  IN OUT UINT32                  *Length,
+  IN     LOAD_COMPONENT_CALLBACK  LoadComponentCallback
+  )
+{
+  EFI_STATUS                Status;
+  COMPONENT_LOAD_CONTEXT    Ctx;
+  BOOLEAN                   Speculative;
+
+  Status = PrepareComponentLoad (ContainerSig, ComponentName,
+                                 (Buffer != NULL) ? *Buffer : NULL,
+                                 (Length != NULL) ? *Length : 0,
+                                 LoadComponentCallback, 1, &Ctx);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
-  FreeTemporaryMemory (AllocBuf);
 
-  if (!EFI_ERROR (Status)) {
-    if (Buffer != NULL) {
-      *Buffer = CompBase;
-    }
-    if (Length != NULL) {
-      *Length = DecompressedLen;
+  CopyComponentTask ((UINT64)(UINTN)&Ctx);
+  Speculative = IsSpeculativeDecompress (&Ctx);
+  if (Speculative) {
+    // Decompress the hashed copy on an idle processor while the signature is verified
+    StartDecompress (&Ctx, TRUE);
+  }
+  Status = AuthenticateLoadedComponent (&Ctx, LoadComponentCallback);
+  if (Speculative) {
+    if (Ctx.Job.State != EnumMpJobIdle) {
+      MpTaskWait (&Ctx.Job);
     }
+  } else if (!EFI_ERROR (Status)) {
+    StartDecompress (&Ctx, FALSE);
   }
+  Status = FinishComponentLoad (&Ctx, LoadComponentCallback, Buffer, Length);
+  FreeTemporaryMemory (Ctx.AllocBuf);
 
   return Status;
 }
@@ -945,3 +1560,102 @@ LoadComponent (
 {
   return LoadComponentWithCallback (ContainerSig, ComponentName, Buffer, Length, NULL);
 }
+
+
+/**
+  Load multiple components from containers or flash map to memory.
+
+  The components are copied, hashed and decompressed in parallel on the idle
+  processors, while authentication and the callbacks run on the BSP in the
+  order of the requests.
+
+  @param[in,out] Requests        Array of component load requests.
+  @param[in]     Count           Number of requests.
+
+  @retval EFI_INVALID_PARAMETER    Requests is NULL.
+  @retval EFI_OUT_OF_RESOURCES     Cannot allocate the load contexts.
+  @retval EFI_SUCCESS              All components were loaded.
+  @retval Others                   Status of the first request that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+LoadComponents (
+  IN OUT LOAD_COMPONENT_REQUEST  *Requests,
+  IN     UINT32                   Count
+  )
+{
+  EFI_STATUS                Status;
+  COMPONENT_LOAD_CONTEXT   *Ctx;
+  LOAD_COMPONENT_REQUEST   *Req;
+  UINT32                    Index;
+  UINT32                    MaxJobs;
+  BOOLEAN                   Speculative;
+
+  if ((Requests == NULL) && (Count > 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Ctx = AllocateZeroPool (Count * sizeof (COMPONENT_LOAD_CONTEXT));
+  if (Ctx == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // Locate all components and allocate buffers, then copy and hash them in parallel
+  MaxJobs = MpTaskGetWorkerCount () + 1;
+  for (Index = 0; Index < Count; Index++) {
+    Req = &Requests[Index];
+    Req->Status = PrepareComponentLoad (Req->ContainerSig, Req->ComponentName, Req->Buffer,
+                                        Req->Length, Req->Callback, MaxJobs, &Ctx[Index]);
+    if (!EFI_ERROR (Req->Status) && (MaxJobs > 1)) {
+      MpTaskSubmit (&Ctx[Index].Job, CopyComponentTask, (UINT64)(UINTN)&Ctx[Index]);
+    }
+  }
+
+  // Without idle processors, hash the components together instead
+  if (MaxJobs == 1) {
+    HashComponentsBatch (Ctx, Requests, Count);
+  }
+
+  // Authenticate in request order, and decompress the authenticated ones in parallel
+  for (Index = 0; Index < Count; Index++) {
+    Req = &Requests[Index];
+    if (EFI_ERROR (Req->Status)) {
+      continue;
+    }
+    if (MaxJobs > 1) {
+      MpTaskWait (&Ctx[Index].Job);
+    }
+    Speculative = IsSpeculativeDecompress (&Ctx[Index]);
+    if (Speculative) {
+      StartDecompress (&Ctx[Index], TRUE);
+    }
+    Status = AuthenticateLoadedComponent (&Ctx[Index], Req->Callback);
+    if (!EFI_ERROR (Status) && !Speculative) {
+      StartDecompress (&Ctx[Index], TRUE);
+    }
+  }
+  // Wait for all the decompression before the failed components are zeroed
+  MpTaskJoin ();
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Count; Index++) {
+    Req = &Requests[Index];
+    if (!EFI_ERROR (Req->Status)) {
+      Req->Status = FinishComponentLoad (&Ctx[Index], Req->Callback, &Req->Buffer, &Req->Length);
+    }
+    if (EFI_ERROR (Req->Status) && !EFI_ERROR (Status)) {
+      Status = Req->Status;
+    }
+  }
+
+  // Temporary memory is a stack, so release it in reverse order
+  for (Index = Count; Index > 0; Index--) {
+    if (Ctx[Index - 1].AllocBuf != NULL) {
+      FreeTemporaryMemory (Ctx[Index - 1].AllocBuf);
+    }
+  }
+  FreePool (Ctx);
+
+  return Status;
+}
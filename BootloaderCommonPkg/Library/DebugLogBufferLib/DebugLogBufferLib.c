@@ -7,11 +7,435 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include <PiPei.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/PcdLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimeStampLib.h>
+#include <Library/SerialPortLib.h>
 #include <Library/BootloaderCommonLib.h>
 #include <Library/DebugLogBufferLib.h>
 #include <Guid/LoaderPlatformDataGuid.h>
 
+/**
+  Get the APIC ID of the calling CPU.
+
+  @retval  The initial APIC ID, or the x2APIC ID if it is supported.
+
+**/
+STATIC
+UINT32
+GetCpuApicId (
+  VOID
+  )
+{
+  UINT32  MaxLeaf;
+  UINT32  RegEbx;
+  UINT32  RegEdx;
+
+  AsmCpuid (0, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf >= 0x0B) {
+    AsmCpuidEx (0x0B, 0, NULL, &RegEbx, NULL, &RegEdx);
+    if (RegEbx != 0) {
+      return RegEdx;
+    }
+  }
+
+  AsmCpuid (1, NULL, &RegEbx, NULL, NULL);
+  return RegEbx >> 24;
+}
+
+/**
+  Get the data of a ring.
+
+  @param  LogRing          The debug log rings.
+  @param  Index            Index of the ring.
+
+  @retval  Pointer to the ring data.
+
+**/
+STATIC
+UINT8 *
+GetRingData (
+  IN DEBUG_LOG_RING_HEADER  *LogRing,
+  IN UINT32                  Index
+  )
+{
+  return (UINT8 *)&LogRing->Ring[LogRing->RingCount] + Index * LogRing->RingSize;
+}
+
+/**
+  Get the position of the record following a record in a ring.
+
+  @param  LogRing          The debug log rings.
+  @param  Data             The ring data.
+  @param  Position         Position of the record.
+
+  @retval  Position of the next record.
+
+**/
+STATIC
+UINT32
+GetNextRecordPosition (
+  IN DEBUG_LOG_RING_HEADER  *LogRing,
+  IN UINT8                  *Data,
+  IN UINT32                  Position
+  )
+{
+  DEBUG_LOG_RECORD  *Record;
+  UINT32             Offset;
+
+  Offset = Position & (LogRing->RingSize - 1);
+  Record = (DEBUG_LOG_RECORD *)(Data + Offset);
+  if ((LogRing->RingSize - Offset < sizeof (DEBUG_LOG_RECORD)) || (Record->Length == DEBUG_LOG_RECORD_PAD)) {
+    return Position + LogRing->RingSize - Offset;
+  }
+
+  return Position + ALIGN_VALUE (sizeof (DEBUG_LOG_RECORD) + Record->Length, 8);
+}
+
+/**
+  Find the ring of a CPU, claiming a free ring on the first use.
+
+  Rings are claimed with a compare exchange and never released, so the
+  search is bounded by the ring count.
+
+  @param  LogRing          The debug log rings.
+  @param  ApicId           APIC ID of the CPU.
+
+  @retval  Index of the ring, RingCount if all rings are in use.
+
+**/
+STATIC
+UINT32
+GetCpuRingIndex (
+  IN DEBUG_LOG_RING_HEADER  *LogRing,
+  IN UINT32                  ApicId
+  )
+{
+  UINT32  Count;
+  UINT32  Index;
+  UINT32  Owner;
+
+  Index = ApicId % LogRing->RingCount;
+  for (Count = 0; Count < LogRing->RingCount; Count++) {
+    Owner = *(volatile UINT32 *)&LogRing->Ring[Index].ApicId;
+    if (Owner == ApicId) {
+      return Index;
+    }
+    if ((Owner == DEBUG_LOG_RING_FREE) &&
+        (InterlockedCompareExchange32 (&LogRing->Ring[Index].ApicId, DEBUG_LOG_RING_FREE, ApicId) == DEBUG_LOG_RING_FREE)) {
+      return Index;
+    }
+    Index = (Index + 1) % LogRing->RingCount;
+  }
+
+  return LogRing->RingCount;
+}
+
+/**
+  Append a record to the ring of a CPU, dropping the oldest records if needed.
+
+  @param  LogRing          The debug log rings.
+  @param  Index            Index of the ring owned by the calling CPU.
+  @param  ErrorLevel       The error level of the debug message.
+  @param  Buffer           Pointer to the message.
+  @param  NumberOfBytes    Length of the message.
+
+**/
+STATIC
+VOID
+WriteRingRecord (
+  IN DEBUG_LOG_RING_HEADER  *LogRing,
+  IN UINT32                  Index,
+  IN UINTN                   ErrorLevel,
+  IN UINT8                  *Buffer,
+  IN UINTN                   NumberOfBytes
+  )
+{
+  DEBUG_LOG_RING    *Ring;
+  DEBUG_LOG_RECORD  *Record;
+  UINT8             *Data;
+  UINT32             Head;
+  UINT32             Offset;
+  UINT32             Length;
+
+  Ring   = &LogRing->Ring[Index];
+  Data   = GetRingData (LogRing, Index);
+  Length = (UINT32)MIN (NumberOfBytes, LogRing->RingSize / 4 - sizeof (DEBUG_LOG_RECORD));
+
+  //
+  // Records do not wrap around, skip to the ring start if it does not fit
+  //
+  Head   = Ring->Head;
+  Offset = Head & (LogRing->RingSize - 1);
+  if (Offset + ALIGN_VALUE (sizeof (DEBUG_LOG_RECORD) + Length, 8) > LogRing->RingSize) {
+    Head += LogRing->RingSize - Offset;
+  }
+
+  while (Head + ALIGN_VALUE (sizeof (DEBUG_LOG_RECORD) + Length, 8) - Ring->Tail > LogRing->RingSize) {
+    Ring->Tail = GetNextRecordPosition (LogRing, Data, Ring->Tail);
+  }
+
+  if ((Head != Ring->Head) && (LogRing->RingSize - Offset >= sizeof (DEBUG_LOG_RECORD))) {
+    ((DEBUG_LOG_RECORD *)(Data + Offset))->Length = DEBUG_LOG_RECORD_PAD;
+  }
+
+  Record = (DEBUG_LOG_RECORD *)(Data + (Head & (LogRing->RingSize - 1)));
+  Record->TimeStamp  = AsmReadTsc ();
+  Record->ErrorLevel = (UINT32)ErrorLevel;
+  Record->Length     = (UINT16)Length;
+  Record->Reserved   = 0;
+  CopyMem (Record + 1, Buffer, Length);
+
+  //
+  // Publish the record after its content
+  //
+  MemoryFence ();
+  Ring->Head = Head + ALIGN_VALUE (sizeof (DEBUG_LOG_RECORD) + Length, 8);
+}
+
+/**
+  Get the per-CPU debug log rings.
+
+  @retval  The debug log rings, NULL if they are not initialized.
+
+**/
+DEBUG_LOG_RING_HEADER *
+EFIAPI
+GetDebugLogRing (
+  VOID
+  )
+{
+  EFI_STATUS              Status;
+  DEBUG_LOG_RING_HEADER  *LogRing;
+
+  Status = GetLibraryData (PcdGet8 (PcdDebugLogRingLibId), (VOID **)&LogRing);
+  if (EFI_ERROR (Status) || (LogRing->Signature != DEBUG_LOG_RING_SIGNATURE)) {
+    return NULL;
+  }
+
+  return LogRing;
+}
+
+/**
+  Initialize the per-CPU debug log rings.
+
+  The rings are kept as library data so that they are handed over to the
+  payload. This must be called by the BSP after memory is available and
+  before APs start to log. The ring size is set by PcdDebugLogRingSize.
+
+  @param  RingCount        Number of rings, the maximum number of CPUs.
+
+  @retval EFI_SUCCESS            The rings are initialized.
+  @retval EFI_ALREADY_STARTED    The rings have been initialized already.
+  @retval EFI_UNSUPPORTED        The rings are disabled.
+  @retval EFI_OUT_OF_RESOURCES   No enough memory for the rings.
+
+**/
+EFI_STATUS
+EFIAPI
+DebugLogRingInit (
+  IN UINT32     RingCount
+  )
+{
+  EFI_STATUS              Status;
+  DEBUG_LOG_RING_HEADER  *LogRing;
+  UINT32                  RingSize;
+  UINT32                  Size;
+  UINT32                  Index;
+
+  if (GetDebugLogRing () != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  // Ring offsets are taken from the free running positions, use a power of 2
+  RingSize = GetPowerOfTwo32 (FixedPcdGet32 (PcdDebugLogRingSize));
+  if ((RingSize < 0x100) || (RingCount == 0) || (RingCount > MAX_UINT16)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Size    = sizeof (DEBUG_LOG_RING_HEADER) + RingCount * (sizeof (DEBUG_LOG_RING) + RingSize);
+  LogRing = (DEBUG_LOG_RING_HEADER *) AllocateZeroPool (Size);
+  if (LogRing == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  LogRing->Signature    = DEBUG_LOG_RING_SIGNATURE;
+  LogRing->HeaderLength = sizeof (DEBUG_LOG_RING_HEADER);
+  LogRing->RingCount    = (UINT16)RingCount;
+  LogRing->RingSize     = RingSize;
+  LogRing->BspApicId    = GetCpuApicId ();
+  LogRing->FreqKhz      = GetTimeStampFrequency ();
+  for (Index = 0; Index < RingCount; Index++) {
+    LogRing->Ring[Index].ApicId = DEBUG_LOG_RING_FREE;
+  }
+  GetCpuRingIndex (LogRing, LogRing->BspApicId);
+
+  Status = SetLibraryData (PcdGet8 (PcdDebugLogRingLibId), LogRing, Size);
+  if (EFI_ERROR (Status)) {
+    FreePool (LogRing);
+  }
+
+  return Status;
+}
+
+/**
+  Get the next record in time order from the per-CPU debug log rings.
+
+  Position holds the read position of each ring. Initialize entry N with
+  Ring[N].Tail to read all records.
+
+  @param  LogRing          The debug log rings.
+  @param  Position         Read positions of all rings, RingCount entries.
+  @param  RingIndex        Index of the ring holding the record.
+
+  @retval  The next record, NULL if all records have been read.
+
+**/
+DEBUG_LOG_RECORD *
+EFIAPI
+GetNextDebugLogRecord (
+  IN     DEBUG_LOG_RING_HEADER  *LogRing,
+  IN OUT UINT32                 *Position,
+  OUT    UINT32                 *RingIndex
+  )
+{
+  DEBUG_LOG_RECORD  *Record;
+  DEBUG_LOG_RECORD  *Next;
+  UINT8             *Data;
+  UINT32             Index;
+  UINT32             Offset;
+
+  Next = NULL;
+  for (Index = 0; Index < LogRing->RingCount; Index++) {
+    Data = GetRingData (LogRing, Index);
+
+    // Records overwritten since the read started are lost
+    if ((INT32)(LogRing->Ring[Index].Tail - Position[Index]) > 0) {
+      Position[Index] = LogRing->Ring[Index].Tail;
+    }
+
+    // Skip the padding at the ring end
+    while (Position[Index] != LogRing->Ring[Index].Head) {
+      Offset = Position[Index] & (LogRing->RingSize - 1);
+      Record = (DEBUG_LOG_RECORD *)(Data + Offset);
+      if ((LogRing->RingSize - Offset >= sizeof (DEBUG_LOG_RECORD)) && (Record->Length != DEBUG_LOG_RECORD_PAD)) {
+        if ((Next == NULL) || (Record->TimeStamp < Next->TimeStamp)) {
+          Next       = Record;
+          *RingIndex = Index;
+        }
+        break;
+      }
+      Position[Index] = GetNextRecordPosition (LogRing, Data, Position[Index]);
+    }
+  }
+
+  if (Next != NULL) {
+    Position[*RingIndex] = GetNextRecordPosition (LogRing, GetRingData (LogRing, *RingIndex), Position[*RingIndex]);
+  }
+
+  return Next;
+}
+
+/**
+  Get the length of the deferred serial output not sent yet.
+
+  @param  LogBufHdr        The log buffer.
+
+  @retval  The number of bytes not sent yet.
+
+**/
+STATIC
+UINT32
+GetPendingSerialLength (
+  IN DEBUG_LOG_BUFFER_HEADER  *LogBufHdr
+  )
+{
+  if ((LogBufHdr->SerialLength < LogBufHdr->HeaderLength) || (LogBufHdr->SerialLength > LogBufHdr->TotalLength)) {
+    return 0;
+  }
+
+  if (LogBufHdr->SerialLength <= LogBufHdr->UsedLength) {
+    return LogBufHdr->UsedLength - LogBufHdr->SerialLength;
+  }
+
+  return (LogBufHdr->TotalLength - LogBufHdr->SerialLength) + (LogBufHdr->UsedLength - LogBufHdr->HeaderLength);
+}
+
+/**
+  Send the deferred serial output kept in the log buffer to the serial port.
+
+  It does nothing unless DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED is set in
+  PcdDebugOutputDeviceMask. SerialLength in the log buffer header tracks the
+  output sent so far.
+
+  @param  Wait             TRUE to send all pending output.
+                           FALSE to send only what the UART accepts without waiting.
+
+  @retval  The number of bytes sent.
+
+**/
+UINTN
+EFIAPI
+DebugLogBufferFlush (
+  IN BOOLEAN    Wait
+  )
+{
+  DEBUG_LOG_BUFFER_HEADER  *LogBufHdr;
+  DEBUG_LOG_RING_HEADER    *LogRing;
+  UINT32                    End;
+  UINT32                    Length;
+  UINT32                    Control;
+  UINTN                     Sent;
+
+  if ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED) == 0) {
+    return 0;
+  }
+
+  // Only the BSP owns the log buffer and the serial port
+  LogRing = GetDebugLogRing ();
+  if ((LogRing != NULL) && (GetCpuApicId () != LogRing->BspApicId)) {
+    return 0;
+  }
+
+  // Called from DebugLogBufferWrite (), so DON'T use DEBUG/ASSERT macro here
+  LogBufHdr = (DEBUG_LOG_BUFFER_HEADER *) GetDebugLogBufferPtr ();
+  if ((LogBufHdr == NULL) || (LogBufHdr->Signature != DEBUG_LOG_BUFFER_SIGNATURE)) {
+    return 0;
+  }
+
+  if ((LogBufHdr->SerialLength < LogBufHdr->HeaderLength) || (LogBufHdr->SerialLength > LogBufHdr->TotalLength)) {
+    LogBufHdr->SerialLength = LogBufHdr->UsedLength;
+  }
+
+  Sent = 0;
+  while (LogBufHdr->SerialLength != LogBufHdr->UsedLength) {
+    if (LogBufHdr->SerialLength == LogBufHdr->TotalLength) {
+      // Continue from the ring buffer start
+      LogBufHdr->SerialLength = LogBufHdr->HeaderLength;
+      continue;
+    }
+
+    End    = (LogBufHdr->SerialLength < LogBufHdr->UsedLength) ? LogBufHdr->UsedLength : LogBufHdr->TotalLength;
+    Length = End - LogBufHdr->SerialLength;
+    if (!Wait) {
+      // The whole transmit FIFO is free when the output buffer is empty
+      if (EFI_ERROR (SerialPortGetControl (&Control)) || ((Control & EFI_SERIAL_OUTPUT_BUFFER_EMPTY) == 0)) {
+        break;
+      }
+      Length = MIN (Length, MAX (FixedPcdGet32 (PcdSerialPortFifoSize), 1));
+    }
+
+    SerialPortWrite (&LogBufHdr->Buffer[LogBufHdr->SerialLength - LogBufHdr->HeaderLength], Length);
+    LogBufHdr->SerialLength += Length;
+    Sent += Length;
+  }
+
+  return Sent;
+}
+
 /**
   Write data from buffer to console buffer.
 
@@ -61,6 +485,16 @@ DebugLogBufferWrite (
     LogBufHdr->UsedLength = LogBufHdr->HeaderLength;
   }
 
+  //
+  // Deferred serial output still in the buffer must not be overwritten,
+  // send it out first when the buffer is about to run over it.
+  //
+  if ((PcdGet32 (PcdDebugOutputDeviceMask) & DEBUG_OUTPUT_DEVICE_SERIAL_DEFERRED) != 0) {
+    if (GetPendingSerialLength (LogBufHdr) + NumberOfBytes >= (UINTN)(LogBufHdr->TotalLength - LogBufHdr->HeaderLength)) {
+      DebugLogBufferFlush (TRUE);
+    }
+  }
+
   RemainingBytes = 0;
   if (LogBufHdr->UsedLength + NumberOfBytes > LogBufHdr->TotalLength) {
     RemainingBytes = LogBufHdr->UsedLength + NumberOfBytes - LogBufHdr->TotalLength;
@@ -83,3 +517,50 @@ DebugLogBufferWrite (
 
   return (NumberOfBytes + RemainingBytes);
 }
+
+/**
+  Write a debug message to the log buffer.
+
+  The BSP writes the message to the log buffer. When the per-CPU debug log
+  rings are initialized, the message is also recorded with its time stamp
+  and error level in the ring of the calling CPU. Messages from APs are only
+  recorded in the rings.
+
+  @param  ErrorLevel       The error level of the debug message.
+  @param  Buffer           Pointer to the data buffer to be written.
+  @param  NumberOfBytes    Number of bytes to written.
+
+  @retval 0                NumberOfBytes is 0.
+  @retval >0               The number of bytes written.
+
+**/
+UINTN
+EFIAPI
+DebugLogBufferWriteLevel (
+  IN UINTN      ErrorLevel,
+  IN UINT8     *Buffer,
+  IN UINTN      NumberOfBytes
+  )
+{
+  DEBUG_LOG_RING_HEADER  *LogRing;
+  UINT32                  ApicId;
+  UINT32                  Index;
+
+  LogRing = GetDebugLogRing ();
+  if (LogRing == NULL) {
+    return DebugLogBufferWrite (Buffer, NumberOfBytes);
+  }
+
+  ApicId = GetCpuApicId ();
+  Index  = GetCpuRingIndex (LogRing, ApicId);
+  if (Index < LogRing->RingCount) {
+    WriteRingRecord (LogRing, Index, ErrorLevel, Buffer, NumberOfBytes);
+  }
+
+  // The log buffer has a single writer, the BSP
+  if (ApicId == LogRing->BspApicId) {
+    return DebugLogBufferWrite (Buffer, NumberOfBytes);
+  }
+
+  return NumberOfBytes;
+}
@@ -10,6 +10,176 @@
 #include <Library/Lz4DecompressLib.h>
 #include <Library/DecompressLib.h>
 
+// Size of the LZMA stream header
+#define  LZMA_STREAM_HEADER_SIZE   13
+
+/**
+  Locate a block in a chunked LZMA source buffer.
+
+  @param  Source          The source buffer starting with LZMB_BLOCK_INDEX.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  BlockIndex      The index of the block to locate.
+  @param  Block           A pointer to receive the LZMA stream of the block.
+  @param  BlockLen        A pointer to receive the size of the LZMA stream.
+  @param  DstOffset       A pointer to receive the block offset in the decompressed data.
+
+  @retval  RETURN_SUCCESS          The block was located.
+  @retval  RETURN_INVALID_PARAMETER The block index is corrupted or BlockIndex is out of range.
+
+**/
+STATIC
+RETURN_STATUS
+LzmbGetBlock (
+  IN  CONST VOID    *Source,
+  IN  UINTN          SourceSize,
+  IN  UINT32         BlockIndex,
+  OUT CONST UINT8  **Block,
+  OUT UINT32        *BlockLen,
+  OUT UINT32        *DstOffset
+  )
+{
+  CONST LZMB_BLOCK_INDEX  *Index;
+  UINT32                   Start;
+  UINT32                   End;
+
+  Index = (CONST LZMB_BLOCK_INDEX *)Source;
+  if ((SourceSize < sizeof (LZMB_BLOCK_INDEX)) || (Index->BlockSize == 0) || (Index->BlockCount == 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((((UINT64)Index->BlockCount + 1) * sizeof (UINT32) > SourceSize - sizeof (LZMB_BLOCK_INDEX)) ||
+      (BlockIndex >= Index->BlockCount) ||
+      (MultU64x32 (BlockIndex, Index->BlockSize) > MAX_UINT32)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Start = Index->BlockOffset[BlockIndex];
+  End   = Index->BlockOffset[BlockIndex + 1];
+  if ((Start < sizeof (LZMB_BLOCK_INDEX) + (Index->BlockCount + 1) * sizeof (UINT32)) ||
+      (End > SourceSize) || (End < Start) || (End - Start < LZMA_STREAM_HEADER_SIZE)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *Block     = (CONST UINT8 *)Source + Start;
+  *BlockLen  = End - Start;
+  *DstOffset = BlockIndex * Index->BlockSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Get the decompressed and scratch size of a chunked LZMA block.
+
+  @param  Source          The source buffer starting with LZMB_BLOCK_INDEX.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  BlockIndex      The index of the block.
+  @param  Block           A pointer to receive the LZMA stream of the block.
+  @param  BlockLen        A pointer to receive the size of the LZMA stream.
+  @param  DstOffset       A pointer to receive the block offset in the decompressed data.
+  @param  DstSize         A pointer to receive the decompressed size of the block.
+  @param  ScratchSize     A pointer to receive the scratch size for the block.
+
+  @retval  RETURN_SUCCESS          The block information was returned.
+  @retval  RETURN_INVALID_PARAMETER The block is corrupted.
+
+**/
+STATIC
+RETURN_STATUS
+LzmbGetBlockInfo (
+  IN  CONST VOID    *Source,
+  IN  UINTN          SourceSize,
+  IN  UINT32         BlockIndex,
+  OUT CONST UINT8  **Block,
+  OUT UINT32        *BlockLen,
+  OUT UINT32        *DstOffset,
+  OUT UINT32        *DstSize,
+  OUT UINT32        *ScratchSize
+  )
+{
+  CONST LZMB_BLOCK_INDEX  *Index;
+  RETURN_STATUS            Status;
+
+  Status = LzmbGetBlock (Source, SourceSize, BlockIndex, Block, BlockLen, DstOffset);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = LzmaUefiDecompressGetInfo (*Block, *BlockLen, DstSize, ScratchSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  // Only the last block may be shorter, so no block can overwrite the next one
+  Index = (CONST LZMB_BLOCK_INDEX *)Source;
+  if ((*DstSize > Index->BlockSize) ||
+      ((BlockIndex + 1 < Index->BlockCount) && (*DstSize != Index->BlockSize))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Get the decompressed and scratch size of a chunked LZMA source buffer.
+
+  @param  Source          The source buffer starting with LZMB_BLOCK_INDEX.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the decompressed data.
+  @param  ScratchSize     A pointer to the scratch size, in bytes, to decompress one block.
+
+  @retval  RETURN_SUCCESS          The sizes were returned.
+  @retval  RETURN_INVALID_PARAMETER The source buffer is corrupted.
+
+**/
+STATIC
+RETURN_STATUS
+LzmbGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS  Status;
+  CONST UINT8   *Block;
+  UINT32         BlockLen;
+  UINT32         BlockCount;
+  UINT32         Index;
+  UINT32         DstOffset;
+  UINT32         DstSize;
+  UINT32         BlockScratch;
+  UINT32         MaxScratch;
+
+  Status = DecompressGetBlockCount (LZMB_SIGNATURE, Source, SourceSize, &BlockCount);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  DstOffset  = 0;
+  DstSize    = 0;
+  MaxScratch = 0;
+  for (Index = 0; Index < BlockCount; Index++) {
+    Status = LzmbGetBlockInfo (Source, SourceSize, Index, &Block, &BlockLen,
+                               &DstOffset, &DstSize, &BlockScratch);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    MaxScratch = MAX (MaxScratch, BlockScratch);
+  }
+
+  if ((UINT64)DstOffset + DstSize > MAX_UINT32) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (DestinationSize != NULL) {
+    *DestinationSize = DstOffset + DstSize;
+  }
+  if (ScratchSize != NULL) {
+    *ScratchSize = MaxScratch;
+  }
+
+  return RETURN_SUCCESS;
+}
+
 /**
   Given a compressed source buffer, this function retrieves the size of
   the uncompressed buffer and the size of the scratch buffer required
@@ -65,6 +235,8 @@ DecompressGetInfo (
   } else if (!FeaturePcdGet (PcdMinDecompression)) {
     if (Signature == LZMA_SIGNATURE) {
       Status = LzmaUefiDecompressGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
+    } else if (Signature == LZMB_SIGNATURE) {
+      Status = LzmbGetInfo (Source, SourceSize, DestinationSize, ScratchSize);
     }
   }
 
@@ -105,6 +277,8 @@ Decompress (
   )
 {
   RETURN_STATUS  Status;
+  UINT32         BlockCount;
+  UINT32         Index;
 
   Status = RETURN_UNSUPPORTED;
   if (Signature == LZ4_SIGNATURE) {
@@ -115,8 +289,120 @@ Decompress (
   } else if (!FeaturePcdGet (PcdMinDecompression)) {
     if (Signature == LZMA_SIGNATURE) {
       Status = LzmaUefiDecompress (Source, SourceSize, Destination, Scratch);
+    } else if (Signature == LZMB_SIGNATURE) {
+      Status = DecompressGetBlockCount (Signature, Source, (UINT32)SourceSize, &BlockCount);
+      for (Index = 0; !RETURN_ERROR (Status) && (Index < BlockCount); Index++) {
+        Status = DecompressBlock (Signature, Source, SourceSize, Index, Destination, Scratch);
+      }
     }
   }
 
   return Status;
 }
+
+/**
+  Get the number of blocks that can be decompressed independently.
+
+  @param  Signature       The signature to indicate the decompression algorithm.
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  BlockCount      A pointer to the number of blocks. It is 1 for the
+                          algorithms that do not support blocks.
+
+  @retval  RETURN_SUCCESS          The number of blocks was returned in BlockCount.
+  @retval  RETURN_UNSUPPORTED      The decompression is not supported.
+  @retval  RETURN_INVALID_PARAMETER The block index is corrupted.
+
+**/
+RETURN_STATUS
+EFIAPI
+DecompressGetBlockCount (
+  IN  UINT32       Signature,
+  IN  CONST VOID  *Source,
+  IN  UINT32       SourceSize,
+  OUT UINT32      *BlockCount
+  )
+{
+  RETURN_STATUS  Status;
+  CONST UINT8   *Block;
+  UINT32         BlockLen;
+  UINT32         DstOffset;
+
+  if ((Signature == LZ4_SIGNATURE) || (Signature == LZDM_SIGNATURE)) {
+    *BlockCount = 1;
+    return RETURN_SUCCESS;
+  }
+
+  Status = RETURN_UNSUPPORTED;
+  if (!FeaturePcdGet (PcdMinDecompression)) {
+    if (Signature == LZMA_SIGNATURE) {
+      *BlockCount = 1;
+      Status = RETURN_SUCCESS;
+    } else if (Signature == LZMB_SIGNATURE) {
+      // Validate the index through the first block
+      Status = LzmbGetBlock (Source, SourceSize, 0, &Block, &BlockLen, &DstOffset);
+      if (!RETURN_ERROR (Status)) {
+        *BlockCount = ((CONST LZMB_BLOCK_INDEX *)Source)->BlockCount;
+      }
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Decompresses a single block of a compressed source buffer.
+
+  The block is extracted to its offset in Destination, so the blocks can be
+  decompressed in any order and in parallel as long as each caller uses its
+  own scratch buffer.
+
+  @param  Signature       The signature to indicate the decompression algorithm.
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size of source buffer.
+  @param  BlockIndex      The index of the block to decompress.
+  @param  Destination     The destination buffer for the whole decompressed data.
+  @param  Scratch         A temporary scratch buffer that is used to perform the decompression.
+
+  @retval  RETURN_SUCCESS Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          or BlockIndex is out of range.
+**/
+RETURN_STATUS
+EFIAPI
+DecompressBlock (
+  IN UINT32      Signature,
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      BlockIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS  Status;
+  CONST UINT8   *Block;
+  UINT32         BlockLen;
+  UINT32         DstOffset;
+  UINT32         DstSize;
+  UINT32         ScratchSize;
+
+  if (Signature != LZMB_SIGNATURE) {
+    if (BlockIndex != 0) {
+      return RETURN_INVALID_PARAMETER;
+    }
+    return Decompress (Signature, Source, SourceSize, Destination, Scratch);
+  }
+
+  if (FeaturePcdGet (PcdMinDecompression)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Status = LzmbGetBlockInfo (Source, SourceSize, BlockIndex, &Block, &BlockLen,
+                             &DstOffset, &DstSize, &ScratchSize);
+  if (!RETURN_ERROR (Status)) {
+    Status = LzmaUefiDecompress (Block, BlockLen, (UINT8 *)Destination + DstOffset, Scratch);
+  }
+
+  return Status;
+}
@@ -103,6 +103,8 @@
   @param[in]  File            pointer to an Open file.
   @param[in]  FileBlock       Block to find the file.
   @param[out] DiskBlockPtr    Pointer to the disk which contains block.
+  @param[out] RunPtr          Number of file blocks from FileBlock that are
+                              consecutive on the disk, at least 1. Optional.
 
   @retval 0 if success
   @retval other if error.
@@ -112,16 +114,21 @@ RETURN_STATUS
 BlockMap (
   IN  OPEN_FILE     *File,
   IN  INDPTR         FileBlock,
-  OUT INDPTR        *DiskBlockPtr
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *RunPtr       OPTIONAL
   );
 
 /**
   Search a directory for a Name and return its inode number.
 
+  The directory entry lookup cache of the file system is checked first,
+  and the result of a directory scan is added to it.
+
   @param[in]      Name        Name to compare with
   @param[in]      Length      Length of the dir name
   @param[in/out]  File        Pointer to file private data
-  @param[out]     INumPtr     pointer to Inode number.
+  @param[in/out]  INumPtr     On input, inode number of the directory.
+                              On output, inode number of the Name.
 
   @retval 0 if success
   @retval other if error.
@@ -132,7 +139,7 @@ SearchDirectory (
   IN      CHAR8         *Name,
   IN      INT32          Length,
   IN OUT  OPEN_FILE     *File,
-  OUT     INODE32       *INumPtr
+  IN OUT  INODE32       *INumPtr
   );
 
 /**
@@ -246,26 +253,177 @@ ReadInode (
   //
   Fp->InodeCacheBlock = ~0;
   Fp->BufferBlockNum = -1;
+  Fp->RunCount = 0;
   return Status;
 }
 
+/**
+  Count the block pointers following Table[0] that continue its disk block run.
+
+  @param[in]  Table           Block pointers of consecutive file blocks.
+  @param[in]  Count           Number of pointers in Table.
+
+  @retval Number of pointers in the run, at least 1.
+**/
+STATIC
+UINT32
+BlockRun (
+  IN  INDPTR        *Table,
+  IN  UINT32         Count
+  )
+{
+  UINT32    Run;
+
+  if (Table[0] == 0) {
+    return 1;
+  }
+
+  for (Run = 1; Run < Count; Run++) {
+    if (Table[Run] != Table[0] + (INDPTR)Run) {
+      break;
+    }
+  }
+
+  return Run;
+}
+
+/**
+  Find the cached run containing a file block.
+
+  @param[in]  Fp              Pointer to the file.
+  @param[in]  FileBlock       File block to find.
+  @param[out] Position        Index of the first run starting after FileBlock.
+
+  @retval The run containing FileBlock, or NULL if it is not cached.
+**/
+STATIC
+BLOCK_RUN *
+RunCacheFind (
+  IN  FILE          *Fp,
+  IN  UINT32         FileBlock,
+  OUT UINT32        *Position
+  )
+{
+  UINT32     Low;
+  UINT32     High;
+  UINT32     Mid;
+  BLOCK_RUN *Run;
+
+  Low  = 0;
+  High = Fp->RunCount;
+  while (Low < High) {
+    Mid = (Low + High) / 2;
+    if (Fp->RunCache[Mid].FileBlock <= FileBlock) {
+      Low = Mid + 1;
+    } else {
+      High = Mid;
+    }
+  }
+
+  *Position = Low;
+  if (Low == 0) {
+    return NULL;
+  }
+
+  Run = &Fp->RunCache[Low - 1];
+  if (FileBlock - Run->FileBlock >= Run->Length) {
+    return NULL;
+  }
+
+  return Run;
+}
+
+/**
+  Remember a run of file blocks that are consecutive on the disk.
+
+  The part of the run that is cached already is dropped, so the cached runs
+  never overlap. Nothing is added once the cache is full.
+
+  @param[in]  Fp              Pointer to the file.
+  @param[in]  FileBlock       First file block of the run.
+  @param[in]  Length          Number of blocks in the run.
+  @param[in]  DiskBlock       Disk block of FileBlock, 0 for a hole.
+**/
+STATIC
+VOID
+RunCacheAdd (
+  IN  FILE          *Fp,
+  IN  UINT32         FileBlock,
+  IN  UINT32         Length,
+  IN  INDPTR         DiskBlock
+  )
+{
+  UINT32     Position;
+  UINT32     Overlap;
+  BLOCK_RUN *Run;
+
+  if (Fp->RunCache == NULL) {
+    Fp->RunCache = AllocatePool (BLOCK_RUN_CACHE_SZ * sizeof (BLOCK_RUN));
+    if (Fp->RunCache == NULL) {
+      return;
+    }
+  }
+
+  if ((Length == 0) || (Fp->RunCount >= BLOCK_RUN_CACHE_SZ)) {
+    return;
+  }
+
+  RunCacheFind (Fp, FileBlock, &Position);
+  if (Position > 0) {
+    Run = &Fp->RunCache[Position - 1];
+    if (Run->FileBlock + Run->Length > FileBlock) {
+      Overlap = Run->FileBlock + Run->Length - FileBlock;
+      if (Overlap >= Length) {
+        return;
+      }
+      FileBlock += Overlap;
+      Length    -= Overlap;
+      if (DiskBlock != 0) {
+        DiskBlock += (INDPTR)Overlap;
+      }
+    }
+  }
+
+  if (Position < Fp->RunCount) {
+    Run = &Fp->RunCache[Position];
+    if (FileBlock + Length > Run->FileBlock) {
+      Length = Run->FileBlock - FileBlock;
+      if (Length == 0) {
+        return;
+      }
+    }
+  }
+
+  CopyMem (&Fp->RunCache[Position + 1], &Fp->RunCache[Position],
+           (Fp->RunCount - Position) * sizeof (BLOCK_RUN));
+  Run = &Fp->RunCache[Position];
+  Run->FileBlock = FileBlock;
+  Run->Length    = Length;
+  Run->DiskBlock = DiskBlock;
+  Fp->RunCount++;
+}
+
 /**
   Given an offset in a FILE, find the disk block number that
-  contains that block.
+  contains that block by walking the extent tree or the indirect
+  blocks. The runs found on the way are added to the run cache.
 
   @param[in]  File            pointer to an Open file.
   @param[in]  FileBlock       Block to find the file.
   @param[out] DiskBlockPtr    Pointer to the disk which contains block.
+  @param[out] RunPtr          Number of file blocks from FileBlock that are
+                              consecutive on the disk, at least 1.
 
   @retval 0 if success
   @retval other if error.
 **/
 STATIC
 RETURN_STATUS
-BlockMap (
+BlockMapResolve (
   IN  OPEN_FILE     *File,
   IN  INDPTR         FileBlock,
-  OUT INDPTR        *DiskBlockPtr
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *RunPtr
   )
 {
   FILE     *Fp;
@@ -281,10 +439,14 @@ BlockMap (
   EXT4_EXTENT_INDEX *ExtIndex;
   EXT4_EXTENT       *Extent;
   RETURN_STATUS     Status;
+  UINT32            Run;
+  UINT32            WindowBlock;
 
   Fp = (FILE *)File->FileSystemSpecificData;
   FileSystem = Fp->SuperBlockPtr;
   Buf = (VOID *)Fp->Buffer;
+  Run = 1;
+  WindowBlock = (UINT32) FileBlock;
 
   if ((Fp->DiskInode.Ext2DInodeStatusFlags & EXT4_EXTENTS) != 0) {
     Etable = (EXT4_EXTENT_TABLE*) &(Fp->DiskInode.Ext2DInodeBlocks);
@@ -314,7 +476,9 @@ BlockMap (
 
         //
         // We need to read the next level node of the extent tree since the data was not in the current level.
+        // It goes to the file buffer, so that no longer holds a file block.
         //
+        Fp->BufferBlockNum = -1;
         Status = DEV_STRATEGY (File->DevPtr) (File->FileDevData, F_READ,
                                           FSBTODB (Fp->SuperBlockPtr, (DADDRESS) NextLevelNode), FileSystem->Ext2FsBlockSize,
                                           Buf, &RSize);
@@ -336,12 +500,30 @@ BlockMap (
       }
     }
 
+    //
+    // Remember all the extents of the leaf, the following blocks are likely in them too.
+    //
+    for (Index=0; Index < Etable->Eheader.EhEntries; Index++) {
+      Extent = &(Etable->Enodes.Extent[Index]);
+      if (Extent->EstartHi == 0) {
+        RunCacheAdd (Fp, Extent->Eblk, Extent->Elen, (INDPTR) Extent->EstartLo);
+      }
+    }
+
     Extent = NULL;
     for (Index=0; Index < Etable->Eheader.EhEntries; Index++) {
       Extent = &(Etable->Enodes.Extent[Index]);
       if ((((UINT32) FileBlock) >= Extent->Eblk) && (((UINT32) FileBlock) < (Extent->Eblk + Extent->Elen))) {
         break;
       }
+      if (((UINT32) FileBlock) < Extent->Eblk) {
+        //
+        // A hole up to this extent
+        //
+        Run = Extent->Eblk - (UINT32) FileBlock;
+        Extent = NULL;
+        break;
+      }
       Extent = NULL;
     }
 
@@ -352,6 +534,7 @@ BlockMap (
       //
       ASSERT (Extent->EstartHi == 0);
       *DiskBlockPtr = Extent->EstartLo + (FileBlock - Extent->Eblk); // (LShiftU64((UINT64)Extent->EiLeafHi, 32) | Extent->EstartLo) + (FileBlock - Extent->Eblk);
+      Run = Extent->Eblk + Extent->Elen - (UINT32) FileBlock;
     } else {
       *DiskBlockPtr = 0;
     }
@@ -360,7 +543,13 @@ BlockMap (
       //
       // Direct block.
       //
+      for (Index = 0; Index < NDADDR; Index += Run) {
+        Run = BlockRun ((INDPTR *)&Fp->DiskInode.Ext2DInodeBlocks[Index], NDADDR - Index);
+        RunCacheAdd (Fp, Index, Run, (INDPTR) Fp->DiskInode.Ext2DInodeBlocks[Index]);
+      }
+
       *DiskBlockPtr = Fp->DiskInode.Ext2DInodeBlocks[FileBlock];
+      *RunPtr = BlockRun ((INDPTR *)&Fp->DiskInode.Ext2DInodeBlocks[FileBlock], NDADDR - FileBlock);
       return 0;
     }
 
@@ -370,6 +559,7 @@ BlockMap (
     if (IndCache == Fp->InodeCacheBlock) {
       *DiskBlockPtr =
         Fp->InodeCache[FileBlock & IND_CACHE_MASK];
+      *RunPtr = BlockRun (&Fp->InodeCache[FileBlock & IND_CACHE_MASK], IND_CACHE_SZ - (FileBlock & IND_CACHE_MASK));
       return 0;
     }
 
@@ -395,6 +585,7 @@ BlockMap (
       Level -= Fp->NiShift;
       if (IndBlockNum == 0) {
         *DiskBlockPtr = 0;    // missing
+        *RunPtr = 1;
         return 0;
       }
 
@@ -404,6 +595,7 @@ BlockMap (
       //  of a filesystem block.
       //  However we don't do this very often anyway...
       //
+      Fp->BufferBlockNum = -1;
       Status = DEV_STRATEGY (File->DevPtr) (File->FileDevData, F_READ,
                                         FSBTODB (Fp->SuperBlockPtr, IndBlockNum), FileSystem->Ext2FsBlockSize,
                                         Buf, &RSize);
@@ -426,7 +618,75 @@ BlockMap (
              IND_CACHE_SZ * sizeof Fp->InodeCache[0]);
     Fp->InodeCacheBlock = IndCache;
 
+    //
+    // Remember the runs of the whole cached part
+    //
+    WindowBlock -= (UINT32) (FileBlock & IND_CACHE_MASK);
+    for (Index = 0; Index < IND_CACHE_SZ; Index += Run) {
+      Run = BlockRun (&Fp->InodeCache[Index], IND_CACHE_SZ - Index);
+      RunCacheAdd (Fp, WindowBlock + Index, Run, Fp->InodeCache[Index]);
+    }
+
     *DiskBlockPtr = IndBlockNum;
+    Run = BlockRun (&Fp->InodeCache[FileBlock & IND_CACHE_MASK], IND_CACHE_SZ - (FileBlock & IND_CACHE_MASK));
+  }
+
+  *RunPtr = Run;
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Given an offset in a FILE, find the disk block number that
+  contains that block.
+
+  The runs of consecutive disk blocks resolved before are looked up
+  first, so the extent tree or the indirect blocks are only read for
+  blocks not mapped yet.
+
+  @param[in]  File            pointer to an Open file.
+  @param[in]  FileBlock       Block to find the file.
+  @param[out] DiskBlockPtr    Pointer to the disk which contains block.
+  @param[out] RunPtr          Number of file blocks from FileBlock that are
+                              consecutive on the disk, at least 1. Optional.
+
+  @retval 0 if success
+  @retval other if error.
+**/
+STATIC
+RETURN_STATUS
+BlockMap (
+  IN  OPEN_FILE     *File,
+  IN  INDPTR         FileBlock,
+  OUT INDPTR        *DiskBlockPtr,
+  OUT UINT32        *RunPtr       OPTIONAL
+  )
+{
+  FILE          *Fp;
+  BLOCK_RUN     *CachedRun;
+  UINT32         Position;
+  UINT32         Run;
+  RETURN_STATUS  Status;
+
+  Fp = (FILE *)File->FileSystemSpecificData;
+
+  CachedRun = RunCacheFind (Fp, (UINT32) FileBlock, &Position);
+  if (CachedRun != NULL) {
+    *DiskBlockPtr = 0;
+    if (CachedRun->DiskBlock != 0) {
+      *DiskBlockPtr = CachedRun->DiskBlock + (FileBlock - (INDPTR) CachedRun->FileBlock);
+    }
+    Run = CachedRun->Length - ((UINT32) FileBlock - CachedRun->FileBlock);
+  } else {
+    Status = BlockMapResolve (File, FileBlock, DiskBlockPtr, &Run);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+    RunCacheAdd (Fp, (UINT32) FileBlock, Run, *DiskBlockPtr);
+  }
+
+  if (RunPtr != NULL) {
+    *RunPtr = Run;
   }
 
   return RETURN_SUCCESS;
@@ -469,7 +729,7 @@ BufReadFile (
   BlockSize = FileSystem->Ext2FsBlockSize;    // no fragment
 
   if (FileBlock != Fp->BufferBlockNum) {
-    Rc = BlockMap (File, FileBlock, &DiskBlock);
+    Rc = BlockMap (File, FileBlock, &DiskBlock, NULL);
     if (Rc != 0) {
       return Rc;
     }
@@ -513,10 +773,14 @@ BufReadFile (
 /**
   Search a directory for a Name and return its inode number.
 
+  The directory entry lookup cache of the file system is checked first,
+  and the result of a directory scan is added to it.
+
   @param[in]      Name        Name to compare with
   @param[in]      Length      Length of the dir name
   @param[in/out]  File        Pointer to file private data
-  @param[out]     INumPtr     pointer to Inode number.
+  @param[in/out]  INumPtr     On input, inode number of the directory.
+                              On output, inode number of the Name.
 
   @retval 0 if success
   @retval other if error.
@@ -527,7 +791,7 @@ SearchDirectory (
   IN      CHAR8         *Name,
   IN      INT32          Length,
   IN OUT  OPEN_FILE     *File,
-  OUT     INODE32       *INumPtr
+  IN OUT  INODE32       *INumPtr
   )
 {
   FILE *Fp;
@@ -537,8 +801,20 @@ SearchDirectory (
   UINT32 BufSize;
   INT32 NameLen;
   RETURN_STATUS Status;
+  FS_DIR_CACHE *DirCache;
+  INODE32 DirINumber;
 
   Fp = (FILE *)File->FileSystemSpecificData;
+  DirCache = ((PEI_EXT_PRIVATE_DATA *)File->FileDevData)->DirCache;
+  DirINumber = *INumPtr;
+
+  Status = FsDirCacheLookup (DirCache, DirINumber, Name, Length, INumPtr);
+  if (Status != EFI_NO_MAPPING) {
+    if (!RETURN_ERROR (Status)) {
+      File->FileNamePtr = Name;
+    }
+    return Status;
+  }
 
   Fp->SeekPtr = 0;
   //
@@ -568,11 +844,13 @@ SearchDirectory (
         //
         *INumPtr = Dp->Ext2DirectInodeNumber;
         File->FileNamePtr = Name;
+        FsDirCacheInsert (DirCache, DirINumber, Name, Length, INumPtr);
         return 0;
       }
     }
     Fp->SeekPtr += BufSize;
   }
+  FsDirCacheInsert (DirCache, DirINumber, Name, Length, NULL);
   return EFI_NOT_FOUND;
 }
 
@@ -953,7 +1231,7 @@ Ext2fsOpen (
         INDPTR    DiskBlock;
 
         Buf = Fp->Buffer;
-        Status = BlockMap (File, (INDPTR)0, &DiskBlock);
+        Status = BlockMap (File, (INDPTR)0, &DiskBlock, NULL);
         if (RETURN_ERROR (Status)) {
           goto out;
         }
@@ -1044,6 +1322,9 @@ Ext2fsClose (
   if (Fp->Buffer) {
     FreePool (Fp->Buffer);
   }
+  if (Fp->RunCache) {
+    FreePool (Fp->RunCache);
+  }
   FreePool (Fp->SuperBlockPtr);
   FreePool (Fp);
   return RETURN_SUCCESS;
@@ -1089,13 +1370,18 @@ Ext2fsRead (
   )
 {
   FILE *Fp;
+  M_EXT2FS *FileSystem;
   UINT32 Csize;
   CHAR8 *Buf;
   UINT32 BufSize;
   CHAR8 *Address;
   RETURN_STATUS Status;
+  INDPTR DiskBlock;
+  UINT32 Blocks;
+  UINT32 Run;
 
   Fp = (FILE *)File->FileSystemSpecificData;
+  FileSystem = Fp->SuperBlockPtr;
   Status = RETURN_SUCCESS;
   Address = Start;
 
@@ -1107,17 +1393,53 @@ Ext2fsRead (
       break;
     }
 
-    Status = BufReadFile (File, &Buf, &BufSize);
-    if (RETURN_ERROR (Status)) {
-      break;
+    //
+    // Whole blocks are read straight into the caller's buffer, as many as are
+    // consecutive on the disk. Only the unaligned head and tail go through the
+    // file buffer.
+    //
+    Blocks = 0;
+    if (BLOCKOFFSET (FileSystem, Fp->SeekPtr) == 0) {
+      Blocks = Size >> FileSystem->Ext2FsLogicalBlock;
+      Run    = (Fp->DiskInode.Ext2DInodeSize - (UINT32)Fp->SeekPtr) >> FileSystem->Ext2FsLogicalBlock;
+      if (Blocks > Run) {
+        Blocks = Run;
+      }
     }
 
-    Csize = Size;
-    if (Csize > BufSize) {
-      Csize = BufSize;
-    }
+    if (Blocks > 0) {
+      Status = BlockMap (File, LBLKNO (FileSystem, Fp->SeekPtr), &DiskBlock, &Run);
+      if (RETURN_ERROR (Status)) {
+        break;
+      }
+      if (Blocks > Run) {
+        Blocks = Run;
+      }
+
+      Csize = LBLKTOSIZE (FileSystem, Blocks);
+      if (DiskBlock == 0) {
+        ZeroMem (Address, Csize);
+      } else {
+        Status = DEV_STRATEGY (File->DevPtr) (File->FileDevData, F_READ,
+                                          FSBTODB (FileSystem, DiskBlock),
+                                          Csize, Address, &BufSize);
+        if (RETURN_ERROR (Status)) {
+          break;
+        }
+      }
+    } else {
+      Status = BufReadFile (File, &Buf, &BufSize);
+      if (RETURN_ERROR (Status)) {
+        break;
+      }
+
+      Csize = Size;
+      if (Csize > BufSize) {
+        Csize = BufSize;
+      }
 
-    CopyMem (Address, Buf, Csize);
+      CopyMem (Address, Buf, Csize);
+    }
 
     Fp->SeekPtr += Csize;
     Address += Csize;
@@ -68,6 +68,7 @@
 #include <Library/BaseLib.h>
 #include <Library/PartitionLib.h>
 #include <Library/FileSystemLib.h>
+#include <Library/FsDirCacheLib.h>
 #include "Ext2FsDiNode.h"
 #include "Ext2FsDir.h"
 #include "LibsaFsStand.h"
@@ -329,6 +330,20 @@ typedef struct {
 
 typedef UINT32 INODE32;
 
+//
+//  Run of file blocks that are consecutive on the disk.
+//
+typedef struct {
+  UINT32            FileBlock;                // first file block of the run
+  UINT32            Length;                   // number of blocks in the run
+  INDPTR            DiskBlock;                // disk block of FileBlock, 0 for a hole
+} BLOCK_RUN;
+
+//
+//  Maximum number of runs cached per open file.
+//
+#define BLOCK_RUN_CACHE_SZ  1024
+
 //
 //  In-core open file.
 //
@@ -342,6 +357,8 @@ typedef struct {
   CHAR8             *Buffer;                  // buffer for data block
   UINT32            BufferSize;               // size of data block
   DADDRESS          BufferBlockNum;           // block number of data block
+  BLOCK_RUN         *RunCache;                // resolved runs sorted by FileBlock
+  UINT32            RunCount;                 // number of runs in RunCache
 } FILE;
 
 
@@ -424,6 +441,7 @@ typedef struct {
   UINT64               LastBlock;
   UINT32               BlockSize;
   UINT8                PhysicalDevNo;
+  FS_DIR_CACHE        *DirCache;
 } PEI_EXT_PRIVATE_DATA;
 
 /**
@@ -65,6 +65,11 @@ ExtInitFileSystem (
 
   DEBUG ((DEBUG_INFO, "Detected EXT on StartBlock %d Part %d\n", PrivateData->StartBlock, SwPart));
 
+  //
+  // The directory entry lookup cache is optional
+  //
+  FsDirCacheCreate (sizeof (INODE32), &PrivateData->DirCache);
+
   *FsHandle = (EFI_HANDLE)PrivateData;
 
   return EFI_SUCCESS;
@@ -99,6 +104,7 @@ ExtCloseFileSystem (
   }
 
   if (PrivateData != NULL && PrivateData->Signature == FS_EXT_SIGNATURE) {
+    FsDirCacheDestroy (PrivateData->DirCache);
     FreePool (PrivateData);
   }
 }
@@ -258,6 +264,62 @@ ExtFsReadFile (
   return EFI_SUCCESS;
 }
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+ExtFsReadFilePart (
+  IN  EFI_HANDLE                                  FsHandle,
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  )
+{
+  OPEN_FILE              *OpenFile;
+  FILE                   *Fp;
+  UINT32                  FileSize;
+  UINT32                  Residual;
+  EFI_STATUS              Status;
+
+  OpenFile = (OPEN_FILE *)FileHandle;
+  if ((OpenFile == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FileSize = Ext2fsFileSize (OpenFile);
+  if ((Offset > FileSize) || (Size > FileSize - Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Size == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Fp = (FILE *)OpenFile->FileSystemSpecificData;
+  Fp->SeekPtr = (OFFSET)Offset;
+
+  Residual = 0;
+  Status = Ext2fsRead (OpenFile, Buffer, (UINT32)Size, &Residual);
+  if (EFI_ERROR (Status) || (Residual != 0)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Close a file by opened file handle
 
@@ -88,6 +88,38 @@ GetNextFilePathNode (
   }
 }
 
+/**
+  Get the directory entry lookup cache key of a file path node.
+  FAT names are not case sensitive, so the key is the upper case name.
+
+  @param[in]     Node             The file path node.
+  @param[in]     NodeLen          The file path node length.
+  @param[out]    Key              Buffer for the key, FAT_LONG_NAME_LEN characters.
+
+  @retval        The key size in bytes, 0 if the node is too long.
+
+**/
+STATIC
+UINT32
+GetDirCacheKey (
+  IN  CHAR16 *Node,
+  IN  UINT32  NodeLen,
+  OUT CHAR16 *Key
+  )
+{
+  UINT32  Index;
+
+  if (NodeLen > FAT_LONG_NAME_LEN) {
+    return 0;
+  }
+
+  for (Index = 0; Index < NodeLen; Index++) {
+    Key[Index] = CharToUpper (Node[Index]);
+  }
+
+  return NodeLen * sizeof (CHAR16);
+}
+
 /**
   Finds a file on a FAT volume.
   This function finds the the file named FileName on a specified FAT volume and
@@ -121,6 +153,10 @@ FindFile (
   CHAR16        *NodeCurr;
   CHAR16        *NodeNext;
   UINT32         NodeLen;
+  CHAR16         Key[FAT_LONG_NAME_LEN];
+  UINT32         KeySize;
+  UINT64         DirId;
+  PEI_FAT_DIR_CACHE_DATA  CacheData;
 
   File = &PrivateData->File;
 
@@ -155,36 +191,75 @@ FindFile (
   while (NodeCurr != NULL) {
     NodeNext = GetNextFilePathNode (NodeCurr, &NodeLen);
     if (NodeLen > 0) {
-      do {
-        Status   = FatReadNextDirectoryEntry (
-                       PrivateData,
-                       &Parent,
-                       (NodeNext == NULL) ? 0 : FAT_ATTR_DIRECTORY,
-                       File
-                   );
-        if (Status == EFI_SUCCESS) {
-          //
-          // Compare whether the file name is matched.
-          //
-          if (EngStrniColl (NodeCurr, File->FileName, NodeLen)) {
-            if (NodeLen == ARRAY_SIZE (File->FileName)) {
-              break;
-            }
-            if ((NodeLen < ARRAY_SIZE (File->FileName)) && (File->FileName[NodeLen] == 0)) {
-              break;
-            }
-          }
+      //
+      // Look up the directory entry in the cache first
+      //
+      DirId   = LShiftU64 (VolumeIndex, 32) | Parent.StartingCluster;
+      KeySize = GetDirCacheKey (NodeCurr, NodeLen, Key);
+      Status  = EFI_NO_MAPPING;
+      if (KeySize > 0) {
+        Status = FsDirCacheLookup (PrivateData->DirCache, DirId, Key, KeySize, &CacheData);
+      }
 
-          if (EngStrniColl (NodeCurr, File->LongFileName, NodeLen)) {
-            if (NodeLen == ARRAY_SIZE (File->LongFileName)) {
-              break;
+      if (Status == EFI_SUCCESS) {
+        if ((NodeNext != NULL) && ((CacheData.Attributes & FAT_ATTR_DIRECTORY) == 0)) {
+          Status = EFI_NOT_FOUND;
+        } else {
+          ZeroMem (File, sizeof (PEI_FAT_FILE));
+          CopyMem (File->FileName, CacheData.FileName, sizeof (File->FileName));
+          File->Attributes      = CacheData.Attributes;
+          File->StartingCluster = CacheData.StartingCluster;
+          File->CurrentCluster  = CacheData.StartingCluster;
+          File->FileSize        = CacheData.FileSize;
+          File->Volume          = Parent.Volume;
+        }
+      } else if (Status == EFI_NO_MAPPING) {
+        do {
+          Status   = FatReadNextDirectoryEntry (
+                         PrivateData,
+                         &Parent,
+                         (NodeNext == NULL) ? 0 : FAT_ATTR_DIRECTORY,
+                         File
+                     );
+          if (Status == EFI_SUCCESS) {
+            //
+            // Compare whether the file name is matched.
+            //
+            if (EngStrniColl (NodeCurr, File->FileName, NodeLen)) {
+              if (NodeLen == ARRAY_SIZE (File->FileName)) {
+                break;
+              }
+              if ((NodeLen < ARRAY_SIZE (File->FileName)) && (File->FileName[NodeLen] == 0)) {
+                break;
+              }
             }
-            if ((NodeLen < ARRAY_SIZE (File->LongFileName)) && (File->LongFileName[NodeLen] == 0)) {
-              break;
+
+            if (EngStrniColl (NodeCurr, File->LongFileName, NodeLen)) {
+              if (NodeLen == ARRAY_SIZE (File->LongFileName)) {
+                break;
+              }
+              if ((NodeLen < ARRAY_SIZE (File->LongFileName)) && (File->LongFileName[NodeLen] == 0)) {
+                break;
+              }
             }
           }
+        } while (Status == EFI_SUCCESS);
+
+        if (KeySize > 0) {
+          if (!EFI_ERROR (Status)) {
+            CopyMem (CacheData.FileName, File->FileName, sizeof (CacheData.FileName));
+            CacheData.StartingCluster = File->StartingCluster;
+            CacheData.FileSize        = File->FileSize;
+            CacheData.Attributes      = File->Attributes;
+            FsDirCacheInsert (PrivateData->DirCache, DirId, Key, KeySize, &CacheData);
+          } else if ((Status == EFI_NOT_FOUND) && (NodeNext == NULL)) {
+            //
+            // Only a missing last node is known to be missing for any type
+            //
+            FsDirCacheInsert (PrivateData->DirCache, DirId, Key, KeySize, NULL);
+          }
         }
-      } while (Status == EFI_SUCCESS);
+      }
       if (EFI_ERROR (Status)) {
         return EFI_NOT_FOUND;
       } else {
@@ -252,6 +327,12 @@ FatInitFileSystem (
 
   PrivateData->Signature = FS_FAT_SIGNATURE;
 
+  Status = FatInitCache (PrivateData);
+  if (EFI_ERROR (Status)) {
+    FreePool (PrivateData);
+    return Status;
+  }
+
   // Add first hardware partition info
   FatBlockDevice = &PrivateData->BlockDevice[0];
   FatBlockDevice->FoundDevNo    = TRUE;
@@ -280,9 +361,14 @@ FatInitFileSystem (
 
   Status = FatGetVolumeData (PrivateData);
   if (EFI_ERROR (Status)) {
+    FatFreeCache (PrivateData);
     FreePool (PrivateData);
   } else {
     DEBUG ((DEBUG_INFO, "Detected FAT on HwDev %d Part %d\n",  PartBlockDev->HarewareDevice, SwPart));
+    //
+    // The directory entry lookup cache is optional
+    //
+    FsDirCacheCreate (sizeof (PEI_FAT_DIR_CACHE_DATA), &PrivateData->DirCache);
     *FsHandle = (EFI_HANDLE)PrivateData;
   }
 
@@ -312,6 +398,8 @@ FatCloseFileSystem (
   }
 
   if (PrivateData != NULL && PrivateData->Signature == FS_FAT_SIGNATURE) {
+    FsDirCacheDestroy (PrivateData->DirCache);
+    FatFreeCache (PrivateData);
     FreePool (PrivateData);
   }
 }
@@ -472,6 +560,72 @@ FatFsReadFile (
   return Status;
 }
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  @param[in]     FsHandle         file system handle.
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+
+**/
+EFI_STATUS
+EFIAPI
+FatFsReadFilePart (
+  IN  EFI_HANDLE                                  FsHandle,
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  )
+{
+  EFI_STATUS              Status;
+  PEI_FAT_FILE           *File;
+  PEI_FAT_PRIVATE_DATA   *PrivateData;
+
+  File = (PEI_FAT_FILE *)FileHandle;
+  PrivateData = (PEI_FAT_PRIVATE_DATA *)FsHandle;
+  if ((File == NULL) || (Buffer == NULL) || (PrivateData == NULL) || (PrivateData->Signature != FS_FAT_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Offset > File->FileSize) || (Size > File->FileSize - Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Size == 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Positions only move forward along the cluster chain, so restart from
+  // the first cluster to go backward.
+  //
+  if (Offset < File->CurrentPos) {
+    File->CurrentPos         = 0;
+    File->CurrentCluster     = File->StartingCluster;
+    File->StraightReadAmount = 0;
+    Status = FatSetFilePos (PrivateData, File, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (Offset > File->CurrentPos) {
+    Status = FatSetFilePos (PrivateData, File, (UINT32)Offset - File->CurrentPos);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return FatReadFile (PrivateData, File, Size, Buffer);
+}
+
 /**
   Close a file by opened file handle
 
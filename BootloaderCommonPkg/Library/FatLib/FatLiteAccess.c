@@ -294,6 +294,7 @@ FatSetFilePos (
   UINT32      Offset;
   UINT32      Cluster;
   UINT32      PrevCluster;
+  UINT32      Clusters;
 
   if (File->IsFixedRootDir) {
 
@@ -307,26 +308,52 @@ FatSetFilePos (
   } else {
 
     DivU64x32Remainder (File->CurrentPos, File->Volume->ClusterSize, &Offset);
-    AlignedPos = (UINT32) File->CurrentPos - (UINT32) Offset;
 
-    while
-    (
-      !FAT_CLUSTER_FUNCTIONAL (File->CurrentCluster) &&
-      AlignedPos + File->Volume->ClusterSize <= File->CurrentPos + Pos
-      ) {
-      AlignedPos += File->Volume->ClusterSize;
+    if ((Pos > 0) && (Pos <= File->StraightReadAmount)) {
+      //
+      // The position stays in the consecutive clusters found last time,
+      // so the cluster chain only needs to be followed at their end.
+      //
+      Clusters = (Offset + Pos) / File->Volume->ClusterSize;
+      if (Pos < File->StraightReadAmount) {
+        File->CurrentPos         += Pos;
+        File->CurrentCluster     += Clusters;
+        File->StraightReadAmount -= Pos;
+        return EFI_SUCCESS;
+      }
+
       Status = FatGetNextCluster (
                  PrivateData,
                  File->Volume,
-                 File->CurrentCluster,
+                 File->CurrentCluster + Clusters - 1,
                  &File->CurrentCluster
                  );
       if (EFI_ERROR (Status)) {
         return EFI_DEVICE_ERROR;
       }
+    } else {
+      AlignedPos = (UINT32) File->CurrentPos - (UINT32) Offset;
+
+      while
+      (
+        !FAT_CLUSTER_FUNCTIONAL (File->CurrentCluster) &&
+        AlignedPos + File->Volume->ClusterSize <= File->CurrentPos + Pos
+        ) {
+        AlignedPos += File->Volume->ClusterSize;
+        Status = FatGetNextCluster (
+                   PrivateData,
+                   File->Volume,
+                   File->CurrentCluster,
+                   &File->CurrentCluster
+                   );
+        if (EFI_ERROR (Status)) {
+          return EFI_DEVICE_ERROR;
+        }
+      }
     }
 
     if (FAT_CLUSTER_FUNCTIONAL (File->CurrentCluster)) {
+      File->StraightReadAmount = 0;
       return EFI_INVALID_PARAMETER;
     }
 
@@ -418,6 +445,18 @@ FatReadFile (
       DivU64x32Remainder (File->CurrentPos, File->Volume->ClusterSize, &Offset);
       PhysicalAddr  = File->Volume->FirstClusterPos + MultU64x32 (File->Volume->ClusterSize, File->CurrentCluster - 2);
 
+      //
+      // StraightReadAmount covers all the consecutive clusters from CurrentPos,
+      // so each run of clusters is read in one go. It is 0 when the run is not
+      // known yet, e.g. for a file just found in its parent directory, and past
+      // the last cluster.
+      //
+      if (File->StraightReadAmount == 0) {
+        Status = FatSetFilePos (PrivateData, File, 0);
+        if (EFI_ERROR (Status) || (File->StraightReadAmount == 0)) {
+          return EFI_DEVICE_ERROR;
+        }
+      }
       Amount        = File->StraightReadAmount;
       Amount        = Size > Amount ? Amount : Size;
       Status = FatReadDisk (
@@ -136,9 +136,149 @@ FatReadBlock (
 }
 
 
+/**
+  Allocate and initialize the block cache.
+
+  The number of cache buffers is given by PcdFatCacheEntries.
+
+  @param  PrivateData           Global memory map for accessing global variables
+
+  @retval EFI_SUCCESS           The cache is ready.
+  @retval EFI_OUT_OF_RESOURCES  The cache could not be allocated.
+
+**/
+EFI_STATUS
+FatInitCache (
+  IN  PEI_FAT_PRIVATE_DATA   *PrivateData
+  )
+{
+  UINT32                Index;
+  UINT32                HashSize;
+
+  PrivateData->CacheCount = PcdGet32 (PcdFatCacheEntries);
+  if (PrivateData->CacheCount < 2) {
+    PrivateData->CacheCount = 2;
+  }
+
+  HashSize = GetPowerOfTwo32 (PrivateData->CacheCount);
+  if (HashSize < PrivateData->CacheCount) {
+    HashSize <<= 1;
+  }
+  PrivateData->CacheHashMask = HashSize - 1;
+
+  PrivateData->CacheBuffer = AllocateZeroPool (PrivateData->CacheCount * sizeof (PEI_FAT_CACHE_BUFFER));
+  PrivateData->CacheHash   = AllocatePool (HashSize * sizeof (UINT32));
+  if ((PrivateData->CacheBuffer == NULL) || (PrivateData->CacheHash == NULL)) {
+    FatFreeCache (PrivateData);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem32 (PrivateData->CacheHash, HashSize * sizeof (UINT32), PEI_FAT_CACHE_NONE);
+
+  //
+  // All buffers start invalid in the LRU list, so they get used first.
+  //
+  for (Index = 0; Index < PrivateData->CacheCount; Index++) {
+    PrivateData->CacheBuffer[Index].HashNext = PEI_FAT_CACHE_NONE;
+    PrivateData->CacheBuffer[Index].LruPrev  = (Index == 0) ? PEI_FAT_CACHE_NONE : Index - 1;
+    PrivateData->CacheBuffer[Index].LruNext  = (Index == PrivateData->CacheCount - 1) ? PEI_FAT_CACHE_NONE : Index + 1;
+  }
+  PrivateData->LruHead = 0;
+  PrivateData->LruTail = PrivateData->CacheCount - 1;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the block cache.
+
+  @param  PrivateData           Global memory map for accessing global variables
+
+**/
+VOID
+FatFreeCache (
+  IN  PEI_FAT_PRIVATE_DATA   *PrivateData
+  )
+{
+  if (PrivateData->CacheBuffer != NULL) {
+    FreePool (PrivateData->CacheBuffer);
+    PrivateData->CacheBuffer = NULL;
+  }
+  if (PrivateData->CacheHash != NULL) {
+    FreePool (PrivateData->CacheHash);
+    PrivateData->CacheHash = NULL;
+  }
+  PrivateData->CacheCount = 0;
+}
+
+/**
+  Get the hash bucket of a cache line.
+
+  @param  PrivateData       the global memory map.
+  @param  BlockDeviceNo     the Block device.
+  @param  Lba               the first Logical Block Address of the line
+
+  @return Pointer to the bucket holding the index of its first cache buffer.
+
+**/
+STATIC
+UINT32 *
+FatCacheBucket (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  UINTN                 BlockDeviceNo,
+  IN  UINT64                Lba
+  )
+{
+  UINT32                Hash;
+
+  //
+  // Consecutive lines go to consecutive buckets
+  //
+  Hash = (UINT32) DivU64x32 (Lba, PEI_FAT_CACHE_LINE_SIZE / PrivateData->BlockDevice[BlockDeviceNo].BlockSize);
+  Hash ^= (UINT32) BlockDeviceNo * 0x9E3779B1;
+  return &PrivateData->CacheHash[Hash & PrivateData->CacheHashMask];
+}
+
+/**
+  Move a cache buffer to the most recently used end of the LRU list.
+
+  @param  PrivateData       the global memory map.
+  @param  Index             the cache buffer index.
+
+**/
+STATIC
+VOID
+FatCacheTouch (
+  IN  PEI_FAT_PRIVATE_DATA  *PrivateData,
+  IN  UINT32                Index
+  )
+{
+  PEI_FAT_CACHE_BUFFER  *CacheBuffer;
+
+  if (PrivateData->LruHead == Index) {
+    return;
+  }
+
+  CacheBuffer = &PrivateData->CacheBuffer[Index];
+  PrivateData->CacheBuffer[CacheBuffer->LruPrev].LruNext = CacheBuffer->LruNext;
+  if (CacheBuffer->LruNext != PEI_FAT_CACHE_NONE) {
+    PrivateData->CacheBuffer[CacheBuffer->LruNext].LruPrev = CacheBuffer->LruPrev;
+  } else {
+    PrivateData->LruTail = CacheBuffer->LruPrev;
+  }
+
+  CacheBuffer->LruPrev = PEI_FAT_CACHE_NONE;
+  CacheBuffer->LruNext = PrivateData->LruHead;
+  PrivateData->CacheBuffer[PrivateData->LruHead].LruPrev = Index;
+  PrivateData->LruHead = Index;
+}
+
 /**
   Find a cache block designated to specific Block device and Lba.
-  If not found, invalidate an oldest one and use it. (LRU cache)
+  If not found, invalidate the least recently used one and use it. (LRU cache)
+
+  A cache buffer holds a line of PEI_FAT_CACHE_LINE_SIZE bytes aligned to
+  its size, so a miss reads the blocks around Lba in the same I/O.
 
   @param  PrivateData       the global memory map.
   @param  BlockDeviceNo     the Block device.
@@ -159,54 +299,71 @@ FatGetCacheBlock (
   )
 {
   EFI_STATUS            Status;
+  PEI_FAT_BLOCK_DEVICE  *BlockDev;
   PEI_FAT_CACHE_BUFFER  *CacheBuffer;
-  INTN                  Index;
-  STATIC UINT8          Seed;
-
-  Status      = EFI_SUCCESS;
-  CacheBuffer = NULL;
+  UINT32                *Bucket;
+  UINT32                *Link;
+  UINT32                Index;
+  UINT32                LineBlocks;
+  UINT32                Offset;
+  UINT64                LineLba;
 
   //
-  // go through existing cache buffers
+  // Current device ID should be less than maximum device ID.
   //
-  for (Index = 0; Index < PEI_FAT_CACHE_SIZE; Index++) {
-    CacheBuffer = & (PrivateData->CacheBuffer[Index]);
-    if (CacheBuffer->Valid && CacheBuffer->BlockDeviceNo == BlockDeviceNo && CacheBuffer->Lba == Lba) {
-      break;
-    }
+  if (BlockDeviceNo >= PEI_FAT_MAX_BLOCK_DEVICE) {
+    return EFI_DEVICE_ERROR;
   }
 
-  if (Index < PEI_FAT_CACHE_SIZE) {
-    *CachePtr = (CHAR8 *) CacheBuffer->Buffer;
-    return EFI_SUCCESS;
+  BlockDev   = &PrivateData->BlockDevice[BlockDeviceNo];
+  if (Lba > BlockDev->LastBlock) {
+    return EFI_DEVICE_ERROR;
   }
+
+  LineBlocks = PEI_FAT_CACHE_LINE_SIZE / BlockDev->BlockSize;
+  DivU64x32Remainder (Lba, LineBlocks, &Offset);
+  LineLba    = Lba - Offset;
+
   //
-  // We have to find an invalid cache buffer
+  // go through the cache buffers in the same hash bucket
   //
-  for (Index = 0; Index < PEI_FAT_CACHE_SIZE; Index++) {
-    if (!PrivateData->CacheBuffer[Index].Valid) {
-      break;
+  Bucket = FatCacheBucket (PrivateData, BlockDeviceNo, LineLba);
+  for (Index = *Bucket; Index != PEI_FAT_CACHE_NONE; Index = CacheBuffer->HashNext) {
+    CacheBuffer = &PrivateData->CacheBuffer[Index];
+    if (CacheBuffer->BlockDeviceNo == BlockDeviceNo && CacheBuffer->Lba == LineLba) {
+      FatCacheTouch (PrivateData, Index);
+      *CachePtr = (CHAR8 *) CacheBuffer->Buffer + Offset * BlockDev->BlockSize;
+      return EFI_SUCCESS;
     }
   }
+
   //
-  // Use the cache buffer
+  // Reuse the least recently used cache buffer
   //
-  if (Index == PEI_FAT_CACHE_SIZE) {
-    Index = (Seed++) % PEI_FAT_CACHE_SIZE;
+  Index       = PrivateData->LruTail;
+  CacheBuffer = &PrivateData->CacheBuffer[Index];
+  if (CacheBuffer->Valid) {
+    Link = FatCacheBucket (PrivateData, CacheBuffer->BlockDeviceNo, CacheBuffer->Lba);
+    while (*Link != Index) {
+      Link = &PrivateData->CacheBuffer[*Link].HashNext;
+    }
+    *Link = CacheBuffer->HashNext;
+    CacheBuffer->Valid = FALSE;
   }
 
   //
-  // Current device ID should be less than maximum device ID.
+  // Make it the most recently used one first, a logical block device reads
+  // through the cache of its parent device.
   //
-  if (BlockDeviceNo >= PEI_FAT_MAX_BLOCK_DEVICE) {
-    return EFI_DEVICE_ERROR;
-  }
+  FatCacheTouch (PrivateData, Index);
 
-  CacheBuffer                 = & (PrivateData->CacheBuffer[Index]);
+  if (LineLba + LineBlocks - 1 > BlockDev->LastBlock) {
+    LineBlocks = (UINT32) (BlockDev->LastBlock - LineLba + 1);
+  }
 
   CacheBuffer->BlockDeviceNo  = BlockDeviceNo;
-  CacheBuffer->Lba            = Lba;
-  CacheBuffer->Size           = PrivateData->BlockDevice[BlockDeviceNo].BlockSize;
+  CacheBuffer->Lba            = LineLba;
+  CacheBuffer->Size           = LineBlocks * BlockDev->BlockSize;
 
   //
   // Read in the data
@@ -214,7 +371,7 @@ FatGetCacheBlock (
   Status = FatReadBlock (
              PrivateData,
              BlockDeviceNo,
-             Lba,
+             LineLba,
              CacheBuffer->Size,
              CacheBuffer->Buffer
              );
@@ -222,8 +379,10 @@ FatGetCacheBlock (
     return EFI_DEVICE_ERROR;
   }
 
-  CacheBuffer->Valid  = TRUE;
-  *CachePtr           = (CHAR8 *) CacheBuffer->Buffer;
+  CacheBuffer->Valid    = TRUE;
+  CacheBuffer->HashNext = *Bucket;
+  *Bucket               = Index;
+  *CachePtr             = (CHAR8 *) CacheBuffer->Buffer + Offset * BlockDev->BlockSize;
 
   return Status;
 }
@@ -265,25 +424,28 @@ FatReadDisk (
   BlockSize = PrivateData->BlockDevice[BlockDeviceNo].BlockSize;
 
   //
-  // Read underrun
+  // Read underrun, a read starting on a block boundary goes to the device
+  // directly with the aligned parts.
   //
   Lba     = DivU64x32Remainder (StartingAddress, BlockSize, &Offset);
-  Status  = FatGetCacheBlock (PrivateData, BlockDeviceNo, Lba, &CachePtr);
-  if (EFI_ERROR (Status)) {
-    return EFI_DEVICE_ERROR;
-  }
+  if ((Offset != 0) || (Size < BlockSize)) {
+    Status  = FatGetCacheBlock (PrivateData, BlockDeviceNo, Lba, &CachePtr);
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
 
-  Amount = Size < (BlockSize - Offset) ? Size : (BlockSize - Offset);
-  CopyMem (BufferPtr, CachePtr + Offset, Amount);
+    Amount = Size < (BlockSize - Offset) ? Size : (BlockSize - Offset);
+    CopyMem (BufferPtr, CachePtr + Offset, Amount);
 
-  if (Size == Amount) {
-    return EFI_SUCCESS;
-  }
+    if (Size == Amount) {
+      return EFI_SUCCESS;
+    }
 
-  Size -= Amount;
-  BufferPtr += Amount;
-  StartingAddress += Amount;
-  Lba += 1;
+    Size -= Amount;
+    BufferPtr += Amount;
+    StartingAddress += Amount;
+    Lba += 1;
+  }
 
   //
   // Read aligned parts
@@ -19,6 +19,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <BlockDevice.h>
 #include <Library/MediaAccessLib.h>
+#include <Library/FsDirCacheLib.h>
 
 #include "FatLiteApi.h"
 #include "FatLiteFmt.h"
@@ -26,8 +27,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // Definitions
 //
-#define PEI_FAT_CACHE_SIZE                            4
 #define PEI_FAT_MAX_BLOCK_SIZE                        8192
+#define PEI_FAT_CACHE_LINE_SIZE                       PEI_FAT_MAX_BLOCK_SIZE
+#define PEI_FAT_CACHE_NONE                            MAX_UINT32
 #define FAT_MAX_FILE_NAME_LENGTH                      128
 #define PEI_FAT_MAX_BLOCK_DEVICE                      64
 #define PEI_FAT_MAX_BLOCK_IO_PPI                      32
@@ -94,15 +96,30 @@ typedef struct {
   UINT32          FileSize;
 } PEI_FAT_FILE;
 
+//
+// Directory entry lookup cache data
+// It holds what is needed to rebuild the PEI_FAT_FILE of a sub file.
+//
+typedef struct {
+  CHAR16          FileName[FAT_NAME_LEN + 2];
+  UINT32          StartingCluster;
+  UINT32          FileSize;
+  UINT8           Attributes;
+} PEI_FAT_DIR_CACHE_DATA;
+
 //
 // Cache Buffer
+// Each buffer holds a line of consecutive blocks starting at Lba, so that a
+// miss in the FAT table reads ahead the following FAT entries as well.
 //
 typedef struct {
   BOOLEAN Valid;
   UINTN   BlockDeviceNo;
   UINT64  Lba;
-  UINT32  Lru;
-  UINT64  Buffer[PEI_FAT_MAX_BLOCK_SIZE / 8];
+  UINT32  HashNext;
+  UINT32  LruPrev;
+  UINT32  LruNext;
+  UINT64  Buffer[PEI_FAT_CACHE_LINE_SIZE / 8];
   UINTN   Size;
 } PEI_FAT_CACHE_BUFFER;
 
@@ -176,7 +193,21 @@ typedef struct {
   UINTN                               VolumeCount;
   PEI_FAT_VOLUME                      Volume[PEI_FAT_MAX_VOLUME];
   PEI_FAT_FILE                        File;
-  PEI_FAT_CACHE_BUFFER                CacheBuffer[PEI_FAT_CACHE_SIZE];
+  //
+  // Cache buffers, hashed by Lba and kept in a list from the most recently
+  // used (LruHead) to the least recently used (LruTail) one.
+  //
+  PEI_FAT_CACHE_BUFFER                *CacheBuffer;
+  UINT32                              CacheCount;
+  UINT32                              *CacheHash;
+  UINT32                              CacheHashMask;
+  UINT32                              LruHead;
+  UINT32                              LruTail;
+  //
+  // Directory entries found or missing, keyed by the starting cluster of
+  // the parent directory and the upper case name.
+  //
+  FS_DIR_CACHE                        *DirCache;
 } PEI_FAT_PRIVATE_DATA;
 
 
@@ -235,6 +266,33 @@ EngStrniColl (
   IN UINT32                  Len
   );
 
+/**
+  Allocate and initialize the block cache.
+
+  The number of cache buffers is given by PcdFatCacheEntries.
+
+  @param  PrivateData           Global memory map for accessing global variables
+
+  @retval EFI_SUCCESS           The cache is ready.
+  @retval EFI_OUT_OF_RESOURCES  The cache could not be allocated.
+
+**/
+EFI_STATUS
+FatInitCache (
+  IN  PEI_FAT_PRIVATE_DATA   *PrivateData
+  );
+
+/**
+  Free the block cache.
+
+  @param  PrivateData           Global memory map for accessing global variables
+
+**/
+VOID
+FatFreeCache (
+  IN  PEI_FAT_PRIVATE_DATA   *PrivateData
+  );
+
 /**
   Reads a block of data from the block device by calling
   underlying Block I/O service.
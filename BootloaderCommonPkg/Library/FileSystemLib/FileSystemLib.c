@@ -55,6 +55,7 @@ RegisterFileSystems (
       mFileSystemFuncs[FsType].ReadFile         = FatFsReadFile;
       mFileSystemFuncs[FsType].CloseFile        = FatFsCloseFile;
       mFileSystemFuncs[FsType].ListDir          = FatFsListDir;
+      mFileSystemFuncs[FsType].ReadFilePart     = FatFsReadFilePart;
     }
 
     FsType = EnumFileSystemTypeExt2;
@@ -66,6 +67,7 @@ RegisterFileSystems (
       mFileSystemFuncs[FsType].ReadFile         = ExtFsReadFile;
       mFileSystemFuncs[FsType].CloseFile        = ExtFsCloseFile;
       mFileSystemFuncs[FsType].ListDir          = ExtFsListDir;
+      mFileSystemFuncs[FsType].ReadFilePart     = ExtFsReadFilePart;
     }
     mFileSystemRegistered = TRUE;
   }
@@ -417,6 +419,60 @@ ReadFile (
   return mFileSystemFuncs[FsType].ReadFile (FileSystemControlBlock->FsHandle, FileControlBlock->FileHandle, FileBuffer, FileSize);
 }
 
+/**
+  Read a part of a file into memory by opened file handle.
+
+  It allows to read the parts of a file to different places, for example a
+  file header first and then the data it describes to its final address.
+
+  @param[in]     FileHandle       file handle
+  @param[in]     Offset           Offset in the file to read from.
+  @param[in]     Size             Number of bytes to read.
+  @param[out]    Buffer           Buffer to receive the data.
+
+  @retval EFI_SUCCESS             The data was read correctly.
+  @retval EFI_INVALID_PARAMETER   Parameter is not valid, or the part is beyond the file end.
+  @retval EFI_DEVICE_ERROR        A device error occurred.
+  @retval EFI_UNSUPPORTED         The file system does not support it.
+
+**/
+EFI_STATUS
+EFIAPI
+ReadFilePart (
+  IN  EFI_HANDLE                                  FileHandle,
+  IN  UINTN                                       Offset,
+  IN  UINTN                                       Size,
+  OUT VOID                                       *Buffer
+  )
+{
+  OS_FILE_SYSTEM_TYPE         FsType;
+  FILE_SYSTEM_CONTROL_BLOCK  *FileSystemControlBlock;
+  FILE_CONTROL_BLOCK         *FileControlBlock;
+
+  ASSERT (FileHandle != NULL);
+  if ((FileHandle == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FileControlBlock = (FILE_CONTROL_BLOCK *)FileHandle;
+  ASSERT (FileControlBlock->Signature == FILE_CB_SIGNATURE);
+
+  FileSystemControlBlock = (FILE_SYSTEM_CONTROL_BLOCK *)FileControlBlock->FileSystemControlBlock;
+  ASSERT (FileSystemControlBlock->Signature == FILE_SYSTEM_CB_SIGNATURE);
+
+  FsType = GetFileSystemType (FileSystemControlBlock);
+  if (FsType >= EnumFileSystemTypeAuto) {
+    return EFI_NOT_READY;
+  }
+
+  if (mFileSystemFuncs[FsType].ReadFilePart == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return mFileSystemFuncs[FsType].ReadFilePart (FileSystemControlBlock->FsHandle, FileControlBlock->FileHandle,
+                                                Offset, Size, Buffer);
+}
+
 /**
   Close a file by opened file handle
 
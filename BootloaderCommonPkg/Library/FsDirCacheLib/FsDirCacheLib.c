@@ -0,0 +1,301 @@
+/** @file
+  Directory entry lookup cache shared by the file system backends.
+
+Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/FsDirCacheLib.h>
+#include <Library/PcdLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#define FS_DIR_CACHE_NAME_SIZE    128
+#define FS_DIR_CACHE_NONE         0xFFFF
+
+typedef struct {
+  UINT64                DirId;
+  UINT32                Hash;
+  UINT32                LastUse;
+  UINT16                HashNext;
+  UINT16                NameSize;
+  BOOLEAN               Missing;
+  UINT8                 Name[FS_DIR_CACHE_NAME_SIZE];
+} FS_DIR_CACHE_ENTRY;
+
+struct _FS_DIR_CACHE {
+  UINT32                DataSize;
+  UINT32                EntryCount;
+  UINT32                UsedCount;
+  UINT32                HashMask;
+  UINT32                Tick;
+  UINT16               *HashHead;
+  FS_DIR_CACHE_ENTRY   *Entry;
+  UINT8                *Data;
+};
+
+/**
+  Calculate the hash of a name in a directory.
+
+  @param[in]     DirId            Identifier of the directory.
+  @param[in]     Name             Name to hash.
+  @param[in]     NameSize         Size of the name in bytes.
+
+  @retval        The hash value.
+
+**/
+STATIC
+UINT32
+DirCacheHash (
+  IN  UINT64                                      DirId,
+  IN  CONST UINT8                                *Name,
+  IN  UINT32                                      NameSize
+  )
+{
+  UINT32    Hash;
+  UINT32    Index;
+
+  //
+  // FNV-1a
+  //
+  Hash = 0x811C9DC5;
+  for (Index = 0; Index < sizeof (DirId); Index++) {
+    Hash = (Hash ^ (UINT8)RShiftU64 (DirId, Index * 8)) * 0x01000193;
+  }
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Name[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Find the cache entry of a name in a directory.
+
+  @param[in]     DirCache         Cache to search.
+  @param[in]     DirId            Identifier of the directory.
+  @param[in]     Name             Name to find.
+  @param[in]     NameSize         Size of the name in bytes.
+  @param[in]     Hash             Hash of the name.
+
+  @retval        Index of the entry, FS_DIR_CACHE_NONE if not found.
+
+**/
+STATIC
+UINT16
+DirCacheFind (
+  IN  FS_DIR_CACHE                               *DirCache,
+  IN  UINT64                                      DirId,
+  IN  CONST VOID                                 *Name,
+  IN  UINT32                                      NameSize,
+  IN  UINT32                                      Hash
+  )
+{
+  UINT16                Index;
+  FS_DIR_CACHE_ENTRY   *Entry;
+
+  Index = DirCache->HashHead[Hash & DirCache->HashMask];
+  while (Index != FS_DIR_CACHE_NONE) {
+    Entry = &DirCache->Entry[Index];
+    if ((Entry->Hash == Hash) && (Entry->DirId == DirId) && (Entry->NameSize == NameSize) &&
+        (CompareMem (Entry->Name, Name, NameSize) == 0)) {
+      break;
+    }
+    Index = Entry->HashNext;
+  }
+
+  return Index;
+}
+
+/**
+  Create a directory entry lookup cache for a mounted file system.
+
+  The number of entries is set by PcdFsDirCacheEntries.
+
+  @param[in]     DataSize         Size of the data kept for each name.
+  @param[out]    DirCache         Pointer to the created cache.
+
+  @retval EFI_SUCCESS             The cache was created.
+  @retval EFI_UNSUPPORTED         The cache is disabled.
+  @retval EFI_OUT_OF_RESOURCES    Insufficant memory resource pool.
+
+**/
+EFI_STATUS
+EFIAPI
+FsDirCacheCreate (
+  IN  UINT32                                      DataSize,
+  OUT FS_DIR_CACHE                              **DirCache
+  )
+{
+  FS_DIR_CACHE         *Cache;
+  UINT32                EntryCount;
+  UINT32                HashCount;
+
+  *DirCache  = NULL;
+  EntryCount = MIN (FixedPcdGet32 (PcdFsDirCacheEntries), FS_DIR_CACHE_NONE);
+  if (EntryCount == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  HashCount = GetPowerOfTwo32 (EntryCount);
+  if (HashCount < EntryCount) {
+    HashCount <<= 1;
+  }
+
+  Cache = (FS_DIR_CACHE *) AllocateZeroPool (sizeof (FS_DIR_CACHE) + HashCount * sizeof (UINT16) +
+                                             EntryCount * (sizeof (FS_DIR_CACHE_ENTRY) + DataSize));
+  if (Cache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cache->DataSize   = DataSize;
+  Cache->EntryCount = EntryCount;
+  Cache->HashMask   = HashCount - 1;
+  Cache->Entry      = (FS_DIR_CACHE_ENTRY *) (Cache + 1);
+  Cache->HashHead   = (UINT16 *) (Cache->Entry + EntryCount);
+  Cache->Data       = (UINT8 *) (Cache->HashHead + HashCount);
+  SetMem16 (Cache->HashHead, HashCount * sizeof (UINT16), FS_DIR_CACHE_NONE);
+
+  *DirCache = Cache;
+  return EFI_SUCCESS;
+}
+
+/**
+  Free a directory entry lookup cache.
+
+  @param[in]     DirCache         Cache to free, could be NULL.
+
+**/
+VOID
+EFIAPI
+FsDirCacheDestroy (
+  IN  FS_DIR_CACHE                               *DirCache
+  )
+{
+  if (DirCache != NULL) {
+    FreePool (DirCache);
+  }
+}
+
+/**
+  Look up a name of a directory in the cache.
+
+  @param[in]     DirCache         Cache to look up, could be NULL.
+  @param[in]     DirId            Backend specific identifier of the directory.
+  @param[in]     Name             Name to look up.
+  @param[in]     NameSize         Size of the name in bytes.
+  @param[out]    Data             Buffer for the data kept for the name.
+
+  @retval EFI_SUCCESS             The name was found, its data is returned.
+  @retval EFI_NOT_FOUND           The name is known to be missing.
+  @retval EFI_NO_MAPPING          The name is not in the cache.
+
+**/
+EFI_STATUS
+EFIAPI
+FsDirCacheLookup (
+  IN  FS_DIR_CACHE                               *DirCache,
+  IN  UINT64                                      DirId,
+  IN  CONST VOID                                 *Name,
+  IN  UINT32                                      NameSize,
+  OUT VOID                                       *Data
+  )
+{
+  UINT16                Index;
+  FS_DIR_CACHE_ENTRY   *Entry;
+
+  if ((DirCache == NULL) || (NameSize > FS_DIR_CACHE_NAME_SIZE)) {
+    return EFI_NO_MAPPING;
+  }
+
+  Index = DirCacheFind (DirCache, DirId, Name, NameSize, DirCacheHash (DirId, Name, NameSize));
+  if (Index == FS_DIR_CACHE_NONE) {
+    return EFI_NO_MAPPING;
+  }
+
+  Entry = &DirCache->Entry[Index];
+  Entry->LastUse = ++DirCache->Tick;
+  if (Entry->Missing) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Data, DirCache->Data + Index * DirCache->DataSize, DirCache->DataSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Add a name of a directory to the cache.
+
+  The least recently used entry is replaced when the cache is full.
+  Names too long for the cache are ignored.
+
+  @param[in]     DirCache         Cache to update, could be NULL.
+  @param[in]     DirId            Backend specific identifier of the directory.
+  @param[in]     Name             Name to add.
+  @param[in]     NameSize         Size of the name in bytes.
+  @param[in]     Data             Data for the name, NULL if the name is missing.
+
+**/
+VOID
+EFIAPI
+FsDirCacheInsert (
+  IN  FS_DIR_CACHE                               *DirCache,
+  IN  UINT64                                      DirId,
+  IN  CONST VOID                                 *Name,
+  IN  UINT32                                      NameSize,
+  IN  CONST VOID                                 *Data        OPTIONAL
+  )
+{
+  UINT32                Hash;
+  UINT16                Index;
+  UINT16                Search;
+  UINT16               *Link;
+  FS_DIR_CACHE_ENTRY   *Entry;
+
+  if ((DirCache == NULL) || (NameSize > FS_DIR_CACHE_NAME_SIZE)) {
+    return;
+  }
+
+  Hash  = DirCacheHash (DirId, Name, NameSize);
+  Index = DirCacheFind (DirCache, DirId, Name, NameSize, Hash);
+  if (Index == FS_DIR_CACHE_NONE) {
+    if (DirCache->UsedCount < DirCache->EntryCount) {
+      Index = (UINT16)DirCache->UsedCount++;
+    } else {
+      //
+      // Replace the least recently used entry
+      //
+      Index = 0;
+      for (Search = 1; Search < DirCache->EntryCount; Search++) {
+        if ((DirCache->Tick - DirCache->Entry[Search].LastUse) > (DirCache->Tick - DirCache->Entry[Index].LastUse)) {
+          Index = Search;
+        }
+      }
+
+      Entry = &DirCache->Entry[Index];
+      Link  = &DirCache->HashHead[Entry->Hash & DirCache->HashMask];
+      while (*Link != Index) {
+        Link = &DirCache->Entry[*Link].HashNext;
+      }
+      *Link = Entry->HashNext;
+    }
+
+    Entry = &DirCache->Entry[Index];
+    Entry->DirId    = DirId;
+    Entry->Hash     = Hash;
+    Entry->NameSize = (UINT16)NameSize;
+    CopyMem (Entry->Name, Name, NameSize);
+    Entry->HashNext = DirCache->HashHead[Hash & DirCache->HashMask];
+    DirCache->HashHead[Hash & DirCache->HashMask] = Index;
+  }
+
+  Entry = &DirCache->Entry[Index];
+  Entry->LastUse = ++DirCache->Tick;
+  Entry->Missing = (BOOLEAN)(Data == NULL);
+  if (Data != NULL) {
+    CopyMem (DirCache->Data + Index * DirCache->DataSize, Data, DirCache->DataSize);
+  }
+}
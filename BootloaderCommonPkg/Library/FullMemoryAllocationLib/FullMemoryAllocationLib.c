@@ -8,6 +8,91 @@
 
 #include <Imem.h>
 #include <Library/BlMemoryAllocationLib.h>
+#include <Library/BootloaderCommonLib.h>
+#include <Library/PcdLib.h>
+
+STATIC ALLOC_TRACE_INFO  *mAllocTraceInfo = NULL;
+
+/**
+  Get the memory allocation trace table.
+
+  The table is allocated from the page pool on the first use, outside of the
+  traced allocation functions.
+
+  @retval   The trace table, or NULL if the allocations are not traced.
+
+**/
+ALLOC_TRACE_INFO *
+EFIAPI
+GetAllocTraceInfo (
+  VOID
+  )
+{
+  EFI_STATUS             Status;
+  EFI_PHYSICAL_ADDRESS   Memory;
+  UINTN                  Size;
+
+  if (FixedPcdGet32 (PcdAllocTraceEntries) == 0) {
+    return NULL;
+  }
+
+  if (mAllocTraceInfo == NULL) {
+    Size   = sizeof (ALLOC_TRACE_INFO) + FixedPcdGet32 (PcdAllocTraceEntries) * sizeof (ALLOC_TRACE_ENTRY);
+    Status = CoreAllocatePages (AllocateAnyPages, EfiBootServicesData, EFI_SIZE_TO_PAGES (Size), &Memory);
+    if (!EFI_ERROR (Status)) {
+      mAllocTraceInfo = (ALLOC_TRACE_INFO *)(UINTN)Memory;
+      AllocTraceInit (mAllocTraceInfo, FixedPcdGet32 (PcdAllocTraceEntries));
+      mAllocTraceInfo->Anchor[LOADER_STAGE_PAYLOAD] = (UINT32)(UINTN)AllocatePool;
+    }
+  }
+
+  return mAllocTraceInfo;
+}
+
+/**
+  Record a memory allocation in the trace table.
+
+  @param[in]  Caller    Return address of the allocation call.
+  @param[in]  Buffer    The allocated buffer.
+  @param[in]  Size      The allocated size in bytes.
+  @param[in]  Type      ALLOC_TRACE_TYPE_* of the allocation.
+
+  @retval     The allocated buffer.
+
+**/
+STATIC
+VOID *
+TraceAllocation (
+  IN VOID     *Caller,
+  IN VOID     *Buffer,
+  IN UINTN     Size,
+  IN UINT8     Type
+  )
+{
+  if ((FixedPcdGet32 (PcdAllocTraceEntries) > 0) && (Buffer != NULL)) {
+    AllocTraceAdd (GetAllocTraceInfo (), Caller, Buffer, Size, Type, LOADER_STAGE_PAYLOAD);
+  }
+  return Buffer;
+}
+
+/**
+  Remove a freed memory allocation from the trace table.
+
+  @param[in]  Buffer    The freed buffer.
+  @param[in]  Type      ALLOC_TRACE_TYPE_* of the allocation.
+
+**/
+STATIC
+VOID
+TraceFree (
+  IN VOID     *Buffer,
+  IN UINT8     Type
+  )
+{
+  if (mAllocTraceInfo != NULL) {
+    AllocTraceRemove (mAllocTraceInfo, Type, Buffer, 1);
+  }
+}
 
 /**
   Add system memory resource for allocation.
@@ -91,7 +176,8 @@ AllocatePages (
   IN UINTN  Pages
   )
 {
-  return InternalAllocatePages (EfiBootServicesData, Pages);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePages (EfiBootServicesData, Pages),
+                          EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -113,7 +199,8 @@ AllocateReservedPages (
   IN UINTN  Pages
   )
 {
-  return InternalAllocatePages (EfiReservedMemoryType, Pages);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePages (EfiReservedMemoryType, Pages),
+                          EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -145,6 +232,7 @@ FreePages (
   ASSERT (Pages != 0);
   Status = CoreFreePages ((EFI_PHYSICAL_ADDRESS) (UINTN) Buffer, Pages);
   ASSERT_EFI_ERROR (Status);
+  TraceFree (Buffer, ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -258,7 +346,8 @@ AllocateAlignedPages (
   IN UINTN  Alignment
   )
 {
-  return InternalAllocateAlignedPages (EfiBootServicesData, Pages, Alignment);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocateAlignedPages (EfiBootServicesData, Pages, Alignment),
+                          EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -290,6 +379,7 @@ FreeAlignedPages (
   ASSERT (Pages != 0);
   Status = CoreFreePages ((EFI_PHYSICAL_ADDRESS) (UINTN) Buffer, Pages);
   ASSERT_EFI_ERROR (Status);
+  TraceFree (Buffer, ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -339,7 +429,8 @@ AllocatePool (
   IN UINTN  AllocationSize
   )
 {
-  return InternalAllocatePool (EfiBootServicesData, AllocationSize);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePool (EfiBootServicesData, AllocationSize),
+                          AllocationSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -360,7 +451,8 @@ AllocateReservedPool (
   IN UINTN  AllocationSize
   )
 {
-  return InternalAllocatePool (EfiReservedMemoryType, AllocationSize);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePool (EfiReservedMemoryType, AllocationSize),
+                          AllocationSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -411,7 +503,8 @@ AllocateZeroPool (
   IN UINTN  AllocationSize
   )
 {
-  return InternalAllocateZeroPool (EfiBootServicesData, AllocationSize);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocateZeroPool (EfiBootServicesData, AllocationSize),
+                          AllocationSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -474,7 +567,8 @@ AllocateCopyPool (
   IN CONST VOID  *Buffer
   )
 {
-  return InternalAllocateCopyPool (EfiBootServicesData, AllocationSize, Buffer);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocateCopyPool (EfiBootServicesData, AllocationSize, Buffer),
+                          AllocationSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -546,7 +640,8 @@ ReallocatePool (
   IN VOID   *OldBuffer  OPTIONAL
   )
 {
-  return InternalReallocatePool (EfiBootServicesData, OldSize, NewSize, OldBuffer);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalReallocatePool (EfiBootServicesData, OldSize, NewSize, OldBuffer),
+                          NewSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -573,6 +668,7 @@ FreePool (
 
   Status = CoreFreePool (Buffer);
   ASSERT_EFI_ERROR (Status);
+  TraceFree (Buffer, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -594,7 +690,8 @@ AllocateRuntimePages (
   IN UINTN  Pages
   )
 {
-  return InternalAllocatePages (EfiRuntimeServicesData, Pages);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePages (EfiRuntimeServicesData, Pages),
+                          EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
 }
 
 /**
@@ -615,7 +712,8 @@ AllocateRuntimePool (
   IN UINTN  AllocationSize
   )
 {
-  return InternalAllocatePool (EfiRuntimeServicesData, AllocationSize);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePool (EfiRuntimeServicesData, AllocationSize),
+                          AllocationSize, ALLOC_TRACE_TYPE_POOL);
 }
 
 /**
@@ -632,7 +730,8 @@ AllocateTemporaryMemory (
   IN UINTN  AllocationSize
   )
 {
-  return InternalAllocatePool (EfiBootServicesData, AllocationSize);
+  return TraceAllocation (RETURN_ADDRESS (0), InternalAllocatePool (EfiBootServicesData, AllocationSize),
+                          AllocationSize, ALLOC_TRACE_TYPE_TEMP);
 }
 
 /**
@@ -647,5 +746,6 @@ FreeTemporaryMemory (
   IN VOID   *Buffer
   )
 {
+  TraceFree (Buffer, ALLOC_TRACE_TYPE_TEMP);
   FreePool (Buffer);
 }
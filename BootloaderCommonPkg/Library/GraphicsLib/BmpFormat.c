@@ -307,7 +307,7 @@ DisplayBmpToFrameBuffer (
 
 End:
   if (IsAllocated) {
-    FreePool (BltLineBuf);
+    FreeTemporaryMemory (BltLineBuf);
   }
 
   return Status;
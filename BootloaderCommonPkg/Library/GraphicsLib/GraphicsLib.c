@@ -12,6 +12,21 @@
 
 #define  ANSI_ESCAPE_SEQ_CLEAR_SCREEN    (UINT8 *)"\x1b[2J"
 
+#define  GLYPH_TILE_PIXELS               (GLYPH_WIDTH * GLYPH_HEIGHT)
+#define  GLYPH_CACHE_PAIRS               4
+
+//
+// Pre-rendered glyph tiles for one foreground/background color pair.
+// Tiles are rendered on first use of a glyph.
+//
+typedef struct {
+  UINT32                         Foreground;
+  UINT32                         Background;
+  UINT32                         LastUse;
+  UINT8                         *Valid;
+  UINT32                        *Tiles;
+} GLYPH_TILE_CACHE;
+
 CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL mColors[16] = {
   //
   // B     G     R
@@ -35,6 +50,165 @@ CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL mColors[16] = {
 };
 
 STATIC FRAME_BUFFER_CONSOLE mFbConsole;
+STATIC GLYPH_TILE_CACHE     mGlyphCache[GLYPH_CACHE_PAIRS];
+STATIC UINT32               mGlyphCacheTick;
+
+/**
+  Get the index of a character in the glyph table.
+
+  @param[in] Glyph               ASCII character
+
+  @retval                        Index into gUsStdNarrowGlyphData
+
+**/
+STATIC
+UINTN
+GetGlyphIndex (
+  IN CHAR8                         Glyph
+  )
+{
+  UINTN                            Code;
+
+  // Glyph table maps to ASCII characters, index the table with the character
+  Code = (UINTN)(Glyph & 0xFF);
+  if ((Code >= 0xAF) && (Code <= 0xF2)) {
+    Code = (0x80 - 0x20) + (Code - 0xAF);
+  } else if ((Code >= 0x20) && (Code <= 0x7F)) {
+    Code = Code - 0x20;
+  } else {
+    Code = 0;
+  }
+
+  if (Code >= mNarrowFontSize / sizeof (EFI_NARROW_GLYPH)) {
+    Code = 0;
+  }
+
+  return Code;
+}
+
+/**
+  Expand a 1-bpp glyph into a tile of pixels.
+
+  @param[in]  Code               Index into gUsStdNarrowGlyphData
+  @param[in]  ForegroundColor    Foreground color to use
+  @param[in]  BackgroundColor    Background color to use
+  @param[out] Tile               Buffer of GLYPH_TILE_PIXELS pixels
+
+**/
+STATIC
+VOID
+RenderGlyph (
+  IN  UINTN                         Code,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor,
+  OUT UINT32                       *Tile
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Fore;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Back;
+  UINT8                               *GlyphBitmap;
+  UINTN                                Row;
+  UINTN                                Col;
+
+  Fore.Pixel  = ForegroundColor;
+  Back.Pixel  = BackgroundColor;
+  GlyphBitmap = gUsStdNarrowGlyphData[Code].GlyphCol1;
+  for (Row = 0; Row < GLYPH_HEIGHT; Row++) {
+    for (Col = 0; Col < GLYPH_WIDTH; Col++) {
+      *Tile++ = ((GlyphBitmap[Row] & (1 << (GLYPH_WIDTH - Col - 1))) != 0) ? Fore.Raw : Back.Raw;
+    }
+  }
+}
+
+/**
+  Get the glyph tile cache of a color pair.
+
+  The least recently used color pair is replaced when all cache slots are in use.
+
+  @param[in] ForegroundColor     Foreground color
+  @param[in] BackgroundColor     Background color
+
+  @retval                        The glyph tile cache, NULL if out of memory
+
+**/
+STATIC
+GLYPH_TILE_CACHE *
+GetGlyphTileCache (
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL ForegroundColor,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL BackgroundColor
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Fore;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Back;
+  GLYPH_TILE_CACHE                    *Cache;
+  UINTN                                Index;
+  UINTN                                GlyphCount;
+
+  Fore.Pixel = ForegroundColor;
+  Back.Pixel = BackgroundColor;
+  mGlyphCacheTick++;
+
+  Cache = &mGlyphCache[0];
+  for (Index = 0; Index < GLYPH_CACHE_PAIRS; Index++) {
+    if ((mGlyphCache[Index].Tiles != NULL) && (mGlyphCache[Index].Foreground == Fore.Raw) &&
+        (mGlyphCache[Index].Background == Back.Raw)) {
+      mGlyphCache[Index].LastUse = mGlyphCacheTick;
+      return &mGlyphCache[Index];
+    }
+    if ((Cache->Tiles != NULL) &&
+        ((mGlyphCache[Index].Tiles == NULL) || (mGlyphCache[Index].LastUse < Cache->LastUse))) {
+      Cache = &mGlyphCache[Index];
+    }
+  }
+
+  GlyphCount = mNarrowFontSize / sizeof (EFI_NARROW_GLYPH);
+  if (Cache->Tiles == NULL) {
+    Cache->Tiles = AllocatePool (GlyphCount * (GLYPH_TILE_PIXELS * sizeof (UINT32) + 1));
+    if (Cache->Tiles == NULL) {
+      return NULL;
+    }
+    Cache->Valid = (UINT8 *)(Cache->Tiles + GlyphCount * GLYPH_TILE_PIXELS);
+  }
+
+  ZeroMem (Cache->Valid, GlyphCount);
+  Cache->Foreground = Fore.Raw;
+  Cache->Background = Back.Raw;
+  Cache->LastUse    = mGlyphCacheTick;
+  return Cache;
+}
+
+/**
+  Get the pre-rendered tile of a glyph, rendering it on first use.
+
+  @param[in] Cache               Glyph tile cache of the color pair
+  @param[in] Glyph               ASCII character
+
+  @retval                        Pointer to GLYPH_TILE_PIXELS pixels
+
+**/
+STATIC
+UINT32 *
+GetGlyphTile (
+  IN GLYPH_TILE_CACHE              *Cache,
+  IN CHAR8                         Glyph
+  )
+{
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Fore;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Back;
+  UINTN                                Code;
+  UINT32                              *Tile;
+
+  Code = GetGlyphIndex (Glyph);
+  Tile = Cache->Tiles + Code * GLYPH_TILE_PIXELS;
+  if (Cache->Valid[Code] == 0) {
+    Fore.Raw = Cache->Foreground;
+    Back.Raw = Cache->Background;
+    RenderGlyph (Code, Fore.Pixel, Back.Pixel, Tile);
+    Cache->Valid[Code] = 1;
+  }
+
+  return Tile;
+}
 
 /**
   Copy image into frame buffer.
@@ -112,42 +286,20 @@ BltGlyphToFrameBuffer (
   IN UINTN                         OffY
   )
 {
-  UINT8                            *GlyphBitmap;
-  UINTN                            Width, Height;
-  UINTN                            Row;
-  UINTN                            Col;
-  UINTN                            Code;
-  UINTN                            Base;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL    GopBlt[GLYPH_WIDTH * GLYPH_HEIGHT];
+  GLYPH_TILE_CACHE                *Cache;
+  UINT32                           GopBlt[GLYPH_TILE_PIXELS];
 
   if (GfxInfoHob == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  Width = GLYPH_WIDTH;
-  Height = GLYPH_HEIGHT;
-
-  // Glyph table maps to ASCII characters, index the table with the character
-  Code = (UINTN)(Glyph & 0xFF);
-  Base = 0xAF;
-  if ((Code >= Base) && (Code <= 0xF2)) {
-    Code = (0x80 - 0x20) + (Code - Base);
-  } else if ((Code >= 0x20) && (Code <= 0x7F)) {
-    Code = Code - 0x20;
-  } else {
-    Code = 0;
-  }
-
-  // Glyph table maps to ASCII characters, index the table with the character
-  GlyphBitmap = gUsStdNarrowGlyphData[Code].GlyphCol1;
-
-  for (Row = 0; Row < Height; Row++) {
-    for (Col = 0; Col < Width; Col++) {
-      GopBlt[Row * Width + Col] = ((GlyphBitmap[Row] & (1 << (Width - Col - 1))) != 0) ? ForegroundColor : BackgroundColor;
-    }
+  Cache = GetGlyphTileCache (ForegroundColor, BackgroundColor);
+  if (Cache != NULL) {
+    return BltToFrameBuffer (GfxInfoHob, GetGlyphTile (Cache, Glyph), GLYPH_WIDTH, GLYPH_HEIGHT, OffX, OffY);
   }
 
-  return BltToFrameBuffer (GfxInfoHob, GopBlt, Width, Height, OffX, OffY);
+  RenderGlyph (GetGlyphIndex (Glyph), ForegroundColor, BackgroundColor, GopBlt);
+  return BltToFrameBuffer (GfxInfoHob, GopBlt, GLYPH_WIDTH, GLYPH_HEIGHT, OffX, OffY);
 }
 
 /**
@@ -205,12 +357,12 @@ InitFrameBufferConsole (
   Console->Cols        = Width / GLYPH_WIDTH;
   Console->CursorX     = 0;
   Console->CursorY     = 0;
+  Console->DirtyStart  = 0;
+  Console->DirtyEnd    = 0;
   Console->ForegroundColor = mColors[7];
   Console->BackgroundColor = mColors[0];
   Console->TextDisplayBuf = AllocateZeroPool (Console->Rows * Console->Cols);
   ASSERT (Console->TextDisplayBuf != NULL);
-  Console->TextSwapBuf = AllocateZeroPool (Console->Rows * Console->Cols);
-  ASSERT (Console->TextSwapBuf != NULL);
   Console->TextDrawBuf = AllocateZeroPool (Console->Rows * Console->Cols * 2);
   ASSERT (Console->TextDrawBuf != NULL);
 
@@ -222,9 +374,70 @@ InitFrameBufferConsole (
   return EFI_SUCCESS;
 }
 
+/**
+  Draw the dirty characters of the current console line into the frame buffer.
+
+  The dirty characters are drawn as one rectangle, one pixel row at a time,
+  using the pre-rendered glyph tiles.
+
+  @param[in] Console             Frame buffer console
+
+**/
+STATIC
+VOID
+FrameBufferConsoleFlush (
+  IN FRAME_BUFFER_CONSOLE  *Console
+  )
+{
+  GLYPH_TILE_CACHE       *Cache;
+  CHAR8                  *Text;
+  UINT32                 *Dst;
+  UINTN                   Stride;
+  UINTN                   Row;
+  UINTN                   Col;
+
+  if (Console->DirtyStart >= Console->DirtyEnd) {
+    return;
+  }
+
+  Text  = &Console->TextDisplayBuf[Console->DirtyRow * Console->Cols];
+  Cache = GetGlyphTileCache (Console->ForegroundColor, Console->BackgroundColor);
+  if (Cache == NULL) {
+    for (Col = Console->DirtyStart; Col < Console->DirtyEnd; Col++) {
+      BltGlyphToFrameBuffer (Console->GfxInfoHob, Text[Col],
+                             Console->ForegroundColor, Console->BackgroundColor,
+                             Console->OffX + Col * GLYPH_WIDTH,
+                             Console->OffY + Console->DirtyRow * GLYPH_HEIGHT);
+    }
+  } else {
+    // Render missing tiles first so that the rows below are plain copies
+    for (Col = Console->DirtyStart; Col < Console->DirtyEnd; Col++) {
+      GetGlyphTile (Cache, Text[Col]);
+    }
+
+    Stride = Console->GfxInfoHob->GraphicsMode.HorizontalResolution;
+    for (Row = 0; Row < GLYPH_HEIGHT; Row++) {
+      Dst = (UINT32 *) (UINTN) (Console->GfxInfoHob->FrameBufferBase);
+      Dst += (Console->OffY + Console->DirtyRow * GLYPH_HEIGHT + Row) * Stride;
+      Dst += Console->OffX + Console->DirtyStart * GLYPH_WIDTH;
+      for (Col = Console->DirtyStart; Col < Console->DirtyEnd; Col++) {
+        CopyMem (Dst, Cache->Tiles + GetGlyphIndex (Text[Col]) * GLYPH_TILE_PIXELS + Row * GLYPH_WIDTH,
+                 GLYPH_WIDTH * sizeof (UINT32));
+        Dst += GLYPH_WIDTH;
+      }
+    }
+  }
+
+  Console->DirtyStart = 0;
+  Console->DirtyEnd   = 0;
+}
+
 /**
   Scroll the console area of the screen up.
 
+  The remaining lines are moved up with a frame buffer block move and the
+  new lines are cleared with the background color.
+
   @param[in] ScrollAmount Amount (in rows) to scroll
 
   @retval EFI_SUCCESS
@@ -237,11 +450,12 @@ FrameBufferConsoleScroll (
   )
 {
   FRAME_BUFFER_CONSOLE   *Console;
-  UINTN                  BufX;
-  UINTN                  BufY;
-  UINTN                  BufPos;
-  UINTN                  ScreenX;
-  UINTN                  ScreenY;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL_UNION  Back;
+  UINT32                 *Dst;
+  UINTN                  Stride;
+  UINTN                  LineSize;
+  UINTN                  Lines;
+  UINTN                  Index;
 
   Console = &mFbConsole;
   if (Console->Height == 0) {
@@ -252,38 +466,40 @@ FrameBufferConsoleScroll (
     ScrollAmount = Console->Rows;
   }
 
+  FrameBufferConsoleFlush (Console);
+
+  Stride   = Console->GfxInfoHob->GraphicsMode.HorizontalResolution;
+  LineSize = Console->Cols * GLYPH_WIDTH * sizeof (UINT32);
+  Dst      = (UINT32 *) (UINTN) (Console->GfxInfoHob->FrameBufferBase);
+  Dst     += Console->OffY * Stride + Console->OffX;
+
   if (ScrollAmount < Console->Rows) {
     // Move all lines in text buffer up
-    CopyMem (&Console->TextSwapBuf[0],
+    CopyMem (&Console->TextDisplayBuf[0],
              &Console->TextDisplayBuf[Console->Cols * ScrollAmount],
              Console->Cols * (Console->Rows - ScrollAmount));
+
+    // Move the pixel rows up, in one block when the console spans full scan lines
+    Lines = (Console->Rows - ScrollAmount) * GLYPH_HEIGHT;
+    if (LineSize == Stride * sizeof (UINT32)) {
+      CopyMem (Dst, Dst + ScrollAmount * GLYPH_HEIGHT * Stride, Lines * LineSize);
+      Dst += Lines * Stride;
+    } else {
+      for (Index = 0; Index < Lines; Index++) {
+        CopyMem (Dst, Dst + ScrollAmount * GLYPH_HEIGHT * Stride, LineSize);
+        Dst += Stride;
+      }
+    }
   }
 
   // Blank remaining lines
-  ZeroMem (&Console->TextSwapBuf[Console->Cols * (Console->Rows - ScrollAmount)],
+  ZeroMem (&Console->TextDisplayBuf[Console->Cols * (Console->Rows - ScrollAmount)],
            Console->Cols * ScrollAmount);
 
-  // Write text buffer to screen
-  //
-  // Note: At this point, TextDisplayBuf contains what is currently being
-  // displayed and TextSwapBuf contains what *should* be displayed. Step through
-  // every character of the buffer and update the framebuffer with any
-  // differences.
-  BufPos = 0;
-  ScreenY = Console->OffY;
-  for (BufY = 0; BufY < Console->Rows; BufY++) {
-    ScreenX = Console->OffX;
-    for (BufX = 0; BufX < Console->Cols; BufX++) {
-      if (Console->TextSwapBuf[BufPos] != Console->TextDisplayBuf[BufPos]) {
-        Console->TextDisplayBuf[BufPos] = Console->TextSwapBuf[BufPos];
-        BltGlyphToFrameBuffer (Console->GfxInfoHob, Console->TextSwapBuf[BufPos],
-                               Console->ForegroundColor, Console->BackgroundColor,
-                               ScreenX, ScreenY);
-      }
-      BufPos++;
-      ScreenX += GLYPH_WIDTH;
-    }
-    ScreenY += GLYPH_HEIGHT;
+  Back.Pixel = Console->BackgroundColor;
+  for (Index = 0; Index < ScrollAmount * GLYPH_HEIGHT; Index++) {
+    SetMem32 (Dst, LineSize, Back.Raw);
+    Dst += Stride;
   }
 
   return EFI_SUCCESS;
@@ -316,7 +532,6 @@ FrameBufferWrite (
   )
 {
   FRAME_BUFFER_CONSOLE *Console;
-  EFI_STATUS            Status;
   UINTN                 Pos;
   UINTN                 Length;
   EFI_PEI_GRAPHICS_INFO_HOB  *GfxInfoHob;
@@ -338,8 +553,10 @@ FrameBufferWrite (
     GfxInfoHob = Console->GfxInfoHob;
     Length = (GfxInfoHob->GraphicsMode.HorizontalResolution * GfxInfoHob->GraphicsMode.PixelsPerScanLine) * 4;
     SetMem64 ((UINT32 *) (UINTN)(GfxInfoHob->FrameBufferBase), Length, 0);
-    Console->CursorX = 0;
-    Console->CursorY = 0;
+    Console->CursorX    = 0;
+    Console->CursorY    = 0;
+    Console->DirtyStart = 0;
+    Console->DirtyEnd   = 0;
     return NumberOfBytes;
   }
 
@@ -371,7 +588,8 @@ FrameBufferWrite (
         }
       }
     } else if (Buffer[Pos] == '\n') {
-      // Newline
+      // Newline, draw the completed line
+      FrameBufferConsoleFlush (Console);
       Console->CursorX = 0;
       Console->CursorY++;
     } else if (Buffer[Pos] == '\r') {
@@ -379,17 +597,24 @@ FrameBufferWrite (
       Console->CursorX = 0;
     } else {
       Console->TextDisplayBuf[Console->CursorY * Console->Cols + Console->CursorX] = Buffer[Pos];
-      Status = BltGlyphToFrameBuffer (Console->GfxInfoHob, Buffer[Pos],
-                                      Console->ForegroundColor, Console->BackgroundColor,
-                                      Console->OffX + Console->CursorX * GLYPH_WIDTH,
-                                      Console->OffY + Console->CursorY * GLYPH_HEIGHT);
-      if (Status != EFI_SUCCESS) {
-        break;
+      // Collect the changed characters of a line, they are drawn together
+      if ((Console->DirtyStart < Console->DirtyEnd) && (Console->DirtyRow != Console->CursorY)) {
+        FrameBufferConsoleFlush (Console);
+      }
+      if (Console->DirtyStart >= Console->DirtyEnd) {
+        Console->DirtyRow   = Console->CursorY;
+        Console->DirtyStart = Console->CursorX;
+        Console->DirtyEnd   = Console->CursorX + 1;
+      } else {
+        Console->DirtyStart = MIN (Console->DirtyStart, Console->CursorX);
+        Console->DirtyEnd   = MAX (Console->DirtyEnd, Console->CursorX + 1);
       }
       Console->CursorX++;
     }
   }
 
+  FrameBufferConsoleFlush (Console);
+
   return Pos;
 }
 
@@ -12,6 +12,28 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/BootloaderCommonLib.h>
+#include <Guid/HobIndexGuid.h>
+
+//
+// GUID HOB lookups from the start of a HOB list are served from a hash table
+// of the first HOB of each GUID. The table is built on the first lookup and
+// extended when HOBs are appended to the list, as seen from the PHIT HOB.
+// It is only used from Stage2 on, when the module data is writable.
+//
+#define HOB_CACHE_LIST_COUNT     2
+#define HOB_CACHE_SLOT_COUNT     256
+#define HOB_CACHE_SLOT_LIMIT     (HOB_CACHE_SLOT_COUNT * 3 / 4)
+
+typedef struct {
+  UINT8      *HobList;
+  UINT8      *CoveredEnd;
+  UINT32      Used;
+  BOOLEAN     Full;
+  UINT32      Slot[HOB_CACHE_SLOT_COUNT];    // GUID HOB offset from HobList, 0 if empty
+} HOB_GUID_CACHE;
+
+STATIC HOB_GUID_CACHE   mHobGuidCache[HOB_CACHE_LIST_COUNT];
+STATIC UINT32           mHobGuidCacheNext;
 
 /**
   Returns the pointer to the HOB list.
@@ -96,6 +118,201 @@ GetFirstHob (
   return GetNextHob (Type, HobList);
 }
 
+/**
+  Get the hash table slot of a GUID.
+
+  @param  Guid          The GUID to hash.
+
+  @return The first slot to probe.
+
+**/
+STATIC
+UINT32
+HobGuidHash (
+  IN CONST EFI_GUID         *Guid
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)Guid) ^ ReadUnaligned32 ((CONST UINT32 *)Guid + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)Guid + 2) ^ ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+  Hash ^= Hash >> 16;
+  return Hash & (HOB_CACHE_SLOT_COUNT - 1);
+}
+
+/**
+  Find the slot of a GUID in the HOB cache.
+
+  @param  Cache         The HOB cache.
+  @param  Guid          The GUID to find.
+
+  @return The slot holding the GUID, or the empty slot to insert it.
+
+**/
+STATIC
+UINT32 *
+HobCacheFindSlot (
+  IN HOB_GUID_CACHE         *Cache,
+  IN CONST EFI_GUID         *Guid
+  )
+{
+  UINT32              Index;
+  EFI_HOB_GUID_TYPE  *GuidHob;
+
+  Index = HobGuidHash (Guid);
+  while (Cache->Slot[Index] != 0) {
+    GuidHob = (EFI_HOB_GUID_TYPE *)(Cache->HobList + Cache->Slot[Index]);
+    if (CompareGuid (Guid, &GuidHob->Name)) {
+      break;
+    }
+    Index = (Index + 1) & (HOB_CACHE_SLOT_COUNT - 1);
+  }
+
+  return &Cache->Slot[Index];
+}
+
+/**
+  Add a GUID HOB to the HOB cache, unless its GUID is already there.
+
+  @param  Cache         The HOB cache.
+  @param  Guid          The GUID of the HOB.
+  @param  Offset        The HOB offset from the start of the HOB list.
+
+  @retval TRUE          The GUID HOB is in the cache.
+  @retval FALSE         The cache is full.
+
+**/
+STATIC
+BOOLEAN
+HobCacheAdd (
+  IN HOB_GUID_CACHE         *Cache,
+  IN CONST EFI_GUID         *Guid,
+  IN UINT32                  Offset
+  )
+{
+  UINT32  *Slot;
+
+  Slot = HobCacheFindSlot (Cache, Guid);
+  if (*Slot == 0) {
+    if (Cache->Used >= HOB_CACHE_SLOT_LIMIT) {
+      return FALSE;
+    }
+    *Slot = Offset;
+    Cache->Used++;
+  }
+
+  return TRUE;
+}
+
+/**
+  Reset the HOB cache of a HOB list.
+
+  The GUID HOBs in the index HOB built by the loader, if any, are added
+  without walking through them.
+
+  @param  Cache         The HOB cache.
+  @param  HobList       The start of the HOB list.
+  @param  HobEnd        The end of the HOB list.
+
+**/
+STATIC
+VOID
+HobCacheReset (
+  IN HOB_GUID_CACHE         *Cache,
+  IN UINT8                  *HobList,
+  IN UINT8                  *HobEnd
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  HOB_INDEX_INFO       *IndexInfo;
+  UINT32                Index;
+
+  ZeroMem (Cache, sizeof (HOB_GUID_CACHE));
+  Cache->HobList    = HobList;
+  Cache->CoveredEnd = HobList;
+
+  Hob.Raw = GET_NEXT_HOB (HobList);
+  if ((Hob.Raw >= HobEnd) || (Hob.Header->HobType != EFI_HOB_TYPE_GUID_EXTENSION) ||
+      !CompareGuid (&Hob.Guid->Name, &gLoaderHobIndexGuid)) {
+    return;
+  }
+
+  IndexInfo = (HOB_INDEX_INFO *)GET_GUID_HOB_DATA (Hob.Raw);
+  if ((IndexInfo->Signature != HOB_INDEX_INFO_SIGNATURE) || (IndexInfo->HobListSize > (UINTN)(HobEnd - HobList)) ||
+      (IndexInfo->Count > HOB_INDEX_MAX_ENTRIES)) {
+    return;
+  }
+
+  for (Index = 0; Index < IndexInfo->Count; Index++) {
+    if (!HobCacheAdd (Cache, &IndexInfo->Entry[Index].Name, IndexInfo->Entry[Index].Offset)) {
+      Cache->Full = TRUE;
+      return;
+    }
+  }
+  Cache->CoveredEnd = HobList + IndexInfo->HobListSize;
+}
+
+/**
+  Get the up to date HOB cache of a HOB list.
+
+  @param  HobStart      The start of the HOB list.
+
+  @return The HOB cache, or NULL if the HOB list cannot be cached.
+
+**/
+STATIC
+HOB_GUID_CACHE *
+GetHobGuidCache (
+  IN CONST VOID             *HobStart
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+  HOB_GUID_CACHE       *Cache;
+  UINT8                *HobEnd;
+  UINT32                Index;
+
+  Hob.Raw = (UINT8 *) HobStart;
+  if ((Hob.Raw == NULL) || (Hob.Header->HobType != EFI_HOB_TYPE_HANDOFF) ||
+      (GetLoaderStage () < LOADER_STAGE_2)) {
+    return NULL;
+  }
+
+  HobEnd = (UINT8 *)(UINTN)Hob.HandoffInformationTable->EfiEndOfHobList;
+  for (Index = 0; Index < HOB_CACHE_LIST_COUNT; Index++) {
+    if (mHobGuidCache[Index].HobList == Hob.Raw) {
+      break;
+    }
+  }
+
+  if (Index < HOB_CACHE_LIST_COUNT) {
+    Cache = &mHobGuidCache[Index];
+    if (HobEnd < Cache->CoveredEnd) {
+      HobCacheReset (Cache, Hob.Raw, HobEnd);
+    }
+  } else {
+    Cache = &mHobGuidCache[mHobGuidCacheNext];
+    mHobGuidCacheNext = (mHobGuidCacheNext + 1) % HOB_CACHE_LIST_COUNT;
+    HobCacheReset (Cache, Hob.Raw, HobEnd);
+  }
+
+  //
+  // Add the HOBs appended since the last lookup
+  //
+  Hob.Raw = Cache->CoveredEnd;
+  while (!Cache->Full && (Hob.Raw < HobEnd) && !END_OF_HOB_LIST (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      if (!HobCacheAdd (Cache, &Hob.Guid->Name, (UINT32)(Hob.Raw - Cache->HobList))) {
+        Cache->Full = TRUE;
+        break;
+      }
+    }
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+  Cache->CoveredEnd = Hob.Raw;
+
+  return Cache->Full ? NULL : Cache;
+}
+
 /**
   Returns the next instance of the matched GUID HOB from the starting HOB.
 
@@ -126,6 +343,14 @@ GetNextGuidHob (
   )
 {
   EFI_PEI_HOB_POINTERS  GuidHob;
+  HOB_GUID_CACHE       *Cache;
+  UINT32               *Slot;
+
+  Cache = GetHobGuidCache (HobStart);
+  if (Cache != NULL) {
+    Slot = HobCacheFindSlot (Cache, Guid);
+    return (*Slot == 0) ? NULL : Cache->HobList + *Slot;
+  }
 
   GuidHob.Raw = (UINT8 *) HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
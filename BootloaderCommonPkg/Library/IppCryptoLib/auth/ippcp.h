@@ -100,6 +100,9 @@ IPPAPI(IppStatus, ippsHashGetTag_rmf,(Ipp8u* pMD, int tagLen, const IppsHashStat
 IPPAPI(IppStatus, ippsHashFinal_rmf,(Ipp8u* pMD, IppsHashState_rmf* pCtx))
 IPPAPI(IppStatus, ippsHashMessage_rmf,(const Ipp8u* pMsg, int len, Ipp8u* pMD, const IppsHashMethod* pMethod))
 
+/* multi-buffer Hash Primitives */
+IPPAPI(IppStatus, ippsSHA384MessageDigestMb4,(const Ipp8u* const pMsg[], const int msgLen[], Ipp8u* const pMD[], int nMsg))
+
 
 /* general MGF Primitives*/
 IPPAPI(IppStatus, ippsMGF,(const Ipp8u* pSeed, int seedLen, Ipp8u* pMask, int maskLen, IppHashAlgId hashAlg))
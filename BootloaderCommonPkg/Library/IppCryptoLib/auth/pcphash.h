@@ -216,6 +216,9 @@ void EFIAPI UpdateSHA512W7 (void* uniHash, const Ipp8u* mblk, int mlen, const vo
 void EFIAPI UpdateSHA512G9 (void* uniHash, const Ipp8u* mblk, int mlen, const void* uniPraram);
 void UpdateMD5   (void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
 void UpdateSM3   (void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
+int  EFIAPI cpGetAvxFeatures (void);
+void EFIAPI ExpandSM3MsgAvx (Ipp32u* pW, Ipp32u* pWp, const Ipp8u* pMsg);
+void EFIAPI UpdateSHA512Mb4Avx2 (Ipp64u* pHash, const Ipp8u* const* ppMsg, int nBlocks, const Ipp64u* pK);
 
 #if (_SHA_NI_ENABLING_ == _FEATURE_TICKTOCK_) || (_SHA_NI_ENABLING_ == _FEATURE_ON_)
 void UpdateSHA1ni  (void* pHash, const Ipp8u* mblk, int mlen, const void* pParam);
@@ -347,6 +347,88 @@ IPPFUN(IppStatus, ippsSHA384Update,(const Ipp8u* pSrc, int len, IppsSHA384State*
 }
 
 
+/*F*
+//    Name: ippsSHA384MessageDigestMb4
+//
+// Purpose: Digest up to 4 independent messages in parallel.
+//
+// Returns:                Reason:
+//    ippStsNullPtrErr        pMsg == NULL
+//                            msgLen == NULL
+//                            pMD == NULL
+//    ippStsLengthErr         nMsg <1 or nMsg >4
+//                            msgLen[i] <0
+//    ippStsNotSupportedModeErr  multi-buffer processing is not enabled,
+//                               or AVX2 is not available on this processor
+//    ippStsNoErr             no errors
+//
+// Parameters:
+//    pMsg        pointers to the input messages
+//    msgLen      lengths of the input messages
+//    pMD         addresses of the output digests
+//    nMsg        number of messages
+//
+*F*/
+IPPFUN(IppStatus, ippsSHA384MessageDigestMb4,(const Ipp8u* const pMsg[], const int msgLen[], Ipp8u* const pMD[], int nMsg))
+{
+#if defined(_SLIMBOOT_OPT) && (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SHA384_MB4)
+   /* hash word i of lane j is at hash[i*4+j] */
+   Ipp64u hash[8*4];
+   const Ipp8u* pLane[4];
+   int nBlocks;
+   int lane;
+   int i;
+
+   IPP_BAD_PTR3_RET(pMsg, msgLen, pMD);
+   IPP_BADARG_RET((nMsg<1) || (nMsg>4), ippStsLengthErr);
+   /* the kernel is only built in, the processor may not have AVX2 enabled */
+   IPP_BADARG_RET(!(cpGetAvxFeatures() & IPP_CPU_AVX2), ippStsNotSupportedModeErr);
+
+   /* all messages are processed together for their common full blocks */
+   nBlocks = 0;
+   for(lane=0; lane<nMsg; lane++) {
+      IPP_BADARG_RET((msgLen[lane]<0), ippStsLengthErr);
+      IPP_BADARG_RET((msgLen[lane] && !pMsg[lane]), ippStsNullPtrErr);
+      IPP_BAD_PTR1_RET(pMD[lane]);
+      if((lane==0) || (msgLen[lane]/MBS_SHA512 < nBlocks))
+         nBlocks = msgLen[lane]/MBS_SHA512;
+   }
+
+   /* unused lanes repeat the first message */
+   for(lane=0; lane<4; lane++) {
+      pLane[lane] = pMsg[(lane<nMsg)? lane : 0];
+      for(i=0; i<8; i++)
+         hash[i*4+lane] = sha512_384_iv[i];
+   }
+   if(nBlocks)
+      UpdateSHA512Mb4Avx2(hash, pLane, nBlocks, sha512_cnt);
+
+   /* the rest of each message is processed on its own */
+   for(lane=0; lane<nMsg; lane++) {
+      DigestSHA512 laneHash;
+      int procLen = nBlocks*MBS_SHA512;
+      int restLen = msgLen[lane] - procLen;
+      int fullLen = restLen & ~(MBS_SHA512-1);
+
+      for(i=0; i<8; i++)
+         laneHash[i] = hash[i*4+lane];
+      if(fullLen)
+         UpdateSHA512(laneHash, pMsg[lane]+procLen, fullLen, sha512_cnt);
+      cpFinalizeSHA512(laneHash, pMsg[lane]+procLen+fullLen, restLen-fullLen, (Ipp64u)msgLen[lane], 0);
+      sha512_384_hashOctString(pMD[lane], laneHash);
+   }
+
+   return ippStsNoErr;
+#else
+   IPP_UNREFERENCED_PARAMETER(pMsg);
+   IPP_UNREFERENCED_PARAMETER(msgLen);
+   IPP_UNREFERENCED_PARAMETER(pMD);
+   IPP_UNREFERENCED_PARAMETER(nMsg);
+   return ippStsNotSupportedModeErr;
+#endif
+}
+
+
 /*
 // available SHA384 methods
 */
@@ -404,6 +404,73 @@ IPPFUN( const IppsHashMethod*, ippsHashMethod_SM3, (void) )
 //    uniParam pointer to the optional parameter
 //
 *F*/
+#if defined(_SLIMBOOT_OPT) && (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SM3_AVX)
+
+/* SM3 step with the message words W and W' expanded in advance */
+#define SM3_EXPANDED_STEP(A,B,C,D,E,F,G,H, FF, GG, W,Wp,Tj, r)  { \
+   TT1 = ROL32(A,12); \
+   SS1 = ROL32(TT1 + E + Tj[(r)], 7); \
+   TT1 = FF(A,B,C) + D + (SS1 ^ TT1) + Wp[(r)]; \
+   TT2 = GG(E,F,G) + H + SS1 + W[(r)]; \
+   \
+   D = C; \
+   C = ROL32(B, 9); \
+   B = A; \
+   A = TT1; \
+   H = G; \
+   G = ROL32(F,19); \
+   F = E; \
+   E = P0(TT2); \
+}
+
+static void UpdateSM3Avx(void* uniHash, const Ipp8u* mblk, int mlen, const void* uniParam)
+{
+   Ipp32u* hash = (Ipp32u*)uniHash;
+   Ipp32u* SM3_cnt_loc = (Ipp32u*)uniParam;
+
+   for(; mlen>=MBS_SM3; mblk += MBS_SM3, mlen -= MBS_SM3) {
+      int r;
+
+      /* expand message block, W needs room for the last partial vector */
+      Ipp32u W[72];
+      Ipp32u Wp[64];
+      ExpandSM3MsgAvx(W, Wp, mblk);
+
+      /*
+      // update hash
+      */
+      {
+         /* init A, B, C, D, E, F, G, H by the input hash */
+         Ipp32u A = hash[0];
+         Ipp32u B = hash[1];
+         Ipp32u C = hash[2];
+         Ipp32u D = hash[3];
+         Ipp32u E = hash[4];
+         Ipp32u F = hash[5];
+         Ipp32u G = hash[6];
+         Ipp32u H = hash[7];
+
+         Ipp32u TT1, TT2, SS1;
+         for(r=0; r<16; r++)
+            SM3_EXPANDED_STEP(A,B,C,D,E,F,G,H, FF1,GG1, W,Wp, SM3_cnt_loc, r);
+         for(; r<64; r++)
+            SM3_EXPANDED_STEP(A,B,C,D,E,F,G,H, FF2,GG2, W,Wp, SM3_cnt_loc, r);
+
+         /* update hash */
+         hash[0] ^= A;
+         hash[1] ^= B;
+         hash[2] ^= C;
+         hash[3] ^= D;
+         hash[4] ^= E;
+         hash[5] ^= F;
+         hash[6] ^= G;
+         hash[7] ^= H;
+      }
+   }
+}
+
+#endif
+
 #if defined(_ALG_SM3_COMPACT_)
 #pragma message("SM3 compact")
 
@@ -429,6 +496,14 @@ void UpdateSM3(void* uniHash, const Ipp8u* mblk, int mlen, const void* uniParam)
    Ipp32u* hash = (Ipp32u*)uniHash;
    Ipp32u* SM3_cnt_loc = (Ipp32u*)uniParam;
 
+   #if defined(_SLIMBOOT_OPT) && (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SM3_AVX)
+   /* the AVX kernel is only built in, use it if this processor has AVX enabled */
+   if(cpGetAvxFeatures() & IPP_CPU_AVX) {
+      UpdateSM3Avx(uniHash, mblk, mlen, uniParam);
+      return;
+   }
+   #endif
+
    for(; mlen>=MBS_SM3; data += MBS_SM3/sizeof(Ipp32u), mlen -= MBS_SM3) {
       int r;
 
@@ -486,6 +561,14 @@ void UpdateSM3(void* uniHash, const Ipp8u* mblk, int mlen, const void* uniParam)
    Ipp32u* hash = (Ipp32u*)uniHash;
    Ipp32u* SM3_cnt_loc = (Ipp32u*)uniParam;
 
+   #if defined(_SLIMBOOT_OPT) && (FixedPcdGet32 (PcdCryptoShaOptMask) & IPP_CRYPTO_SM3_AVX)
+   /* the AVX kernel is only built in, use it if this processor has AVX enabled */
+   if(cpGetAvxFeatures() & IPP_CPU_AVX) {
+      UpdateSM3Avx(uniHash, mblk, mlen, uniParam);
+      return;
+   }
+   #endif
+
    for(; mlen>=MBS_SM3; data += MBS_SM3/sizeof(Ipp32u), mlen -= MBS_SM3) {
 
       /* copy input hash */
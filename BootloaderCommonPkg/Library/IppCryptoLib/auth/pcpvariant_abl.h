@@ -37,5 +37,11 @@
 #define IPP_CRYPTO_SHA256_NI    0x0002
 #define IPP_CRYPTO_SHA384_W7    0x0004
 #define IPP_CRYPTO_SHA384_G9    0x0008
+#define IPP_CRYPTO_SM3_AVX      0x0010
+#define IPP_CRYPTO_SHA384_MB4   0x0020
+
+/* cpGetAvxFeatures () flags */
+#define IPP_CPU_AVX             0x0001
+#define IPP_CPU_AVX2            0x0002
 
 #endif /* _CP_VARIANT_ABL_H */
@@ -43,6 +43,113 @@ Sha384 (const Ipp8u* pMsg, Ipp32u msgLen, Ipp8u* pMD)
   }
 }
 
+/**
+  Find the next buffer in ascending length order.
+
+  Buffers of the same length are ordered by their index, so that every
+  buffer is returned exactly once.
+
+  @param[in]   Length      Array of the buffer lengths in bytes.
+  @param[in]   Count       Number of buffers.
+  @param[in]   Prev        Index of the previously returned buffer.
+  @param[in]   First       TRUE to return the first buffer, Prev is ignored.
+
+  @retval  Index of the next buffer.
+**/
+STATIC
+Ipp32u
+NextByLength (
+  IN  CONST Ipp32u   *Length,
+  IN        Ipp32u    Count,
+  IN        Ipp32u    Prev,
+  IN        BOOLEAN   First
+  )
+{
+  Ipp32u  Index;
+  Ipp32u  Next;
+
+  Next = Count;
+  for (Index = 0; Index < Count; Index++) {
+    if (!First && ((Length[Index] < Length[Prev]) || ((Length[Index] == Length[Prev]) && (Index <= Prev)))) {
+      continue;
+    }
+    if ((Next == Count) || (Length[Index] < Length[Next])) {
+      Next = Index;
+    }
+  }
+
+  return Next;
+}
+
+/**
+  Computes the SHA-384 message digests of several input data buffers.
+
+  Up to four buffers are hashed together when the multi-buffer kernel is
+  enabled in PcdCryptoShaOptMask, otherwise the buffers are hashed one by one.
+  The buffers are grouped in ascending length order, since the kernel only
+  processes the blocks common to all lanes of a group together.
+
+  @param[in]   Data        Array of pointers to the buffers to be hashed.
+  @param[in]   Length      Array of the lengths of the Data buffers in bytes.
+  @param[out]  Digest      Array of pointers to the buffers that receive the
+                           SHA-384 digest values (48 bytes each).
+  @param[in]   Count       Number of buffers to be hashed.
+
+  @retval  RETURN_SUCCESS             Success.
+  @retval  RETURN_INVALID_PARAMETER   Data, Length or Digest is NULL.
+  @retval  RETURN_UNSUPPORTED         SHA-384 is not supported.
+  @retval  RETURN_SECURITY_VIOLATION  All other errors.
+**/
+RETURN_STATUS
+EFIAPI
+Sha384Batch (
+  IN  CONST Ipp8u * CONST  *Data,
+  IN  CONST Ipp32u         *Length,
+  OUT       Ipp8u * CONST  *Digest,
+  IN        Ipp32u          Count
+  )
+{
+  Ipp32u        Index;
+  Ipp32u        Lane;
+  Ipp32u        Lanes;
+  Ipp32u        Next;
+  int           LaneLen[4];
+  const Ipp8u  *LaneData[4];
+  Ipp8u        *LaneDigest[4];
+
+  if (!(FixedPcdGet8(PcdIppHashLibSupportedMask) & IPP_HASHLIB_SHA2_384)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((Data == NULL) || (Length == NULL) || (Digest == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Next = 0;
+  for (Index = 0; Index < Count; Index += Lanes) {
+    Lanes = IPP_MIN (Count - Index, 4);
+    for (Lane = 0; Lane < Lanes; Lane++) {
+      Next = NextByLength (Length, Count, Next, (BOOLEAN)(Index + Lane == 0));
+      LaneData[Lane]   = Data[Next];
+      LaneDigest[Lane] = Digest[Next];
+      LaneLen[Lane]    = (int)Length[Next];
+    }
+
+    if (ippsSHA384MessageDigestMb4 (LaneData, LaneLen, LaneDigest, (int)Lanes) == ippStsNoErr) {
+      continue;
+    }
+
+    for (Lane = 0; Lane < Lanes; Lane++) {
+      if (ippsHashMessage_rmf (LaneData[Lane], LaneLen[Lane], LaneDigest[Lane],
+                               ippsHashMethod_SHA384 ()) != ippStsNoErr) {
+        return RETURN_SECURITY_VIOLATION;
+      }
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
 /**
   Initializes the hash context for SHA384 hashing.
 
@@ -182,6 +182,144 @@ IsBzImage (
   return TRUE;
 }
 
+/**
+  Check if a memory range is usable RAM in the memory map.
+
+  @param[in]  Base           Base address of the memory range.
+  @param[in]  Size           Size of the memory range.
+
+  @retval     TRUE           The whole range is in a RAM entry.
+  @retval     FALSE          The range is not RAM, or there is no memory map yet.
+**/
+STATIC
+BOOLEAN
+IsRamRange (
+  IN  UINT64                  Base,
+  IN  UINT64                  Size
+  )
+{
+  VOID                       *HobList;
+  EFI_HOB_GUID_TYPE          *GuidHob;
+  MEMORY_MAP_INFO            *MapInfo;
+  UINTN                       Index;
+
+  //
+  // Stage2 loads a kernel payload before the memory map HOB is built
+  //
+  HobList = GetHobList ();
+  if (HobList == NULL) {
+    return FALSE;
+  }
+
+  GuidHob = GetNextGuidHob (&gLoaderMemoryMapInfoGuid, HobList);
+  if (GuidHob == NULL) {
+    return FALSE;
+  }
+
+  MapInfo = (MEMORY_MAP_INFO *)GET_GUID_HOB_DATA (GuidHob);
+
+  for (Index = 0; Index < MapInfo->Count; Index++) {
+    if ((MapInfo->Entry[Index].Type == MEM_MAP_TYPE_RAM) &&
+        (Base >= MapInfo->Entry[Index].Base) &&
+        (Base + Size <= MapInfo->Entry[Index].Base + MapInfo->Entry[Index].Size)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Get the address to place the protected mode kernel of a bzImage.
+
+  A relocatable kernel is placed at its preferred address when the memory
+  it needs there is RAM, so that it does not have to move itself before
+  decompressing. Otherwise it is placed at LINUX_KERNEL_BASE.
+
+  @param[in]  ImageBase      Memory address of the bzImage, at least its setup sectors.
+  @param[out] SetupSize      Size of the setup sectors that precede the protected
+                             mode kernel in the bzImage. Optional.
+
+  @retval     The address for the protected mode kernel, 0 if it is not a bzImage.
+**/
+UINTN
+EFIAPI
+GetBzImageKernelBase (
+  IN  CONST VOID             *ImageBase,
+  OUT UINT32                 *SetupSize     OPTIONAL
+  )
+{
+  CONST SETUP_HEADER         *Header;
+  UINT64                      KernelSize;
+
+  if (!IsBzImage (ImageBase)) {
+    return 0;
+  }
+
+  Header = &((CONST BOOT_PARAMS *)ImageBase)->Hdr;
+  if (SetupSize != NULL) {
+    if (Header->SetupSectorss != 0) {
+      *SetupSize = (Header->SetupSectorss + 1) * 512;
+    } else {
+      *SetupSize = 5 * 512;
+    }
+  }
+
+  //
+  // The preferred address and the memory needed to decompress the kernel
+  // are given since boot protocol 2.10
+  //
+  if ((Header->Version >= 0x020A) && (Header->RelocatableKernel != 0) &&
+      (Header->PrefAddress > LINUX_KERNEL_BASE) && (Header->PrefAddress < SIZE_4GB)) {
+    KernelSize = MAX (Header->InitSize, Header->SysSize * 16);
+    if (IsRamRange (Header->PrefAddress, KernelSize)) {
+      return (UINTN)Header->PrefAddress;
+    }
+  }
+
+  return LINUX_KERNEL_BASE;
+}
+
+/**
+  Setup boot parameters for a kernel placed at its load address.
+
+  @param[in]  ImageBase      Memory address of the bzImage setup sectors.
+  @param[in]  KernelBuf      Address of the protected mode kernel.
+  @param[in]  InitRdBase     Memory address of an InitRd image.
+  @param[in]  InitRdLen      InitRd image size.
+  @param[in]  CmdLineBase    Memory address of command line buffer.
+  @param[in]  CmdLineLen     Command line buffer size.
+**/
+STATIC
+VOID
+SetupBootParams (
+  IN  CONST VOID                  *ImageBase,
+  IN      UINTN                    KernelBuf,
+  IN  CONST VOID                  *InitRdBase,
+  IN      UINT32                   InitRdLen,
+  IN  CONST VOID                  *CmdLineBase,
+  IN      UINT32                   CmdLineLen
+  )
+{
+  BOOT_PARAMS                *Bp;
+  BOOT_PARAMS                *BaseBp;
+
+  BaseBp = (BOOT_PARAMS *) ImageBase;
+  Bp = GetLinuxBootParams ();
+  ZeroMem ((VOID *)Bp, sizeof (BOOT_PARAMS));
+  CopyMem (&Bp->Hdr, &BaseBp->Hdr, sizeof (SETUP_HEADER));
+
+  //
+  // Update boot params
+  //
+  Bp->Hdr.Code32Start  = (UINT32)KernelBuf;
+  Bp->Hdr.LoaderId     = 0xff;
+  Bp->Hdr.CmdLinePtr   = (UINT32)(UINTN)CmdLineBase;
+  Bp->Hdr.CmdlineSize  = CmdLineLen;
+  Bp->Hdr.RamDiskStart = (UINT32)(UINTN)InitRdBase;
+  Bp->Hdr.RamDisklen   = InitRdLen;
+}
+
 /**
   Load linux kernel image to specified address and setup boot parameters.
 
@@ -205,9 +343,7 @@ LoadBzImage (
   IN      UINT32                   CmdLineLen
   )
 {
-  BOOT_PARAMS                *Bp;
-  BOOT_PARAMS                *BaseBp;
-  VOID                       *KernelBuf;
+  UINTN                       KernelBuf;
   UINT32                      BootParamSize;
   UINTN                       KernelSize;
   VOID CONST                 *ImageBase;
@@ -217,33 +353,55 @@ LoadBzImage (
     return EFI_INVALID_PARAMETER;
   }
 
-  if (!IsBzImage (ImageBase)) {
+  KernelBuf = GetBzImageKernelBase (ImageBase, &BootParamSize);
+  if (KernelBuf == 0) {
     return EFI_UNSUPPORTED;
   }
 
-  BaseBp = (BOOT_PARAMS *) ImageBase;
-  Bp = GetLinuxBootParams ();
-  ZeroMem ((VOID *)Bp, sizeof (BOOT_PARAMS));
-  CopyMem (&Bp->Hdr, &BaseBp->Hdr, sizeof (SETUP_HEADER));
+  KernelSize = ((BOOT_PARAMS *) ImageBase)->Hdr.SysSize * 16;
+  CopyMem ((VOID *)KernelBuf, (UINT8 *)ImageBase + BootParamSize, KernelSize);
+
+  SetupBootParams (ImageBase, KernelBuf, InitRdBase, InitRdLen, CmdLineBase, CmdLineLen);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Setup boot parameters for a linux kernel whose protected mode kernel was
+  read to the address returned by GetBzImageKernelBase () already.
+
+  @param[in]  SetupBase      Memory address of the bzImage setup sectors.
+  @param[in]  InitRdBase     Memory address of an InitRd image.
+  @param[in]  InitRdLen      InitRd image size.
+  @param[in]  CmdLineBase    Memory address of command line buffer.
+  @param[in]  CmdLineLen     Command line buffer size.
 
-  if (Bp->Hdr.SetupSectorss != 0) {
-    BootParamSize = (Bp->Hdr.SetupSectorss + 1) * 512;
-  } else {
-    BootParamSize = 5 * 512;
+  @retval EFI_INVALID_PARAMETER   Input parameters are not valid.
+  @retval EFI_UNSUPPORTED         Unsupported binary type.
+  @retval EFI_SUCCESS             Boot parameters are setup successfully.
+**/
+EFI_STATUS
+EFIAPI
+SetupBzImage (
+  IN  CONST VOID                  *SetupBase,
+  IN  CONST VOID                  *InitRdBase,
+  IN      UINT32                   InitRdLen,
+  IN  CONST VOID                  *CmdLineBase,
+  IN      UINT32                   CmdLineLen
+  )
+{
+  UINTN                       KernelBuf;
+
+  if (SetupBase == NULL) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  KernelBuf  = (VOID *) (UINTN)LINUX_KERNEL_BASE;
-  KernelSize = Bp->Hdr.SysSize * 16;
-  CopyMem (KernelBuf, (UINT8 *)ImageBase + BootParamSize, KernelSize);
+  KernelBuf = GetBzImageKernelBase (SetupBase, NULL);
+  if (KernelBuf == 0) {
+    return EFI_UNSUPPORTED;
+  }
 
-  //
-  // Update boot params
-  //
-  Bp->Hdr.LoaderId     = 0xff;
-  Bp->Hdr.CmdLinePtr   = (UINT32)(UINTN)CmdLineBase;
-  Bp->Hdr.CmdlineSize  = CmdLineLen;
-  Bp->Hdr.RamDiskStart = (UINT32)(UINTN)InitRdBase;
-  Bp->Hdr.RamDisklen   = InitRdLen;
+  SetupBootParams (SetupBase, KernelBuf, InitRdBase, InitRdLen, CmdLineBase, CmdLineLen);
 
   return EFI_SUCCESS;
 }
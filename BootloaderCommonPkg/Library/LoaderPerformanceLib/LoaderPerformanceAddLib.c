@@ -6,8 +6,15 @@
 **/
 
 #include <PiPei.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/TimeStampLib.h>
 #include <Library/BootloaderCommonLib.h>
+#include <Library/LoaderPerformanceLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+
+// The span buffer grows up to this many times of PcdBootSpanBufferSize
+#define  BOOT_SPAN_GROW_LIMIT    16
 
 /**
   Add a given performance measure point timestamp.
@@ -45,3 +52,206 @@ AddMeasurePoint (
 {
   AddMeasurePointTimestamp (Id, ReadTimeStamp());
 }
+
+/**
+  Get the boot span buffer.
+
+  @param[in]  Create      Create the buffer if it does not exist yet.
+
+  @retval     The boot span buffer, NULL if it is not available.
+
+**/
+STATIC
+BOOT_SPAN_INFO *
+GetSpanBuffer (
+  IN  BOOLEAN        Create
+  )
+{
+  EFI_STATUS       Status;
+  BOOT_SPAN_INFO  *SpanInfo;
+  UINT32           Size;
+
+  Status = GetLibraryData (PcdGet8 (PcdBootSpanLibId), (VOID **)&SpanInfo);
+  if (!EFI_ERROR (Status) && (SpanInfo->Signature == BOOT_SPAN_INFO_SIGNATURE)) {
+    return SpanInfo;
+  }
+
+  Size = FixedPcdGet32 (PcdBootSpanBufferSize);
+  if (!Create || (Size < sizeof (BOOT_SPAN_INFO) + sizeof (BOOT_SPAN_RECORD))) {
+    return NULL;
+  }
+
+  SpanInfo = (BOOT_SPAN_INFO *) AllocateZeroPool (Size);
+  if (SpanInfo == NULL) {
+    return NULL;
+  }
+
+  SpanInfo->Signature   = BOOT_SPAN_INFO_SIGNATURE;
+  SpanInfo->Revision    = 1;
+  SpanInfo->Current     = BOOT_SPAN_NONE;
+  SpanInfo->FreqKhz     = GetTimeStampFrequency ();
+  SpanInfo->TotalLength = Size;
+  Status = SetLibraryData (PcdGet8 (PcdBootSpanLibId), SpanInfo, Size);
+  if (EFI_ERROR (Status)) {
+    // Library data is not ready yet
+    FreePool (SpanInfo);
+    return NULL;
+  }
+
+  return SpanInfo;
+}
+
+/**
+  Double the size of a full boot span buffer.
+
+  @param[in]  SpanInfo    The full boot span buffer.
+
+  @retval     The new boot span buffer, NULL if it cannot grow.
+
+**/
+STATIC
+BOOT_SPAN_INFO *
+GrowSpanBuffer (
+  IN  BOOT_SPAN_INFO  *SpanInfo
+  )
+{
+  BOOT_SPAN_INFO  *NewInfo;
+  UINT32           Size;
+
+  if (SpanInfo->TotalLength >= FixedPcdGet32 (PcdBootSpanBufferSize) * BOOT_SPAN_GROW_LIMIT) {
+    return NULL;
+  }
+
+  Size    = SpanInfo->TotalLength * 2;
+  NewInfo = (BOOT_SPAN_INFO *) AllocatePool (Size);
+  if (NewInfo == NULL) {
+    return NULL;
+  }
+
+  CopyMem (NewInfo, SpanInfo, sizeof (BOOT_SPAN_INFO) + SpanInfo->Count * sizeof (BOOT_SPAN_RECORD));
+  NewInfo->TotalLength = Size;
+  if (EFI_ERROR (SetLibraryData (PcdGet8 (PcdBootSpanLibId), NewInfo, Size))) {
+    FreePool (NewInfo);
+    return NULL;
+  }
+
+  //
+  // The old buffer is not freed since it might be a part of the
+  // library data block migrated from the previous stage.
+  //
+  return NewInfo;
+}
+
+/**
+  Begin a boot span.
+
+  Spans begun before the current span ends are nested in it.
+
+  @param[in]  Id          Measure point Id describing the span
+  @param[in]  Signature   Signature of the component owning the span
+  @param[in]  DeviceId    Device the span works on, 0 if none
+
+  @retval     Handle of the span, BOOT_SPAN_NONE if it is not recorded.
+
+**/
+UINT16
+BeginSpan (
+  IN  UINT16         Id,
+  IN  UINT32         Signature,
+  IN  UINT32         DeviceId
+  )
+{
+  BOOT_SPAN_INFO    *SpanInfo;
+  BOOT_SPAN_INFO    *NewInfo;
+  BOOT_SPAN_RECORD  *Span;
+  UINT16             Index;
+
+  SpanInfo = GetSpanBuffer (TRUE);
+  if (SpanInfo == NULL) {
+    return BOOT_SPAN_NONE;
+  }
+
+  if ((sizeof (BOOT_SPAN_INFO) + (SpanInfo->Count + 1) * sizeof (BOOT_SPAN_RECORD) > SpanInfo->TotalLength) ||
+      (SpanInfo->Count >= BOOT_SPAN_NONE)) {
+    NewInfo = NULL;
+    if (SpanInfo->Count < BOOT_SPAN_NONE) {
+      NewInfo = GrowSpanBuffer (SpanInfo);
+    }
+    if (NewInfo == NULL) {
+      SpanInfo->Flags |= BOOT_SPAN_INFO_FULL;
+      return BOOT_SPAN_NONE;
+    }
+    SpanInfo = NewInfo;
+  }
+
+  Index = (UINT16)SpanInfo->Count++;
+  Span  = &SpanInfo->Span[Index];
+  Span->Signature = Signature;
+  Span->Id        = Id;
+  Span->Parent    = SpanInfo->Current;
+  Span->Depth     = 0;
+  if (Span->Parent != BOOT_SPAN_NONE) {
+    Span->Depth   = (UINT8)(SpanInfo->Span[Span->Parent].Depth + 1);
+  }
+  Span->Flags     = BOOT_SPAN_OPEN;
+  Span->Reserved  = 0;
+  Span->DeviceId  = DeviceId;
+  Span->EndTsc    = 0;
+  Span->Bytes     = 0;
+  SpanInfo->Current = Index;
+  Span->StartTsc  = ReadTimeStamp ();
+
+  return Index;
+}
+
+/**
+  End a boot span.
+
+  @param[in]  Span        Handle returned by BeginSpan
+  @param[in]  Bytes       Number of bytes processed in the span
+
+**/
+VOID
+EndSpan (
+  IN  UINT16         Span,
+  IN  UINT64         Bytes
+  )
+{
+  UINT64             Tsc;
+  BOOT_SPAN_INFO    *SpanInfo;
+  BOOT_SPAN_RECORD  *Record;
+
+  Tsc = ReadTimeStamp ();
+  if (Span == BOOT_SPAN_NONE) {
+    return;
+  }
+
+  SpanInfo = GetSpanBuffer (FALSE);
+  if ((SpanInfo == NULL) || (Span >= SpanInfo->Count)) {
+    return;
+  }
+
+  Record = &SpanInfo->Span[Span];
+  if ((Record->Flags & BOOT_SPAN_OPEN) == 0) {
+    return;
+  }
+
+  Record->EndTsc    = Tsc;
+  Record->Bytes     = Bytes;
+  Record->Flags    &= (UINT8)~BOOT_SPAN_OPEN;
+  SpanInfo->Current = Record->Parent;
+}
+
+/**
+  Get the boot span buffer.
+
+  @retval     The boot span buffer, NULL if no span was recorded.
+
+**/
+BOOT_SPAN_INFO *
+GetBootSpanInfo (
+  VOID
+  )
+{
+  return GetSpanBuffer (FALSE);
+}
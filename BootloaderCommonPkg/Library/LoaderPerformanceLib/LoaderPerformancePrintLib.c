@@ -372,6 +372,55 @@ PrintBootloaderPerfData (
   DEBUG ((DEBUG_INFO | DEBUG_EVENT, "------+------------+------------+----------------------------------\n"));
 }
 
+/**
+  Print Bootloader boot span information.
+
+  @param[in]  PerfIdToStrTbl    A pointer to description table corresponding to Id
+
+**/
+VOID
+PrintBootloaderSpans (
+  IN PERF_ID_TO_STR  PerfIdToStrTbl
+  )
+{
+  BOOT_SPAN_INFO    *SpanInfo;
+  BOOT_SPAN_RECORD  *Span;
+  UINT32             Idx;
+  UINT32             Start;
+  UINT32             Time;
+  CHAR8              Sig[5];
+  CHAR8              Indent[17];
+  UINT32             IndentLen;
+
+  SpanInfo = GetBootSpanInfo ();
+  if ((SpanInfo == NULL) || (SpanInfo->FreqKhz == 0)) {
+    return;
+  }
+
+  Sig[4] = 0;
+  SetMem (Indent, sizeof (Indent) - 1, ' ');
+  DEBUG ((DEBUG_INFO | DEBUG_EVENT, " Id   | Start (ms) | Time (us)  | Comp | Device   | Bytes      | Description\n"));
+  DEBUG ((DEBUG_INFO | DEBUG_EVENT, "------+------------+------------+------+----------+------------+-----------------------\n"));
+  for (Idx = 0; Idx < SpanInfo->Count; Idx++) {
+    Span  = &SpanInfo->Span[Idx];
+    Start = (UINT32)DivU64x32 (Span->StartTsc, SpanInfo->FreqKhz);
+    Time  = 0;
+    if ((Span->Flags & BOOT_SPAN_OPEN) == 0) {
+      Time = (UINT32)DivU64x32 (MultU64x32 (Span->EndTsc - Span->StartTsc, 1000), SpanInfo->FreqKhz);
+    }
+    CopyMem (Sig, &Span->Signature, sizeof (Span->Signature));
+    IndentLen = MIN (Span->Depth * 2, sizeof (Indent) - 1);
+    Indent[IndentLen] = 0;
+    DEBUG ((DEBUG_INFO | DEBUG_EVENT, " %4X | %7d ms | %7d us | %a | %08X | %10ld | %a%a\n",
+      Span->Id, Start, Time, Sig, Span->DeviceId, Span->Bytes, Indent, PerfIdToStr (Span->Id, PerfIdToStrTbl)));
+    Indent[IndentLen] = ' ';
+  }
+  DEBUG ((DEBUG_INFO | DEBUG_EVENT, "------+------------+------------+------+----------+------------+-----------------------\n"));
+  if ((SpanInfo->Flags & BOOT_SPAN_INFO_FULL) != 0) {
+    DEBUG ((DEBUG_INFO | DEBUG_EVENT, " Span buffer is full, later spans are not recorded\n"));
+  }
+}
+
 /**
   Print Bootloader Measure Point information.
 
@@ -395,4 +444,9 @@ PrintMeasurePoint (
   if ((PcdGet32 (PcdBootPerformanceMask) & BIT1) != 0) {
     PrintFspPerfData ();
   }
+
+  // Print bootloader boot spans
+  if ((PcdGet32 (PcdBootPerformanceMask) & BIT2) != 0) {
+    PrintBootloaderSpans (PerfIdToStrTbl);
+  }
 }
@@ -60,6 +60,32 @@ typedef UINTN*                uptrval;
 #define unlikely(expr)        expect((expr) != 0, 0)
 #define LZ4_wildCopy(d,s,e)   {UINT64 *d1 = (UINT64 *)(d); UINT64 *s1 = (UINT64 *)(s); do {*d1++=*s1++;} while ((BYTE *)d1<e);}
 #define LZ4_copy8(d,s)        *(UINT64 *)(d) = *(UINT64 *)(s)
+#define LZ4_wideCopy(w,d,s,l) {if ((w) == 32) Lz4WideCopyAvx2((d),(s),(l)); else Lz4WideCopySse2((d),(s),(l));}
+
+/*-************************************
+*  Wide copy, see Lz4WideCopy.nasm
+**************************************/
+UINT32
+EFIAPI
+Lz4GetWideCopySize (
+  VOID
+  );
+
+VOID
+EFIAPI
+Lz4WideCopySse2 (
+  OUT VOID        *Destination,
+  IN  CONST VOID  *Source,
+  IN  UINTN        Length
+  );
+
+VOID
+EFIAPI
+Lz4WideCopyAvx2 (
+  OUT VOID        *Destination,
+  IN  CONST VOID  *Source,
+  IN  UINTN        Length
+  );
 
 /*-************************************
 *  Common Constants
@@ -131,7 +157,8 @@ FORCE_INLINE int LZ4_decompress_generic(
                  int dict,               /* noDict, withPrefix64k, usingExtDict */
                  const BYTE* const lowPrefix,  /* == dest when no prefix */
                  const BYTE* const dictStart,  /* only if dict==usingExtDict */
-                 const size_t dictSize         /* note : = 0 if noDict */
+                 const size_t dictSize,        /* note : = 0 if noDict */
+                 const size_t wideSize         /* wide copy size in bytes, 0 if not supported */
                  )
 {
     /* Local Variables */
@@ -193,7 +220,11 @@ FORCE_INLINE int LZ4_decompress_generic(
             op += length;
             break;     /* Necessarily EOF, due to parsing restrictions */
         }
-        LZ4_wildCopy(op, ip, cpy);
+        if ((wideSize) && (length >= 2*wideSize)) {
+            LZ4_wideCopy(wideSize, op, ip, length);
+        } else {
+            LZ4_wildCopy(op, ip, cpy);
+        }
         ip += length; op = cpy;
 
         /* get offset */
@@ -242,8 +273,24 @@ FORCE_INLINE int LZ4_decompress_generic(
         }
 #endif
 
-        /* copy match within block */
+        /* copy long match within block using wide copy */
         cpy = op + length;
+        if ((wideSize) && (length >= 4*wideSize) && (offset != 0) && (cpy <= oend-12)) {
+            if (offset < wideSize) {
+                /* expand the pattern until it repeats at least every wideSize bytes */
+                size_t period = offset;
+                size_t i;
+                while (period < wideSize) period += offset;
+                for (i = 0; i < period; i++) op[i] = match[i];
+                op += period;
+                match = op - period;
+            }
+            LZ4_wideCopy(wideSize, op, match, (size_t)(cpy - op));
+            op = cpy;
+            continue;
+        }
+
+        /* copy match within block */
         if (unlikely(offset<8)) {
             const int dec64 = dec64table[offset];
             op[0] = match[0];
@@ -286,7 +333,8 @@ _output_error:
 
 int LZ4_decompress_safe(const char* source, char* dest, int compressedSize, int maxDecompressedSize)
 {
-    return LZ4_decompress_generic(source, dest, compressedSize, maxDecompressedSize, endOnInputSize, full, 0, noDict, (BYTE*)dest, NULL, 0);
+    return LZ4_decompress_generic(source, dest, compressedSize, maxDecompressedSize, endOnInputSize, full, 0, noDict, (BYTE*)dest, NULL, 0,
+                                  Lz4GetWideCopySize());
 }
 
 
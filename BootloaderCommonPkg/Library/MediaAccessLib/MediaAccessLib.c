@@ -21,6 +21,25 @@
 
 OS_BOOT_MEDIUM_TYPE   mCurrentMediaType = OsBootDeviceMax;
 DEVICE_BLOCK_FUNC     mDeviceBlockFuncs[OsBootDeviceMax];
+MEDIA_READ_TOKEN     *mPendingRead;
+
+/**
+  Finish the outstanding asynchronous read, if any.
+
+  The device interfaces handle one request at a time, so this has to be done
+  before any other access is sent to the media.
+
+**/
+STATIC
+VOID
+MediaFinishPendingRead (
+  VOID
+  )
+{
+  if (mPendingRead != NULL) {
+    MediaWaitBlocks (mPendingRead);
+  }
+}
 
 /**
   Get current media interface type.
@@ -72,6 +91,8 @@ MediaSetInterfaceType (
       mDeviceBlockFuncs[Type].GetInfo     = AhciGetMediaInfo;
       mDeviceBlockFuncs[Type].ReadBlocks  = AhciReadBlocks;
       mDeviceBlockFuncs[Type].WriteBlocks = AhciWriteBlocks;
+      mDeviceBlockFuncs[Type].ReadBlocksAsync = AhciReadBlocksAsync;
+      mDeviceBlockFuncs[Type].PollBlocks  = AhciPollBlocks;
     }
 
     Type = OsBootDeviceEmmc;
@@ -82,6 +103,8 @@ MediaSetInterfaceType (
       mDeviceBlockFuncs[Type].WriteBlocks = MmcWriteBlocks;
       mDeviceBlockFuncs[Type].WriteBlocksExt = MmcWriteBlocksExt;
       mDeviceBlockFuncs[Type].DevTuning   = MmcTuning;
+      mDeviceBlockFuncs[Type].ReadBlocksAsync = MmcReadBlocksAsync;
+      mDeviceBlockFuncs[Type].PollBlocks  = MmcPollBlocks;
     }
 
     Type = OsBootDeviceSd;
@@ -90,6 +113,8 @@ MediaSetInterfaceType (
       mDeviceBlockFuncs[Type].GetInfo     = MmcGetMediaInfo;
       mDeviceBlockFuncs[Type].ReadBlocks  = MmcReadBlocks;
       mDeviceBlockFuncs[Type].WriteBlocks = MmcWriteBlocks;
+      mDeviceBlockFuncs[Type].ReadBlocksAsync = MmcReadBlocksAsync;
+      mDeviceBlockFuncs[Type].PollBlocks  = MmcPollBlocks;
     }
 
     Type = OsBootDeviceUfs;
@@ -123,6 +148,8 @@ MediaSetInterfaceType (
       mDeviceBlockFuncs[Type].GetInfo     = NvmeGetMediaInfo;
       mDeviceBlockFuncs[Type].ReadBlocks  = NvmeReadBlocks;
       mDeviceBlockFuncs[Type].WriteBlocks = NvmeWriteBlocks;
+      mDeviceBlockFuncs[Type].ReadBlocksAsync = NvmeReadBlocksAsync;
+      mDeviceBlockFuncs[Type].PollBlocks  = NvmePollBlocks;
     }
 
     Type = OsBootDeviceMemory;
@@ -188,9 +215,161 @@ MediaReadBlocks (
     return EFI_UNSUPPORTED;
   }
 
+  MediaFinishPendingRead ();
+
   return mDeviceBlockFuncs[mCurrentMediaType].ReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
 }
 
+/**
+  Start reading the requested number of blocks from the specified block device.
+
+  The function returns as soon as the read is started, so that the caller can
+  process other data while the device transfers. MediaPollBlocks () or
+  MediaWaitBlocks () report when the data is in the buffer. Media interfaces
+  without asynchronous support complete the read before returning.
+
+  Only one asynchronous read is outstanding at a time. Starting another one, or
+  any other media access, waits for the outstanding read to finish first.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            It must not be accessed until the read has finished.
+  @param[out] Token         Tracks the read for MediaPollBlocks () and MediaWaitBlocks ().
+
+  @retval EFI_SUCCESS             The read was started or has already finished.
+  @retval EFI_UNSUPPORTED         The interface is not supported.
+  @retval EFI_NOT_READY           The MediaSetInterfaceType() has not been called yet.
+  @retval EFI_INVALID_PARAMETER   Token is NULL, the read request contains LBAs that are
+                                  not valid, or the buffer is not properly aligned.
+  @retval Others                  The read could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaReadBlocksAsync (
+  IN  UINTN                          DeviceIndex,
+  IN  EFI_LBA                        StartLBA,
+  IN  UINTN                          BufferSize,
+  OUT VOID                          *Buffer,
+  OUT MEDIA_READ_TOKEN              *Token
+  )
+{
+  EFI_STATUS          Status;
+  DEVICE_BLOCK_FUNC  *BlockFunc;
+
+  if (Token == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mCurrentMediaType >= OsBootDeviceMax) {
+    return EFI_NOT_READY;
+  }
+
+  BlockFunc = &mDeviceBlockFuncs[mCurrentMediaType];
+  if (BlockFunc->ReadBlocks == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MediaFinishPendingRead ();
+
+  Token->MediaType   = mCurrentMediaType;
+  Token->DeviceIndex = DeviceIndex;
+
+  if ((BlockFunc->ReadBlocksAsync == NULL) || (BlockFunc->PollBlocks == NULL)) {
+    //
+    // Synchronous fallback, the read is finished once started
+    //
+    Status = BlockFunc->ReadBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
+    Token->Status = Status;
+    return Status;
+  }
+
+  Status = BlockFunc->ReadBlocksAsync (DeviceIndex, StartLBA, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    Token->Status = Status;
+    return Status;
+  }
+
+  Token->Status = EFI_NOT_READY;
+  mPendingRead  = Token;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check a read started by MediaReadBlocksAsync () without waiting.
+
+  @param[in, out]  Token    The token returned by MediaReadBlocksAsync ().
+
+  @retval EFI_SUCCESS             The data was read correctly from the device.
+  @retval EFI_NOT_READY           The read is still in progress.
+  @retval EFI_INVALID_PARAMETER   Token is NULL.
+  @retval Others                  The read has finished with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaPollBlocks (
+  IN OUT MEDIA_READ_TOKEN           *Token
+  )
+{
+  EFI_STATUS          Status;
+
+  if (Token == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Token->Status != EFI_NOT_READY) {
+    return Token->Status;
+  }
+
+  Status = mDeviceBlockFuncs[Token->MediaType].PollBlocks (Token->DeviceIndex);
+  if (Status != EFI_NOT_READY) {
+    Token->Status = Status;
+    if (mPendingRead == Token) {
+      mPendingRead = NULL;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Wait for a read started by MediaReadBlocksAsync () to finish.
+
+  @param[in, out]  Token    The token returned by MediaReadBlocksAsync ().
+
+  @retval EFI_SUCCESS             The data was read correctly from the device.
+  @retval EFI_INVALID_PARAMETER   Token is NULL.
+  @retval Others                  The read has finished with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+MediaWaitBlocks (
+  IN OUT MEDIA_READ_TOKEN           *Token
+  )
+{
+  EFI_STATUS          Status;
+
+  //
+  // The device interfaces time out the read themselves
+  //
+  do {
+    Status = MediaPollBlocks (Token);
+    if (Status == EFI_NOT_READY) {
+      CpuPause ();
+    }
+  } while (Status == EFI_NOT_READY);
+
+  return Status;
+}
+
 /**
   This function writes data from Memory to media
 
@@ -227,6 +406,8 @@ MediaWriteBlocks (
     return EFI_UNSUPPORTED;
   }
 
+  MediaFinishPendingRead ();
+
   return mDeviceBlockFuncs[mCurrentMediaType].WriteBlocks (DeviceIndex, StartLBA, BufferSize, Buffer);
 }
 
@@ -300,6 +481,8 @@ MediaInitialize (
     return EFI_UNSUPPORTED;
   }
 
+  MediaFinishPendingRead ();
+
   return mDeviceBlockFuncs[mCurrentMediaType].DevInit (MediaHcPciBase, DevInitPhase);
 }
 
@@ -342,6 +525,8 @@ MediaWriteBlocksExt (
     return EFI_UNSUPPORTED;
   }
 
+  MediaFinishPendingRead ();
+
   return mDeviceBlockFuncs[mCurrentMediaType].WriteBlocksExt (DeviceIndex, StartLBA, BufferSize, Buffer, IsReliableWrite);
 }
 
@@ -370,6 +555,8 @@ MediaTuning (
     return EFI_UNSUPPORTED;
   }
 
+  MediaFinishPendingRead ();
+
   return mDeviceBlockFuncs[mCurrentMediaType].DevTuning (MediaHcPciBase);
 }
 
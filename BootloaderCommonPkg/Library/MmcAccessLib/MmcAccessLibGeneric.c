@@ -19,6 +19,8 @@
 #include <Library/CryptoLib.h>
 #include <Library/PrintLib.h>
 
+STATIC MMC_ASYNC_READ  mMmcAsyncRead;
+
 /**
   Decode and print EMMC CSD Register content.
 
@@ -1614,6 +1616,75 @@ MmcStopTransmission (
   return Status;
 }
 
+/**
+  Build the read/write multiple blocks command packet.
+
+  @param[in]  Private           A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Lba               The starting logical block address to be read/written.
+  @param[in]  Buffer            A pointer to the destination/source buffer for the data.
+  @param[in]  BufferSize        Size of Buffer, must be a multiple of device block size.
+  @param[in]  IsRead            Indicates it is a read or write operation.
+  @param[out] SdMmcCmdBlk       The command block to fill.
+  @param[out] SdMmcStatusBlk    The status block to use.
+  @param[out] Packet            The command packet to fill.
+
+**/
+STATIC
+VOID
+MmcBuildRwPacket (
+  IN  SD_MMC_HC_PRIVATE_DATA               *Private,
+  IN  EFI_LBA                               Lba,
+  IN  VOID                                 *Buffer,
+  IN  UINTN                                 BufferSize,
+  IN  BOOLEAN                               IsRead,
+  OUT EFI_SD_MMC_COMMAND_BLOCK             *SdMmcCmdBlk,
+  OUT EFI_SD_MMC_STATUS_BLOCK              *SdMmcStatusBlk,
+  OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet
+  )
+{
+  EMMC_CARD_DATA                       *CardData;
+
+  CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
+
+  ZeroMem (SdMmcCmdBlk, sizeof (*SdMmcCmdBlk));
+  ZeroMem (SdMmcStatusBlk, sizeof (*SdMmcStatusBlk));
+  ZeroMem (Packet, sizeof (*Packet));
+
+  Packet->SdMmcCmdBlk    = SdMmcCmdBlk;
+  Packet->SdMmcStatusBlk = SdMmcStatusBlk;
+  Packet->Timeout        = (BufferSize / (2 * 1024 * 1024) + 1) * 1000 * 1000;
+
+  if (IsRead) {
+    Packet->InDataBuffer     = Buffer;
+    Packet->InTransferLength = (UINT32)BufferSize;
+
+    if (BufferSize > CardData->BlockLen) {
+      SdMmcCmdBlk->CommandIndex = EMMC_READ_MULTIPLE_BLOCK;
+    } else {
+      SdMmcCmdBlk->CommandIndex = EMMC_READ_SINGLE_BLOCK;
+    }
+    SdMmcCmdBlk->CommandType  = SdMmcCommandTypeAdtc;
+    SdMmcCmdBlk->ResponseType = SdMmcResponseTypeR1;
+  } else {
+    Packet->OutDataBuffer     = Buffer;
+    Packet->OutTransferLength = (UINT32)BufferSize;
+
+    if (BufferSize > CardData->BlockLen) {
+      SdMmcCmdBlk->CommandIndex = EMMC_WRITE_MULTIPLE_BLOCK;
+    } else {
+      SdMmcCmdBlk->CommandIndex = EMMC_WRITE_BLOCK;
+    }
+    SdMmcCmdBlk->CommandType  = SdMmcCommandTypeAdtc;
+    SdMmcCmdBlk->ResponseType = SdMmcResponseTypeR1;
+  }
+
+  if (Private->Slot.SectorAddressing) {
+    SdMmcCmdBlk->CommandArgument = (UINT32)Lba;
+  } else {
+    SdMmcCmdBlk->CommandArgument = (UINT32)MultU64x32 (Lba, CardData->BlockLen);
+  }
+}
+
 /**
   Read/write multiple blocks through sync or async I/O request.
 
@@ -1643,51 +1714,206 @@ MmcRwMultiBlocks (
   EFI_SD_MMC_STATUS_BLOCK               SdMmcStatusBlk;
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   Packet;
   EFI_STATUS                            Status;
+
+  MmcBuildRwPacket (Private, Lba, Buffer, BufferSize, IsRead, &SdMmcCmdBlk, &SdMmcStatusBlk, &Packet);
+
+  Status = SdMmcSendCommand (Private, &Packet);
+
+  return Status;
+}
+
+/**
+  Get the maximum number of blocks of a single read/write command.
+
+  @param[in]  Private           A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+
+  @retval     The maximum number of blocks.
+
+**/
+STATIC
+UINT32
+MmcGetMaxRwBlock (
+  IN  SD_MMC_HC_PRIVATE_DATA   *Private
+  )
+{
+  UINT32                                MaxBlock;
   EMMC_CARD_DATA                       *CardData;
 
   CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
 
-  ZeroMem (&SdMmcCmdBlk, sizeof (SdMmcCmdBlk));
-  ZeroMem (&SdMmcStatusBlk, sizeof (SdMmcStatusBlk));
-  ZeroMem (&Packet, sizeof (Packet));
+  MaxBlock = PcdGet16 (PcdEmmcMaxRwBlockNumber);
+  if (FeaturePcdGet(PcdDmaProtectionEnabled)) {
+    // When DMA protection is enabled, only tranfer less than DMA buffer size
+    // Use half for safe.  Around 1MB will be used for CmdTable.
+    MaxBlock = (PcdGet32 (PcdDmaBufferSize) >> 1) / CardData->BlockLen;
+    if (MaxBlock == 0) {
+      MaxBlock = 1;
+    }
+    if (MaxBlock > PcdGet16 (PcdEmmcMaxRwBlockNumber)) {
+      MaxBlock = PcdGet16 (PcdEmmcMaxRwBlockNumber);
+    }
+  }
 
-  Packet.SdMmcCmdBlk    = &SdMmcCmdBlk;
-  Packet.SdMmcStatusBlk = &SdMmcStatusBlk;
-  Packet.Timeout        = (BufferSize / (2 * 1024 * 1024) + 1) * 1000 * 1000;
+  return MaxBlock;
+}
 
-  if (IsRead) {
-    Packet.InDataBuffer     = Buffer;
-    Packet.InTransferLength = (UINT32)BufferSize;
+/**
+  Bring the device back to transfer state after a failed read/write command.
 
-    if (BufferSize > CardData->BlockLen) {
-      SdMmcCmdBlk.CommandIndex = EMMC_READ_MULTIPLE_BLOCK;
-    } else {
-      SdMmcCmdBlk.CommandIndex = EMMC_READ_SINGLE_BLOCK;
+  @param[in]  Private           A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+
+**/
+STATIC
+VOID
+MmcRecoverRw (
+  IN  SD_MMC_HC_PRIVATE_DATA   *Private
+  )
+{
+  UINT32                                DevStatus;
+  UINT32                                DevState;
+  UINT16                                Rca;
+
+  Rca = 1;
+  MmcSendStatus (Private, Rca, &DevStatus);
+  DevState = (DevStatus >> 9) & 0x0F;
+
+  if (DevState == 6) {
+    DEBUG ((DEBUG_ERROR, "EMMC device state is 'RCV', Sending STOP_TRANSMISSION (CMD12)\n"));
+    MmcStopTransmission (Private, Rca);
+  }
+}
+
+/**
+  Issue the next read command of the asynchronous read.
+
+  @retval EFI_SUCCESS           The command is running.
+  @retval Others                The command could not be issued.
+
+**/
+STATIC
+EFI_STATUS
+MmcAsyncReadNext (
+  VOID
+  )
+{
+  EFI_STATUS                            Status;
+  SD_MMC_HC_PRIVATE_DATA               *Private;
+  EMMC_CARD_DATA                       *CardData;
+
+  Private  = mMmcAsyncRead.Private;
+  CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
+
+  mMmcAsyncRead.BlockNum = MIN (mMmcAsyncRead.Remaining, mMmcAsyncRead.MaxBlock);
+  if (Private->Slot.CardType != SdCardType) {
+    Status = MmcSetBlkCount (Private, (UINT16)mMmcAsyncRead.BlockNum, FALSE);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "EmmcRead  MmcSetBlkCount Failed: Lba 0x%x, BlockNum 0x%x with 0x%x\n",
+              (UINT32)mMmcAsyncRead.Lba, mMmcAsyncRead.BlockNum, Status));
+      return Status;
     }
-    SdMmcCmdBlk.CommandType  = SdMmcCommandTypeAdtc;
-    SdMmcCmdBlk.ResponseType = SdMmcResponseTypeR1;
-  } else {
-    Packet.OutDataBuffer     = Buffer;
-    Packet.OutTransferLength = (UINT32)BufferSize;
+  }
 
-    if (BufferSize > CardData->BlockLen) {
-      SdMmcCmdBlk.CommandIndex = EMMC_WRITE_MULTIPLE_BLOCK;
-    } else {
-      SdMmcCmdBlk.CommandIndex = EMMC_WRITE_BLOCK;
+  MmcBuildRwPacket (Private, mMmcAsyncRead.Lba, mMmcAsyncRead.Buffer, mMmcAsyncRead.BlockNum * CardData->BlockLen,
+                    TRUE, &mMmcAsyncRead.SdMmcCmdBlk, &mMmcAsyncRead.SdMmcStatusBlk, &mMmcAsyncRead.Packet);
+
+  mMmcAsyncRead.StartTime = GetTimeInNanoSecond (GetPerformanceCounter ());
+  Status = SdMmcStartCommand (Private, &mMmcAsyncRead.Packet, &mMmcAsyncRead.Trb);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "EmmcRead  Failed: Lba 0x%x, BlockNum 0x%x with %r\n", (UINT32)mMmcAsyncRead.Lba,
+            mMmcAsyncRead.BlockNum, Status));
+    MmcRecoverRw (Private);
+  }
+
+  return Status;
+}
+
+/**
+  Check the read started by MmcReadBlocksAsync () without waiting.
+
+  @retval EFI_SUCCESS           The data was read correctly from the device.
+  @retval EFI_NOT_READY         The read is still in progress.
+  @retval EFI_NOT_FOUND         No read is outstanding.
+  @retval EFI_TIMEOUT           The running command did not complete in time.
+  @retval Others                The read failed.
+
+**/
+STATIC
+EFI_STATUS
+MmcPollAsyncRead (
+  VOID
+  )
+{
+  EFI_STATUS                            Status;
+  SD_MMC_HC_PRIVATE_DATA               *Private;
+  EMMC_CARD_DATA                       *CardData;
+
+  Private = mMmcAsyncRead.Private;
+  if (Private == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Nothing to transfer for a zero size read
+  //
+  if (mMmcAsyncRead.Remaining == 0) {
+    mMmcAsyncRead.Private = NULL;
+    return EFI_SUCCESS;
+  }
+
+  Status = SdMmcCheckTrbResult (Private, mMmcAsyncRead.Trb);
+  if (Status == EFI_NOT_READY) {
+    if ((GetTimeInNanoSecond (GetPerformanceCounter ()) - mMmcAsyncRead.StartTime) <
+        MultU64x32 (mMmcAsyncRead.Packet.Timeout, 1000)) {
+      return EFI_NOT_READY;
     }
-    SdMmcCmdBlk.CommandType  = SdMmcCommandTypeAdtc;
-    SdMmcCmdBlk.ResponseType = SdMmcResponseTypeR1;
+    Status = EFI_TIMEOUT;
   }
 
-  if (Private->Slot.SectorAddressing) {
-    SdMmcCmdBlk.CommandArgument = (UINT32)Lba;
-  } else {
-    SdMmcCmdBlk.CommandArgument = (UINT32)MultU64x32 (Lba, CardData->BlockLen);
+  SdMmcFreeTrb (mMmcAsyncRead.Trb);
+  mMmcAsyncRead.Trb = NULL;
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "EmmcRead  Failed: Lba 0x%x, BlockNum 0x%x with %r\n", (UINT32)mMmcAsyncRead.Lba,
+            mMmcAsyncRead.BlockNum, Status));
+    MmcRecoverRw (Private);
+    mMmcAsyncRead.Private = NULL;
+    return Status;
   }
 
-  Status = SdMmcSendCommand (Private, &Packet);
+  CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
+  mMmcAsyncRead.Lba       += mMmcAsyncRead.BlockNum;
+  mMmcAsyncRead.Buffer    += mMmcAsyncRead.BlockNum * CardData->BlockLen;
+  mMmcAsyncRead.Remaining -= mMmcAsyncRead.BlockNum;
+  if (mMmcAsyncRead.Remaining == 0) {
+    mMmcAsyncRead.Private = NULL;
+    return EFI_SUCCESS;
+  }
 
-  return Status;
+  Status = MmcAsyncReadNext ();
+  if (EFI_ERROR (Status)) {
+    mMmcAsyncRead.Private = NULL;
+    return Status;
+  }
+
+  return EFI_NOT_READY;
+}
+
+/**
+  Wait for the read started by MmcReadBlocksAsync () if there is one.
+
+  Every other command has to wait for it since the host runs one command at a
+  time.
+
+**/
+STATIC
+VOID
+MmcFinishAsyncRead (
+  VOID
+  )
+{
+  while (MmcPollAsyncRead () == EFI_NOT_READY) {
+    CpuPause ();
+  }
 }
 
 /**
@@ -1727,30 +1953,18 @@ MmcReadWrite (
   UINTN                                 BlockNum;
   UINTN                                 Remaining;
   UINT32                                MaxBlock;
-  UINT32                                DevStatus;
-  UINT32                                DevState;
-  UINT16                                Rca;
   EMMC_CARD_DATA                       *CardData;
 
   Status = EFI_SUCCESS;
 
+  MmcFinishAsyncRead ();
+
   CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
   BlockNum  = (BufferSize + CardData->BlockLen - 1) / CardData->BlockLen;
 
   Remaining = BlockNum;
 
-  MaxBlock = PcdGet16 (PcdEmmcMaxRwBlockNumber);
-  if (FeaturePcdGet(PcdDmaProtectionEnabled)) {
-    // When DMA protection is enabled, only tranfer less than DMA buffer size
-    // Use half for safe.  Around 1MB will be used for CmdTable.
-    MaxBlock = (PcdGet32 (PcdDmaBufferSize) >> 1) / CardData->BlockLen;
-    if (MaxBlock == 0) {
-      MaxBlock = 1;
-    }
-    if (MaxBlock > PcdGet16 (PcdEmmcMaxRwBlockNumber)) {
-      MaxBlock = PcdGet16 (PcdEmmcMaxRwBlockNumber);
-    }
-  }
+  MaxBlock = MmcGetMaxRwBlock (Private);
 
   DEBUG ((DEBUG_VERBOSE, "MmcReadWrite Lba=0x%x Buffer=0x%p BufferSize=0x%x, BlockNum=0x%x\n",
           (UINT32)Lba, Buffer, BufferSize, BlockNum));
@@ -1776,15 +1990,7 @@ MmcReadWrite (
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "Emmc%a Failed: Lba 0x%x, BlockNum 0x%x with %r\n", IsRead ? "Read " : "Write", (UINT32)Lba,
               BlockNum, Status));
-      Rca = 1;
-      MmcSendStatus (Private, Rca, &DevStatus);
-      DevState = (DevStatus >> 9) & 0x0F;
-
-      if (DevState == 6) {
-        DEBUG ((DEBUG_ERROR, "EMMC device state is 'RCV', Sending STOP_TRANSMISSION (CMD12)\n"));
-        MmcStopTransmission (Private, Rca);
-      }
-
+      MmcRecoverRw (Private);
       return Status;
     }
     DEBUG ((DEBUG_VERBOSE, "Emmc%a: Lba 0x%x, BlockNum 0x%x with %r\n", IsRead ? "Read " : "Write", (UINT32)Lba, BlockNum,
@@ -2053,6 +2259,8 @@ MmcSelectPart (
     return EFI_NOT_READY;
   }
 
+  MmcFinishAsyncRead ();
+
   Private = MmcGetHcPrivateData();
   if (Private == NULL) {
     return EFI_NOT_READY;
@@ -2150,6 +2358,113 @@ MmcReadBlocks (
   return Status;
 }
 
+/**
+  This function starts reading data from EMMC to Memory without waiting for
+  the data.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+  @param[in]  StartLBA      The starting logical block address (LBA) to read from
+                            on the device
+  @param[in]  BufferSize    The size of the Buffer in bytes. This number must be
+                            a multiple of the intrinsic block size of the device.
+  @param[out] Buffer        A pointer to the destination buffer for the data.
+                            It must not be touched until MmcPollBlocks () no
+                            longer returns EFI_NOT_READY.
+
+  @retval EFI_SUCCESS             The read was started.
+  @retval EFI_ALREADY_STARTED     An asynchronous read is already outstanding.
+  @retval EFI_NOT_READY           The device is not initialized.
+  @retval EFI_INVALID_PARAMETER   The buffer is not valid.
+  @retval Others                  The read could not be started.
+
+**/
+EFI_STATUS
+EFIAPI
+MmcReadBlocksAsync (
+  IN  UINTN                         DeviceIndex,
+  IN  EFI_LBA                       StartLBA,
+  IN  UINTN                         BufferSize,
+  OUT VOID                          *Buffer
+  )
+{
+  EFI_STATUS                        Status;
+  SD_MMC_HC_PRIVATE_DATA            *Private;
+  EMMC_CARD_DATA                    *CardData;
+
+  if (mMmcAsyncRead.Private != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  if (!MmcIsInitialized()) {
+    return EFI_NOT_READY;
+  }
+
+  Private = MmcGetHcPrivateData();
+  if (Private == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  if ((Buffer == NULL) && (BufferSize != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (DeviceIndex != Private->CurrentPartition) {
+    Status = MmcSelectPart ((UINT8)DeviceIndex);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  CardData = (EMMC_CARD_DATA *) Private->Slot.CardData;
+  mMmcAsyncRead.DeviceIndex = DeviceIndex;
+  mMmcAsyncRead.Lba         = StartLBA;
+  mMmcAsyncRead.Buffer      = Buffer;
+  mMmcAsyncRead.Remaining   = (BufferSize + CardData->BlockLen - 1) / CardData->BlockLen;
+  mMmcAsyncRead.MaxBlock    = MmcGetMaxRwBlock (Private);
+  mMmcAsyncRead.Trb         = NULL;
+  mMmcAsyncRead.Private     = Private;
+  if (mMmcAsyncRead.Remaining == 0) {
+    //
+    // Completed by the next MmcPollBlocks ()
+    //
+    return EFI_SUCCESS;
+  }
+
+  Status = MmcAsyncReadNext ();
+  if (EFI_ERROR (Status)) {
+    mMmcAsyncRead.Private = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  This function checks the read started by MmcReadBlocksAsync () without
+  waiting.
+
+  @param[in]  DeviceIndex   Specifies the block device to which the function wants
+                            to talk.
+
+  @retval EFI_SUCCESS             The data was read correctly from the device.
+  @retval EFI_NOT_READY           The read is still in progress.
+  @retval EFI_NOT_FOUND           No read is outstanding on the device.
+  @retval Others                  The read failed.
+
+**/
+EFI_STATUS
+EFIAPI
+MmcPollBlocks (
+  IN  UINTN                         DeviceIndex
+  )
+{
+  if ((mMmcAsyncRead.Private == NULL) || (mMmcAsyncRead.DeviceIndex != DeviceIndex)) {
+    return EFI_NOT_FOUND;
+  }
+
+  return MmcPollAsyncRead ();
+}
+
 /**
   This function is an extention of MmcWriteBlocks API.
 
@@ -15,6 +15,25 @@
 #define  SD_OCR_30      18
 #define  SD_OCR_LOW     7
 
+//
+// Read started by MmcReadBlocksAsync (). The packet is kept here since the
+// running TRB refers to it.
+//
+typedef struct {
+  SD_MMC_HC_PRIVATE_DATA                *Private;           // NULL when idle
+  UINTN                                 DeviceIndex;        // Partition the read was started on
+  EFI_LBA                               Lba;                // Start of the running command
+  UINT8                                 *Buffer;
+  UINTN                                 Remaining;
+  UINT32                                MaxBlock;
+  UINTN                                 BlockNum;           // Blocks of the running command
+  EFI_SD_MMC_COMMAND_BLOCK              SdMmcCmdBlk;
+  EFI_SD_MMC_STATUS_BLOCK               SdMmcStatusBlk;
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   Packet;
+  SD_MMC_HC_TRB                         *Trb;
+  UINT64                                StartTime;          // Start of the running command in ns
+} MMC_ASYNC_READ;
+
 /**
   Get a pointer to the SD_MMC_HC_PRIVATE_DATA instance.
 
@@ -219,6 +219,31 @@ SdMmcWaitTrbResult (
   IN SD_MMC_HC_TRB                    *Trb
   );
 
+/**
+  Start a SD command without waiting for its completion.
+
+  The command is checked with SdMmcCheckTrbResult () and the returned TRB must
+  be released with SdMmcFreeTrb () once it is no longer pending. Packet must
+  stay valid until then.
+
+  @param[in]  Private           A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Packet            A pointer to the SD command data structure.
+  @param[out] Trb               The TRB of the running command.
+
+  @retval EFI_SUCCESS           The SD Command Packet was started by the host.
+  @retval EFI_INVALID_PARAMETER Packet, Slot, or the contents of the Packet is invalid.
+  @retval EFI_NO_MEDIA          SD Device not present in the Slot.
+  @retval EFI_OUT_OF_RESOURCES  The TRB could not be allocated.
+  @retval Others                The command could not be started.
+
+**/
+EFI_STATUS
+SdMmcStartCommand (
+  IN     SD_MMC_HC_PRIVATE_DATA                *Private,
+  IN     EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   *Packet,
+  OUT    SD_MMC_HC_TRB                        **Trb
+  );
+
 /**
   Sends SD command to an SD card that is attached to the SD controller.
 
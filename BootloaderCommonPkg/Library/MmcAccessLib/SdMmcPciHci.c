@@ -1784,49 +1784,34 @@ SdMmcWaitTrbResult (
 }
 
 /**
-  Sends SD command to an SD card that is attached to the SD controller.
-
-  The PassThru() function sends the SD command specified by Packet to the SD card
-  specified by Slot.
-
-  If Packet is successfully sent to the SD card, then EFI_SUCCESS is returned.
-
-  If a device error occurs while sending the Packet, then EFI_DEVICE_ERROR is returned.
-
-  If Slot is not in a valid range for the SD controller, then EFI_INVALID_PARAMETER
-  is returned.
+  Start a SD command without waiting for its completion.
 
-  If Packet defines a data command but both InDataBuffer and OutDataBuffer are NULL,
-  EFI_INVALID_PARAMETER is returned.
+  The command is checked with SdMmcCheckTrbResult () and the returned TRB must
+  be released with SdMmcFreeTrb () once it is no longer pending. Packet must
+  stay valid until then.
 
-  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
-  @param[in,out] Packet         A pointer to the SD command data structure.
+  @param[in]  Private           A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Packet            A pointer to the SD command data structure.
+  @param[out] Trb               The TRB of the running command.
 
-  @retval EFI_SUCCESS           The SD Command Packet was sent by the host.
-  @retval EFI_DEVICE_ERROR      A device error occurred while attempting to send the SD
-                                command Packet.
+  @retval EFI_SUCCESS           The SD Command Packet was started by the host.
   @retval EFI_INVALID_PARAMETER Packet, Slot, or the contents of the Packet is invalid.
-  @retval EFI_INVALID_PARAMETER Packet defines a data command but both InDataBuffer and
-                                OutDataBuffer are NULL.
   @retval EFI_NO_MEDIA          SD Device not present in the Slot.
-  @retval EFI_UNSUPPORTED       The command described by the SD Command Packet is not
-                                supported by the host controller.
-  @retval EFI_BAD_BUFFER_SIZE   The InTransferLength or OutTransferLength exceeds the
-                                limit supported by SD card ( i.e. if the number of bytes
-                                exceed the Last LBA).
+  @retval EFI_OUT_OF_RESOURCES  The TRB could not be allocated.
+  @retval Others                The command could not be started.
 
 **/
 EFI_STATUS
-EFIAPI
-SdMmcSendCommand (
+SdMmcStartCommand (
   IN     SD_MMC_HC_PRIVATE_DATA                *Private,
-  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   *Packet
+  IN     EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   *Packet,
+  OUT    SD_MMC_HC_TRB                        **Trb
   )
 {
   EFI_STATUS                      Status;
-  SD_MMC_HC_TRB                   *Trb;
+  SD_MMC_HC_TRB                   *NewTrb;
 
-  if ((Private == 0x0) || (Packet == NULL)) {
+  if ((Private == 0x0) || (Packet == NULL) || (Trb == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -1846,27 +1831,79 @@ SdMmcSendCommand (
     return EFI_NO_MEDIA;
   }
 
-  Trb = SdMmcCreateTrb (Private, Packet);
-  if (Trb == NULL) {
+  NewTrb = SdMmcCreateTrb (Private, Packet);
+  if (NewTrb == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Status = SdMmcWaitTrbEnv (Private, Trb);
+  Status = SdMmcWaitTrbEnv (Private, NewTrb);
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
-  Status = SdMmcExecTrb (Private, Trb);
+  Status = SdMmcExecTrb (Private, NewTrb);
   if (EFI_ERROR (Status)) {
     goto Done;
   }
 
-  Status = SdMmcWaitTrbResult (Private, Trb);
+  *Trb = NewTrb;
+  return EFI_SUCCESS;
+
+Done:
+  SdMmcFreeTrb (NewTrb);
+
+  return Status;
+}
+
+/**
+  Sends SD command to an SD card that is attached to the SD controller.
+
+  The PassThru() function sends the SD command specified by Packet to the SD card
+  specified by Slot.
+
+  If Packet is successfully sent to the SD card, then EFI_SUCCESS is returned.
+
+  If a device error occurs while sending the Packet, then EFI_DEVICE_ERROR is returned.
+
+  If Slot is not in a valid range for the SD controller, then EFI_INVALID_PARAMETER
+  is returned.
+
+  If Packet defines a data command but both InDataBuffer and OutDataBuffer are NULL,
+  EFI_INVALID_PARAMETER is returned.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in,out] Packet         A pointer to the SD command data structure.
+
+  @retval EFI_SUCCESS           The SD Command Packet was sent by the host.
+  @retval EFI_DEVICE_ERROR      A device error occurred while attempting to send the SD
+                                command Packet.
+  @retval EFI_INVALID_PARAMETER Packet, Slot, or the contents of the Packet is invalid.
+  @retval EFI_INVALID_PARAMETER Packet defines a data command but both InDataBuffer and
+                                OutDataBuffer are NULL.
+  @retval EFI_NO_MEDIA          SD Device not present in the Slot.
+  @retval EFI_UNSUPPORTED       The command described by the SD Command Packet is not
+                                supported by the host controller.
+  @retval EFI_BAD_BUFFER_SIZE   The InTransferLength or OutTransferLength exceeds the
+                                limit supported by SD card ( i.e. if the number of bytes
+                                exceed the Last LBA).
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcSendCommand (
+  IN     SD_MMC_HC_PRIVATE_DATA                *Private,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET   *Packet
+  )
+{
+  EFI_STATUS                      Status;
+  SD_MMC_HC_TRB                   *Trb;
+
+  Status = SdMmcStartCommand (Private, Packet, &Trb);
   if (EFI_ERROR (Status)) {
-    goto Done;
+    return Status;
   }
 
-Done:
+  Status = SdMmcWaitTrbResult (Private, Trb);
   SdMmcFreeTrb (Trb);
 
   return Status;
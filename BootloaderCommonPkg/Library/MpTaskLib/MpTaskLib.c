@@ -0,0 +1,263 @@
+/** @file
+  Simple job scheduler to run short tasks on the idle application processors.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/MpTaskLib.h>
+
+#define  MP_TASK_QUEUE_SIZE    32
+
+STATIC SYS_CPU_TASK           *mSysCpuTask;
+STATIC MP_TASK_JOB            *mJobQueue[MP_TASK_QUEUE_SIZE];
+STATIC volatile UINT32         mJobHead;
+STATIC volatile UINT32         mJobTail;
+STATIC volatile UINT32         mJobPending;
+
+/**
+  Take the next queued job.
+
+  It can be called from any processor.
+
+  @retval NULL         The queue is empty.
+  @retval Others       The job taken from the queue.
+
+**/
+STATIC
+MP_TASK_JOB *
+TakeJob (
+  VOID
+  )
+{
+  MP_TASK_JOB   *Job;
+  UINT32         Head;
+
+  do {
+    Head = mJobHead;
+    if (Head == mJobTail) {
+      return NULL;
+    }
+    // Read the slot before claiming it, since the BSP may reuse it right after
+    Job = mJobQueue[Head % MP_TASK_QUEUE_SIZE];
+  } while (InterlockedCompareExchange32 (&mJobHead, Head, Head + 1) != Head);
+
+  return Job;
+}
+
+/**
+  Run a job on the current processor.
+
+  @param[in]  Job        Job to run.
+
+**/
+STATIC
+VOID
+RunJob (
+  IN  MP_TASK_JOB   *Job
+  )
+{
+  Job->State  = EnumMpJobRunning;
+  Job->Result = Job->TaskFunc (Job->Argument);
+  MemoryFence ();
+  Job->State  = EnumMpJobDone;
+  InterlockedDecrement (&mJobPending);
+}
+
+/**
+  AP task function to drain the job queue.
+
+  @param[in]  Argument   Not used.
+
+  @retval     Always 0.
+
+**/
+STATIC
+UINT64
+EFIAPI
+MpTaskWorker (
+  IN  UINT64   Argument
+  )
+{
+  MP_TASK_JOB   *Job;
+
+  while ((Job = TakeJob ()) != NULL) {
+    RunJob (Job);
+  }
+
+  return 0;
+}
+
+/**
+  Start the job worker on the first idle application processor.
+
+**/
+STATIC
+VOID
+KickIdleAp (
+  VOID
+  )
+{
+  volatile CPU_TASK   *CpuTask;
+  UINT32               Index;
+
+  if (mSysCpuTask == NULL) {
+    return;
+  }
+
+  for (Index = 1; Index < mSysCpuTask->CpuCount; Index++) {
+    CpuTask = &mSysCpuTask->CpuTask[Index];
+    if (CpuTask->State == EnumCpuReady) {
+      CpuTask->TaskFunc = (UINT64)(UINTN)MpTaskWorker;
+      CpuTask->Argument = 0;
+      MemoryFence ();
+      CpuTask->State    = EnumCpuStart;
+      break;
+    }
+  }
+}
+
+/**
+  Initialize the job scheduler with the processor task state.
+
+  @param[in]  SysCpuTask   Pointer to SYS_CPU_TASK structure for all CPUs.
+                           NULL to run all jobs on the BSP.
+
+  @retval EFI_SUCCESS      The scheduler was initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskInit (
+  IN  SYS_CPU_TASK   *SysCpuTask
+  )
+{
+  MpTaskJoin ();
+
+  mSysCpuTask = SysCpuTask;
+  DEBUG ((DEBUG_INFO, "MP task workers: %d\n", MpTaskGetWorkerCount ()));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the number of application processors available to run jobs.
+
+  @retval    The number of application processors.
+
+**/
+UINT32
+EFIAPI
+MpTaskGetWorkerCount (
+  VOID
+  )
+{
+  if ((mSysCpuTask == NULL) || (mSysCpuTask->CpuCount == 0)) {
+    return 0;
+  }
+
+  return mSysCpuTask->CpuCount - 1;
+}
+
+/**
+  Submit a job to the scheduler.
+
+  The job structure must stay valid until MpTaskWait () or MpTaskJoin ()
+  returns. If the queue is full, the job is run on the BSP immediately.
+
+  @param[in,out]  Job        Job to submit.
+  @param[in]      TaskFunc   Job function pointer.
+  @param[in]      Argument   Argument for the job function.
+
+  @retval EFI_INVALID_PARAMETER   Job or TaskFunc is NULL.
+  @retval EFI_SUCCESS             The job was queued or has completed.
+
+**/
+EFI_STATUS
+EFIAPI
+MpTaskSubmit (
+  IN OUT MP_TASK_JOB    *Job,
+  IN     CPU_TASK_FUNC   TaskFunc,
+  IN     UINT64          Argument
+  )
+{
+  if ((Job == NULL) || (TaskFunc == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Job->TaskFunc = TaskFunc;
+  Job->Argument = Argument;
+  Job->Result   = 0;
+  Job->State    = EnumMpJobQueued;
+  InterlockedIncrement (&mJobPending);
+
+  if ((mJobTail - mJobHead) >= MP_TASK_QUEUE_SIZE) {
+    RunJob (Job);
+    return EFI_SUCCESS;
+  }
+
+  // Only the BSP produces jobs, so the tail needs no lock
+  mJobQueue[mJobTail % MP_TASK_QUEUE_SIZE] = Job;
+  MemoryFence ();
+  mJobTail++;
+
+  KickIdleAp ();
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Wait for a submitted job to complete.
+
+  While waiting, the BSP runs queued jobs itself.
+
+  @param[in]  Job        Job to wait for.
+
+  @retval     The return value of the job function.
+
+**/
+UINT64
+EFIAPI
+MpTaskWait (
+  IN  MP_TASK_JOB   *Job
+  )
+{
+  MP_TASK_JOB   *Next;
+
+  while (Job->State != EnumMpJobDone) {
+    Next = TakeJob ();
+    if (Next != NULL) {
+      RunJob (Next);
+    } else {
+      CpuPause ();
+    }
+  }
+
+  return Job->Result;
+}
+
+/**
+  Wait for all submitted jobs to complete.
+
+**/
+VOID
+EFIAPI
+MpTaskJoin (
+  VOID
+  )
+{
+  MP_TASK_JOB   *Job;
+
+  while ((Job = TakeJob ()) != NULL) {
+    RunJob (Job);
+  }
+
+  while (mJobPending != 0) {
+    CpuPause ();
+  }
+}
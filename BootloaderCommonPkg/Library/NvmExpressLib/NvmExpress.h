@@ -53,8 +53,12 @@ VOID
 #define NVME_ASQ_SIZE                             1     // Number of admin submission queue entries, which is 0-based
 #define NVME_ACQ_SIZE                             1     // Number of admin completion queue entries, which is 0-based
 
-#define NVME_CSQ_SIZE                             1     // Number of I/O submission queue entries, which is 0-based
-#define NVME_CCQ_SIZE                             1     // Number of I/O completion queue entries, which is 0-based
+//
+// Number of blocking I/O submission and completion queue entries, which is 0-based.
+// Large reads keep up to NVME_CSQ_SIZE commands outstanding on this queue.
+//
+#define NVME_CSQ_SIZE                             15
+#define NVME_CCQ_SIZE                             15
 
 //
 // Number of asynchronous I/O submission queue entries, which is 0-based.
@@ -86,6 +90,34 @@ VOID
 //
 #define NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE    SIGNATURE_32 ('N','V','M','E')
 
+//
+// Resources of a command outstanding on the blocking I/O queue.
+// The PRP list pages are kept across commands and only grow when needed.
+//
+typedef struct {
+  BOOLEAN                             InUse;
+  UINT16                              Cid;
+  VOID                                *MapData;
+  VOID                                *PrpListHost;
+  EFI_PHYSICAL_ADDRESS                PrpListPhyAddr;
+  UINTN                               PrpListNo;
+  VOID                                *MapPrpList;
+} NVME_IO_SLOT;
+
+//
+// A transfer split into several commands on the blocking I/O queue.
+//
+typedef struct {
+  NVME_DEVICE_PRIVATE_DATA            *Device;
+  UINT8                               Opcode;
+  UINT8                               *Buffer;      // Next block to submit
+  UINT64                              Lba;
+  UINTN                               Blocks;       // Blocks not submitted yet
+  UINT32                              CmdBlocks;
+  UINT64                              Progress;     // Time of the last completion in ns
+  EFI_STATUS                          Status;
+} NVME_QUEUED_TRANSFER;
+
 //
 // Nvme private data structure.
 //
@@ -130,6 +162,19 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   UINT8                               Pt[NVME_MAX_QUEUES];
   UINT16                              Cid[NVME_MAX_QUEUES];
 
+  //
+  // Number of entries of the blocking I/O queue, and the commands
+  // outstanding on it.
+  //
+  UINT16                              IoQueueSize;
+  UINT16                              IoInFlight;
+  NVME_IO_SLOT                        IoSlot[NVME_CSQ_SIZE];
+
+  //
+  // Read started by NvmeBlockIoReadBlocksAsync (), Device is NULL when idle.
+  //
+  NVME_QUEUED_TRANSFER                AsyncRead;
+
   //
   // Nvme controller capabilities
   //
@@ -373,5 +418,81 @@ NvmeDumpStatus (
   IN NVME_CQ             *Cq
   );
 
+/**
+  Submit a read or write command to the blocking I/O queue without waiting for it.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  NamespaceId    The namespace the command is sent to.
+  @param[in]  Opcode         NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param[in]  Buffer         The data buffer.
+  @param[in]  Lba            The start block number.
+  @param[in]  Blocks         Total block number to be transferred.
+  @param[in]  BlockSize      The media block size.
+
+  @retval EFI_SUCCESS            The command was placed in the submission queue.
+  @retval EFI_NOT_READY          The submission queue is full.
+  @retval EFI_OUT_OF_RESOURCES   The data buffer or PRP list could not be mapped.
+  @retval Others                 The doorbell could not be written.
+
+**/
+EFI_STATUS
+NvmeIoQueueSubmit (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private,
+  IN UINT32                            NamespaceId,
+  IN UINT8                             Opcode,
+  IN VOID                              *Buffer,
+  IN UINT64                            Lba,
+  IN UINT32                            Blocks,
+  IN UINT32                            BlockSize
+  );
+
+/**
+  Wait for the next command on the blocking I/O queue to complete.
+
+  Commands may complete in any order, the resources of the completed one
+  are released and its status is returned.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  Timeout        The time to wait in 100ns units, 0 only checks once.
+
+  @retval EFI_SUCCESS            A command completed successfully.
+  @retval EFI_NOT_FOUND          No command is outstanding.
+  @retval EFI_NOT_READY          Timeout is 0 and no command has completed.
+  @retval EFI_DEVICE_ERROR       A command completed with an error.
+  @retval EFI_TIMEOUT            No command completed in time, all outstanding commands are dropped.
+
+**/
+EFI_STATUS
+NvmeIoQueueComplete (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private,
+  IN UINT64                            Timeout
+  );
+
+/**
+  Drop all the commands outstanding on the blocking I/O queue.
+
+  The controller is reset first, so that it stops transferring data for those
+  commands, and the I/O queues are created again. The data buffers are left
+  mapped if the controller could not be reset.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeIoQueueAbort (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private
+  );
+
+/**
+  Release the PRP lists kept for the blocking I/O queue.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeIoQueueFree (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private
+  );
+
 
 #endif
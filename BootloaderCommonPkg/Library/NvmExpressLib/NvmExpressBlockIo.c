@@ -41,6 +41,213 @@ GetMaxTransferBlockNumber (
   return MaxTransferBlocks;
 }
 
+/**
+  Prepare a transfer to be split into commands on the I/O queue.
+
+  The transfer is split into commands of at most MaxTransferBlocks blocks. When the
+  data is bounced through the DMA buffer, the commands are made smaller so that all
+  the outstanding ones fit into the space of a single maximum transfer.
+
+  @param  Transfer               The transfer to prepare.
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Opcode                 NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param  Buffer                 The data buffer.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred.
+  @param  MaxTransferBlocks      Max block number of a single command.
+
+**/
+STATIC
+VOID
+NvmeQueuedInit (
+  OUT    NVME_QUEUED_TRANSFER           *Transfer,
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN     UINT8                          Opcode,
+  IN     VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN     UINTN                          Blocks,
+  IN     UINT32                         MaxTransferBlocks
+  )
+{
+  Transfer->Device    = Device;
+  Transfer->Opcode    = Opcode;
+  Transfer->Buffer    = (UINT8 *)Buffer;
+  Transfer->Lba       = Lba;
+  Transfer->Blocks    = Blocks;
+  Transfer->CmdBlocks = MaxTransferBlocks;
+  Transfer->Progress  = GetTimeInNanoSecond (GetPerformanceCounter ());
+  Transfer->Status    = EFI_SUCCESS;
+  if (FeaturePcdGet (PcdDmaProtectionEnabled)) {
+    Transfer->CmdBlocks = MAX (MaxTransferBlocks / (Device->Controller->IoQueueSize - 1), 1);
+  }
+}
+
+/**
+  Submit commands of a transfer until the I/O queue is full.
+
+  Nothing more is submitted once a command could not be submitted, the error is
+  kept in the transfer status.
+
+  @param  Transfer               The transfer to submit commands for.
+
+**/
+STATIC
+VOID
+NvmeQueuedFill (
+  IN OUT NVME_QUEUED_TRANSFER           *Transfer
+  )
+{
+  EFI_STATUS                       Status;
+  NVME_DEVICE_PRIVATE_DATA         *Device;
+  UINT32                           BlockSize;
+
+  Device    = Transfer->Device;
+  BlockSize = Device->Media.BlockSize;
+  while ((Transfer->Blocks > 0) && !EFI_ERROR (Transfer->Status)) {
+    if (Transfer->Blocks < Transfer->CmdBlocks) {
+      Transfer->CmdBlocks = (UINT32)Transfer->Blocks;
+    }
+    Status = NvmeIoQueueSubmit (Device->Controller, Device->NamespaceId, Transfer->Opcode,
+                                Transfer->Buffer, Transfer->Lba, Transfer->CmdBlocks, BlockSize);
+    if (Status == EFI_NOT_READY) {
+      break;
+    }
+    if (EFI_ERROR (Status)) {
+      Transfer->Status = Status;
+      break;
+    }
+    Transfer->Blocks -= Transfer->CmdBlocks;
+    Transfer->Buffer += Transfer->CmdBlocks * BlockSize;
+    Transfer->Lba    += Transfer->CmdBlocks;
+  }
+}
+
+/**
+  Transfer blocks with several commands outstanding on the I/O queue.
+
+  New commands are submitted as soon as earlier ones complete.
+
+  @param  Device                 The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Opcode                 NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param  Buffer                 The data buffer.
+  @param  Lba                    The start block number.
+  @param  Blocks                 Total block number to be transferred, updated with
+                                 the block number not submitted on return.
+  @param  MaxTransferBlocks      Max block number of a single command.
+
+  @retval EFI_SUCCESS            Datum are transferred.
+  @retval Others                 Fail to transfer all the datum.
+
+**/
+STATIC
+EFI_STATUS
+NvmeQueuedTransfer (
+  IN     NVME_DEVICE_PRIVATE_DATA       *Device,
+  IN     UINT8                          Opcode,
+  IN     VOID                           *Buffer,
+  IN     UINT64                         Lba,
+  IN OUT UINTN                          *Blocks,
+  IN     UINT32                         MaxTransferBlocks
+  )
+{
+  EFI_STATUS                       Status;
+  NVME_QUEUED_TRANSFER             Transfer;
+
+  NvmeQueuedInit (&Transfer, Device, Opcode, Buffer, Lba, *Blocks, MaxTransferBlocks);
+  while (TRUE) {
+    //
+    // Fill the submission queue, then reap one completion to make room.
+    //
+    NvmeQueuedFill (&Transfer);
+    if (Device->Controller->IoInFlight == 0) {
+      break;
+    }
+
+    Status = NvmeIoQueueComplete (Device->Controller, NVME_GENERIC_TIMEOUT);
+    if (EFI_ERROR (Status) && !EFI_ERROR (Transfer.Status)) {
+      Transfer.Status = Status;
+    }
+  }
+
+  *Blocks = Transfer.Blocks;
+  return Transfer.Status;
+}
+
+/**
+  Check the read started by NvmeBlockIoReadBlocksAsync () without waiting.
+
+  Completed commands are reaped and new ones are submitted in their place.
+
+  @param  Private                The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @retval EFI_SUCCESS            Datum are read from the device.
+  @retval EFI_NOT_READY          The read is still in progress.
+  @retval EFI_NOT_FOUND          No read is outstanding.
+  @retval Others                 Fail to read all the datum.
+
+**/
+STATIC
+EFI_STATUS
+NvmePollAsync (
+  IN NVME_CONTROLLER_PRIVATE_DATA       *Private
+  )
+{
+  EFI_STATUS                       Status;
+  NVME_QUEUED_TRANSFER             *Transfer;
+
+  Transfer = &Private->AsyncRead;
+  if (Transfer->Device == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  while (Private->IoInFlight > 0) {
+    Status = NvmeIoQueueComplete (Private, 0);
+    if (Status == EFI_NOT_READY) {
+      break;
+    }
+    Transfer->Progress = GetTimeInNanoSecond (GetPerformanceCounter ());
+    if (EFI_ERROR (Status) && !EFI_ERROR (Transfer->Status)) {
+      Transfer->Status = Status;
+    }
+  }
+
+  NvmeQueuedFill (Transfer);
+
+  if (Private->IoInFlight > 0) {
+    if ((GetTimeInNanoSecond (GetPerformanceCounter ()) - Transfer->Progress) <
+        MultU64x32 (NVME_GENERIC_TIMEOUT, 100)) {
+      return EFI_NOT_READY;
+    }
+    DEBUG ((DEBUG_ERROR, "NvmePollAsync: read timed out at Lba 0x%lx\n", Transfer->Lba));
+    NvmeIoQueueAbort (Private);
+    if (!EFI_ERROR (Transfer->Status)) {
+      Transfer->Status = EFI_TIMEOUT;
+    }
+  }
+
+  Transfer->Device = NULL;
+  return Transfer->Status;
+}
+
+/**
+  Finish the read started by NvmeBlockIoReadBlocksAsync (), if any.
+
+  The read shares the I/O queue with all other commands, so it has to be
+  finished before another command is sent. Its status is dropped here.
+
+  @param  Private                The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+STATIC
+VOID
+NvmeFinishAsync (
+  IN NVME_CONTROLLER_PRIVATE_DATA       *Private
+  )
+{
+  while (NvmePollAsync (Private) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+}
 
 /**
   Read some sectors from the device.
@@ -219,22 +426,14 @@ NvmeRead (
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = ReadSectors (Device, (UINT64) (UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *) (UINTN) ((UINT64) (UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = ReadSectors (Device, (UINT64) (UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  NvmeFinishAsync (Private);
 
-    if (EFI_ERROR (Status)) {
-      break;
-    }
+  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
+  if (Blocks > MaxTransferBlocks) {
+    Status = NvmeQueuedTransfer (Device, NVME_IO_READ_OPC, Buffer, Lba, &Blocks, MaxTransferBlocks);
+  } else if (Blocks > 0) {
+    Status = ReadSectors (Device, (UINT64) (UINTN)Buffer, Lba, (UINT32)Blocks);
+    Blocks = 0;
   }
 
   DEBUG ((DEBUG_VERBOSE, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -289,22 +488,14 @@ NvmeWrite (
   BlockSize     = Device->Media.BlockSize;
   OrginalBlocks = Blocks;
 
-  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = WriteSectors (Device, (UINT64) (UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *) (UINTN) ((UINT64) (UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = WriteSectors (Device, (UINT64) (UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  NvmeFinishAsync (Private);
 
-    if (EFI_ERROR (Status)) {
-      break;
-    }
+  MaxTransferBlocks = GetMaxTransferBlockNumber (Private, BlockSize);
+  if (Blocks > MaxTransferBlocks) {
+    Status = NvmeQueuedTransfer (Device, NVME_IO_WRITE_OPC, Buffer, Lba, &Blocks, MaxTransferBlocks);
+  } else if (Blocks > 0) {
+    Status = WriteSectors (Device, (UINT64) (UINTN)Buffer, Lba, (UINT32)Blocks);
+    Blocks = 0;
   }
 
   DEBUG ((DEBUG_VERBOSE, "%a: Lba = 0x%08Lx, Original = 0x%08Lx, "
@@ -336,6 +527,8 @@ NvmeFlush (
 
   Private = Device->Controller;
 
+  NvmeFinishAsync (Private);
+
   ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
   ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
   ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -401,6 +594,66 @@ NvmeBlockIoReset (
   return Status;
 }
 
+/**
+  Check the parameters of a read request.
+
+  @param  Media      The media to read from.
+  @param  MediaId    Id of the media, changes every time the media is replaced.
+  @param  Lba        The starting Logical Block Address to read from.
+  @param  BufferSize Size of Buffer, must be a multiple of device block size.
+  @param  Buffer     A pointer to the destination buffer for the data.
+
+  @retval EFI_SUCCESS           The request is valid, or BufferSize is 0.
+  @retval EFI_MEDIA_CHANGED     The MediaId does not matched the current device.
+  @retval EFI_BAD_BUFFER_SIZE   The Buffer was not a multiple of the block size of the device.
+  @retval EFI_INVALID_PARAMETER The read request contains LBAs that are not valid,
+                                or the buffer is not on proper alignment.
+
+**/
+STATIC
+EFI_STATUS
+NvmeCheckReadRequest (
+  IN  EFI_BLOCK_IO_MEDIA      *Media,
+  IN  UINT32                  MediaId,
+  IN  EFI_LBA                 Lba,
+  IN  UINTN                   BufferSize,
+  IN  VOID                    *Buffer
+  )
+{
+  UINTN                             BlockSize;
+  UINTN                             NumberOfBlocks;
+  UINTN                             IoAlign;
+
+  if (MediaId != Media->MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if (Buffer == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (BufferSize == 0) {
+    return EFI_SUCCESS;
+  }
+
+  BlockSize = Media->BlockSize;
+  if ((BufferSize % BlockSize) != 0) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  NumberOfBlocks  = BufferSize / BlockSize;
+  if ((Lba + NumberOfBlocks - 1) > Media->LastBlock) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  IoAlign = Media->IoAlign;
+  if (IoAlign > 0 && (((UINTN) Buffer & (IoAlign - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read BufferSize bytes from Lba into Buffer.
 
@@ -432,10 +685,6 @@ NvmeBlockIoReadBlocks (
 {
   NVME_DEVICE_PRIVATE_DATA          *Device;
   EFI_STATUS                        Status;
-  EFI_BLOCK_IO_MEDIA                *Media;
-  UINTN                             BlockSize;
-  UINTN                             NumberOfBlocks;
-  UINTN                             IoAlign;
 
   //
   // Check parameters.
@@ -444,40 +693,101 @@ NvmeBlockIoReadBlocks (
     return EFI_INVALID_PARAMETER;
   }
 
-  Media = This->Media;
-
-  if (MediaId != Media->MediaId) {
-    return EFI_MEDIA_CHANGED;
+  Status = NvmeCheckReadRequest (This->Media, MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status) || (BufferSize == 0)) {
+    return Status;
   }
 
-  if (Buffer == NULL) {
+  Device = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
+
+  Status = NvmeRead (Device, Buffer, Lba, BufferSize / This->Media->BlockSize);
+
+  return Status;
+}
+
+/**
+  Start reading BufferSize bytes from Lba into Buffer without waiting for the data.
+
+  The read keeps up to a full I/O queue of commands outstanding, and more are
+  submitted each time NvmeBlockIoPollBlocks () is called.
+
+  @param  This       Indicates a pointer to the calling context.
+  @param  MediaId    Id of the media, changes every time the media is replaced.
+  @param  Lba        The starting Logical Block Address to read from.
+  @param  BufferSize Size of Buffer, must be a multiple of device block size.
+  @param  Buffer     A pointer to the destination buffer for the data. It must not
+                     be accessed until NvmeBlockIoPollBlocks () reports completion.
+
+  @retval EFI_SUCCESS           The read was started.
+  @retval EFI_ALREADY_STARTED   A read is already outstanding on the controller.
+  @retval EFI_MEDIA_CHANGED     The MediaId does not matched the current device.
+  @retval EFI_BAD_BUFFER_SIZE   The Buffer was not a multiple of the block size of the device.
+  @retval EFI_INVALID_PARAMETER The read request contains LBAs that are not valid,
+                                or the buffer is not on proper alignment.
+
+**/
+EFI_STATUS
+NvmeBlockIoReadBlocksAsync (
+  IN  EFI_BLOCK_IO_PROTOCOL   *This,
+  IN  UINT32                  MediaId,
+  IN  EFI_LBA                 Lba,
+  IN  UINTN                   BufferSize,
+  OUT VOID                    *Buffer
+  )
+{
+  NVME_DEVICE_PRIVATE_DATA          *Device;
+  NVME_CONTROLLER_PRIVATE_DATA      *Private;
+  EFI_STATUS                        Status;
+  UINT32                            BlockSize;
+
+  if (This == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  if (BufferSize == 0) {
-    return EFI_SUCCESS;
+  Status = NvmeCheckReadRequest (This->Media, MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  BlockSize = Media->BlockSize;
-  if ((BufferSize % BlockSize) != 0) {
-    return EFI_BAD_BUFFER_SIZE;
+  Device  = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
+  Private = Device->Controller;
+  if (Private->AsyncRead.Device != NULL) {
+    return EFI_ALREADY_STARTED;
   }
 
-  NumberOfBlocks  = BufferSize / BlockSize;
-  if ((Lba + NumberOfBlocks - 1) > Media->LastBlock) {
-    return EFI_INVALID_PARAMETER;
-  }
+  BlockSize = Device->Media.BlockSize;
+  NvmeQueuedInit (&Private->AsyncRead, Device, NVME_IO_READ_OPC, Buffer, Lba,
+                  BufferSize / BlockSize, GetMaxTransferBlockNumber (Private, BlockSize));
+  NvmeQueuedFill (&Private->AsyncRead);
 
-  IoAlign = Media->IoAlign;
-  if (IoAlign > 0 && (((UINTN) Buffer & (IoAlign - 1)) != 0)) {
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the read started by NvmeBlockIoReadBlocksAsync () without waiting.
+
+  @param  This       Indicates a pointer to the calling context.
+
+  @retval EFI_SUCCESS           The data was read correctly from the device.
+  @retval EFI_NOT_READY         The read is still in progress.
+  @retval EFI_NOT_FOUND         No read is outstanding.
+  @retval Others                The read failed.
+
+**/
+EFI_STATUS
+NvmeBlockIoPollBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL   *This
+  )
+{
+  NVME_DEVICE_PRIVATE_DATA          *Device;
+
+  if (This == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
   Device = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
 
-  Status = NvmeRead (Device, Buffer, Lba, NumberOfBlocks);
-
-  return Status;
+  return NvmePollAsync (Device->Controller);
 }
 
 /**
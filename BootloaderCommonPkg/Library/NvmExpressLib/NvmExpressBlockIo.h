@@ -56,6 +56,52 @@ NvmeBlockIoReadBlocks (
   OUT VOID                    *Buffer
   );
 
+/**
+  Start reading BufferSize bytes from Lba into Buffer without waiting for the data.
+
+  The read keeps up to a full I/O queue of commands outstanding, and more are
+  submitted each time NvmeBlockIoPollBlocks () is called.
+
+  @param  This       Indicates a pointer to the calling context.
+  @param  MediaId    Id of the media, changes every time the media is replaced.
+  @param  Lba        The starting Logical Block Address to read from.
+  @param  BufferSize Size of Buffer, must be a multiple of device block size.
+  @param  Buffer     A pointer to the destination buffer for the data. It must not
+                     be accessed until NvmeBlockIoPollBlocks () reports completion.
+
+  @retval EFI_SUCCESS           The read was started.
+  @retval EFI_ALREADY_STARTED   A read is already outstanding on the controller.
+  @retval EFI_MEDIA_CHANGED     The MediaId does not matched the current device.
+  @retval EFI_BAD_BUFFER_SIZE   The Buffer was not a multiple of the block size of the device.
+  @retval EFI_INVALID_PARAMETER The read request contains LBAs that are not valid,
+                                or the buffer is not on proper alignment.
+
+**/
+EFI_STATUS
+NvmeBlockIoReadBlocksAsync (
+  IN  EFI_BLOCK_IO_PROTOCOL   *This,
+  IN  UINT32                  MediaId,
+  IN  EFI_LBA                 Lba,
+  IN  UINTN                   BufferSize,
+  OUT VOID                    *Buffer
+  );
+
+/**
+  Check the read started by NvmeBlockIoReadBlocksAsync () without waiting.
+
+  @param  This       Indicates a pointer to the calling context.
+
+  @retval EFI_SUCCESS           The data was read correctly from the device.
+  @retval EFI_NOT_READY         The read is still in progress.
+  @retval EFI_NOT_FOUND         No read is outstanding.
+  @retval Others                The read failed.
+
+**/
+EFI_STATUS
+NvmeBlockIoPollBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL   *This
+  );
+
 /**
   Write BufferSize bytes from Lba into Buffer.
 
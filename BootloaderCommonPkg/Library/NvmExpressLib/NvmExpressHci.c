@@ -687,7 +687,7 @@ NvmeCreateIoCompletionQueue (
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
-      QueueSize = NVME_CCQ_SIZE;
+      QueueSize = Private->IoQueueSize - 1;
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
         QueueSize = NVME_ASYNC_CCQ_SIZE;
@@ -756,7 +756,7 @@ NvmeCreateIoSubmissionQueue (
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
     if (Index == 1) {
-      QueueSize = NVME_CSQ_SIZE;
+      QueueSize = Private->IoQueueSize - 1;
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
         QueueSize = NVME_ASYNC_CSQ_SIZE;
@@ -843,6 +843,9 @@ NvmeControllerInit (
   Private->CqHdbl[1].Cqh = 0;
   Private->CqHdbl[2].Cqh = 0;
   Private->AsyncSqHead   = 0;
+  Private->IoInFlight    = 0;
+  Private->AsyncRead.Device = NULL;
+  Private->IoQueueSize   = MIN (NVME_CSQ_SIZE, Private->Cap.Mqes) + 1;
 
   Status = NvmeDisableController (Private);
 
@@ -194,35 +194,24 @@ NvmeDumpStatus (
 }
 
 /**
-  Create PRP lists for data transfer which is larger than 2 memory pages.
-  Note here we calcuate the number of required PRP lists and allocate them at one time.
+  Get the number of PRP lists required to describe a data buffer.
 
-  @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
-  @param[out]    PrpListHost         The host base address of PRP lists.
-  @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from map.
+  @param[out]    LastEntryNo         The number of PRP entries used in the last PRP list.
 
-  @retval The pointer to the first PRP List of the PRP lists.
+  @retval The number of PRP lists.
 
 **/
-VOID *
-NvmeCreatePrpList (
-  IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
+STATIC
+UINTN
+NvmeGetPrpListNo (
   IN     UINTN                        Pages,
-  OUT    VOID                         **PrpListHost,
-  IN OUT UINTN                        *PrpListNo,
-  OUT VOID                            **Mapping
+  OUT    UINTN                        *LastEntryNo
   )
 {
   UINTN                       PrpEntryNo;
-  UINT64                      PrpListBase;
-  UINTN                       PrpListIndex;
-  UINTN                       PrpEntryIndex;
+  UINTN                       PrpListNo;
   UINT64                      Remainder;
-  EFI_PHYSICAL_ADDRESS        PrpListPhyAddr;
-  UINTN                       Bytes;
-  EFI_STATUS                  Status;
 
   //
   // The number of Prp Entry in a memory page.
@@ -232,36 +221,54 @@ NvmeCreatePrpList (
   //
   // Calculate total PrpList number.
   //
-  *PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
-  if (*PrpListNo == 0) {
-    *PrpListNo = 1;
+  PrpListNo = (UINTN)DivU64x64Remainder ((UINT64)Pages, (UINT64)PrpEntryNo - 1, &Remainder);
+  if (PrpListNo == 0) {
+    PrpListNo = 1;
   } else if ((Remainder != 0) && (Remainder != 1)) {
-    *PrpListNo += 1;
+    PrpListNo += 1;
   } else if (Remainder == 1) {
     Remainder = PrpEntryNo;
   } else if (Remainder == 0) {
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = IoMmuAllocateBuffer (
-             *PrpListNo,
-             PrpListHost,
-             &PrpListPhyAddr,
-             Mapping
-             );
-  if (EFI_ERROR(Status) || (*PrpListHost == NULL)) {
-    DEBUG ((DEBUG_VERBOSE, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
-  }
+  *LastEntryNo = (UINTN)Remainder;
+  return PrpListNo;
+}
+
+/**
+  Fill PRP lists for data transfer which is larger than 2 memory pages.
+
+  @param[in]     PhysicalAddr        The physical base address of data buffer.
+  @param[in]     PrpListHost         The host base address of PRP lists.
+  @param[in]     PrpListPhyAddr      The physical base address of PRP lists.
+  @param[in]     PrpListNo           The number of PRP List.
+  @param[in]     LastEntryNo         The number of PRP entries used in the last PRP list.
+
+**/
+STATIC
+VOID
+NvmeFillPrpList (
+  IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
+  IN     VOID                         *PrpListHost,
+  IN     EFI_PHYSICAL_ADDRESS         PrpListPhyAddr,
+  IN     UINTN                        PrpListNo,
+  IN     UINTN                        LastEntryNo
+  )
+{
+  UINTN                       PrpEntryNo;
+  UINT64                      PrpListBase;
+  UINTN                       PrpListIndex;
+  UINTN                       PrpEntryIndex;
 
-  Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
+  PrpEntryNo = EFI_PAGE_SIZE / sizeof (UINT64);
 
   //
   // Fill all PRP lists except of last one.
   //
-  ZeroMem (*PrpListHost, Bytes);
-  for (PrpListIndex = 0; PrpListIndex < *PrpListNo - 1; ++PrpListIndex) {
-    PrpListBase = * (UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  ZeroMem (PrpListHost, EFI_PAGES_TO_SIZE (PrpListNo));
+  for (PrpListIndex = 0; PrpListIndex < PrpListNo - 1; ++PrpListIndex) {
+    PrpListBase = (UINTN)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
 
     for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; ++PrpEntryIndex) {
       if (PrpEntryIndex != PrpEntryNo - 1) {
@@ -281,11 +288,53 @@ NvmeCreatePrpList (
   //
   // Fill last PRP list.
   //
-  PrpListBase = * (UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
-  for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
+  PrpListBase = (UINTN)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  for (PrpEntryIndex = 0; PrpEntryIndex < LastEntryNo; ++PrpEntryIndex) {
     * ((UINT64 *) (UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
     PhysicalAddr += EFI_PAGE_SIZE;
   }
+}
+
+/**
+  Create PRP lists for data transfer which is larger than 2 memory pages.
+  Note here we calcuate the number of required PRP lists and allocate them at one time.
+
+  @param[in]     PhysicalAddr        The physical base address of data buffer.
+  @param[in]     Pages               The number of pages to be transfered.
+  @param[out]    PrpListHost         The host base address of PRP lists.
+  @param[in,out] PrpListNo           The number of PRP List.
+  @param[out]    Mapping             The mapping value returned from map.
+
+  @retval The pointer to the first PRP List of the PRP lists.
+
+**/
+VOID *
+NvmeCreatePrpList (
+  IN     EFI_PHYSICAL_ADDRESS         PhysicalAddr,
+  IN     UINTN                        Pages,
+  OUT    VOID                         **PrpListHost,
+  IN OUT UINTN                        *PrpListNo,
+  OUT VOID                            **Mapping
+  )
+{
+  UINTN                       LastEntryNo;
+  EFI_PHYSICAL_ADDRESS        PrpListPhyAddr;
+  EFI_STATUS                  Status;
+
+  *PrpListNo = NvmeGetPrpListNo (Pages, &LastEntryNo);
+
+  Status = IoMmuAllocateBuffer (
+             *PrpListNo,
+             PrpListHost,
+             &PrpListPhyAddr,
+             Mapping
+             );
+  if (EFI_ERROR(Status) || (*PrpListHost == NULL)) {
+    DEBUG ((DEBUG_VERBOSE, "NvmeCreatePrpList: create PrpList failure!\n"));
+    goto EXIT;
+  }
+
+  NvmeFillPrpList (PhysicalAddr, *PrpListHost, PrpListPhyAddr, *PrpListNo, LastEntryNo);
 
   return (VOID *) (UINTN)PrpListPhyAddr;
 
@@ -580,6 +629,9 @@ NvmExpressPassThru (
   if ((Event != NULL && *Event != NULL) && (QueueId != 0)) {
     Private->SqTdbl[QueueId].Sqt =
       (Private->SqTdbl[QueueId].Sqt + 1) % QueueSize;
+  } else if (QueueId == 1) {
+    Private->SqTdbl[QueueId].Sqt =
+      (Private->SqTdbl[QueueId].Sqt + 1) % Private->IoQueueSize;
   } else {
     Private->SqTdbl[QueueId].Sqt ^= 1;
   }
@@ -650,7 +702,12 @@ NvmExpressPassThru (
     CopyMem (Packet->NvmeCompletion, Cq, sizeof (EFI_NVM_EXPRESS_COMPLETION));
   }
 
-  if ((Private->CqHdbl[QueueId].Cqh ^= 1) == 0) {
+  if (QueueId == 1) {
+    Private->CqHdbl[QueueId].Cqh = (Private->CqHdbl[QueueId].Cqh + 1) % Private->IoQueueSize;
+    if (Private->CqHdbl[QueueId].Cqh == 0) {
+      Private->Pt[QueueId] ^= 1;
+    }
+  } else if ((Private->CqHdbl[QueueId].Cqh ^= 1) == 0) {
     Private->Pt[QueueId] ^= 1;
   }
 
@@ -686,6 +743,288 @@ EXIT:
   return Status;
 }
 
+/**
+  Submit a read or write command to the blocking I/O queue without waiting for it.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  NamespaceId    The namespace the command is sent to.
+  @param[in]  Opcode         NVME_IO_READ_OPC or NVME_IO_WRITE_OPC.
+  @param[in]  Buffer         The data buffer.
+  @param[in]  Lba            The start block number.
+  @param[in]  Blocks         Total block number to be transferred.
+  @param[in]  BlockSize      The media block size.
+
+  @retval EFI_SUCCESS            The command was placed in the submission queue.
+  @retval EFI_NOT_READY          The submission queue is full.
+  @retval EFI_OUT_OF_RESOURCES   The data buffer or PRP list could not be mapped.
+  @retval Others                 The doorbell could not be written.
+
+**/
+EFI_STATUS
+NvmeIoQueueSubmit (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private,
+  IN UINT32                            NamespaceId,
+  IN UINT8                             Opcode,
+  IN VOID                              *Buffer,
+  IN UINT64                            Lba,
+  IN UINT32                            Blocks,
+  IN UINT32                            BlockSize
+  )
+{
+  NVME_IO_SLOT                   *Slot;
+  NVME_SQ                        *Sq;
+  EFI_STATUS                     Status;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  EDKII_IOMMU_OPERATION          Flag;
+  UINTN                          MapLength;
+  UINTN                          PrpListNo;
+  UINTN                          LastEntryNo;
+  UINT32                         Bytes;
+  UINT32                         Offset;
+  UINT32                         Data;
+  UINTN                          Index;
+
+  //
+  // One entry is always left empty to tell a full queue from an empty one.
+  //
+  if (Private->IoInFlight >= Private->IoQueueSize - 1) {
+    return EFI_NOT_READY;
+  }
+
+  Slot = NULL;
+  for (Index = 0; Index < ARRAY_SIZE (Private->IoSlot); Index++) {
+    if (!Private->IoSlot[Index].InUse) {
+      Slot = &Private->IoSlot[Index];
+      break;
+    }
+  }
+  if (Slot == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  if ((Opcode & BIT0) != 0) {
+    Flag = EdkiiIoMmuOperationBusMasterRead;
+  } else {
+    Flag = EdkiiIoMmuOperationBusMasterWrite;
+  }
+
+  Bytes     = Blocks * BlockSize;
+  MapLength = Bytes;
+  Status    = IoMmuMap (Flag, Buffer, &MapLength, &PhyAddr, &Slot->MapData);
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  if (MapLength != Bytes) {
+    IoMmuUnmap (Slot->MapData);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Sq = Private->SqBuffer[1] + Private->SqTdbl[1].Sqt;
+  ZeroMem (Sq, sizeof (NVME_SQ));
+  Sq->Opc    = Opcode;
+  Sq->Cid    = Private->Cid[1]++;
+  Sq->Nsid   = NamespaceId;
+  Sq->Prp[0] = PhyAddr;
+
+  //
+  // Reuse the PRP list pages of this slot, they are only reallocated
+  // when a larger transfer needs more of them.
+  //
+  Offset = (UINT32)PhyAddr & (EFI_PAGE_SIZE - 1);
+  if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+    PrpListNo = NvmeGetPrpListNo (EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &LastEntryNo);
+    if (PrpListNo > Slot->PrpListNo) {
+      if (Slot->PrpListHost != NULL) {
+        IoMmuFreeBuffer (Slot->PrpListNo, Slot->PrpListHost, Slot->MapPrpList);
+        Slot->PrpListHost = NULL;
+        Slot->PrpListNo   = 0;
+      }
+      Status = IoMmuAllocateBuffer (PrpListNo, &Slot->PrpListHost, &Slot->PrpListPhyAddr, &Slot->MapPrpList);
+      if (EFI_ERROR (Status) || (Slot->PrpListHost == NULL)) {
+        Slot->PrpListHost = NULL;
+        IoMmuUnmap (Slot->MapData);
+        return EFI_OUT_OF_RESOURCES;
+      }
+      Slot->PrpListNo = PrpListNo;
+    }
+    NvmeFillPrpList ((PhyAddr + EFI_PAGE_SIZE) & ~ (EFI_PAGE_SIZE - 1), Slot->PrpListHost,
+                     Slot->PrpListPhyAddr, PrpListNo, LastEntryNo);
+    Sq->Prp[1] = Slot->PrpListPhyAddr;
+  } else if ((Offset + Bytes) > EFI_PAGE_SIZE) {
+    Sq->Prp[1] = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~ (EFI_PAGE_SIZE - 1);
+  }
+
+  Sq->Payload.Raw.Cdw10 = (UINT32)Lba;
+  Sq->Payload.Raw.Cdw11 = (UINT32)RShiftU64 (Lba, 32);
+  Sq->Payload.Raw.Cdw12 = (Blocks - 1) & 0xFFFF;
+  if (Opcode == NVME_IO_WRITE_OPC) {
+    Sq->Payload.Raw.Cdw12 |= BIT30;
+  }
+
+  Slot->Cid   = Sq->Cid;
+  Slot->InUse = TRUE;
+  Private->IoInFlight++;
+
+  //
+  // Ring the submission queue doorbell.
+  //
+  Private->SqTdbl[1].Sqt = (Private->SqTdbl[1].Sqt + 1) % Private->IoQueueSize;
+  Data = ReadUnaligned32 ((UINT32 *)&Private->SqTdbl[1]);
+  return NvmHcRwMmio (Private->NvmeHCBase, NVME_SQTDBL_OFFSET (1, Private->Cap.Dstrd), FALSE, sizeof (Data), &Data);
+}
+
+/**
+  Drop all the commands outstanding on the blocking I/O queue.
+
+  The controller is reset first, so that it stops transferring data for those
+  commands, and the I/O queues are created again. The data buffers are left
+  mapped if the controller could not be reset.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeIoQueueAbort (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private
+  )
+{
+  EFI_STATUS                     Status;
+  UINTN                          Index;
+
+  DEBUG ((DEBUG_ERROR, "NvmeIoQueueAbort: %d commands timed out\n", Private->IoInFlight));
+
+  //
+  // Late completions could still be written into the unmapped buffers, and the
+  // queue indices no longer match the controller ones. The reset also clears
+  // Sqt, Cqh, Pt and Cid for the new queues.
+  //
+  Status = NvmeControllerInit (Private);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "NvmeIoQueueAbort: controller reset failed - %r\n", Status));
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Private->IoSlot); Index++) {
+    if (Private->IoSlot[Index].InUse) {
+      if (!EFI_ERROR (Status)) {
+        IoMmuUnmap (Private->IoSlot[Index].MapData);
+      }
+      Private->IoSlot[Index].InUse = FALSE;
+    }
+  }
+  Private->IoInFlight = 0;
+}
+
+/**
+  Wait for the next command on the blocking I/O queue to complete.
+
+  Commands may complete in any order, the resources of the completed one
+  are released and its status is returned.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  Timeout        The time to wait in 100ns units, 0 only checks once.
+
+  @retval EFI_SUCCESS            A command completed successfully.
+  @retval EFI_NOT_FOUND          No command is outstanding.
+  @retval EFI_NOT_READY          Timeout is 0 and no command has completed.
+  @retval EFI_DEVICE_ERROR       A command completed with an error.
+  @retval EFI_TIMEOUT            No command completed in time, all outstanding commands are dropped.
+
+**/
+EFI_STATUS
+NvmeIoQueueComplete (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private,
+  IN UINT64                            Timeout
+  )
+{
+  NVME_CQ                        *Cq;
+  NVME_IO_SLOT                   *Slot;
+  EFI_STATUS                     Status;
+  UINT64                         TimeCount;
+  UINT32                         Data;
+  UINTN                          Index;
+
+  if (Private->IoInFlight == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Wait for completion queue to get filled in. 100ns unit by EFI spec
+  //
+  Cq        = Private->CqBuffer[1] + Private->CqHdbl[1].Cqh;
+  TimeCount = RShiftU64 (Timeout, 7); //times = 128ns unit
+  while (Cq->Pt == Private->Pt[1]) {
+    if (Timeout == 0) {
+      return EFI_NOT_READY;
+    }
+    if (TimeCount-- == 0) {
+      NvmeIoQueueAbort (Private);
+      return EFI_TIMEOUT;
+    }
+    NanoSecondDelay (100);
+  }
+
+  if ((Cq->Sct == 0) && (Cq->Sc == 0)) {
+    Status = EFI_SUCCESS;
+  } else {
+    Status = EFI_DEVICE_ERROR;
+    //
+    // Dump every completion entry status for debugging.
+    //
+    DEBUG_CODE_BEGIN();
+    NvmeDumpStatus (Cq);
+    DEBUG_CODE_END();
+  }
+
+  Slot = NULL;
+  for (Index = 0; Index < ARRAY_SIZE (Private->IoSlot); Index++) {
+    if (Private->IoSlot[Index].InUse && (Private->IoSlot[Index].Cid == Cq->Cid)) {
+      Slot = &Private->IoSlot[Index];
+      break;
+    }
+  }
+
+  if (Slot != NULL) {
+    IoMmuUnmap (Slot->MapData);
+    Slot->InUse = FALSE;
+    Private->IoInFlight--;
+  } else {
+    DEBUG ((DEBUG_ERROR, "NvmeIoQueueComplete: unknown command id 0x%x\n", Cq->Cid));
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  Private->CqHdbl[1].Cqh = (Private->CqHdbl[1].Cqh + 1) % Private->IoQueueSize;
+  if (Private->CqHdbl[1].Cqh == 0) {
+    Private->Pt[1] ^= 1;
+  }
+  Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[1]);
+  NvmHcRwMmio (Private->NvmeHCBase, NVME_CQHDBL_OFFSET (1, Private->Cap.Dstrd), FALSE, sizeof (Data), &Data);
+
+  return Status;
+}
+
+/**
+  Release the PRP lists kept for the blocking I/O queue.
+
+  @param[in]  Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeIoQueueFree (
+  IN NVME_CONTROLLER_PRIVATE_DATA      *Private
+  )
+{
+  UINTN                          Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Private->IoSlot); Index++) {
+    if (Private->IoSlot[Index].PrpListHost != NULL) {
+      IoMmuFreeBuffer (Private->IoSlot[Index].PrpListNo, Private->IoSlot[Index].PrpListHost,
+                       Private->IoSlot[Index].MapPrpList);
+      Private->IoSlot[Index].PrpListHost = NULL;
+      Private->IoSlot[Index].PrpListNo   = 0;
+    }
+  }
+}
+
 /**
   Used to retrieve the next namespace ID for this NVM Express controller.
 
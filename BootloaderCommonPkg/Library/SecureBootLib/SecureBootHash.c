@@ -13,6 +13,8 @@
 #include <Library/SecureBootLib.h>
 #include <Library/BootloaderCommonLib.h>
 
+#define HASH_MULTI_CHUNK_SIZE    SIZE_16KB
+
 /**
   Get hash to extend a firmware stage component
   Hash calculation to extend would be in either of ways
@@ -132,42 +134,256 @@ CalculateHash  (
   return RETURN_SUCCESS;
 }
 
+/**
+  Initialize a hash context for incremental hashing.
+
+  @param[in]  HashCtx        Pointer to the hash context buffer.
+  @param[in]  HashAlg        Specify hash algrothsm.
+
+  @retval RETURN_SUCCESS             Hash context was initialized.
+  @retval RETURN_INVALID_PARAMETER   HashCtx is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashInit (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg
+  )
+{
+  if (HashCtx == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    return Sha256Init (HashCtx, sizeof (HASH_CTX));
+  } else if (HashAlg == HASH_TYPE_SHA384) {
+    return Sha384Init (HashCtx, sizeof (HASH_CTX));
+  } else if (HashAlg == HASH_TYPE_SM3) {
+    return Sm3Init (HashCtx, sizeof (HASH_CTX));
+  }
+
+  return RETURN_UNSUPPORTED;
+}
 
 /**
-  Verify data block hash with the built-in one.
+  Consume a piece of data into a hash context.
+  This method can be called multiple times to hash separate pieces of data.
 
+  @param[in]  HashCtx        Pointer to the hash context buffer.
+  @param[in]  HashAlg        Hash algrothsm used in HashInit ().
   @param[in]  Data           Data buffer pointer.
   @param[in]  Length         Data buffer size.
+
+  @retval RETURN_SUCCESS             Data was hashed.
+  @retval RETURN_INVALID_PARAMETER   HashCtx is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashUpdate (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg,
+  IN CONST UINT8          *Data,
+  IN       UINT32          Length
+  )
+{
+  if (HashCtx == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    return Sha256Update (HashCtx, Data, Length);
+  } else if (HashAlg == HASH_TYPE_SHA384) {
+    return Sha384Update (HashCtx, Data, Length);
+  } else if (HashAlg == HASH_TYPE_SM3) {
+    return Sm3Update (HashCtx, Data, Length);
+  }
+
+  return RETURN_UNSUPPORTED;
+}
+
+/**
+  Finalize a hash context and return the digest.
+
+  @param[in]      HashCtx    Pointer to the hash context buffer.
+  @param[in]      HashAlg    Hash algrothsm used in HashInit ().
+  @param[in,out]  OutHash    Hash of all data consumed by the context.
+
+  @retval RETURN_SUCCESS             Hash Calculation succeeded.
+  @retval RETURN_INVALID_PARAMETER   HashCtx or OutHash is NULL.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+HashFinal (
+  IN       HASH_CTX       *HashCtx,
+  IN       UINT8           HashAlg,
+  IN OUT   UINT8          *OutHash
+  )
+{
+  if ((HashCtx == NULL) || (OutHash == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    return Sha256Final (HashCtx, OutHash);
+  } else if (HashAlg == HASH_TYPE_SHA384) {
+    return Sha384Final (HashCtx, OutHash);
+  } else if (HashAlg == HASH_TYPE_SM3) {
+    return Sm3Final (HashCtx, OutHash);
+  }
+
+  return RETURN_UNSUPPORTED;
+}
+
+/**
+  Calculate the digests of a data buffer for several hash algorithms at once.
+
+  The data is read only once, each chunk is consumed by all the requested
+  algorithms while it is still in cache.
+
+  @param[in]  Data           Data buffer pointer.
+  @param[in]  Length         Data buffer size.
+  @param[in]  HashCount      Number of entries in HashAlg and OutHash, up to HASH_MULTI_MAX.
+  @param[in]  HashAlg        Array of hash algorithms.
+  @param[in,out]  OutHash    Array of pointers to receive the digest for each HashAlg.
+
+  @retval RETURN_SUCCESS             All the digests were calculated.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_UNSUPPORTED         One or more Hash Alg types are not supported,
+                                     the digests of the supported ones are still valid.
+
+**/
+RETURN_STATUS
+EFIAPI
+CalculateHashMulti (
+  IN CONST UINT8          *Data,
+  IN       UINT32          Length,
+  IN       UINT32          HashCount,
+  IN CONST UINT8          *HashAlg,
+  IN OUT   UINT8  * CONST *OutHash
+  )
+{
+  HASH_CTX         HashCtx[HASH_MULTI_MAX];
+  BOOLEAN          Active[HASH_MULTI_MAX];
+  RETURN_STATUS    Status;
+  UINT32           Index;
+  UINT32           Offset;
+  UINT32           ChunkLen;
+
+  if ((HashCount == 0) || (HashCount > HASH_MULTI_MAX) || (HashAlg == NULL) || (OutHash == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashCount == 1) {
+    return CalculateHash (Data, Length, HashAlg[0], OutHash[0]);
+  }
+
+  Status = RETURN_SUCCESS;
+  for (Index = 0; Index < HashCount; Index++) {
+    Active[Index] = !RETURN_ERROR (HashInit (&HashCtx[Index], HashAlg[Index]));
+    if (!Active[Index]) {
+      Status = RETURN_UNSUPPORTED;
+    }
+  }
+
+  for (Offset = 0; Offset < Length; Offset += ChunkLen) {
+    ChunkLen = MIN (Length - Offset, HASH_MULTI_CHUNK_SIZE);
+    for (Index = 0; Index < HashCount; Index++) {
+      if (Active[Index]) {
+        HashUpdate (&HashCtx[Index], HashAlg[Index], Data + Offset, ChunkLen);
+      }
+    }
+  }
+
+  for (Index = 0; Index < HashCount; Index++) {
+    if (Active[Index] && RETURN_ERROR (HashFinal (&HashCtx[Index], HashAlg[Index], OutHash[Index]))) {
+      Status = RETURN_UNSUPPORTED;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Calculate the digests of several independent data buffers.
+
+  Buffers are hashed in parallel lanes when the hash algorithm has a
+  multi-buffer implementation, otherwise they are hashed one by one.
+
+  @param[in]  Data           Array of data buffer pointers.
+  @param[in]  Length         Array of data buffer sizes.
+  @param[in]  Count          Number of data buffers.
+  @param[in]  HashAlg        Specify hash algrothsm.
+  @param[in,out]  OutHash    Array of pointers to receive the digest of each buffer.
+
+  @retval RETURN_SUCCESS             Hash Calculation succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_UNSUPPORTED         Hash Alg type is not supported.
+
+**/
+RETURN_STATUS
+EFIAPI
+CalculateHashBatch (
+  IN CONST UINT8  * CONST *Data,
+  IN CONST UINT32         *Length,
+  IN       UINT32          Count,
+  IN       UINT8           HashAlg,
+  IN OUT   UINT8  * CONST *OutHash
+  )
+{
+  RETURN_STATUS    Status;
+  UINT32           Index;
+
+  if ((Data == NULL) || (Length == NULL) || (OutHash == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA384) {
+    return Sha384Batch (Data, Length, OutHash, Count);
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = CalculateHash (Data[Index], Length[Index], HashAlg, OutHash[Index]);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Verify a pre-calculated data digest with the built-in one.
+
+  @param[in]  Digest         Digest of the data to verify.
   @param[in]  Usage          Hash component usage.
   @param[in]  HashAlg        Specify hash algorithm.
-  @param[in,out]  Hash       On input,  expected hash value when hash component usage is 0.
-                             On output, calculated hash value when verification succeeds.
+  @param[in,out]  HashData   On input,  expected hash value when hash component usage is 0.
+                             On output, digest value when verification succeeds.
 
   @retval RETURN_SUCCESS             Hash verification succeeded.
   @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
-  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
-  @retval RETURN_UNSUPPORTED         HashAlg not supported.
   @retval RETURN_SECURITY_VIOLATION  Hash verification failed.
 
 **/
 RETURN_STATUS
 EFIAPI
-DoHashVerify (
-  IN CONST UINT8           *Data,
-  IN       UINT32           Length,
+DoDigestVerify (
+  IN CONST UINT8           *Digest,
   IN       HASH_COMP_USAGE  Usage,
   IN       UINT8            HashAlg,
   IN OUT   UINT8           *HashData
   )
 {
   RETURN_STATUS        Status;
-  RETURN_STATUS        Status2;
-  UINT8                Digest[HASH_DIGEST_MAX];
   UINT8                DigestSize;
 
-
-  if ((Data == NULL) ||
-      ((HashAlg != HASH_TYPE_SHA256) && (HashAlg != HASH_TYPE_SHA384))) {
+  if (Digest == NULL) {
     return RETURN_INVALID_PARAMETER;
   }
 
@@ -183,11 +399,6 @@ DoHashVerify (
     return RETURN_INVALID_PARAMETER;
   }
 
-  Status = CalculateHash (Data, Length, HashAlg, Digest);
-  if (EFI_ERROR(Status)) {
-    return RETURN_UNSUPPORTED;
-  }
-
   Status = RETURN_SECURITY_VIOLATION;
   if (Usage == 0) {
     // Compare hash with the buffer passed in
@@ -196,8 +407,7 @@ DoHashVerify (
     }
   } else {
     // Compare hash with the the one stored in hash store
-    Status2 = MatchHashInStore (Usage, HashAlg, Digest);
-    if (!EFI_ERROR(Status2)) {
+    if (!EFI_ERROR (MatchHashInStore (Usage, HashAlg, (UINT8 *)Digest))) {
       if (HashData != NULL) {
         CopyMem (HashData, Digest, DigestSize);
       }
@@ -205,6 +415,64 @@ DoHashVerify (
     }
   }
 
+  return Status;
+}
+
+
+/**
+  Verify data block hash with the built-in one.
+
+  @param[in]  Data           Data buffer pointer.
+  @param[in]  Length         Data buffer size.
+  @param[in]  Usage          Hash component usage.
+  @param[in]  HashAlg        Specify hash algorithm.
+  @param[in,out]  Hash       On input,  expected hash value when hash component usage is 0.
+                             On output, calculated hash value when verification succeeds.
+
+  @retval RETURN_SUCCESS             Hash verification succeeded.
+  @retval RETURN_INVALID_PARAMETER   Hash parameter is not valid.
+  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
+  @retval RETURN_UNSUPPORTED         HashAlg not supported.
+  @retval RETURN_SECURITY_VIOLATION  Hash verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoHashVerify (
+  IN CONST UINT8           *Data,
+  IN       UINT32           Length,
+  IN       HASH_COMP_USAGE  Usage,
+  IN       UINT8            HashAlg,
+  IN OUT   UINT8           *HashData
+  )
+{
+  RETURN_STATUS        Status;
+  UINT8                Digest[HASH_DIGEST_MAX];
+  UINT8                DigestSize;
+
+
+  if ((Data == NULL) ||
+      ((HashAlg != HASH_TYPE_SHA256) && (HashAlg != HASH_TYPE_SHA384))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((Usage == 0) && (HashData == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (HashAlg == HASH_TYPE_SHA256) {
+    DigestSize = SHA256_DIGEST_SIZE;
+  } else {
+    DigestSize = SHA384_DIGEST_SIZE;
+  }
+
+  Status = CalculateHash (Data, Length, HashAlg, Digest);
+  if (EFI_ERROR(Status)) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  Status = DoDigestVerify (Digest, Usage, HashAlg, HashData);
+
   DEBUG ((DEBUG_INFO, "HASH verification for usage (0x%08X) with Hash Alg (0x%x): %r\n", Usage, HashAlg, Status));
   if (EFI_ERROR(Status)) {
     DEBUG_CODE_BEGIN();
@@ -129,3 +129,59 @@ DoRsaVerify (
 
   return Status;
 }
+
+/**
+  Verifies the RSA PKCS1-v1_5 signature against a pre-calculated data digest.
+  RSA PSS signatures are not supported since they require the whole message.
+
+  @param[in]  Digest          Digest of the signed data.
+  @param[in]  Usage           Hash usage.
+  @param[in]  Signature       Signature header for singanture data.
+  @param[in]  PubKeyHdr       Public key header for key data
+  @param[in]  PubKeyHashAlg   Hash Alg for PubKeyHash.
+  @param[in]  PubKeyHash      Public key hash value when hash component usage is 0.
+
+  @retval RETURN_SUCCESS             RSA verification succeeded.
+  @retval RETURN_NOT_FOUND           Hash data for hash component usage is not found.
+  @retval RETURN_UNSUPPORTED         Signing type is not supported.
+  @retval RETURN_SECURITY_VIOLATION  PubKey or Signature verification failed.
+
+**/
+RETURN_STATUS
+EFIAPI
+DoRsaVerifyDigest (
+  IN CONST UINT8           *Digest,
+  IN       HASH_COMP_USAGE  Usage,
+  IN CONST SIGNATURE_HDR   *SignatureHdr,
+  IN       PUB_KEY_HDR     *PubKeyHdr,
+  IN       UINT8            PubKeyHashAlg,
+  IN       UINT8           *PubKeyHash      OPTIONAL
+  )
+{
+  RETURN_STATUS    Status;
+
+  if ((Digest == NULL) || (PubKeyHdr->Identifier != PUBKEY_IDENTIFIER) ||
+      (SignatureHdr->Identifier != SIGNATURE_IDENTIFIER)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (SignatureHdr->SigType != SIGNING_TYPE_RSA_PKCS_1_5) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((SignatureHdr->HashAlg != HASH_TYPE_SHA256) && (SignatureHdr->HashAlg != HASH_TYPE_SHA384)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  // Verify public key first
+  Status = DoHashVerify (PubKeyHdr->KeyData, PubKeyHdr->KeySize, Usage, PubKeyHashAlg, PubKeyHash);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = RsaVerify_Pkcs_1_5 (PubKeyHdr, SignatureHdr, Digest);
+
+  DEBUG ((DEBUG_INFO, "RSA verification for usage (0x%08X): %r\n", Usage, Status));
+
+  return Status;
+}
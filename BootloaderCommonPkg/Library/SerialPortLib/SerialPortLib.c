@@ -8,6 +8,8 @@
 #include <Base.h>
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
+#include <Library/PcdLib.h>
+#include <Library/SerialPortLib.h>
 #include <Library/PlatformHookLib.h>
 
 //---------------------------------------------
@@ -33,6 +35,7 @@
 //---------------------------------------------
 #define LSR_TXRDY               0x20
 #define LSR_RXDA                0x01
+#define IIR_FIFO_ENABLED        0xC0
 #define DLAB                    0x01
 #define UART_MAGIC              0x55
 
@@ -181,22 +184,38 @@ SerialPortWrite (
   )
 {
   UINTN  Result;
+  UINTN  FifoSize;
+  UINTN  Count;
   UINT8  Data;
 
   if (NULL == Buffer) {
     return 0;
   }
 
+  //
+  // The transmitter empty bit is set when the whole FIFO is empty,
+  // so a FIFO full of data can be written each time it is set.
+  //
+  FifoSize = 1;
+  if ((NumberOfBytes > 1) && ((SerialPortReadRegister (EIR_OFFSET) & IIR_FIFO_ENABLED) == IIR_FIFO_ENABLED)) {
+    FifoSize = MAX (FixedPcdGet32 (PcdSerialPortFifoSize), 1);
+  }
+
   Result = NumberOfBytes;
 
-  while (NumberOfBytes--) {
+  while (NumberOfBytes > 0) {
     //
     // Wait for the serail port to be ready.
     //
     do {
       Data = SerialPortReadRegister (LSR_OFFSET);
     } while ((Data & LSR_TXRDY) == 0);
-    SerialPortWriteRegister (0, *Buffer++);
+
+    Count = MIN (NumberOfBytes, FifoSize);
+    NumberOfBytes -= Count;
+    while (Count-- > 0) {
+      SerialPortWriteRegister (0, *Buffer++);
+    }
   }
 
   return Result;
@@ -268,3 +287,33 @@ SerialPortPoll (
   return FALSE;
 }
 
+/**
+  Retrieve the status of the control bits on a serial device.
+
+  Only the input and output buffer status is reported.
+
+  @param Control                A pointer to return the current control signals from the serial device.
+
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32 *Control
+  )
+{
+  UINT8  Data;
+
+  Data     = SerialPortReadRegister (LSR_OFFSET);
+  *Control = 0;
+  if ((Data & LSR_TXRDY) != 0) {
+    *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+  if ((Data & LSR_RXDA) == 0) {
+    *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  }
+
+  return RETURN_SUCCESS;
+}
+
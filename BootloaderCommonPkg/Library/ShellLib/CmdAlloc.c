@@ -0,0 +1,155 @@
+/** @file
+  Shell command `alloc` to display the memory allocation trace.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/ShellLib.h>
+#include <Library/HobLib.h>
+#include <Library/BlMemoryAllocationLib.h>
+#include <Guid/AllocTraceInfoGuid.h>
+
+STATIC CONST CHAR16 *mAllocStageStr[ALLOC_TRACE_STAGE_COUNT] = {
+  L"1A", L"1B", L"2", L"PAYLOAD"
+};
+
+STATIC CONST CHAR16 *mAllocTypeStr[] = {
+  L"Pool", L"Pages", L"Temp"
+};
+
+/**
+  Display the memory allocation trace.
+
+  @param[in]  Shell        shell instance
+  @param[in]  Argc         number of command line arguments
+  @param[in]  Argv         command line arguments
+
+  @retval EFI_SUCCESS
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+ShellCommandAllocFunc (
+  IN SHELL  *Shell,
+  IN UINTN   Argc,
+  IN CHAR16 *Argv[]
+  );
+
+CONST SHELL_COMMAND ShellCommandAlloc = {
+  L"alloc",
+  L"Display memory allocation trace",
+  &ShellCommandAllocFunc
+};
+
+/**
+  Print a memory allocation trace table.
+
+  @param[in]  Name         name of the trace table
+  @param[in]  TraceInfo    trace table to print
+  @param[in]  Summary      print the summary only, without the live allocations
+
+**/
+STATIC
+VOID
+PrintAllocTrace (
+  IN CONST CHAR16      *Name,
+  IN ALLOC_TRACE_INFO  *TraceInfo,
+  IN BOOLEAN            Summary
+  )
+{
+  ALLOC_TRACE_ENTRY  *Entry;
+  UINT32              Index;
+  UINT32              Low;
+  UINT32              High;
+
+  ShellPrint (L"[%s] %d live allocations, 0x%X bytes, %d dropped\n",
+              Name, TraceInfo->LiveCount, TraceInfo->LiveSize, TraceInfo->Dropped);
+
+  for (Index = 0; Index < ALLOC_TRACE_STAGE_COUNT; Index++) {
+    if (TraceInfo->Anchor[Index] != 0) {
+      ShellPrint (L"  Stage %-8s peak 0x%08X  anchor 0x%08X\n",
+                  mAllocStageStr[Index], TraceInfo->PeakSize[Index], TraceInfo->Anchor[Index]);
+    }
+  }
+
+  ShellPrint (L"  Size histogram:\n");
+  for (Index = 0; Index < ALLOC_TRACE_HISTOGRAM_COUNT; Index++) {
+    if (TraceInfo->Histogram[Index] != 0) {
+      Low  = (Index == 0) ? 0 : (16 << Index);
+      High = (Index == ALLOC_TRACE_HISTOGRAM_COUNT - 1) ? MAX_UINT32 : (32 << Index) - 1;
+      ShellPrint (L"    0x%08X - 0x%08X : %d\n", Low, High, TraceInfo->Histogram[Index]);
+    }
+  }
+
+  if (Summary) {
+    return;
+  }
+
+  ShellPrint (L"  Caller      Base        Size        Type   Stage\n");
+  for (Index = 0; Index < TraceInfo->LiveCount; Index++) {
+    Entry = &TraceInfo->Entry[Index];
+    ShellPrint (L"  0x%08X  0x%08X  0x%08X  %-5s  %s\n", Entry->Caller, Entry->Base, Entry->Size,
+                (Entry->Type < ARRAY_SIZE (mAllocTypeStr)) ? mAllocTypeStr[Entry->Type] : L"?",
+                (Entry->Stage < ALLOC_TRACE_STAGE_COUNT) ? mAllocStageStr[Entry->Stage] : L"?");
+  }
+}
+
+/**
+  Display the memory allocation trace.
+
+  @param[in]  Shell        shell instance
+  @param[in]  Argc         number of command line arguments
+  @param[in]  Argv         command line arguments
+
+  @retval EFI_SUCCESS
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+ShellCommandAllocFunc (
+  IN SHELL  *Shell,
+  IN UINTN   Argc,
+  IN CHAR16 *Argv[]
+  )
+{
+  EFI_HOB_GUID_TYPE  *GuidHob;
+  ALLOC_TRACE_INFO   *TraceInfo;
+  BOOLEAN             Summary;
+  UINTN               Index;
+
+  Summary = FALSE;
+  for (Index = 1; Index < Argc; Index++) {
+    if (StrCmp (Argv[Index], L"-s") == 0) {
+      Summary = TRUE;
+    } else {
+      ShellPrint (L"Usage: %s [-s]\n", Argv[0]);
+      ShellPrint (L"\n"
+                  L"Flags:\n"
+                  L"  -s     Summary only, without the live allocations\n");
+      return EFI_ABORTED;
+    }
+  }
+
+  TraceInfo = NULL;
+  GuidHob   = GetNextGuidHob (&gLoaderAllocTraceInfoGuid, GetHobList ());
+  if (GuidHob != NULL) {
+    TraceInfo = (ALLOC_TRACE_INFO *)GET_GUID_HOB_DATA (GuidHob);
+    PrintAllocTrace (L"Loader", TraceInfo, Summary);
+  }
+
+  if (GetAllocTraceInfo () != NULL) {
+    TraceInfo = GetAllocTraceInfo ();
+    PrintAllocTrace (L"Payload", TraceInfo, Summary);
+  }
+
+  if (TraceInfo == NULL) {
+    ShellPrint (L"Memory allocation trace is not enabled\n");
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
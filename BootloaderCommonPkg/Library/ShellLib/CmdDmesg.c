@@ -13,6 +13,7 @@
 #include <Library/ConsoleInLib.h>
 #include <Library/ConsoleOutLib.h>
 #include <Library/BootloaderCommonLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/DebugLogBufferLib.h>
 
 /**
@@ -42,6 +43,87 @@ CONST SHELL_COMMAND ShellCommandDmesg = {
 
 CONST UINTN LinesPerPage = 30;
 
+/**
+  Print the records of the per-CPU log rings merged in time order.
+
+  Each line is prefixed with its time stamp and the APIC ID of the CPU.
+
+  @param[in]  LogRing      per-CPU log rings
+  @param[in]  ErrorOnly    print only error and warning messages
+  @param[in]  Paged        page out the log contents
+
+  @retval EFI_SUCCESS
+  @retval EFI_OUT_OF_RESOURCES
+
+**/
+STATIC
+EFI_STATUS
+PrintLogRing (
+  IN DEBUG_LOG_RING_HEADER  *LogRing,
+  IN BOOLEAN                 ErrorOnly,
+  IN BOOLEAN                 Paged
+  )
+{
+  DEBUG_LOG_RECORD        *Record;
+  UINT32                  *Position;
+  BOOLEAN                 *LineStart;
+  CHAR8                   *Text;
+  UINT64                   Time;
+  UINT32                   Index;
+  UINTN                    Pos;
+  UINTN                    PageLineCount;
+  UINT8                    Buf[1];
+
+  Position  = AllocatePool (LogRing->RingCount * (sizeof (UINT32) + sizeof (BOOLEAN)));
+  if (Position == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  LineStart = (BOOLEAN *)(Position + LogRing->RingCount);
+  for (Index = 0; Index < LogRing->RingCount; Index++) {
+    Position[Index]  = LogRing->Ring[Index].Tail;
+    LineStart[Index] = TRUE;
+  }
+
+  PageLineCount = 0;
+  while ((Record = GetNextDebugLogRecord (LogRing, Position, &Index)) != NULL) {
+    if (ErrorOnly && ((Record->ErrorLevel & (DEBUG_ERROR | DEBUG_WARN)) == 0)) {
+      continue;
+    }
+
+    Text = (CHAR8 *)(Record + 1);
+    for (Pos = 0; Pos < Record->Length; Pos++) {
+      if (LineStart[Index]) {
+        // Time stamp in ms with us resolution
+        Time = DivU64x32 (MultU64x32 (Record->TimeStamp, 1000), LogRing->FreqKhz);
+        ShellPrint (L"[%6d.%03d] %02X: ", (UINT32)DivU64x32 (Time, 1000), (UINT32)ModU64x32 (Time, 1000),
+                    LogRing->Ring[Index].ApicId);
+        LineStart[Index] = FALSE;
+      }
+
+      ConsoleWrite ((UINT8 *)&Text[Pos], 1);
+      if (Text[Pos] != '\n') {
+        continue;
+      }
+      LineStart[Index] = TRUE;
+
+      // Page out the log contents if requested
+      if (Paged && (++PageLineCount == LinesPerPage)) {
+        ShellPrint (L"[Press <ESC> to stop, or any other key to continue...]");
+        ConsoleRead (Buf, 1);
+        if (Buf[0] == '\x1b') {
+          FreePool (Position);
+          return EFI_SUCCESS;
+        }
+        PageLineCount = 0;
+        ShellPrint (L"\r%54a\r", "");
+      }
+    }
+  }
+
+  FreePool (Position);
+  return EFI_SUCCESS;
+}
+
 /**
   Print the contents of the log buffer
 
@@ -68,6 +150,9 @@ ShellCommandDmesgFunc (
   BOOLEAN                  Paged = FALSE;
   UINTN                    Length;
   UINTN                    BufIndex;
+  DEBUG_LOG_RING_HEADER   *LogRing;
+  BOOLEAN                  Merged = FALSE;
+  BOOLEAN                  ErrorOnly = FALSE;
 
   for (Index = 1; Index < Argc; Index++) {
     if (StrCmp (Argv[Index], L"-h") == 0) {
@@ -76,6 +161,22 @@ ShellCommandDmesgFunc (
     if (StrCmp (Argv[Index], L"-p") == 0) {
       Paged = TRUE;
     }
+    if (StrCmp (Argv[Index], L"-t") == 0) {
+      Merged = TRUE;
+    }
+    if (StrCmp (Argv[Index], L"-e") == 0) {
+      Merged    = TRUE;
+      ErrorOnly = TRUE;
+    }
+  }
+
+  if (Merged) {
+    LogRing = GetDebugLogRing ();
+    if (LogRing == NULL) {
+      ShellPrint (L"Per-CPU log rings are not available\n");
+      return EFI_UNSUPPORTED;
+    }
+    return PrintLogRing (LogRing, ErrorOnly, Paged);
   }
 
   PageLineCount = 0;
@@ -112,9 +213,11 @@ ShellCommandDmesgFunc (
   return EFI_SUCCESS;
 
 usage:
-  ShellPrint (L"Usage: %s [-p]\n", Argv[0]);
+  ShellPrint (L"Usage: %s [-p] [-t] [-e]\n", Argv[0]);
   ShellPrint (L"\n"
               L"Flags:\n"
-              L"  -p     Paged output (display %d lines at a time)\n", LinesPerPage);
+              L"  -p     Paged output (display %d lines at a time)\n"
+              L"  -t     Time stamped messages of all CPUs from the per-CPU log rings\n"
+              L"  -e     Like -t, but error and warning messages only\n", LinesPerPage);
   return EFI_ABORTED;
 }
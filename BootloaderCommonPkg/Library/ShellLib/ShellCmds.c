@@ -41,6 +41,7 @@ LoadShellCommands (
     ShellCommandRegister (Shell, &ShellCommandPci);
     ShellCommandRegister (Shell, &ShellCommandHob);
     ShellCommandRegister (Shell, &ShellCommandMmap);
+    ShellCommandRegister (Shell, &ShellCommandAlloc);
     ShellCommandRegister (Shell, &ShellCommandPerf);
     ShellCommandRegister (Shell, &ShellCommandBoot);
     ShellCommandRegister (Shell, &ShellCommandMmcDll);
@@ -15,6 +15,7 @@ extern CONST SHELL_COMMAND ShellCommandHelp;
 extern CONST SHELL_COMMAND ShellCommandHob;
 extern CONST SHELL_COMMAND ShellCommandMm;
 extern CONST SHELL_COMMAND ShellCommandMmap;
+extern CONST SHELL_COMMAND ShellCommandAlloc;
 extern CONST SHELL_COMMAND ShellCommandPerf;
 extern CONST SHELL_COMMAND ShellCommandBoot;
 extern CONST SHELL_COMMAND ShellCommandMmcDll;
@@ -508,6 +508,47 @@ TpmError:
 }
 
 
+/**
+  Hash a data buffer for all the active PCR banks.
+
+  All the digests are calculated in a single pass over the data.
+
+  @param[in]  Data        Data pointer.
+  @param[in]  Length      Data Length.
+  @param[out] Digests     Digest values for the active PCR banks.
+**/
+STATIC
+VOID
+TpmHashActivePcrBanks (
+  IN  CONST UINT8                *Data,
+  IN        UINT32                Length,
+  OUT       TPML_DIGEST_VALUES   *Digests
+  )
+{
+  STATIC CONST UINT32  PcrBanks[] = {HASH_ALG_SHA256, HASH_ALG_SHA384, HASH_ALG_SHA512, HASH_ALG_SM3_256};
+  UINT8                HashAlg[HASH_MULTI_MAX];
+  UINT8               *OutHash[HASH_MULTI_MAX];
+  UINT32               PcrBankActive;
+  UINT32               Index;
+
+  TpmLibGetActivePcrBanks(&PcrBankActive);
+
+  Digests->count = 0;
+  for (Index = 0; Index < ARRAY_SIZE (PcrBanks); Index++) {
+    if ((PcrBankActive & PcrBanks[Index]) != 0) {
+      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(PcrBanks[Index]);
+      HashAlg[Digests->count] = GetCryptoHashAlg(PcrBanks[Index]);
+      OutHash[Digests->count] = (UINT8 *) (&(Digests->digests[Digests->count].digest));
+      Digests->count++;
+    }
+  }
+
+  if (Digests->count > 0) {
+    CalculateHashMulti (Data, Length, Digests->count, HashAlg, OutHash);
+  }
+}
+
+
 /**
   This event is extended in PCR[0-7] in two scenarios.
   When WithError=1, it indicates that error occurred during TPM initialization or
@@ -530,7 +571,6 @@ MeasureSeparatorEvent (
   TCG_PCR_EVENT2_HDR         PcrEventHdr;
   UINT32                     Data;
   UINT32                     PcrHandle;
-  UINT32                     PcrBankActive;
 
   if (!IsTpmEnabled()){
     return RETURN_DEVICE_ERROR;
@@ -539,35 +579,7 @@ MeasureSeparatorEvent (
   PcrHandle = 0;
   Data = WithError;
   Digests = &PcrEventHdr.Digests;
-  Digests->count = 1;
-
-  TpmLibGetActivePcrBanks(&PcrBankActive);
-
-  Digests->count = 0;
-
-  if ((PcrBankActive & HASH_ALG_SHA256) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA256);
-      CalculateHash ((UINT8 *)&Data, sizeof (Data), GetCryptoHashAlg(HASH_ALG_SHA256) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-
-  if ((PcrBankActive & HASH_ALG_SHA384) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA384);
-      CalculateHash ((UINT8 *)&Data, sizeof (Data), GetCryptoHashAlg(HASH_ALG_SHA384) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-
-  if ((PcrBankActive & HASH_ALG_SHA512) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA512);
-      CalculateHash ((UINT8 *)&Data, sizeof (Data), GetCryptoHashAlg(HASH_ALG_SHA512) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-
-  if ((PcrBankActive & HASH_ALG_SM3_256) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SM3_256);
-      CalculateHash ((UINT8 *)&Data, sizeof (Data), GetCryptoHashAlg(HASH_ALG_SM3_256) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
+  TpmHashActivePcrBanks ((UINT8 *)&Data, sizeof (Data), Digests);
 
   for (PcrHandle = 0; PcrHandle <= 7; PcrHandle++) {
     Status = Tpm2PcrExtend (PcrHandle, Digests);
@@ -617,7 +629,6 @@ IN  CONST  UINT8                     *Event
   EFI_STATUS                 Status;
   TCG_PCR_EVENT2_HDR         PcrEventHdr;
   TPML_DIGEST_VALUES        *Digests;
-  UINT32                     PcrBankActive;
 
   if (Data == NULL || Event == NULL) {
     return RETURN_INVALID_PARAMETER;
@@ -628,30 +639,7 @@ IN  CONST  UINT8                     *Event
   }
 
   Digests = &PcrEventHdr.Digests;
-  Digests->count = 0;
-
-  TpmLibGetActivePcrBanks(&PcrBankActive);
-
-  if ((PcrBankActive & HASH_ALG_SHA256) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA256);
-      CalculateHash (Data, Length, GetCryptoHashAlg(HASH_ALG_SHA256) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-  if ((PcrBankActive & HASH_ALG_SHA384) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA384);
-      CalculateHash (Data, Length, GetCryptoHashAlg(HASH_ALG_SHA384) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-  if ((PcrBankActive & HASH_ALG_SHA512) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SHA512);
-      CalculateHash (Data, Length, GetCryptoHashAlg(HASH_ALG_SHA512) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
-  if ((PcrBankActive & HASH_ALG_SM3_256) != 0) {
-      Digests->digests[Digests->count].hashAlg = (TPMI_ALG_HASH) GetTpmHashAlg(HASH_ALG_SM3_256);
-      CalculateHash (Data, Length, GetCryptoHashAlg(HASH_ALG_SM3_256) , (UINT8 *) (&(Digests->digests[Digests->count].digest)));
-      Digests->count++;
-  }
+  TpmHashActivePcrBanks (Data, Length, Digests);
 
   Status = Tpm2PcrExtend (PcrHandle, Digests);
   if (Status == EFI_SUCCESS) {
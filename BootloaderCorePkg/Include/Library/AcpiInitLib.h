@@ -11,6 +11,17 @@
 #include <Uefi/UefiBaseType.h>
 #include <IndustryStandard/Acpi.h>
 
+//
+// Boot span record type in the firmware vendor range
+//
+#define FPDT_BOOT_SPAN_RECORD_TYPE      0x1020
+#define FPDT_BOOT_SPAN_RECORD_REVISION  1
+
+//
+// Maximum boot span records reported in the Basic Boot Performance Data Table
+//
+#define FPDT_BOOT_SPAN_MAX              128
+
 #pragma pack(1)
 ///
 /// Firmware Performance Data Table.
@@ -33,6 +44,22 @@ typedef struct {
   //
 } BOOT_PERFORMANCE_TABLE;
 
+///
+/// Boot span record in the Basic Boot Performance Data Table.
+/// Times are in nanoseconds since the processor reset.
+///
+typedef struct {
+  EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER  Header;     ///< Common performance record header.
+  UINT16                                       Id;         ///< Measure point Id describing the span.
+  UINT8                                        Depth;      ///< Nesting level of the span.
+  UINT8                                        Reserved;
+  UINT32                                       Signature;  ///< Signature of the component owning the span.
+  UINT32                                       DeviceId;   ///< Device the span worked on, 0 if none.
+  UINT64                                       StartTime;
+  UINT64                                       EndTime;
+  UINT64                                       Bytes;      ///< Bytes processed in the span.
+} FPDT_BOOT_SPAN_RECORD;
+
 ///
 /// S3 Performance Data Table.
 /// This structure contains S3 performance records which will be updated in S3
@@ -90,4 +117,19 @@ UpdateFpdtS3Table (
   IN  UINT32                   AcpiTableBase
   );
 
+/**
+  Update the boot span records in the ACPI FPDT boot performance table.
+
+  @param[in] AcpiTableBase     ACPI base address
+
+  @retval EFI_SUCCESS          Update the boot span records successfully.
+  @retval EFI_UNSUPPORTED      Boot span recording is disabled.
+  @retval Others               Failed to update the table.
+ **/
+EFI_STATUS
+EFIAPI
+UpdateFpdtBootSpans (
+  IN  UINT32                   AcpiTableBase
+  );
+
 #endif
@@ -31,6 +31,8 @@ typedef  VOID   (EFIAPI *PAYLOAD_ENTRY) (VOID *HobList, VOID *Params);
 
 #define  PLATFORM_NAME_SIZE           8
 
+#define  MEM_POOL_BUCKET_COUNT        15
+
 typedef enum {
   EnumBufFlashMap,
   EnumBufVerInfo,
@@ -195,6 +197,11 @@ typedef struct {
   UINT32            CarBase;
   UINT32            CarSize;
   UINT32            MemPoolMaxUsed;
+  UINT32            MemPoolReclaimTop;
+  UINT32            MemPoolFreeSize;
+  UINT32            MemPoolFreeList;
+  UINT32            MemPoolBucket[MEM_POOL_BUCKET_COUNT];
+  VOID             *AllocTracePtr;
 } LOADER_GLOBAL_DATA;
 
 /**
@@ -219,4 +226,30 @@ GetLoaderGlobalDataPointer (
   VOID
   );
 
+/**
+  Get a mark of the current memory pool top.
+
+  @retval   The memory pool mark.
+
+**/
+VOID *
+EFIAPI
+GetMemoryPoolMark (
+  VOID
+  );
+
+/**
+  Release the memory pool down to a mark.
+
+  All the memory taken from the pool top after the mark is freed.
+
+  @param[in] Mark   The mark returned by GetMemoryPoolMark ().
+
+**/
+VOID
+EFIAPI
+ReleaseMemoryPool (
+  IN VOID   *Mark
+  );
+
 #endif
@@ -12,6 +12,7 @@
 #include <Library/BootloaderCoreLib.h>
 #include <Library/AcpiInitLib.h>
 #include <Library/TimeStampLib.h>
+#include <Library/LoaderPerformanceLib.h>
 
 BOOT_PERFORMANCE_TABLE mBootPerformanceTableTemplate = {
   {
@@ -57,6 +58,76 @@ S3_PERFORMANCE_TABLE        mS3PerformanceTableTemplate = {
 };
 
 
+/**
+  Convert a timestamp counter value into nanoseconds.
+
+  @param[in] Tsc               Timestamp counter value.
+  @param[in] FreqKhz           Timestamp counter frequency in KHz.
+
+  @retval    Time in nanoseconds.
+ **/
+STATIC
+UINT64
+TscToNs (
+  IN  UINT64                          Tsc,
+  IN  UINT32                          FreqKhz
+  )
+{
+  return DivU64x32 (MultU64x32 (Tsc, 1000000), FreqKhz);
+}
+
+/**
+  Fill the boot span records following the basic boot record.
+
+  Only the spans already ended are reported, up to SpanMax records.
+
+  @param[in, out] BootPerfTable  Pointer of boot performance record table.
+  @param[in]      SpanMax        Number of span records reserved after the table.
+ **/
+STATIC
+VOID
+FillFpdtBootSpans (
+  IN OUT BOOT_PERFORMANCE_TABLE       *BootPerfTable,
+  IN     UINT32                       SpanMax
+  )
+{
+  BOOT_SPAN_INFO                      *SpanInfo;
+  BOOT_SPAN_RECORD                    *Span;
+  FPDT_BOOT_SPAN_RECORD               *Record;
+  UINT32                              Index;
+  UINT32                              Count;
+
+  BootPerfTable->Header.Length = sizeof (BOOT_PERFORMANCE_TABLE);
+  SpanInfo = GetBootSpanInfo ();
+  if ((SpanInfo == NULL) || (SpanInfo->FreqKhz == 0)) {
+    return;
+  }
+
+  Record = (FPDT_BOOT_SPAN_RECORD *) (BootPerfTable + 1);
+  Count  = 0;
+  for (Index = 0; (Index < SpanInfo->Count) && (Count < SpanMax); Index++) {
+    Span = &SpanInfo->Span[Index];
+    if ((Span->Flags & BOOT_SPAN_OPEN) != 0) {
+      continue;
+    }
+    Record->Header.Type     = FPDT_BOOT_SPAN_RECORD_TYPE;
+    Record->Header.Length   = sizeof (FPDT_BOOT_SPAN_RECORD);
+    Record->Header.Revision = FPDT_BOOT_SPAN_RECORD_REVISION;
+    Record->Id              = Span->Id;
+    Record->Depth           = Span->Depth;
+    Record->Reserved        = 0;
+    Record->Signature       = Span->Signature;
+    Record->DeviceId        = Span->DeviceId;
+    Record->StartTime       = TscToNs (Span->StartTsc, SpanInfo->FreqKhz);
+    Record->EndTime         = TscToNs (Span->EndTsc, SpanInfo->FreqKhz);
+    Record->Bytes           = Span->Bytes;
+    Record++;
+    Count++;
+  }
+
+  BootPerfTable->Header.Length += Count * sizeof (FPDT_BOOT_SPAN_RECORD);
+}
+
 /**
   Update boot performance record table.
 
@@ -86,14 +157,15 @@ UpdateFpdtBootTable (
 
 
 /**
-  Get FPDT S3 performance table by searching ACPI table
+  Get FPDT by searching ACPI table
 
   @param[in]  AcpiTableBase    ACPI table base address
 
-  @retval S3 performance table address     Value 0 means not found.
+  @retval FPDT address         NULL means not found.
 **/
-UINTN
-GetFpdtS3Table (
+STATIC
+FIRMWARE_PERFORMANCE_TABLE *
+GetFpdt (
   IN  UINT32                                   AcpiTableBase
   )
 {
@@ -102,9 +174,7 @@ GetFpdtS3Table (
   EFI_ACPI_COMMON_HEADER                       *Hdr;
   UINT32                                       *RsdtEntry;
   UINT32                                       NumEntries;
-  FIRMWARE_PERFORMANCE_TABLE                   *Fpdt;
   UINT8                                        Index;
-  BOOT_PERFORMANCE_TABLE                       *BootTable;
 
   Rsdp = (EFI_ACPI_5_0_ROOT_SYSTEM_DESCRIPTION_POINTER *)(UINTN)AcpiTableBase;
   Rsdt = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)Rsdp->RsdtAddress;
@@ -114,22 +184,88 @@ GetFpdtS3Table (
   for (Index = 0; Index < NumEntries; Index++) {
     Hdr = (EFI_ACPI_COMMON_HEADER *) (UINTN) RsdtEntry[Index];
     if (Hdr->Signature == EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE) {
-      Fpdt = (FIRMWARE_PERFORMANCE_TABLE *) Hdr;
-      BootTable = (BOOT_PERFORMANCE_TABLE *)(UINTN)Fpdt->BootPointerRecord.BootPerformanceTablePointer;
-      DEBUG ((DEBUG_VERBOSE, "FPDT: ResetEnd                = %ld\n", BootTable->BasicBoot.ResetEnd));
-      DEBUG ((DEBUG_VERBOSE, "FPDT: OsLoaderLoadImageStart  = %ld\n", BootTable->BasicBoot.OsLoaderLoadImageStart));
-      DEBUG ((DEBUG_VERBOSE, "FPDT: OsLoaderStartImageStart = %ld\n", BootTable->BasicBoot.OsLoaderStartImageStart));
-      DEBUG ((DEBUG_VERBOSE, "FPDT: ExitBootServicesEntry   = %ld\n", BootTable->BasicBoot.ExitBootServicesEntry));
-      DEBUG ((DEBUG_VERBOSE, "FPDT: ExitBootServicesExit    = %ld\n", BootTable->BasicBoot.ExitBootServicesExit));
-
-      return (UINTN)Fpdt->S3PointerRecord.S3PerformanceTablePointer;
+      return (FIRMWARE_PERFORMANCE_TABLE *) Hdr;
     }
   }
 
+  return NULL;
+}
+
+
+/**
+  Get FPDT S3 performance table by searching ACPI table
+
+  @param[in]  AcpiTableBase    ACPI table base address
+
+  @retval S3 performance table address     Value 0 means not found.
+**/
+UINTN
+GetFpdtS3Table (
+  IN  UINT32                                   AcpiTableBase
+  )
+{
+  FIRMWARE_PERFORMANCE_TABLE                   *Fpdt;
+  BOOT_PERFORMANCE_TABLE                       *BootTable;
+
+  Fpdt = GetFpdt (AcpiTableBase);
+  if (Fpdt != NULL) {
+    BootTable = (BOOT_PERFORMANCE_TABLE *)(UINTN)Fpdt->BootPointerRecord.BootPerformanceTablePointer;
+    DEBUG ((DEBUG_VERBOSE, "FPDT: ResetEnd                = %ld\n", BootTable->BasicBoot.ResetEnd));
+    DEBUG ((DEBUG_VERBOSE, "FPDT: OsLoaderLoadImageStart  = %ld\n", BootTable->BasicBoot.OsLoaderLoadImageStart));
+    DEBUG ((DEBUG_VERBOSE, "FPDT: OsLoaderStartImageStart = %ld\n", BootTable->BasicBoot.OsLoaderStartImageStart));
+    DEBUG ((DEBUG_VERBOSE, "FPDT: ExitBootServicesEntry   = %ld\n", BootTable->BasicBoot.ExitBootServicesEntry));
+    DEBUG ((DEBUG_VERBOSE, "FPDT: ExitBootServicesExit    = %ld\n", BootTable->BasicBoot.ExitBootServicesExit));
+
+    return (UINTN)Fpdt->S3PointerRecord.S3PerformanceTablePointer;
+  }
+
   return 0;
 }
 
 
+/**
+  Update the boot span records in the ACPI FPDT boot performance table.
+
+  Spans ended after the ACPI tables were created are added by calling
+  this function again before leaving the bootloader.
+
+  @param[in] AcpiTableBase     ACPI base address
+
+  @retval EFI_SUCCESS          Update the boot span records successfully.
+  @retval EFI_UNSUPPORTED      Boot span recording is disabled.
+  @retval Others               Failed to update the table.
+ **/
+EFI_STATUS
+EFIAPI
+UpdateFpdtBootSpans (
+  IN  UINT32                          AcpiTableBase
+  )
+{
+  FIRMWARE_PERFORMANCE_TABLE          *Fpdt;
+  BOOT_PERFORMANCE_TABLE              *BootPerfTable;
+  UINT32                              SpanMax;
+
+  if (FixedPcdGet32 (PcdBootSpanBufferSize) == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Fpdt = GetFpdt (AcpiTableBase);
+  if (Fpdt == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  BootPerfTable = (BOOT_PERFORMANCE_TABLE *)(UINTN)Fpdt->BootPointerRecord.BootPerformanceTablePointer;
+  ASSERT (BootPerfTable->Header.Signature == EFI_ACPI_5_0_FPDT_BOOT_PERFORMANCE_TABLE_SIGNATURE);
+
+  // The S3 performance table follows the span records reserved by UpdateFpdt
+  SpanMax = (UINT32)(((UINTN)Fpdt->S3PointerRecord.S3PerformanceTablePointer - (UINTN)(BootPerfTable + 1)) /
+                     sizeof (FPDT_BOOT_SPAN_RECORD));
+  FillFpdtBootSpans (BootPerfTable, SpanMax);
+
+  return EFI_SUCCESS;
+}
+
+
 /**
   Update ACPI FPDT S3 performance record table.
 
@@ -182,24 +318,31 @@ UpdateFpdtS3Table (
 /**
   Update Firmware Performance Data Table (FPDT).
 
-  @param[in] Table          Pointer of ACPI FPDT Table.
-  @param[out] ExtraSize     Extra size the table needed.
+  The boot span records are reserved only as far as they fit in the room
+  left after the table.
+
+  @param[in]     Table          Pointer of ACPI FPDT Table.
+  @param[in,out] ExtraSize      On input, the room available after the table.
+                                On output, extra size the table needed.
 
-  @retval EFI_SUCCESS       Update ACPI FPDT table successfully.
-  @retval Others            Failed to update FPDT table.
+  @retval EFI_SUCCESS           Update ACPI FPDT table successfully.
+  @retval EFI_OUT_OF_RESOURCES  Not enough room for the performance tables.
+  @retval Others                Failed to update FPDT table.
  **/
 EFI_STATUS
 UpdateFpdt (
-  IN  UINT8                           *Table,
-  OUT UINT32                          *ExtraSize
+  IN     UINT8                        *Table,
+  IN OUT UINT32                       *ExtraSize
   )
 {
   FIRMWARE_PERFORMANCE_TABLE          *Fpdt;
   UINT8                               BootMode;
   BOOT_PERFORMANCE_TABLE              *BootPerfTable;
   S3_PERFORMANCE_TABLE                *S3PerfTable;
+  UINT32                              BaseSize;
+  UINT32                              SpanMax;
 
-  if ( Table == NULL) {
+  if ((Table == NULL) || (ExtraSize == NULL)) {
     DEBUG((DEBUG_WARN, "TABLE is NULL\n"));
     return EFI_INVALID_PARAMETER;
   }
@@ -208,18 +351,33 @@ UpdateFpdt (
   if (BootMode != BOOT_ON_S3_RESUME) {
     Fpdt          = (FIRMWARE_PERFORMANCE_TABLE *)Table;
     BootPerfTable = (BOOT_PERFORMANCE_TABLE *) (Fpdt + 1);
-    S3PerfTable   = (S3_PERFORMANCE_TABLE *) (BootPerfTable + 1);
+    BaseSize      = (UINT32)((UINT8 *) (BootPerfTable + 1) + sizeof (S3_PERFORMANCE_TABLE) - Table - Fpdt->Header.Length);
+    if (BaseSize > *ExtraSize) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    // Reserve room for the boot span records that fit
+    SpanMax = 0;
+    if (FixedPcdGet32 (PcdBootSpanBufferSize) != 0) {
+      SpanMax = MIN ((*ExtraSize - BaseSize) / sizeof (FPDT_BOOT_SPAN_RECORD), FPDT_BOOT_SPAN_MAX);
+      if (SpanMax < FPDT_BOOT_SPAN_MAX) {
+        DEBUG ((DEBUG_WARN, "FPDT: Room for %d boot span records only\n", SpanMax));
+      }
+    }
+    S3PerfTable = (S3_PERFORMANCE_TABLE *) ((FPDT_BOOT_SPAN_RECORD *) (BootPerfTable + 1) + SpanMax);
 
     Fpdt->BootPointerRecord.BootPerformanceTablePointer = (UINT64) (UINTN) BootPerfTable;
     Fpdt->S3PointerRecord.S3PerformanceTablePointer     = (UINT64) (UINTN) S3PerfTable;
     CopyMem (BootPerfTable, &mBootPerformanceTableTemplate, sizeof (mBootPerformanceTableTemplate));
     CopyMem (S3PerfTable, &mS3PerformanceTableTemplate, sizeof (mS3PerformanceTableTemplate));
     UpdateFpdtBootTable (BootPerfTable);
-
-    if (ExtraSize != NULL) {
-      *ExtraSize = (UINT32)((UINT8 *) (S3PerfTable + 1) - Table - Fpdt->Header.Length);
+    if (SpanMax != 0) {
+      FillFpdtBootSpans (BootPerfTable, SpanMax);
     }
 
+    *ExtraSize = BaseSize + SpanMax * sizeof (FPDT_BOOT_SPAN_RECORD);
+  } else {
+    *ExtraSize = 0;
   }
 
   return  EFI_SUCCESS;
@@ -472,6 +472,7 @@ UpdateFwst (
   @retval     EFI_SUCCESS     ACPI tables are created successfully.
               EFI_NOT_FOUND   Required ACPI tables could not be found.
               EFI_UNSUPPORTED Sysinfo table not found.
+              EFI_OUT_OF_RESOURCES  ACPI tables do not fit in the reclaim region.
 
 **/
 EFI_STATUS
@@ -507,6 +508,7 @@ AcpiInit (
   BOOLEAN                   Loop;
   UINT64                    Signature;
   CONST EFI_ACPI_COMMON_HEADER  **AcpiTblTmpl;
+  UINT32                    AcpiMax;
 
   Facs = NULL;
   Dsdt = NULL;
@@ -514,6 +516,7 @@ AcpiInit (
   UpdateRdstXsdt = 0;
 
   Current = (UINT8 *)(UINTN)(*AcpiMemBase);
+  AcpiMax = *AcpiMemBase + PcdGet32 (PcdLoaderAcpiReclaimSize);
 
   //
   // Create RSDP
@@ -583,6 +586,10 @@ AcpiInit (
       }
 
       ACPI_ALIGN ();
+      if (((UINT32)(UINTN)Current + Table->Length) > AcpiMax) {
+        DEBUG ((DEBUG_ERROR, "No room for ACPI table 0x%08X\n", Table->Signature));
+        return EFI_OUT_OF_RESOURCES;
+      }
       CopyMem  (Current, Table, Table->Length);
 
       UpdateRdstXsdt = 0;
@@ -621,6 +628,7 @@ AcpiInit (
           break;
         case EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE:
           // FPDT
+          ExtraSize = AcpiMax - (UINT32)(UINTN)Current - ((EFI_ACPI_COMMON_HEADER *)Current)->Length;
           Status = UpdateFpdt (Current, &ExtraSize);
           break;
         case EFI_FIRMWARE_UPDATE_STATUS_TABLE_SIGNATURE:
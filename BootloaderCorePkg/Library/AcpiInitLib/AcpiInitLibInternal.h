@@ -60,16 +60,18 @@ UpdateBgrt (
 /**
   Update Firmware Performance Data Table (FPDT).
 
-  @param[in]  Table         Pointer of ACPI FPDT Table.
-  @param[out] ExtraSize     Extra size the table needed.
+  @param[in]     Table          Pointer of ACPI FPDT Table.
+  @param[in,out] ExtraSize      On input, the room available after the table.
+                                On output, extra size the table needed.
 
-  @retval EFI_SUCCESS       Update ACPI FPDT table successfully.
-  @retval Others            Failed to update FPDT table.
+  @retval EFI_SUCCESS           Update ACPI FPDT table successfully.
+  @retval EFI_OUT_OF_RESOURCES  Not enough room for the performance tables.
+  @retval Others                Failed to update FPDT table.
  **/
 EFI_STATUS
 UpdateFpdt (
-  IN  UINT8                             *Table,
-  OUT UINT32                            *ExtraSize
+  IN     UINT8                          *Table,
+  IN OUT UINT32                         *ExtraSize
   );
 
 #endif
@@ -12,10 +12,36 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/PcdLib.h>
+#include <Library/BootloaderCommonLib.h>
 #include <BootloaderCoreGlobal.h>
 
 #define   POOL_MIN_ALIGNMENT    0x10
 
+#define   POOL_HEAD_SIGNATURE   SIGNATURE_32 ('P', 'H', 'D', '0')
+#define   POOL_FREE_SIGNATURE   SIGNATURE_32 ('P', 'F', 'R', '0')
+#define   FREE_PAGE_SIGNATURE   SIGNATURE_32 ('F', 'P', 'G', '0')
+
+//
+// Pool buckets hold blocks of 32 bytes up to 4KB, header included. The bucket
+// sizes grow by 1.5x and 4/3x in turn: 32, 48, 64, 96, 128, ... 3072, 4096.
+//
+#define   POOL_BUCKET_MIN_SIZE  0x20
+#define   POOL_BUCKET_MAX_SIZE  (POOL_BUCKET_MIN_SIZE << ((MEM_POOL_BUCKET_COUNT - 1) / 2))
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    Size;
+  UINT32    Next;
+  UINT32    Reserved;
+} POOL_HEAD;
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    Size;
+  UINT32    Next;
+} FREE_PAGE_RANGE;
+
 /**
   Update the Memory pool top address.
 
@@ -63,27 +89,423 @@ InternalUpdateMemPoolBottom (
 }
 
 /**
-  Allocates a buffer of type EfiBootServicesData.
+  Get the loader global data if the memory pool is reclaimable.
 
-  Allocates the number bytes specified by AllocationSize of type EfiBootServicesData and returns a
-  pointer to the allocated buffer.  If AllocationSize is 0, LdrGlobal->MemPoolCurrTop is returned.
-  If there is not enough memory remaining to satisfy the request, InternalUpdateMemPoolTop ASSERTS
-  and the function does not return.
+  Only the Stage2 part of the permanent memory pool is reclaimable. The
+  allocations made before Stage2 are below MemPoolReclaimTop and are never
+  freed.
+
+  @retval  The loader global data, or NULL if the pool is not reclaimable.
+
+**/
+STATIC
+LOADER_GLOBAL_DATA *
+GetReclaimableGlobalData (
+  VOID
+  )
+{
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+
+  LdrGlobal = GetLoaderGlobalDataPointer();
+  if (!FeaturePcdGet (PcdMemPoolReclaimEnabled) || (LdrGlobal->LoaderStage != LOADER_STAGE_2)) {
+    return NULL;
+  }
+
+  if (LdrGlobal->MemPoolReclaimTop == 0) {
+    LdrGlobal->MemPoolReclaimTop = LdrGlobal->MemPoolCurrTop;
+    LdrGlobal->MemPoolFreeSize   = 0;
+    LdrGlobal->MemPoolFreeList   = 0;
+    ZeroMem (LdrGlobal->MemPoolBucket, sizeof (LdrGlobal->MemPoolBucket));
+  }
+
+  return LdrGlobal;
+}
+
+/**
+  Check if a memory range is in the allocated reclaimable memory pool.
+
+  @param[in]  LdrGlobal     The loader global data.
+  @param[in]  Base          Base of the range.
+  @param[in]  Size          Size of the range.
+
+  @retval TRUE              The range is reclaimable.
+  @retval FALSE             The range is not reclaimable.
+
+**/
+STATIC
+BOOLEAN
+IsReclaimable (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal,
+  IN UINT32               Base,
+  IN UINT32               Size
+  )
+{
+  return (BOOLEAN)((Size != 0) && (Base >= LdrGlobal->MemPoolCurrTop) &&
+                   (Size <= LdrGlobal->MemPoolReclaimTop - Base));
+}
+
+/**
+  Give the free page ranges adjacent to the memory pool top back to the pool.
+
+  @param[in]  LdrGlobal     The loader global data.
+
+**/
+STATIC
+VOID
+ReclaimMemPoolTop (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal
+  )
+{
+  FREE_PAGE_RANGE     *Range;
+
+  while ((LdrGlobal->MemPoolFreeList != 0) && (LdrGlobal->MemPoolFreeList == LdrGlobal->MemPoolCurrTop)) {
+    Range = (FREE_PAGE_RANGE *)(UINTN)LdrGlobal->MemPoolFreeList;
+    LdrGlobal->MemPoolFreeList  = Range->Next;
+    LdrGlobal->MemPoolFreeSize -= Range->Size;
+    LdrGlobal->MemPoolCurrTop  += Range->Size;
+    Range->Signature = 0;
+  }
+}
+
+/**
+  Insert a page range into the free list, which is sorted by address.
+
+  The range is merged with the adjacent free ranges.
+
+  @param[in]  LdrGlobal     The loader global data.
+  @param[in]  Base          Base of the page range.
+  @param[in]  Size          Size of the page range.
+
+**/
+STATIC
+VOID
+InsertFreePages (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal,
+  IN UINT32               Base,
+  IN UINT32               Size
+  )
+{
+  FREE_PAGE_RANGE     *Prev;
+  FREE_PAGE_RANGE     *Range;
+  UINT32              *Link;
+  UINT32               Next;
+
+  Prev = NULL;
+  Link = &LdrGlobal->MemPoolFreeList;
+  while ((*Link != 0) && (*Link < Base)) {
+    Prev = (FREE_PAGE_RANGE *)(UINTN)*Link;
+    Link = &Prev->Next;
+  }
+
+  Next = *Link;
+  if (((Prev != NULL) && ((UINT32)(UINTN)Prev + Prev->Size > Base)) || ((Next != 0) && (Base + Size > Next))) {
+    DEBUG ((DEBUG_ERROR, "Free overlapped pages 0x%08X\n", Base));
+    ASSERT (FALSE);
+    return;
+  }
+
+  LdrGlobal->MemPoolFreeSize += Size;
+  if ((Next != 0) && (Base + Size == Next)) {
+    Range = (FREE_PAGE_RANGE *)(UINTN)Next;
+    Size += Range->Size;
+    Next  = Range->Next;
+    Range->Signature = 0;
+  }
+
+  if ((Prev != NULL) && ((UINT32)(UINTN)Prev + Prev->Size == Base)) {
+    Prev->Size += Size;
+    Prev->Next  = Next;
+  } else {
+    Range = (FREE_PAGE_RANGE *)(UINTN)Base;
+    Range->Signature = FREE_PAGE_SIGNATURE;
+    Range->Size      = Size;
+    Range->Next      = Next;
+    *Link = Base;
+  }
+}
+
+/**
+  Get the block size of a pool bucket.
+
+  @param[in]  Index         The pool bucket index.
+
+  @retval     The block size of the bucket.
+
+**/
+STATIC
+UINT32
+GetBucketSize (
+  IN UINT32               Index
+  )
+{
+  if ((Index & 1) != 0) {
+    return (POOL_BUCKET_MIN_SIZE + POOL_BUCKET_MIN_SIZE / 2) << (Index >> 1);
+  }
+  return POOL_BUCKET_MIN_SIZE << (Index >> 1);
+}
+
+/**
+  Get the smallest pool bucket that can hold a block.
+
+  @param[in]  Size          Block size, not above POOL_BUCKET_MAX_SIZE.
+
+  @retval     The pool bucket index.
+
+**/
+STATIC
+UINT32
+GetBucketIndex (
+  IN UINT32               Size
+  )
+{
+  UINT32               Index;
+
+  for (Index = 0; GetBucketSize (Index) < Size; Index++) {
+  }
+  return Index;
+}
+
+/**
+  Put a small memory range into the pool buckets.
+
+  This keeps the space skipped below the pool top to align a page allocation.
+
+  @param[in]  LdrGlobal     The loader global data.
+  @param[in]  Base          Base of the range, aligned on POOL_MIN_ALIGNMENT.
+  @param[in]  Size          Size of the range.
+
+**/
+STATIC
+VOID
+InsertFreeBuckets (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal,
+  IN UINT32               Base,
+  IN UINT32               Size
+  )
+{
+  POOL_HEAD           *Head;
+  UINT32               Index;
+
+  Index = MEM_POOL_BUCKET_COUNT - 1;
+  while (Size >= POOL_BUCKET_MIN_SIZE) {
+    while (GetBucketSize (Index) > Size) {
+      Index--;
+    }
+    Head = (POOL_HEAD *)(UINTN)Base;
+    Head->Signature = POOL_FREE_SIGNATURE;
+    Head->Size      = GetBucketSize (Index);
+    Head->Next      = LdrGlobal->MemPoolBucket[Index];
+    LdrGlobal->MemPoolBucket[Index] = Base;
+    LdrGlobal->MemPoolFreeSize     += Head->Size;
+    Base += Head->Size;
+    Size -= Head->Size;
+  }
+}
+
+/**
+  Allocate pages from the reclaimable memory pool.
+
+  The smallest free page range that fits is used first, and the pool top is
+  only moved down if no free range fits.
+
+  @param[in]  LdrGlobal     The loader global data.
+  @param[in]  Size          Size to allocate, multiple of EFI_PAGE_SIZE.
+  @param[in]  Alignment     Alignment, power of two and at least EFI_PAGE_SIZE.
+
+  @retval     Base of the allocated pages.
+
+**/
+STATIC
+UINT32
+AllocateReclaimablePages (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal,
+  IN UINT32               Size,
+  IN UINT32               Alignment
+  )
+{
+  FREE_PAGE_RANGE     *Range;
+  UINT32              *Link;
+  UINT32              *BestLink;
+  UINT32               BestSize;
+  UINT32               RangeBase;
+  UINT32               RangeEnd;
+  UINT32               Base;
+  UINT32               Top;
+
+  BestLink = NULL;
+  BestSize = 0;
+  Link     = &LdrGlobal->MemPoolFreeList;
+  while (*Link != 0) {
+    Range = (FREE_PAGE_RANGE *)(UINTN)*Link;
+    if ((Range->Size >= Size) && (ALIGN_DOWN (*Link + Range->Size - Size, Alignment) >= *Link)) {
+      if ((BestLink == NULL) || (Range->Size < BestSize)) {
+        BestLink = Link;
+        BestSize = Range->Size;
+      }
+    }
+    Link = &Range->Next;
+  }
+
+  if (BestLink != NULL) {
+    //
+    // Take the pages from the top of the range and free the rest again
+    //
+    RangeBase = *BestLink;
+    RangeEnd  = RangeBase + BestSize;
+    Range     = (FREE_PAGE_RANGE *)(UINTN)RangeBase;
+    *BestLink = Range->Next;
+    Range->Signature = 0;
+    LdrGlobal->MemPoolFreeSize -= BestSize;
+
+    Base = ALIGN_DOWN (RangeEnd - Size, Alignment);
+    if (Base > RangeBase) {
+      InsertFreePages (LdrGlobal, RangeBase, Base - RangeBase);
+    }
+    if (RangeEnd > Base + Size) {
+      InsertFreePages (LdrGlobal, Base + Size, RangeEnd - (Base + Size));
+    }
+    return Base;
+  }
+
+  Top  = ALIGN_DOWN (LdrGlobal->MemPoolCurrTop, EFI_PAGE_SIZE);
+  Base = ALIGN_DOWN (Top - Size, Alignment);
+  InsertFreeBuckets (LdrGlobal, Top, LdrGlobal->MemPoolCurrTop - Top);
+  InternalUpdateMemPoolTop (Base);
+  if (Top > Base + Size) {
+    InsertFreePages (LdrGlobal, Base + Size, Top - (Base + Size));
+  }
+  return Base;
+}
+
+/**
+  Allocate a pool buffer from the reclaimable memory pool.
+
+  Small buffers come from the smallest pool bucket that fits. Larger buffers
+  take the exact number of pages needed for the buffer and its header.
+
+  @param[in]  LdrGlobal       The loader global data.
+  @param[in]  AllocationSize  The number of bytes to allocate.
+
+  @retval     A pointer to the allocated buffer.
+
+**/
+STATIC
+VOID *
+AllocateReclaimablePool (
+  IN LOADER_GLOBAL_DATA  *LdrGlobal,
+  IN UINTN                AllocationSize
+  )
+{
+  POOL_HEAD           *Head;
+  UINT32               Size;
+  UINT32               Index;
+  UINT32               Top;
+
+  if (AllocationSize + sizeof (POOL_HEAD) > POOL_BUCKET_MAX_SIZE) {
+    Size = ALIGN_UP ((UINT32)AllocationSize + sizeof (POOL_HEAD), EFI_PAGE_SIZE);
+    Head = (POOL_HEAD *)(UINTN)AllocateReclaimablePages (LdrGlobal, Size, EFI_PAGE_SIZE);
+  } else {
+    Index = GetBucketIndex ((UINT32)AllocationSize + sizeof (POOL_HEAD));
+    Size  = GetBucketSize (Index);
+    if (LdrGlobal->MemPoolBucket[Index] != 0) {
+      Head = (POOL_HEAD *)(UINTN)LdrGlobal->MemPoolBucket[Index];
+      ASSERT (Head->Signature == POOL_FREE_SIGNATURE);
+      LdrGlobal->MemPoolBucket[Index] = Head->Next;
+      LdrGlobal->MemPoolFreeSize     -= Size;
+    } else {
+      Top  = ALIGN_DOWN (LdrGlobal->MemPoolCurrTop - Size, POOL_MIN_ALIGNMENT);
+      InternalUpdateMemPoolTop (Top);
+      Head = (POOL_HEAD *)(UINTN)Top;
+    }
+  }
+
+  Head->Signature = POOL_HEAD_SIGNATURE;
+  Head->Size      = Size;
+  Head->Next      = 0;
+  Head->Reserved  = 0;
+  return (VOID *)(Head + 1);
+}
+
+/**
+  Get the memory allocation trace table.
+
+  @retval   The trace table, or NULL if the allocations are not traced.
+
+**/
+STATIC
+ALLOC_TRACE_INFO *
+GetTraceInfo (
+  VOID
+  )
+{
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+
+  if (FixedPcdGet32 (PcdAllocTraceEntries) == 0) {
+    return NULL;
+  }
+
+  LdrGlobal = GetLoaderGlobalDataPointer();
+  return (ALLOC_TRACE_INFO *)LdrGlobal->AllocTracePtr;
+}
+
+/**
+  Record a memory allocation in the trace table.
+
+  The address of AllocatePool () in the current stage is kept as well, so that
+  the caller addresses can be matched with the stage map file.
+
+  @param[in]  Caller    Return address of the allocation call.
+  @param[in]  Buffer    The allocated buffer.
+  @param[in]  Size      The allocated size in bytes.
+  @param[in]  Type      ALLOC_TRACE_TYPE_* of the allocation.
+
+**/
+STATIC
+VOID
+TraceAllocation (
+  IN VOID     *Caller,
+  IN VOID     *Buffer,
+  IN UINTN     Size,
+  IN UINT8     Type
+  )
+{
+  ALLOC_TRACE_INFO    *TraceInfo;
+  UINT8                Stage;
+
+  TraceInfo = GetTraceInfo ();
+  if (TraceInfo == NULL) {
+    return;
+  }
+
+  Stage = GetLoaderGlobalDataPointer()->LoaderStage;
+  if ((Stage < ALLOC_TRACE_STAGE_COUNT) && (TraceInfo->Anchor[Stage] == 0)) {
+    TraceInfo->Anchor[Stage] = (UINT32)(UINTN)AllocatePool;
+  }
+  AllocTraceAdd (TraceInfo, Caller, Buffer, Size, Type, Stage);
+}
+
+/**
+  Allocate a buffer from the memory pool top.
 
   @param  AllocationSize        The number of bytes to allocate.
 
   @return A pointer to the allocated buffer or NULL if allocation fails.
 
 **/
+STATIC
 VOID *
-EFIAPI
-AllocatePool (
+InternalAllocatePool (
   IN UINTN  AllocationSize
   )
 {
   LOADER_GLOBAL_DATA  *LdrGlobal;
   UINT32               Top;
 
+  LdrGlobal = GetReclaimableGlobalData ();
+  if (LdrGlobal != NULL) {
+    return AllocateReclaimablePool (LdrGlobal, AllocationSize);
+  }
+
   LdrGlobal = GetLoaderGlobalDataPointer();
   Top  = LdrGlobal->MemPoolCurrTop;
   Top -= (UINT32)AllocationSize;
@@ -92,6 +514,32 @@ AllocatePool (
   return (VOID *)(UINTN)Top;
 }
 
+/**
+  Allocates a buffer of type EfiBootServicesData.
+
+  Allocates the number bytes specified by AllocationSize of type EfiBootServicesData and returns a
+  pointer to the allocated buffer.  If AllocationSize is 0, LdrGlobal->MemPoolCurrTop is returned.
+  If there is not enough memory remaining to satisfy the request, InternalUpdateMemPoolTop ASSERTS
+  and the function does not return.
+
+  @param  AllocationSize        The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+
+**/
+VOID *
+EFIAPI
+AllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  VOID  *Memory;
+
+  Memory = InternalAllocatePool (AllocationSize);
+  TraceAllocation (RETURN_ADDRESS (0), Memory, AllocationSize, ALLOC_TRACE_TYPE_POOL);
+  return Memory;
+}
+
 /**
   Allocates and zeros a buffer of type EfiBootServicesData.
 
@@ -113,10 +561,11 @@ AllocateZeroPool (
 {
   VOID  *Memory;
 
-  Memory = AllocatePool (AllocationSize);
+  Memory = InternalAllocatePool (AllocationSize);
   if (Memory != NULL) {
     Memory = ZeroMem (Memory, AllocationSize);
   }
+  TraceAllocation (RETURN_ADDRESS (0), Memory, AllocationSize, ALLOC_TRACE_TYPE_POOL);
   return Memory;
 }
 
@@ -146,11 +595,18 @@ AllocatePages (
     return NULL;
   }
 
-  LdrGlobal = GetLoaderGlobalDataPointer();
-  Top  = LdrGlobal->MemPoolCurrTop;
-  Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
-  Top -= (UINT32)(Pages * EFI_PAGE_SIZE);
-  InternalUpdateMemPoolTop (Top);
+  LdrGlobal = GetReclaimableGlobalData ();
+  if (LdrGlobal != NULL) {
+    Top = AllocateReclaimablePages (LdrGlobal, (UINT32)EFI_PAGES_TO_SIZE (Pages), EFI_PAGE_SIZE);
+  } else {
+    LdrGlobal = GetLoaderGlobalDataPointer();
+    Top  = LdrGlobal->MemPoolCurrTop;
+    Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
+    Top -= (UINT32)(Pages * EFI_PAGE_SIZE);
+    InternalUpdateMemPoolTop (Top);
+  }
+
+  TraceAllocation (RETURN_ADDRESS (0), (VOID *)(UINTN)Top, EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
   return (VOID *)(UINTN)Top;
 }
 
@@ -186,15 +642,23 @@ AllocateAlignedPages (
     return NULL;
   }
 
-  LdrGlobal = GetLoaderGlobalDataPointer();
-  Top  = LdrGlobal->MemPoolCurrTop;
-  Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
-  Top -= (UINT32)(Pages * EFI_PAGE_SIZE);
-  if (Alignment > EFI_PAGE_SIZE) {
-    Top  = ALIGN_DOWN (Top, Alignment);
+  LdrGlobal = GetReclaimableGlobalData ();
+  if (LdrGlobal != NULL) {
+    Top = AllocateReclaimablePages (LdrGlobal, (UINT32)EFI_PAGES_TO_SIZE (Pages),
+                                    (UINT32)MAX (Alignment, EFI_PAGE_SIZE));
+  } else {
+    LdrGlobal = GetLoaderGlobalDataPointer();
+    Top  = LdrGlobal->MemPoolCurrTop;
+    Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
+    Top -= (UINT32)(Pages * EFI_PAGE_SIZE);
+    if (Alignment > EFI_PAGE_SIZE) {
+      Top  = ALIGN_DOWN (Top, Alignment);
+    }
+    Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
+    InternalUpdateMemPoolTop (Top);
   }
-  Top  = ALIGN_DOWN (Top, EFI_PAGE_SIZE);
-  InternalUpdateMemPoolTop (Top);
+
+  TraceAllocation (RETURN_ADDRESS (0), (VOID *)(UINTN)Top, EFI_PAGES_TO_SIZE (Pages), ALLOC_TRACE_TYPE_PAGES);
   return (VOID *)(UINTN)Top;
 }
 
@@ -223,6 +687,7 @@ AllocateTemporaryMemory (
   Bottom  = ALIGN_UP (Bottom, POOL_MIN_ALIGNMENT);
   NewBottom = Bottom + (UINT32)AllocationSize;
   InternalUpdateMemPoolBottom (NewBottom);
+  TraceAllocation (RETURN_ADDRESS (0), (VOID *)(UINTN)Bottom, AllocationSize, ALLOC_TRACE_TYPE_TEMP);
   return (VOID *)(UINTN)Bottom;
 }
 
@@ -244,10 +709,12 @@ FreeTemporaryMemory (
   LdrGlobal = GetLoaderGlobalDataPointer();
   if (Buffer == NULL) {
     LdrGlobal->MemPoolCurrBottom = LdrGlobal->MemPoolStart;
+    AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_TEMP, NULL, MAX_UINTN);
   } else {
     NewBottom = (UINT32)(UINTN)Buffer;
     if (NewBottom < LdrGlobal->MemPoolCurrBottom) {
       InternalUpdateMemPoolBottom (NewBottom);
+      AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_TEMP, Buffer, MAX_UINTN - NewBottom);
     }
   }
 }
@@ -261,9 +728,8 @@ FreeTemporaryMemory (
   Allocation Library.  If it is not possible to free allocated pages, then this function will
   perform no actions.
 
-  If Buffer was not allocated with a page allocation function in the Memory Allocation Library,
-  then ASSERT().
-  If Pages is zero, then ASSERT().
+  Pages are only reclaimed in Stage2 when PcdMemPoolReclaimEnabled is set. The freed pages
+  are merged with the adjacent free pages, and given back to the pool top when possible.
 
   @param  Buffer                The pointer to the buffer of pages to free.
   @param  Pages                 The number of 4 KB pages to free.
@@ -276,6 +742,24 @@ FreePages (
   IN UINTN  Pages
   )
 {
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+  UINT32               Base;
+  UINT32               Size;
+
+  LdrGlobal = GetReclaimableGlobalData ();
+  if (LdrGlobal == NULL) {
+    return;
+  }
+
+  Base = (UINT32)(UINTN)Buffer;
+  Size = (UINT32)EFI_PAGES_TO_SIZE (Pages);
+  if (((Base & EFI_PAGE_MASK) != 0) || !IsReclaimable (LdrGlobal, Base, Size)) {
+    return;
+  }
+
+  InsertFreePages (LdrGlobal, Base, Size);
+  ReclaimMemPoolTop (LdrGlobal);
+  AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_PAGES, Buffer, Size);
 }
 
 /**
@@ -286,8 +770,8 @@ FreePages (
   pool allocation services of the Memory Allocation Library.  If it is not possible to free pool
   resources, then this function will perform no actions.
 
-  If Buffer was not allocated with a pool allocation function in the Memory Allocation Library,
-  then ASSERT().
+  Pool buffers are only reclaimed in Stage2 when PcdMemPoolReclaimEnabled is set. A freed
+  small buffer goes to the pool bucket of its size, unless it is at the pool top.
 
   @param  Buffer                The pointer to the buffer to free.
 
@@ -298,6 +782,154 @@ FreePool (
   IN VOID   *Buffer
   )
 {
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+  POOL_HEAD           *Head;
+  UINT32               Base;
+  UINT32               Size;
+  UINT32               Index;
+
+  LdrGlobal = GetReclaimableGlobalData ();
+  if ((LdrGlobal == NULL) || (Buffer == NULL)) {
+    return;
+  }
+
+  Head = (POOL_HEAD *)Buffer - 1;
+  Base = (UINT32)(UINTN)Head;
+  if (!IsReclaimable (LdrGlobal, Base, sizeof (POOL_HEAD)) || (Head->Signature != POOL_HEAD_SIGNATURE) ||
+      !IsReclaimable (LdrGlobal, Base, Head->Size)) {
+    return;
+  }
+
+  Size = Head->Size;
+  if (Size > POOL_BUCKET_MAX_SIZE) {
+    Head->Signature = 0;
+    InsertFreePages (LdrGlobal, Base, Size);
+    ReclaimMemPoolTop (LdrGlobal);
+  } else if (Base == LdrGlobal->MemPoolCurrTop) {
+    Head->Signature = 0;
+    LdrGlobal->MemPoolCurrTop += Size;
+    ReclaimMemPoolTop (LdrGlobal);
+  } else {
+    Index = GetBucketIndex (Size);
+    Head->Signature = POOL_FREE_SIGNATURE;
+    Head->Next      = LdrGlobal->MemPoolBucket[Index];
+    LdrGlobal->MemPoolBucket[Index] = Base;
+    LdrGlobal->MemPoolFreeSize     += Size;
+  }
+  AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_POOL, Buffer, 1);
+}
+
+/**
+  Get a mark of the current memory pool top.
+
+  The mark can be passed to ReleaseMemoryPool () to free everything allocated
+  after it at once, such as all the buffers of a boot phase.
+
+  @retval   The memory pool mark.
+
+**/
+VOID *
+EFIAPI
+GetMemoryPoolMark (
+  VOID
+  )
+{
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+
+  GetReclaimableGlobalData ();
+  LdrGlobal = GetLoaderGlobalDataPointer();
+  return (VOID *)(UINTN)LdrGlobal->MemPoolCurrTop;
+}
+
+/**
+  Release the memory pool down to a mark.
+
+  All the memory taken from the pool top after the mark is freed. Buffers reused from
+  the free lists after the mark are left to their owners. This function does nothing
+  unless the Stage2 memory pool is reclaimable.
+
+  @param[in] Mark   The mark returned by GetMemoryPoolMark ().
+
+**/
+VOID
+EFIAPI
+ReleaseMemoryPool (
+  IN VOID   *Mark
+  )
+{
+  LOADER_GLOBAL_DATA  *LdrGlobal;
+  POOL_HEAD           *Head;
+  FREE_PAGE_RANGE     *Range;
+  UINT32              *Link;
+  UINT32               Top;
+  UINT32               Base;
+  UINT32               End;
+  UINT32               Index;
+
+  LdrGlobal = GetReclaimableGlobalData ();
+  Top       = (UINT32)(UINTN)Mark;
+  if ((LdrGlobal == NULL) || (Top < LdrGlobal->MemPoolCurrTop) || (Top > LdrGlobal->MemPoolReclaimTop)) {
+    return;
+  }
+
+  //
+  // Drop the free buffers below the mark
+  //
+  for (Index = 0; Index < MEM_POOL_BUCKET_COUNT; Index++) {
+    Link = &LdrGlobal->MemPoolBucket[Index];
+    while (*Link != 0) {
+      Head = (POOL_HEAD *)(UINTN)*Link;
+      if (*Link < Top) {
+        *Link = Head->Next;
+        LdrGlobal->MemPoolFreeSize -= Head->Size;
+      } else {
+        Link = &Head->Next;
+      }
+    }
+  }
+
+  Link = &LdrGlobal->MemPoolFreeList;
+  while ((*Link != 0) && (*Link < Top)) {
+    Range = (FREE_PAGE_RANGE *)(UINTN)*Link;
+    Base  = ALIGN_UP (Top, EFI_PAGE_SIZE);
+    End   = *Link + Range->Size;
+    if (End <= Base) {
+      *Link = Range->Next;
+      LdrGlobal->MemPoolFreeSize -= Range->Size;
+    } else {
+      LdrGlobal->MemPoolFreeSize -= Base - *Link;
+      CopyMem ((VOID *)(UINTN)Base, Range, sizeof (FREE_PAGE_RANGE));
+      Range = (FREE_PAGE_RANGE *)(UINTN)Base;
+      Range->Size = End - Base;
+      *Link = Base;
+      break;
+    }
+  }
+
+  AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_POOL, (VOID *)(UINTN)LdrGlobal->MemPoolCurrTop,
+                    Top - LdrGlobal->MemPoolCurrTop);
+  AllocTraceRemove (GetTraceInfo (), ALLOC_TRACE_TYPE_PAGES, (VOID *)(UINTN)LdrGlobal->MemPoolCurrTop,
+                    Top - LdrGlobal->MemPoolCurrTop);
+  LdrGlobal->MemPoolCurrTop = Top;
+  ReclaimMemPoolTop (LdrGlobal);
+}
+
+/**
+  Get the memory allocation trace table.
+
+  The table is only available when PcdAllocTraceEntries is not 0, and records
+  the allocations from Stage1B memory initialization on.
+
+  @retval   The trace table, or NULL if the allocations are not traced.
+
+**/
+ALLOC_TRACE_INFO *
+EFIAPI
+GetAllocTraceInfo (
+  VOID
+  )
+{
+  return GetTraceInfo ();
 }
 
 /**
@@ -371,7 +371,7 @@ MpInit (
       InitializeSpinLock (&mMpDataStruct.SpinLock);
 
       //
-      // Allocate 1 K * 16 AP Stack, assume to support max 16 CPUs
+      // Allocate AP stack for max PcdCpuMaxLogicalProcessorNumber CPUs
       //
       ApStackTop = (EFI_PHYSICAL_ADDRESS) (UINTN)AllocatePages ( \
                    EFI_SIZE_TO_PAGES (PcdGet32 (PcdCpuMaxLogicalProcessorNumber) * AP_STACK_SIZE));
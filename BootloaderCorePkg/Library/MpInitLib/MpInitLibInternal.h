@@ -30,7 +30,8 @@
 #define   AP_BUFFER_ADDRESS        0x38000
 #define   AP_BUFFER_SIZE           0x8000
 
-#define   AP_STACK_SIZE_SHIFT_BITS 12
+// APs may run hashing and decompression jobs, so give them 8KB of stack
+#define   AP_STACK_SIZE_SHIFT_BITS 13
 #define   AP_STACK_SIZE            (1<<AP_STACK_SIZE_SHIFT_BITS)
 #define   AP_TASK_TIMEOUT_UNIT     15
 #define   AP_TASK_TIMEOUT_CNT      1000
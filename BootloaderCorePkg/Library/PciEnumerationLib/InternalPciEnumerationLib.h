@@ -193,4 +193,15 @@ BarExisted (
   OUT UINT32        *OriginalBarValue
   );
 
+/**
+  Allocate the memory of specified size from the memory pool.
+
+  @param AllocationSize size to be allocated.
+
+ **/
+VOID *
+PciAllocatePool (
+  IN UINTN            AllocationSize
+  );
+
 #endif
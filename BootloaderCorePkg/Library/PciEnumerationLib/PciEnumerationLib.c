@@ -17,6 +17,7 @@
 #include <Library/BootloaderCommonLib.h>
 #include "PciAri.h"
 #include "PciIov.h"
+#include "PciSnapshot.h"
 
 #define  DEBUG_PCI_ENUM    0
 
@@ -1856,6 +1857,7 @@ PciEnumeration (
   PCI_IO_DEVICE               *RootBridges;
   UINT8                       RootBridgeCount;
   EFI_STATUS                  Status;
+  VOID                        *PoolPtr;
 
   SetAllocationPool (MemPool);
 
@@ -1868,17 +1870,35 @@ PciEnumeration (
   EnumPolicy = (PCI_ENUM_POLICY_INFO *)PcdGetPtr (PcdPciEnumPolicyInfo);
   RootBridgeCount = 0;
 
+  GetPciResourceAllocTable (&ResAllocTable);
+
+  //
+  // Skip the full enumeration if the topology matches the previous boot
+  //
+  if (FeaturePcdGet (PcdPciEnumSnapshotEnabled) && !FeaturePcdGet (PcdSrIovSupport)) {
+    PoolPtr = GetAllocationPool ();
+    Status  = PciRestoreSnapshot (EnumPolicy, ResAllocTable);
+    SetAllocationPool (PoolPtr);
+    if (!EFI_ERROR (Status)) {
+      SetAllocationPool (MemPool);
+      return EFI_SUCCESS;
+    }
+  }
+
   Status = PciScanRootBridges (EnumPolicy, &RootBridges, &RootBridgeCount);
   ASSERT_EFI_ERROR (Status);
   ASSERT (RootBridgeCount > 0);
 
-  GetPciResourceAllocTable (&ResAllocTable);
   PciProgramResources (EnumPolicy, ResAllocTable, RootBridges);
 
   PciEnableDevices (RootBridges);
 
   BuildPciRootBridgeInfoHob (RootBridges, RootBridgeCount);
 
+  if (FeaturePcdGet (PcdPciEnumSnapshotEnabled) && !FeaturePcdGet (PcdSrIovSupport)) {
+    PciSaveSnapshot (EnumPolicy, ResAllocTable, RootBridges);
+  }
+
 #if DEBUG_PCI_ENUM
   DumpPciResAllocTable ();
   DumpPciResources (RootBridges);
@@ -0,0 +1,859 @@
+/** @file
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/PcdLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PciExpressLib.h>
+#include <Library/HobLib.h>
+#include <Library/VariableLib.h>
+#include <Library/PciEnumerationLib.h>
+#include "InternalPciEnumerationLib.h"
+#include "PciSnapshot.h"
+
+//
+// The most registers recorded for one function
+//
+#define PCI_SNAPSHOT_MAX_REGS     16
+
+#define PCI_SNAPSHOT_BUS(Address)       ((UINT8)((Address) >> 20))
+#define PCI_SNAPSHOT_DEVICE_SIZE(Dev)   (sizeof (PCI_SNAPSHOT_DEVICE) + (Dev)->RegCount * sizeof (PCI_SNAPSHOT_REG))
+
+typedef struct {
+  UINT16                    Offset;
+  UINT8                     Width;
+} PCI_SNAPSHOT_PPB_REG;
+
+//
+// PCI-PCI bridge apperture registers
+//
+STATIC CONST PCI_SNAPSHOT_PPB_REG mPpbAppertureReg[] = {
+  {0x1C, 1}, {0x1D, 1}, {0x20, 2}, {0x22, 2}, {0x24, 2},
+  {0x26, 2}, {0x28, 4}, {0x2C, 4}, {0x30, 2}, {0x32, 2}
+};
+
+/**
+  Calculate the CRC of the enumeration policy and the resource ranges.
+
+  A snapshot is only valid for the same policy and ranges.
+
+  @param[in]  EnumPolicy        PciEnum Policy with root bridge mask to be scanned
+  @param[in]  ResAllocTable     PCI resource allocation table
+
+  @retval     The configuration CRC.
+
+**/
+STATIC
+UINT32
+GetSnapshotConfigCrc (
+  IN CONST  PCI_ENUM_POLICY_INFO  *EnumPolicy,
+  IN CONST  PCI_RES_ALLOC_TABLE   *ResAllocTable
+  )
+{
+  UINT32        Crc;
+
+  Crc  = CalculateCrc32 ((VOID *)EnumPolicy, sizeof (PCI_ENUM_POLICY_INFO) + EnumPolicy->NumOfBus);
+  Crc ^= LRotU32 (CalculateCrc32 ((VOID *)ResAllocTable, sizeof (PCI_RES_ALLOC_TABLE) +
+                                  ResAllocTable->NumOfEntries * sizeof (PCI_RES_ALLOC_RANGE)), 1);
+  return Crc;
+}
+
+/**
+  Calculate the CRC of a snapshot.
+
+  @param[in]  Snapshot          The snapshot.
+
+  @retval     The snapshot CRC.
+
+**/
+STATIC
+UINT32
+GetSnapshotCrc (
+  IN  PCI_SNAPSHOT_HEADER   *Snapshot
+  )
+{
+  UINT32        Crc;
+  UINT32        SavedCrc;
+
+  SavedCrc      = Snapshot->Crc;
+  Snapshot->Crc = 0;
+  Crc           = CalculateCrc32 (Snapshot, Snapshot->Length);
+  Snapshot->Crc = SavedCrc;
+
+  return Crc;
+}
+
+/**
+  Add a register to a device of the snapshot.
+
+  @param[in,out]  Device        The snapshot device.
+  @param[in]      Offset        Register offset.
+  @param[in]      Flags         Register width and PCI_SNAPSHOT_REG_OR.
+  @param[in]      Value         Register value, or the bits to set with PCI_SNAPSHOT_REG_OR.
+
+**/
+STATIC
+VOID
+AddSnapshotReg (
+  IN OUT  PCI_SNAPSHOT_DEVICE   *Device,
+  IN      UINT16                 Offset,
+  IN      UINT8                  Flags,
+  IN      UINT32                 Value
+  )
+{
+  PCI_SNAPSHOT_REG    *Reg;
+
+  ASSERT (Device->RegCount < PCI_SNAPSHOT_MAX_REGS);
+  Reg = &Device->Reg[Device->RegCount++];
+  Reg->Offset   = Offset;
+  Reg->Flags    = Flags;
+  Reg->Reserved = 0;
+  Reg->Value    = Value;
+}
+
+/**
+  Add the programmed BARs of a device to the snapshot.
+
+  @param[in,out]  Device        The snapshot device.
+  @param[in]      PciBar        The BAR array.
+  @param[in]      BarCount      The number of BARs.
+
+**/
+STATIC
+VOID
+AddSnapshotBars (
+  IN OUT  PCI_SNAPSHOT_DEVICE   *Device,
+  IN      CONST PCI_BAR         *PciBar,
+  IN      UINT32                 BarCount
+  )
+{
+  UINT32        Idx;
+  UINT16        Offset;
+
+  for (Idx = 0; Idx < BarCount; Idx++) {
+    if ((PciBar[Idx].Length == 0) || (PciBar[Idx].Offset >= 0x100)) {
+      continue;
+    }
+    Offset = PciBar[Idx].Offset;
+    AddSnapshotReg (Device, Offset, 4, PciExpressRead32 (Device->Address + Offset));
+    if ((PciBar[Idx].OrgBarType == PciBarTypeMem64) || (PciBar[Idx].OrgBarType == PciBarTypePMem64)) {
+      AddSnapshotReg (Device, Offset + 4, 4, PciExpressRead32 (Device->Address + Offset + 4));
+    }
+  }
+}
+
+/**
+  Add a PCI device and all devices under it to the snapshot.
+
+  Devices are added in the scan order, so a bridge always comes before
+  the devices behind it.
+
+  @param[in]      Parent        The parent device.
+  @param[in,out]  Snapshot      The snapshot.
+  @param[in]      MaxLength     The snapshot buffer size.
+
+  @retval EFI_SUCCESS           The devices are added.
+  @retval EFI_BUFFER_TOO_SMALL  The snapshot buffer is too small.
+
+**/
+STATIC
+EFI_STATUS
+AddSnapshotDevices (
+  IN      CONST PCI_IO_DEVICE   *Parent,
+  IN OUT  PCI_SNAPSHOT_HEADER   *Snapshot,
+  IN      UINT32                 MaxLength
+  )
+{
+  EFI_STATUS                Status;
+  LIST_ENTRY               *CurrentLink;
+  PCI_IO_DEVICE            *PciIoDevice;
+  PCI_SNAPSHOT_DEVICE      *Device;
+  UINT32                    Address;
+  UINT32                    Idx;
+  UINT32                    Data32;
+  UINT16                    Command;
+  BOOLEAN                   HasChild;
+
+  CurrentLink = Parent->ChildList.ForwardLink;
+  while ((CurrentLink != NULL) && (CurrentLink != &Parent->ChildList)) {
+    PciIoDevice = PCI_IO_DEVICE_FROM_LINK (CurrentLink);
+    if (Snapshot->Length + sizeof (PCI_SNAPSHOT_DEVICE) + PCI_SNAPSHOT_MAX_REGS * sizeof (PCI_SNAPSHOT_REG) > MaxLength) {
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    Address  = PciIoDevice->Address;
+    HasChild = (BOOLEAN)(PciIoDevice->ChildList.ForwardLink != &PciIoDevice->ChildList);
+    Device   = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Snapshot + Snapshot->Length);
+    ZeroMem (Device, sizeof (PCI_SNAPSHOT_DEVICE));
+    Device->Address    = Address;
+    Device->Id         = PciExpressRead32 (Address + PCI_VENDOR_ID_OFFSET);
+    Device->HeaderType = PciExpressRead8 (Address + PCI_HEADER_TYPE_OFFSET) & HEADER_LAYOUT_CODE;
+
+    Command = EFI_PCI_COMMAND_IO_SPACE | EFI_PCI_COMMAND_MEMORY_SPACE;
+    if (IS_PCI_BRIDGE (&PciIoDevice->Pci)) {
+      Device->SecondaryBus   = PciExpressRead8 (Address + PCI_BRIDGE_SECONDARY_BUS_REGISTER_OFFSET);
+      Device->SubordinateBus = PciExpressRead8 (Address + PCI_BRIDGE_SUBORDINATE_BUS_REGISTER_OFFSET);
+      for (Idx = 0; Idx < ARRAY_SIZE (mPpbAppertureReg); Idx++) {
+        switch (mPpbAppertureReg[Idx].Width) {
+        case 1:
+          Data32 = PciExpressRead8 (Address + mPpbAppertureReg[Idx].Offset);
+          break;
+        case 2:
+          Data32 = PciExpressRead16 (Address + mPpbAppertureReg[Idx].Offset);
+          break;
+        default:
+          Data32 = PciExpressRead32 (Address + mPpbAppertureReg[Idx].Offset);
+          break;
+        }
+        AddSnapshotReg (Device, mPpbAppertureReg[Idx].Offset, mPpbAppertureReg[Idx].Width, Data32);
+      }
+      AddSnapshotBars (Device, PciIoDevice->PpbBar, PPB_MAX_BAR);
+
+      if (FeaturePcdGet (PcdAriSupport) && (PciIoDevice->PciExpressCapabilityOffset != 0)) {
+        Data32 = PciExpressRead32 (Address + PciIoDevice->PciExpressCapabilityOffset +
+                                   EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_OFFSET);
+        if ((Data32 & EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_ARI_FORWARDING) != 0) {
+          AddSnapshotReg (Device, PciIoDevice->PciExpressCapabilityOffset + EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_OFFSET,
+                          4 | PCI_SNAPSHOT_REG_OR, EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_ARI_FORWARDING);
+        }
+      }
+      if (HasChild) {
+        Command |= EFI_PCI_COMMAND_BUS_MASTER;
+      }
+    } else {
+      AddSnapshotBars (Device, PciIoDevice->PciBar, PCI_MAX_BAR);
+    }
+    AddSnapshotReg (Device, PCI_COMMAND_OFFSET, 2 | PCI_SNAPSHOT_REG_OR, Command);
+
+    Snapshot->Length += (UINT32)PCI_SNAPSHOT_DEVICE_SIZE (Device);
+    Snapshot->DeviceCount++;
+
+    if (HasChild) {
+      Status = AddSnapshotDevices (PciIoDevice, Snapshot, MaxLength);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+    CurrentLink = CurrentLink->ForwardLink;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Count the functions present on a PCI bus.
+
+  The bus is scanned the same way as PciScanBus () does.
+
+  @param[in]  Bus               The bus number.
+
+  @retval     The number of functions present.
+
+**/
+STATIC
+UINT32
+CountBusFunctions (
+  IN  UINT8     Bus
+  )
+{
+  UINT8         Device;
+  UINT8         Func;
+  UINT32        Count;
+
+  Count = 0;
+  for (Device = 0; Device <= PCI_MAX_DEVICE; Device++) {
+    if (PciExpressRead16 (PCI_EXPRESS_LIB_ADDRESS (Bus, Device, 0, PCI_VENDOR_ID_OFFSET)) == 0xFFFF) {
+      continue;
+    }
+    Count++;
+    if ((PciExpressRead8 (PCI_EXPRESS_LIB_ADDRESS (Bus, Device, 0, PCI_HEADER_TYPE_OFFSET)) & HEADER_TYPE_MULTI_FUNCTION) == 0) {
+      continue;
+    }
+    for (Func = 1; Func <= PCI_MAX_FUNC; Func++) {
+      if (PciExpressRead16 (PCI_EXPRESS_LIB_ADDRESS (Bus, Device, Func, PCI_VENDOR_ID_OFFSET)) != 0xFFFF) {
+        Count++;
+      }
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Check that the functions present on a bus are exactly the recorded ones.
+
+  The recorded functions have been found already, so it is enough to
+  compare the number of functions.
+
+  @param[in]  Snapshot          The snapshot.
+  @param[in]  Bus               The bus number.
+
+  @retval TRUE                  The bus matches the snapshot.
+  @retval FALSE                 Some function on the bus is not in the snapshot.
+
+**/
+STATIC
+BOOLEAN
+IsSnapshotBusMatched (
+  IN  PCI_SNAPSHOT_HEADER   *Snapshot,
+  IN  UINT8                  Bus
+  )
+{
+  PCI_SNAPSHOT_DEVICE      *Device;
+  UINT32                    Index;
+  UINT32                    Count;
+
+  Count  = 0;
+  Device = (PCI_SNAPSHOT_DEVICE *)((PCI_ROOT_BRIDGE_ENTRY *)(Snapshot + 1) + Snapshot->RootBridgeCount);
+  for (Index = 0; Index < Snapshot->DeviceCount; Index++) {
+    if (PCI_SNAPSHOT_BUS (Device->Address) == Bus) {
+      Count++;
+    }
+    Device = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Device + PCI_SNAPSHOT_DEVICE_SIZE (Device));
+  }
+
+  return (BOOLEAN)(CountBusFunctions (Bus) == Count);
+}
+
+/**
+  Get the value of a recorded register of a device.
+
+  @param[in]  Device            The snapshot device.
+  @param[in]  Offset            Register offset.
+
+  @retval     The register value, or 0 if the register is not recorded.
+
+**/
+STATIC
+UINT32
+GetSnapshotRegValue (
+  IN  CONST PCI_SNAPSHOT_DEVICE   *Device,
+  IN  UINT16                       Offset
+  )
+{
+  UINT32        RegIdx;
+
+  for (RegIdx = 0; RegIdx < Device->RegCount; RegIdx++) {
+    if (Device->Reg[RegIdx].Offset == Offset) {
+      return Device->Reg[RegIdx].Value;
+    }
+  }
+
+  return 0;
+}
+
+/**
+  Check if an address range is inside a resource range.
+
+  @param[in]  Base              Base of the address range.
+  @param[in]  Limit             Limit of the address range.
+  @param[in]  ResBase           Base of the resource range.
+  @param[in]  ResLimit          Limit of the resource range.
+
+  @retval TRUE                  The address range is inside the resource range.
+  @retval FALSE                 The address range is not inside the resource range.
+
+**/
+STATIC
+BOOLEAN
+IsInResRange (
+  IN  UINT64    Base,
+  IN  UINT64    Limit,
+  IN  UINT64    ResBase,
+  IN  UINT64    ResLimit
+  )
+{
+  return (BOOLEAN)((Base <= Limit) && (Base >= ResBase) && (Limit <= ResLimit));
+}
+
+/**
+  Check if a memory address range is inside the MMIO resource ranges.
+
+  @param[in]  ResRange          The resource allocation range of the bus.
+  @param[in]  Base              Base of the address range.
+  @param[in]  Limit             Limit of the address range.
+  @param[in]  Allow64           The range may be inside the 64-bit MMIO range.
+
+  @retval TRUE                  The address range is valid.
+  @retval FALSE                 The address range is not valid.
+
+**/
+STATIC
+BOOLEAN
+IsSnapshotMemValid (
+  IN  CONST PCI_RES_ALLOC_RANGE   *ResRange,
+  IN  UINT64                       Base,
+  IN  UINT64                       Limit,
+  IN  BOOLEAN                      Allow64
+  )
+{
+  if (IsInResRange (Base, Limit, ResRange->Mmio32Base, ResRange->Mmio32Limit)) {
+    return TRUE;
+  }
+
+  return (BOOLEAN)(Allow64 && IsInResRange (Base, Limit, ResRange->Mmio64Base, ResRange->Mmio64Limit));
+}
+
+/**
+  Get the offset of the PCI Express capability of a function.
+
+  @param[in]  Address           PCI_EXPRESS_LIB_ADDRESS of the function.
+
+  @retval     The capability offset, or 0 if it is not found.
+
+**/
+STATIC
+UINT8
+GetSnapshotPciExpCapOffset (
+  IN  UINT32    Address
+  )
+{
+  UINT8         CapabilityPtr;
+  UINT16        CapabilityEntry;
+  UINT32        Count;
+
+  if ((PciExpressRead16 (Address + PCI_PRIMARY_STATUS_OFFSET) & EFI_PCI_STATUS_CAPABILITY) == 0) {
+    return 0;
+  }
+
+  CapabilityPtr = PciExpressRead8 (Address + PCI_CAPBILITY_POINTER_OFFSET);
+  for (Count = 0; (Count < 48) && (CapabilityPtr >= 0x40) && ((CapabilityPtr & 0x03) == 0); Count++) {
+    CapabilityEntry = PciExpressRead16 (Address + CapabilityPtr);
+    if ((UINT8)CapabilityEntry == EFI_PCI_CAPABILITY_ID_PCIEXP) {
+      return CapabilityPtr;
+    }
+    CapabilityPtr = (UINT8)(CapabilityEntry >> 8);
+  }
+
+  return 0;
+}
+
+/**
+  Check the recorded registers of a device before they are programmed.
+
+  The snapshot variable is not authenticated. Only the registers the save
+  path records are accepted: the BARs, the bridge windows, the command
+  register and the ARI forwarding bit. Every BAR and window must be inside
+  the resource ranges of the bus of the device.
+
+  @param[in]  Device            The snapshot device, reachable on the bus.
+  @param[in]  ResAllocTable     PCI resource allocation table
+
+  @retval TRUE                  The device registers can be programmed.
+  @retval FALSE                 The device registers are not valid.
+
+**/
+STATIC
+BOOLEAN
+IsSnapshotDeviceValid (
+  IN  CONST PCI_SNAPSHOT_DEVICE   *Device,
+  IN  CONST PCI_RES_ALLOC_TABLE   *ResAllocTable
+  )
+{
+  CONST PCI_RES_ALLOC_RANGE   *ResRange;
+  CONST PCI_SNAPSHOT_REG      *Reg;
+  UINT32                       RegIdx;
+  UINT32                       Idx;
+  UINT32                       BarEnd;
+  UINT64                       Base;
+  UINT64                       Limit;
+  UINT8                        Bus;
+  BOOLEAN                      IsBridge;
+  BOOLEAN                      IsUpperBar;
+
+  Bus      = PCI_SNAPSHOT_BUS (Device->Address);
+  ResRange = NULL;
+  for (Idx = 0; Idx < ResAllocTable->NumOfEntries; Idx++) {
+    if ((ResAllocTable->ResourceRange[Idx].BusBase <= Bus) && (ResAllocTable->ResourceRange[Idx].BusLimit >= Bus)) {
+      ResRange = &ResAllocTable->ResourceRange[Idx];
+      break;
+    }
+  }
+  if ((ResRange == NULL) || (Device->RegCount > PCI_SNAPSHOT_MAX_REGS)) {
+    return FALSE;
+  }
+
+  IsBridge   = (BOOLEAN)(Device->HeaderType == HEADER_TYPE_PCI_TO_PCI_BRIDGE);
+  BarEnd     = PCI_BASE_ADDRESSREG_OFFSET + (IsBridge ? PPB_MAX_BAR : PCI_MAX_BAR) * sizeof (UINT32);
+  IsUpperBar = FALSE;
+  for (RegIdx = 0; RegIdx < Device->RegCount; RegIdx++) {
+    Reg = &Device->Reg[RegIdx];
+
+    if (Reg->Offset == PCI_COMMAND_OFFSET) {
+      if ((Reg->Flags != (2 | PCI_SNAPSHOT_REG_OR)) ||
+          ((Reg->Value & ~(UINT32)(EFI_PCI_COMMAND_IO_SPACE | EFI_PCI_COMMAND_MEMORY_SPACE | EFI_PCI_COMMAND_BUS_MASTER)) != 0)) {
+        return FALSE;
+      }
+      continue;
+    }
+
+    if (IsBridge && (Reg->Flags == (4 | PCI_SNAPSHOT_REG_OR))) {
+      // ARI forwarding in the PCI Express device control 2 register
+      if (!FeaturePcdGet (PcdAriSupport) || (Reg->Value != EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_ARI_FORWARDING) ||
+          (GetSnapshotPciExpCapOffset (Device->Address) == 0) ||
+          (Reg->Offset != GetSnapshotPciExpCapOffset (Device->Address) + EFI_PCIE_CAPABILITY_DEVICE_CONTROL_2_OFFSET)) {
+        return FALSE;
+      }
+      continue;
+    }
+
+    if (IsBridge && (Reg->Offset >= mPpbAppertureReg[0].Offset) && (Reg->Offset <= mPpbAppertureReg[ARRAY_SIZE (mPpbAppertureReg) - 1].Offset)) {
+      // The windows are checked together below
+      for (Idx = 0; Idx < ARRAY_SIZE (mPpbAppertureReg); Idx++) {
+        if ((Reg->Offset == mPpbAppertureReg[Idx].Offset) && (Reg->Flags == mPpbAppertureReg[Idx].Width)) {
+          break;
+        }
+      }
+      if (Idx == ARRAY_SIZE (mPpbAppertureReg)) {
+        return FALSE;
+      }
+      continue;
+    }
+
+    if ((Reg->Offset < PCI_BASE_ADDRESSREG_OFFSET) || (Reg->Offset >= BarEnd) ||
+        ((Reg->Offset & 0x03) != 0) || (Reg->Flags != 4)) {
+      return FALSE;
+    }
+    if (IsUpperBar) {
+      // Checked with the lower half of the 64-bit BAR
+      IsUpperBar = FALSE;
+      continue;
+    }
+    if ((Reg->Value & BIT0) != 0) {
+      Base = Reg->Value & ~(UINT32)0x03;
+      if (!IsInResRange (Base, Base, ResRange->IoBase, ResRange->IoLimit)) {
+        return FALSE;
+      }
+    } else {
+      Base = Reg->Value & ~(UINT32)0x0F;
+      if ((Reg->Value & (BIT2 | BIT1)) == BIT2) {
+        if ((RegIdx + 1 >= Device->RegCount) || (Device->Reg[RegIdx + 1].Offset != Reg->Offset + 4)) {
+          return FALSE;
+        }
+        Base      |= LShiftU64 (Device->Reg[RegIdx + 1].Value, 32);
+        IsUpperBar = TRUE;
+      }
+      if (!IsSnapshotMemValid (ResRange, Base, Base, IsUpperBar)) {
+        return FALSE;
+      }
+    }
+  }
+
+  if (!IsBridge) {
+    return TRUE;
+  }
+
+  //
+  // A disabled window has its base above its limit
+  //
+  Base  = ((GetSnapshotRegValue (Device, 0x1C) & 0xF0) << 8) | (GetSnapshotRegValue (Device, 0x30) << 16);
+  Limit = ((GetSnapshotRegValue (Device, 0x1D) & 0xF0) << 8) | (GetSnapshotRegValue (Device, 0x32) << 16) | 0xFFF;
+  if ((Base <= Limit) && !IsInResRange (Base, Limit, ResRange->IoBase, ResRange->IoLimit)) {
+    return FALSE;
+  }
+
+  Base  = LShiftU64 (GetSnapshotRegValue (Device, 0x20) & 0xFFF0, 16);
+  Limit = LShiftU64 (GetSnapshotRegValue (Device, 0x22) & 0xFFF0, 16) | 0xFFFFF;
+  if ((Base <= Limit) && !IsSnapshotMemValid (ResRange, Base, Limit, FALSE)) {
+    return FALSE;
+  }
+
+  Base  = LShiftU64 (GetSnapshotRegValue (Device, 0x24) & 0xFFF0, 16) | LShiftU64 (GetSnapshotRegValue (Device, 0x28), 32);
+  Limit = LShiftU64 (GetSnapshotRegValue (Device, 0x26) & 0xFFF0, 16) | LShiftU64 (GetSnapshotRegValue (Device, 0x2C), 32) | 0xFFFFF;
+  if ((Base <= Limit) && !IsSnapshotMemValid (ResRange, Base, Limit, TRUE)) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Load the snapshot from the variable store and check its integrity.
+
+  @param[in]  ConfigCrc         The expected configuration CRC.
+  @param[out] Snapshot          The loaded snapshot.
+
+  @retval EFI_SUCCESS           The snapshot is loaded.
+  @retval EFI_NOT_FOUND         No valid snapshot was found.
+
+**/
+STATIC
+EFI_STATUS
+LoadSnapshot (
+  IN  UINT32                 ConfigCrc,
+  OUT PCI_SNAPSHOT_HEADER  **Snapshot
+  )
+{
+  EFI_STATUS                Status;
+  PCI_SNAPSHOT_HEADER      *Header;
+  PCI_SNAPSHOT_DEVICE      *Device;
+  UINTN                     Size;
+  UINT32                    Offset;
+  UINT32                    Index;
+
+  Size   = PCI_SNAPSHOT_MAX_SIZE;
+  Header = (PCI_SNAPSHOT_HEADER *)PciAllocatePool (Size);
+  Status = GetVariable (PCI_SNAPSHOT_VARIABLE_NAME, NULL, &Size, Header);
+  if (EFI_ERROR (Status) || (Size < sizeof (PCI_SNAPSHOT_HEADER))) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((Header->Signature != PCI_SNAPSHOT_SIGNATURE) || (Header->Length != Size) ||
+      (Header->ConfigCrc != ConfigCrc) || (Header->Crc != GetSnapshotCrc (Header))) {
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Check that all the devices are within the snapshot
+  //
+  Offset = sizeof (PCI_SNAPSHOT_HEADER) + Header->RootBridgeCount * sizeof (PCI_ROOT_BRIDGE_ENTRY);
+  for (Index = 0; Index < Header->DeviceCount; Index++) {
+    if (Offset + sizeof (PCI_SNAPSHOT_DEVICE) > Header->Length) {
+      return EFI_NOT_FOUND;
+    }
+    Device  = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Header + Offset);
+    Offset += (UINT32)PCI_SNAPSHOT_DEVICE_SIZE (Device);
+  }
+  if (Offset != Header->Length) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Snapshot = Header;
+  return EFI_SUCCESS;
+}
+
+/**
+  Program the PCI devices from the topology snapshot of a previous boot.
+
+  The snapshot is used only if it was taken with the same enumeration policy
+  and resource ranges, and every recorded device and bridge bus range is still
+  present without any new device on the recorded buses. Every recorded register
+  must also be one a full enumeration programs, with a value inside the resource
+  ranges, so a tampered snapshot falls back to the full enumeration.
+
+  @param[in]  EnumPolicy        PciEnum Policy with root bridge mask to be scanned
+  @param[in]  ResAllocTable     PCI resource allocation table
+
+  @retval EFI_SUCCESS           The snapshot was applied and the root bridge info HOB built.
+  @retval EFI_NOT_FOUND         No valid snapshot was found.
+  @retval EFI_NOT_READY         The snapshot does not match the hardware.
+
+**/
+EFI_STATUS
+EFIAPI
+PciRestoreSnapshot (
+  IN CONST  PCI_ENUM_POLICY_INFO  *EnumPolicy,
+  IN CONST  PCI_RES_ALLOC_TABLE   *ResAllocTable
+  )
+{
+  EFI_STATUS                    Status;
+  PCI_SNAPSHOT_HEADER          *Snapshot;
+  PCI_ROOT_BRIDGE_ENTRY        *RootBridge;
+  PCI_SNAPSHOT_DEVICE          *FirstDevice;
+  PCI_SNAPSHOT_DEVICE          *Device;
+  PCI_SNAPSHOT_REG             *Reg;
+  PCI_ROOT_BRIDGE_INFO_HOB     *RootBridgeInfoHob;
+  PLATFORM_PCI_ENUM_HOOK_PROC   PlatformPciEnumHookProc;
+  UINT32                        Index;
+  UINT32                        RegIdx;
+  UINT32                        Address;
+  UINT8                         Bus;
+  UINT8                         Pass;
+  BOOLEAN                       InRange;
+
+  Status = LoadSnapshot (GetSnapshotConfigCrc (EnumPolicy, ResAllocTable), &Snapshot);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  RootBridge  = (PCI_ROOT_BRIDGE_ENTRY *)(Snapshot + 1);
+  FirstDevice = (PCI_SNAPSHOT_DEVICE *)(RootBridge + Snapshot->RootBridgeCount);
+
+  //
+  // Check the devices and assign the bus numbers so that the devices
+  // behind the bridges could be reached
+  //
+  PlatformPciEnumHookProc = (PLATFORM_PCI_ENUM_HOOK_PROC)(UINTN)PcdGet32 (PcdPciEnumHookProc);
+  Device = FirstDevice;
+  for (Index = 0; Index < Snapshot->DeviceCount; Index++) {
+    Address = Device->Address;
+    Bus     = PCI_SNAPSHOT_BUS (Address);
+    if ((PciExpressRead32 (Address + PCI_VENDOR_ID_OFFSET) != Device->Id) ||
+        ((PciExpressRead8 (Address + PCI_HEADER_TYPE_OFFSET) & HEADER_LAYOUT_CODE) != Device->HeaderType)) {
+      DEBUG ((DEBUG_INFO, "PCI snapshot mismatch at [%02x|%02x|%02x]\n", Bus, (Address >> 15) & 0x1F, (Address >> 12) & 0x07));
+      return EFI_NOT_READY;
+    }
+    if (!IsSnapshotDeviceValid (Device, ResAllocTable)) {
+      DEBUG ((DEBUG_INFO, "PCI snapshot invalid at [%02x|%02x|%02x]\n", Bus, (Address >> 15) & 0x1F, (Address >> 12) & 0x07));
+      return EFI_NOT_READY;
+    }
+
+    if (Device->HeaderType == HEADER_TYPE_PCI_TO_PCI_BRIDGE) {
+      InRange = FALSE;
+      for (RegIdx = 0; RegIdx < Snapshot->RootBridgeCount; RegIdx++) {
+        if ((Bus >= RootBridge[RegIdx].BusBase) && (Device->SubordinateBus <= RootBridge[RegIdx].BusLimit)) {
+          InRange = TRUE;
+        }
+      }
+      if (!InRange || (Device->SecondaryBus <= Bus) || (Device->SubordinateBus < Device->SecondaryBus)) {
+        return EFI_NOT_READY;
+      }
+      PciExpressWrite16 (Address + PCI_BRIDGE_PRIMARY_BUS_REGISTER_OFFSET, (UINT16)((Device->SecondaryBus << 8) | Bus));
+      PciExpressWrite8 (Address + PCI_BRIDGE_SUBORDINATE_BUS_REGISTER_OFFSET, Device->SubordinateBus);
+      if (PlatformPciEnumHookProc != NULL) {
+        PlatformPciEnumHookProc (Bus, (UINT8)((Address >> 15) & 0x1F), (UINT8)((Address >> 12) & 0x07),
+                                 EfiPciBeforeChildBusEnumeration);
+      }
+    }
+    Device = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Device + PCI_SNAPSHOT_DEVICE_SIZE (Device));
+  }
+
+  //
+  // No device may have been added to a recorded bus
+  //
+  for (Index = 0; Index < Snapshot->RootBridgeCount; Index++) {
+    if (!IsSnapshotBusMatched (Snapshot, RootBridge[Index].BusBase)) {
+      return EFI_NOT_READY;
+    }
+  }
+  Device = FirstDevice;
+  for (Index = 0; Index < Snapshot->DeviceCount; Index++) {
+    if ((Device->HeaderType == HEADER_TYPE_PCI_TO_PCI_BRIDGE) && !IsSnapshotBusMatched (Snapshot, Device->SecondaryBus)) {
+      DEBUG ((DEBUG_INFO, "PCI snapshot mismatch on bus 0x%02x\n", Device->SecondaryBus));
+      return EFI_NOT_READY;
+    }
+    Device = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Device + PCI_SNAPSHOT_DEVICE_SIZE (Device));
+  }
+
+  //
+  // Program the recorded resources first, then enable the devices
+  //
+  for (Pass = 0; Pass < 2; Pass++) {
+    Device = FirstDevice;
+    for (Index = 0; Index < Snapshot->DeviceCount; Index++) {
+      Address = Device->Address;
+      if ((Pass == 0) && (Device->HeaderType == HEADER_TYPE_PCI_TO_PCI_BRIDGE)) {
+        PciExpressAnd16 (Address + PCI_COMMAND_OFFSET, (UINT16)~EFI_PCI_COMMAND_BITS_OWNED);
+        PciExpressAnd16 (Address + PCI_BRIDGE_CONTROL_REGISTER_OFFSET, (UINT16)~EFI_PCI_BRIDGE_CONTROL_BITS_OWNED);
+        PciExpressWrite8 (Address + PCI_INT_LINE_OFFSET, 0x00);
+      }
+      for (RegIdx = 0; RegIdx < Device->RegCount; RegIdx++) {
+        Reg = &Device->Reg[RegIdx];
+        if ((Pass == 0) == ((Reg->Flags & PCI_SNAPSHOT_REG_OR) != 0)) {
+          continue;
+        }
+        switch (Reg->Flags) {
+        case 1:
+          PciExpressWrite8 (Address + Reg->Offset, (UINT8)Reg->Value);
+          break;
+        case 2:
+          PciExpressWrite16 (Address + Reg->Offset, (UINT16)Reg->Value);
+          break;
+        case 4:
+          PciExpressWrite32 (Address + Reg->Offset, Reg->Value);
+          break;
+        case 2 | PCI_SNAPSHOT_REG_OR:
+          PciExpressOr16 (Address + Reg->Offset, (UINT16)Reg->Value);
+          break;
+        case 4 | PCI_SNAPSHOT_REG_OR:
+          PciExpressOr32 (Address + Reg->Offset, Reg->Value);
+          break;
+        default:
+          break;
+        }
+      }
+      Device = (PCI_SNAPSHOT_DEVICE *)((UINT8 *)Device + PCI_SNAPSHOT_DEVICE_SIZE (Device));
+    }
+  }
+
+  RootBridgeInfoHob = BuildGuidHob (&gLoaderPciRootBridgeInfoGuid,
+                                    sizeof (PCI_ROOT_BRIDGE_INFO_HOB) + Snapshot->RootBridgeCount * sizeof (PCI_ROOT_BRIDGE_ENTRY));
+  if (RootBridgeInfoHob != NULL) {
+    ZeroMem (RootBridgeInfoHob, sizeof (PCI_ROOT_BRIDGE_INFO_HOB));
+    RootBridgeInfoHob->Revision = 1;
+    RootBridgeInfoHob->Count    = Snapshot->RootBridgeCount;
+    CopyMem (RootBridgeInfoHob->Entry, RootBridge, Snapshot->RootBridgeCount * sizeof (PCI_ROOT_BRIDGE_ENTRY));
+  }
+
+  DEBUG ((DEBUG_INFO, "PCI snapshot restored, %d devices\n", Snapshot->DeviceCount));
+  return EFI_SUCCESS;
+}
+
+/**
+  Save the topology and resource assignment of a full enumeration.
+
+  The snapshot is written to the variable store only when it differs from
+  the saved one. The root bridge info HOB must have been built.
+
+  @param[in]  EnumPolicy        PciEnum Policy with root bridge mask to be scanned
+  @param[in]  ResAllocTable     PCI resource allocation table
+  @param[in]  RootBridges       A pointer which has Root Bridges in ChildList
+
+  @retval EFI_SUCCESS           The snapshot is saved.
+  @retval EFI_NOT_FOUND         The root bridge info HOB is not found.
+  @retval EFI_BUFFER_TOO_SMALL  The topology is too big for a snapshot.
+  @retval others                The snapshot could not be written.
+
+**/
+EFI_STATUS
+EFIAPI
+PciSaveSnapshot (
+  IN CONST  PCI_ENUM_POLICY_INFO  *EnumPolicy,
+  IN CONST  PCI_RES_ALLOC_TABLE   *ResAllocTable,
+  IN CONST  PCI_IO_DEVICE         *RootBridges
+  )
+{
+  EFI_STATUS                    Status;
+  PCI_SNAPSHOT_HEADER          *Snapshot;
+  PCI_SNAPSHOT_HEADER          *SavedSnapshot;
+  PCI_ROOT_BRIDGE_INFO_HOB     *RootBridgeInfoHob;
+  UINT32                        ConfigCrc;
+  VOID                         *GuidHob;
+
+  GuidHob = GetFirstGuidHob (&gLoaderPciRootBridgeInfoGuid);
+  if (GuidHob == NULL) {
+    return EFI_NOT_FOUND;
+  }
+  RootBridgeInfoHob = (PCI_ROOT_BRIDGE_INFO_HOB *)GET_GUID_HOB_DATA (GuidHob);
+  if (RootBridgeInfoHob->Count == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  Snapshot = (PCI_SNAPSHOT_HEADER *)PciAllocatePool (PCI_SNAPSHOT_MAX_SIZE);
+  ZeroMem (Snapshot, sizeof (PCI_SNAPSHOT_HEADER));
+  ConfigCrc = GetSnapshotConfigCrc (EnumPolicy, ResAllocTable);
+  Snapshot->Signature       = PCI_SNAPSHOT_SIGNATURE;
+  Snapshot->ConfigCrc       = ConfigCrc;
+  Snapshot->RootBridgeCount = RootBridgeInfoHob->Count;
+  Snapshot->Length          = sizeof (PCI_SNAPSHOT_HEADER) + RootBridgeInfoHob->Count * sizeof (PCI_ROOT_BRIDGE_ENTRY);
+  if (Snapshot->Length > PCI_SNAPSHOT_MAX_SIZE) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  CopyMem (Snapshot + 1, RootBridgeInfoHob->Entry, RootBridgeInfoHob->Count * sizeof (PCI_ROOT_BRIDGE_ENTRY));
+
+  Status = AddSnapshotDevices (RootBridges, Snapshot, PCI_SNAPSHOT_MAX_SIZE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "PCI topology too big for a snapshot\n"));
+    return Status;
+  }
+  Snapshot->Crc = GetSnapshotCrc (Snapshot);
+
+  Status = LoadSnapshot (ConfigCrc, &SavedSnapshot);
+  if (!EFI_ERROR (Status) && (SavedSnapshot->Length == Snapshot->Length) &&
+      (CompareMem (SavedSnapshot, Snapshot, Snapshot->Length) == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  Status = SetVariable (PCI_SNAPSHOT_VARIABLE_NAME, 0, Snapshot->Length, Snapshot);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "PCI snapshot not saved: %r\n", Status));
+  }
+
+  return Status;
+}
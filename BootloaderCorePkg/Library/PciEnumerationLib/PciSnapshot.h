@@ -0,0 +1,104 @@
+/** @file
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PCI_SNAPSHOT_H__
+#define __PCI_SNAPSHOT_H__
+
+#define PCI_SNAPSHOT_SIGNATURE          SIGNATURE_32 ('P', 'C', 'I', 'S')
+#define PCI_SNAPSHOT_VARIABLE_NAME      "PCISNAP"
+#define PCI_SNAPSHOT_MAX_SIZE           SIZE_8KB
+
+//
+// Register operation flags in a PCI snapshot
+//
+#define PCI_SNAPSHOT_REG_WIDTH_MASK     0x07
+#define PCI_SNAPSHOT_REG_OR             BIT7
+
+#pragma pack(1)
+
+typedef struct {
+  UINT16                    Offset;
+  UINT8                     Flags;      // Register width in bytes and PCI_SNAPSHOT_REG_OR
+  UINT8                     Reserved;
+  UINT32                    Value;
+} PCI_SNAPSHOT_REG;
+
+typedef struct {
+  UINT32                    Address;    // PCI_EXPRESS_LIB_ADDRESS of the function
+  UINT32                    Id;         // Vendor ID and Device ID
+  UINT8                     HeaderType;
+  UINT8                     SecondaryBus;
+  UINT8                     SubordinateBus;
+  UINT8                     RegCount;
+  PCI_SNAPSHOT_REG          Reg[0];
+} PCI_SNAPSHOT_DEVICE;
+
+typedef struct {
+  UINT32                    Signature;
+  UINT32                    Length;
+  UINT32                    ConfigCrc;  // CRC32 of the enumeration policy and resource ranges
+  UINT32                    Crc;        // CRC32 of the snapshot with this field 0
+  UINT16                    DeviceCount;
+  UINT8                     RootBridgeCount;
+  UINT8                     Reserved;
+  //
+  // PCI_ROOT_BRIDGE_ENTRY  RootBridge[RootBridgeCount];
+  // PCI_SNAPSHOT_DEVICE    Device[DeviceCount];
+  //
+} PCI_SNAPSHOT_HEADER;
+
+#pragma pack()
+
+/**
+  Program the PCI devices from the topology snapshot of a previous boot.
+
+  The snapshot is used only if it was taken with the same enumeration policy
+  and resource ranges, and every recorded device and bridge bus range is still
+  present without any new device on the recorded buses. Every recorded register
+  must also be one a full enumeration programs, with a value inside the resource
+  ranges, so a tampered snapshot falls back to the full enumeration.
+
+  @param[in]  EnumPolicy        PciEnum Policy with root bridge mask to be scanned
+  @param[in]  ResAllocTable     PCI resource allocation table
+
+  @retval EFI_SUCCESS           The snapshot was applied and the root bridge info HOB built.
+  @retval EFI_NOT_FOUND         No valid snapshot was found.
+  @retval EFI_NOT_READY         The snapshot does not match the hardware.
+
+**/
+EFI_STATUS
+EFIAPI
+PciRestoreSnapshot (
+  IN CONST  PCI_ENUM_POLICY_INFO  *EnumPolicy,
+  IN CONST  PCI_RES_ALLOC_TABLE   *ResAllocTable
+  );
+
+/**
+  Save the topology and resource assignment of a full enumeration.
+
+  The snapshot is written to the variable store only when it differs from
+  the saved one. The root bridge info HOB must have been built.
+
+  @param[in]  EnumPolicy        PciEnum Policy with root bridge mask to be scanned
+  @param[in]  ResAllocTable     PCI resource allocation table
+  @param[in]  RootBridges       A pointer which has Root Bridges in ChildList
+
+  @retval EFI_SUCCESS           The snapshot is saved.
+  @retval EFI_NOT_FOUND         The root bridge info HOB is not found.
+  @retval EFI_BUFFER_TOO_SMALL  The topology is too big for a snapshot.
+  @retval others                The snapshot could not be written.
+
+**/
+EFI_STATUS
+EFIAPI
+PciSaveSnapshot (
+  IN CONST  PCI_ENUM_POLICY_INFO  *EnumPolicy,
+  IN CONST  PCI_RES_ALLOC_TABLE   *ResAllocTable,
+  IN CONST  PCI_IO_DEVICE         *RootBridges
+  );
+
+#endif // __PCI_SNAPSHOT_H__
@@ -24,7 +24,8 @@ CONST DEBUG_LOG_BUFFER_HEADER mLogBufHdrTmpl = {
   0,
   {0, 0},
   sizeof (DEBUG_LOG_BUFFER_HEADER),
-  FixedPcdGet32 (PcdEarlyLogBufferSize)
+  FixedPcdGet32 (PcdEarlyLogBufferSize),
+  sizeof (DEBUG_LOG_BUFFER_HEADER)
 };
 
 //
@@ -68,6 +68,7 @@ PrepareStage2 (
   EFI_STATUS                Status;
   UINT32                    Delta;
   STAGE_HDR                *StageHdr;
+  UINT16                    Span;
 
 
   if (FixedPcdGetBool (PcdStage2LoadHigh)) {
@@ -77,8 +78,11 @@ PrepareStage2 (
   }
 
   AddMeasurePoint (0x2080);
+  DstLen = 0;
+  Span   = BeginSpan (0x2080, FLASH_MAP_SIG_STAGE2, 0);
   Status = LoadComponentWithCallback (COMP_TYPE_STAGE_2, FLASH_MAP_SIG_STAGE2,
                                      &DstAdr, &DstLen, LoadComponentCallback);
+  EndSpan (Span, DstLen);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Loading Stage2 error - %r !", Status));
     return 0;
@@ -356,6 +360,7 @@ SecStartup2 (
   VOID                    **FieldPtr;
   UINT32                    Tolum;
   UINT64                    Touum;
+  UINT16                    Span;
 
   LdrGlobal = (LOADER_GLOBAL_DATA *)GetLoaderGlobalDataPointer ();
   ASSERT (LdrGlobal != NULL);
@@ -388,6 +393,8 @@ SecStartup2 (
   DEBUG ((DEBUG_INFO,  "Append public key hash into store: %r\n", Status));
 
   CreateConfigDatabase (LdrGlobal, &Stage1bParam);
+  Status = BuildConfigDataIndex ();
+  DEBUG ((DEBUG_INFO, "Build CFG Data index: %r\n", Status));
 
   // Overwrite platform ID if CFGDATA contains it
   PidCfgData = (PLATFORMID_CFG_DATA *)FindConfigDataByTag (CDATA_PLATFORMID_TAG);
@@ -413,7 +420,9 @@ SecStartup2 (
   HobList = NULL;
   DEBUG ((DEBUG_INIT, "Memory Init\n"));
   AddMeasurePoint (0x2020);
+  Span   = BeginSpan (0x2030, SIGNATURE_32 ('F', 'S', 'P', 'M'), 0);
   Status = CallFspMemoryInit (PCD_GET32_WITH_ADJUST (PcdFSPMBase), &HobList);
+  EndSpan (Span, 0);
   AddMeasurePoint (0x2030);
   FspResetHandler (Status);
   ASSERT_EFI_ERROR (Status);
@@ -449,6 +458,7 @@ SecStartup2 (
   LdrGlobal->MemPoolCurrTop    = MemPoolCurrTop;
   LdrGlobal->MemPoolCurrBottom = MemPoolStart;
   LdrGlobal->MemPoolMaxUsed    = 0;
+  LdrGlobal->AllocTracePtr     = NULL;
 
   if (FeaturePcdGet (PcdDmaProtectionEnabled)) {
     DmaBuffer = MemPoolStart - (PcdGet32 (PcdLoaderAcpiNvsSize) + PcdGet32 (PcdLoaderAcpiReclaimSize)
@@ -494,6 +504,14 @@ SecStartup2 (
   // Update total memory size
   SetMemoryInfo (EnumMemInfoTom,    Tolum + (Touum - SIZE_4GB));
 
+  // Trace the memory pool allocations from now on if enabled
+  if (FixedPcdGet32 (PcdAllocTraceEntries) > 0) {
+    AllocateLen = sizeof (ALLOC_TRACE_INFO) + FixedPcdGet32 (PcdAllocTraceEntries) * sizeof (ALLOC_TRACE_ENTRY);
+    BufPtr      = AllocatePool (AllocateLen);
+    AllocTraceInit ((ALLOC_TRACE_INFO *)BufPtr, FixedPcdGet32 (PcdAllocTraceEntries));
+    LdrGlobal->AllocTracePtr = BufPtr;
+  }
+
   // Restore S3_DATA in new LoaderGlobal
   LdrGlobal->S3DataPtr = AllocatePool (sizeof (S3_DATA));
   if (LdrGlobal->BootMode != BOOT_ON_S3_RESUME) {
@@ -545,6 +563,8 @@ SecStartup2 (
     if (PcdGet32 (PcdEarlyLogBufferSize) < PcdGet32 (PcdLogBufferSize)) {
       // If log buffer needs to be bigger post memory, increase it.
       OldLogBuf = (DEBUG_LOG_BUFFER_HEADER *)LdrGlobal->LogBufPtr;
+      // Only UsedLength is copied, so deferred serial output has to be sent first
+      DebugLogBufferFlush (TRUE);
       NewLogBuf = (DEBUG_LOG_BUFFER_HEADER *)AllocatePool (PcdGet32 (PcdLogBufferSize));
       if (NewLogBuf != NULL) {
         CopyMem ((VOID *)NewLogBuf, (VOID *)OldLogBuf, OldLogBuf->UsedLength);
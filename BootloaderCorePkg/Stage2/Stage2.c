@@ -7,6 +7,12 @@
 
 #include "Stage2.h"
 
+#define  PLD_COMP_PAYLOAD    0
+#define  PLD_COMP_CMDLINE    1
+#define  PLD_COMP_INITRD     2
+
+STATIC LOAD_COMPONENT_REQUEST  mPayloadComp[3];
+
 /**
   Callback function to add performance measure point during component loading.
 
@@ -49,6 +55,40 @@ LoadComponentCallback (
 
 }
 
+/**
+  Load a component from the extra payload container.
+
+  The copy loaded along with the payload is returned if available.
+
+  @param[in]     ComponentName   Component name.
+  @param[in,out] Buffer          Pointer to receive component base.
+  @param[in,out] Length          Pointer to receive component size.
+
+  @retval EFI_SUCCESS            The component was loaded.
+  @retval Others                 The component could not be loaded.
+
+**/
+STATIC
+EFI_STATUS
+LoadPayloadComponent (
+  IN     UINT32    ComponentName,
+  IN OUT VOID    **Buffer,
+  IN OUT UINT32   *Length
+  )
+{
+  UINT32        Index;
+
+  for (Index = PLD_COMP_CMDLINE; Index < ARRAY_SIZE (mPayloadComp); Index++) {
+    if (mPayloadComp[Index].ComponentName == ComponentName) {
+      *Buffer = mPayloadComp[Index].Buffer;
+      *Length = mPayloadComp[Index].Length;
+      return mPayloadComp[Index].Status;
+    }
+  }
+
+  return LoadComponent (FLASH_MAP_SIG_EPAYLOAD, ComponentName, Buffer, Length);
+}
+
 /**
   Prepare and load payload into proper location for execution.
 
@@ -72,6 +112,7 @@ PreparePayload (
   UINT32                         ComponentName;
   UINT8                          BootMode;
   UINT64                         SignatureBuf;
+  UINT16                         Span;
 
   BootMode = GetBootMode();
   //
@@ -108,8 +149,27 @@ PreparePayload (
   AddMeasurePoint (0x3100);
   DstLen = 0;
   DstAdr = (VOID *)(UINTN)Dst;
-  Status = LoadComponentWithCallback (ContainerSig, ComponentName,
-                                      &DstAdr, &DstLen, LoadComponentCallback);
+  Span   = BeginSpan (0x3100, ComponentName, 0);
+  if (FeaturePcdGet (PcdParallelLoadEnabled) && FeaturePcdGet (PcdLinuxPayloadEnabled) &&
+      (ContainerSig == FLASH_MAP_SIG_EPAYLOAD) && (ComponentName == LINX_PAYLOAD_ID_SIGNATURE)) {
+    // Load kernel command line and InitRd together with the kernel
+    mPayloadComp[PLD_COMP_PAYLOAD].ContainerSig  = ContainerSig;
+    mPayloadComp[PLD_COMP_PAYLOAD].ComponentName = ComponentName;
+    mPayloadComp[PLD_COMP_PAYLOAD].Buffer        = DstAdr;
+    mPayloadComp[PLD_COMP_PAYLOAD].Callback      = LoadComponentCallback;
+    mPayloadComp[PLD_COMP_CMDLINE].ContainerSig  = FLASH_MAP_SIG_EPAYLOAD;
+    mPayloadComp[PLD_COMP_CMDLINE].ComponentName = SIGNATURE_32 ('C', 'M', 'D', 'L');
+    mPayloadComp[PLD_COMP_INITRD].ContainerSig   = FLASH_MAP_SIG_EPAYLOAD;
+    mPayloadComp[PLD_COMP_INITRD].ComponentName  = SIGNATURE_32 ('I', 'N', 'R', 'D');
+    LoadComponents (mPayloadComp, ARRAY_SIZE (mPayloadComp));
+    Status = mPayloadComp[PLD_COMP_PAYLOAD].Status;
+    DstAdr = mPayloadComp[PLD_COMP_PAYLOAD].Buffer;
+    DstLen = mPayloadComp[PLD_COMP_PAYLOAD].Length;
+  } else {
+    Status = LoadComponentWithCallback (ContainerSig, ComponentName,
+                                        &DstAdr, &DstLen, LoadComponentCallback);
+  }
+  EndSpan (Span, DstLen);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Loading payload error - %r !", Status));
     return 0;
@@ -152,8 +212,10 @@ NormalBootPath (
   UINT16                          PldMachine;
   LOADED_PAYLOAD_INFO             PayloadInfo;
   UNIVERSAL_PAYLOAD_EXTRA_DATA   *PldImgInfo;
+  S3_DATA                        *S3Data;
 
   LdrGlobal = (LOADER_GLOBAL_DATA *)GetLoaderGlobalDataPointer();
+  S3Data    = (S3_DATA *)LdrGlobal->S3DataPtr;
 
   // Load payload
   Dst = (UINT32 *)(UINTN)PreparePayload (Stage2Param);
@@ -214,8 +276,7 @@ NormalBootPath (
         InitRdLen  = 0;
         CmdLine    = NULL;
         CmdLineLen = 0;
-        Status = LoadComponent (FLASH_MAP_SIG_EPAYLOAD, SIGNATURE_32 ('C', 'M', 'D', 'L'),
-                                (VOID **)&CmdLine, &CmdLineLen);
+        Status = LoadPayloadComponent (SIGNATURE_32 ('C', 'M', 'D', 'L'), (VOID **)&CmdLine, &CmdLineLen);
         if (!EFI_ERROR (Status)) {
           // Limit max command line length
           if (CmdLineLen > CMDLINE_LENGTH_MAX - 1) {
@@ -226,8 +287,7 @@ NormalBootPath (
         }
 
         // Try to load InitRd if it exists. If loading fails, continue booting
-        Status = LoadComponent (FLASH_MAP_SIG_EPAYLOAD, SIGNATURE_32 ('I', 'N', 'R', 'D'),
-                                (VOID **)&InitRd, &InitRdLen);
+        Status = LoadPayloadComponent (SIGNATURE_32 ('I', 'N', 'R', 'D'), (VOID **)&InitRd, &InitRdLen);
         if (!EFI_ERROR (Status)) {
           DEBUG ((DEBUG_INFO, "InitRD is loaded at 0x%x:0x%x\n", InitRd, InitRdLen));
         }
@@ -282,6 +342,11 @@ NormalBootPath (
 
   AddMeasurePoint (0x31F0);
 
+  // Add the spans ended after ACPI init to FPDT
+  if (S3Data->AcpiBase != 0) {
+    UpdateFpdtBootSpans (S3Data->AcpiBase);
+  }
+
   DEBUG ((DEBUG_INFO, "HOB @ 0x%08X\n", LdrGlobal->LdrHobList));
   PldHobList = BuildExtraInfoHob (Stage2Param);
 
@@ -301,6 +366,7 @@ NormalBootPath (
       }
     }
     DEBUG ((DEBUG_INIT, "Jump to payload\n\n"));
+    DebugLogBufferFlush (TRUE);
     if (PldMachine == IMAGE_FILE_MACHINE_X64) {
       // Need to call in x64 long mode
       Execute64BitCode ((UINT64)(UINTN)PldEntry, (UINT64)(UINTN)PldHobList,
@@ -356,6 +422,7 @@ S3ResumePath (
 
   // Find Wake Vector and Jump to OS
   AddMeasurePoint (0x31F0);
+  DebugLogBufferFlush (TRUE);
   FindAcpiWakeVectorAndJump (S3Data->AcpiBase);
 }
 
@@ -390,6 +457,9 @@ SecStartup (
   VOID                           *SmbiosEntry;
   BOOLEAN                         SplashPostPci;
   UINT8                           SmmRebaseMode;
+  UINT16                          Span;
+  UINT32                          Length;
+  HOB_INDEX_INFO                 *HobIndex;
 
   // Initialize HOB
   LdrGlobal = (LOADER_GLOBAL_DATA *)GetLoaderGlobalDataPointer();
@@ -405,6 +475,9 @@ SecStartup (
   // Deallocate temporary memory used by previous stage
   FreeTemporaryMemory (NULL);
 
+  // Per-CPU log rings so that APs can log safely
+  DebugLogRingInit (PcdGet32 (PcdCpuMaxLogicalProcessorNumber));
+
   if (IS_X64) {
     // Build full physical space 1:1 mapping page table
     CreateIdentityMappingPageTables (0);
@@ -430,6 +503,13 @@ SecStartup (
     (UINTN)PcdGet32 (PcdLoaderHobStackSize)
     );
 
+  // Reserve the GUID HOB index right after the PHIT HOB, it is filled at handoff
+  Length   = sizeof (HOB_INDEX_INFO) + sizeof (HOB_INDEX_ENTRY) * HOB_INDEX_MAX_ENTRIES;
+  HobIndex = BuildGuidHob (&gLoaderHobIndexGuid, Length);
+  if (HobIndex != NULL) {
+    ZeroMem (HobIndex, Length);
+  }
+
   InitializeDebugAgent (DEBUG_AGENT_INIT_DXE_LOAD, NULL, NULL);
 
   // Call FspSiliconInit
@@ -446,7 +526,9 @@ SecStartup (
 
   DEBUG ((DEBUG_INIT, "Silicon Init\n"));
   AddMeasurePoint (0x3020);
+  Span   = BeginSpan (0x3030, SIGNATURE_32 ('F', 'S', 'P', 'S'), 0);
   Status = CallFspSiliconInit ();
+  EndSpan (Span, 0);
   AddMeasurePoint (0x3030);
   FspResetHandler (Status);
   ASSERT_EFI_ERROR (Status);
@@ -494,6 +576,9 @@ SecStartup (
   // MP Init phase 2
   if (FixedPcdGetBool (PcdSmpEnabled) && !EFI_ERROR (Status)) {
     Status = MpInit (EnumMpInitRun);
+    if (FeaturePcdGet (PcdParallelLoadEnabled) && !EFI_ERROR (Status)) {
+      MpTaskInit (MpGetTask ());
+    }
     AddMeasurePoint (0x3080);
   }
   ASSERT_EFI_ERROR (Status);
@@ -505,7 +590,9 @@ SecStartup (
   if (FixedPcdGetBool (PcdPciEnumEnabled)) {
     MemPool = AllocateTemporaryMemory (0);
     DEBUG ((DEBUG_INIT, "PCI Enum\n"));
+    Span   = BeginSpan (0x30A0, SIGNATURE_32 ('P', 'C', 'I', 'E'), 0);
     Status = PciEnumeration (MemPool);
+    EndSpan (Span, 0);
     AddMeasurePoint (0x30A0);
     UpdateGraphicsHob ();
     BoardInit (PostPciEnumeration);
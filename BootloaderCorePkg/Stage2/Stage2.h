@@ -41,6 +41,7 @@
 #include <Library/ThunkLib.h>
 #include <Library/LocalApicLib.h>
 #include <Library/ContainerLib.h>
+#include <Library/MpTaskLib.h>
 #include <Guid/BootLoaderServiceGuid.h>
 #include <Guid/BootLoaderVersionGuid.h>
 #include <Guid/LoaderPlatformInfoGuid.h>
@@ -71,6 +72,7 @@
 #include <Guid/SpiFlashInfoGuid.h>
 #include <Guid/NvVariableInfoGuid.h>
 #include <Guid/SmmS3CommunicationInfoGuid.h>
+#include <Guid/HobIndexGuid.h>
 
 
 #define UIMAGE_FIT_MAGIC               (0x56190527)
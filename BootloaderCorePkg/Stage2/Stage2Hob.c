@@ -789,6 +789,60 @@ BuildSmmVariableHobs (
   }
 }
 
+/**
+  Fill the GUID HOB index reserved right after the PHIT HOB.
+
+  The payload HobLib looks up GUID HOBs from the index instead of walking
+  the HOB list. GUID HOBs beyond HOB_INDEX_MAX_ENTRIES are left out, and are
+  still found by walking the HOB list from the end of the indexed part.
+
+  @param HobList             The HOB list pointer.
+
+**/
+STATIC
+VOID
+BuildHobIndex (
+  IN  VOID                         *HobList
+  )
+{
+  EFI_PEI_HOB_POINTERS             Hob;
+  HOB_INDEX_INFO                   *HobIndex;
+  HOB_INDEX_ENTRY                  *Entry;
+  UINT32                           Index;
+
+  Hob.Raw = GET_NEXT_HOB (HobList);
+  if ((Hob.Header->HobType != EFI_HOB_TYPE_GUID_EXTENSION) || !CompareGuid (&Hob.Guid->Name, &gLoaderHobIndexGuid)) {
+    return;
+  }
+
+  HobIndex = (HOB_INDEX_INFO *)GET_GUID_HOB_DATA (Hob.Guid);
+  ZeroMem (HobIndex, sizeof (HOB_INDEX_INFO));
+  Hob.Raw  = (UINT8 *)HobList;
+  while (!END_OF_HOB_LIST (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      if (HobIndex->Count >= HOB_INDEX_MAX_ENTRIES) {
+        break;
+      }
+
+      // Insertion sort, a GUID HOB goes after the earlier ones with the same GUID
+      Entry = HobIndex->Entry;
+      for (Index = HobIndex->Count; Index > 0; Index--) {
+        if (CompareMem (&Entry[Index - 1].Name, &Hob.Guid->Name, sizeof (EFI_GUID)) <= 0) {
+          break;
+        }
+        CopyMem (&Entry[Index], &Entry[Index - 1], sizeof (HOB_INDEX_ENTRY));
+      }
+      CopyGuid (&Entry[Index].Name, &Hob.Guid->Name);
+      Entry[Index].Offset = (UINT32)(Hob.Raw - (UINT8 *)HobList);
+      HobIndex->Count++;
+    }
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  HobIndex->HobListSize = (UINT32)(Hob.Raw - (UINT8 *)HobList);
+  HobIndex->Revision    = 1;
+  HobIndex->Signature   = HOB_INDEX_INFO_SIGNATURE;
+}
 
 /**
   Build and update HOBs.
@@ -829,6 +883,11 @@ BuildExtraInfoHob (
   VOID                             *DeviceTableHob;
   LDR_SMM_INFO                     *SmmInfoHob;
   SYS_CPU_TASK_HOB                 *SysCpuTaskHob;
+  BOOT_SPAN_INFO                   *SpanInfo;
+  BOOT_SPAN_INFO                   *SpanInfoHob;
+  ALLOC_TRACE_INFO                 *AllocTrace;
+  ALLOC_TRACE_INFO                 *AllocTraceHob;
+  UINT32                           LiveCount;
 
   LdrGlobal = (LOADER_GLOBAL_DATA *)GetLoaderGlobalDataPointer();
   S3Data    = (S3_DATA *)LdrGlobal->S3DataPtr;
@@ -935,6 +994,36 @@ BuildExtraInfoHob (
     CopyMem (PerformanceInfo->TimeStamp, LdrGlobal->PerfData.TimeStamp, sizeof (UINT64) * Count);
   }
 
+  // Build boot span Hob
+  SpanInfo = GetBootSpanInfo ();
+  if (SpanInfo != NULL) {
+    Length = sizeof (BOOT_SPAN_INFO) + sizeof (BOOT_SPAN_RECORD) * SpanInfo->Count;
+    SpanInfoHob = BuildGuidHob (&gLoaderBootSpanInfoGuid, Length);
+    if (SpanInfoHob != NULL) {
+      CopyMem (SpanInfoHob, SpanInfo, Length);
+      SpanInfoHob->TotalLength = Length;
+    }
+  }
+
+  // Build memory allocation trace Hob with the allocations still live at this point
+  AllocTrace = GetAllocTraceInfo ();
+  if (AllocTrace != NULL) {
+    // A GUID HOB is limited to 16-bit length, report the entries that do not fit as dropped
+    LiveCount = (UINT32)MIN (AllocTrace->LiveCount,
+                  (0xFFF8 - sizeof (EFI_HOB_GUID_TYPE) - sizeof (ALLOC_TRACE_INFO)) / sizeof (ALLOC_TRACE_ENTRY));
+    Length = sizeof (ALLOC_TRACE_INFO) + sizeof (ALLOC_TRACE_ENTRY) * LiveCount;
+    AllocTraceHob = BuildGuidHob (&gLoaderAllocTraceInfoGuid, Length);
+    if (AllocTraceHob != NULL) {
+      CopyMem (AllocTraceHob, AllocTrace, Length);
+      AllocTraceHob->EntryCount = LiveCount;
+      AllocTraceHob->LiveCount  = LiveCount;
+      for (Index = LiveCount; Index < AllocTrace->LiveCount; Index++) {
+        AllocTraceHob->Dropped++;
+        AllocTraceHob->LiveSize -= AllocTrace->Entry[Index].Size;
+      }
+    }
+  }
+
   // Build Loader Platform info Hob
   Length       = sizeof (LOADER_PLATFORM_INFO);
   LoaderPlatformInfo = BuildGuidHob (&gLoaderPlatformInfoGuid, Length);
@@ -965,5 +1054,7 @@ BuildExtraInfoHob (
   if ((PcdGet8(PcdBuildSmmHobs) & BIT1) != 0) {
     BuildSmmVariableHobs ();
   }
+
+  BuildHobIndex (LdrGlobal->LdrHobList);
   return LdrGlobal->LdrHobList;
 }
@@ -77,6 +77,9 @@ BoardNotifyPhase (
 /**
   Display graphical splash screen
 
+  Nothing allocated while drawing the splash screen is used once it is on the
+  frame buffer, so the memory pool is released back to its mark afterwards.
+
   @retval EFI_SUCCESS     Splash screen was successfully displayed
   @retval EFI_NOT_FOUND   Frame buffer hob not found
   @retval EFI_UNSUPPORTED BmpImage is not a valid *.BMP image
@@ -91,6 +94,7 @@ DisplaySplash (
   EFI_STATUS                           Status;
   VOID                                *SplashLogoBmp;
   EFI_PEI_GRAPHICS_INFO_HOB           *GfxInfoHob;
+  VOID                                *PoolMark;
 
   // Get framebuffer info
   GfxInfoHob = (EFI_PEI_GRAPHICS_INFO_HOB *)GetGuidHobData (NULL, NULL, &gEfiGraphicsInfoHobGuid);
@@ -101,7 +105,9 @@ DisplaySplash (
   // Convert image from BMP format and write to frame buffer
   SplashLogoBmp = (VOID *)(UINTN)PCD_GET32_WITH_ADJUST (PcdSplashLogoAddress);
   ASSERT (SplashLogoBmp != NULL);
-  Status = DisplayBmpToFrameBuffer (SplashLogoBmp, NULL, 0, GfxInfoHob);
+  PoolMark = GetMemoryPoolMark ();
+  Status   = DisplayBmpToFrameBuffer (SplashLogoBmp, NULL, 0, GfxInfoHob);
+  ReleaseMemoryPool (PoolMark);
 
   return Status;
 }
@@ -136,12 +142,13 @@ PrintStackHeapInfo (
 
   DEBUG ((
            DEBUG_INFO,
-           "Stage2 heap: 0x%X (0x%X used, 0x%X free, 0x%x max used)\n",
+           "Stage2 heap: 0x%X (0x%X used, 0x%X free, 0x%x max used, 0x%X reusable)\n",
            LdrGlobal->MemPoolEnd - LdrGlobal->MemPoolStart,
            (LdrGlobal->MemPoolEnd - LdrGlobal->MemPoolCurrTop) +
-           (LdrGlobal->MemPoolCurrBottom - LdrGlobal->MemPoolStart),
-           LdrGlobal->MemPoolCurrTop - LdrGlobal->MemPoolCurrBottom,
-           LdrGlobal->MemPoolMaxUsed
+           (LdrGlobal->MemPoolCurrBottom - LdrGlobal->MemPoolStart) - LdrGlobal->MemPoolFreeSize,
+           LdrGlobal->MemPoolCurrTop - LdrGlobal->MemPoolCurrBottom + LdrGlobal->MemPoolFreeSize,
+           LdrGlobal->MemPoolMaxUsed,
+           LdrGlobal->MemPoolFreeSize
            ));
 }
 
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+## @ AllocTraceTool.py
+# Decode the Slim Bootloader memory allocation trace.
+#
+# The trace is read from a serial log containing the output of the shell
+# 'alloc' command. The caller addresses of the live allocations are resolved
+# to the nearest preceding symbol in the map file of each stage, and the
+# allocations are reported per caller.
+#
+# Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import re
+import sys
+import bisect
+import argparse
+
+sys.dont_write_bytecode = True
+
+
+ANCHOR_SYMBOL = 'AllocatePool'
+
+
+class AllocTrace:
+    def __init__(self, name):
+        self.name    = name
+        self.summary = ''
+        self.anchors = {}
+        self.peaks   = {}
+        self.histo   = []
+        self.entries = []
+
+
+def parse_log(log_file):
+    # Parse the tables printed by the shell 'alloc' command, the last ones win
+    traces = {}
+    trace  = None
+    with open(log_file, 'r', errors='ignore') as fd:
+        lines = fd.read().splitlines()
+
+    for line in lines:
+        match = re.match(r'\[(\w+)\] (\d+ live allocations.*)$', line.strip())
+        if match:
+            trace = AllocTrace(match.group(1))
+            trace.summary = match.group(2)
+            traces[trace.name] = trace
+            continue
+        if trace is None:
+            continue
+
+        match = re.match(r'\s*Stage (\w+)\s+peak 0x([0-9A-Fa-f]+)\s+anchor 0x([0-9A-Fa-f]+)', line)
+        if match:
+            trace.peaks[match.group(1)]   = int(match.group(2), 16)
+            trace.anchors[match.group(1)] = int(match.group(3), 16)
+            continue
+
+        match = re.match(r'\s*0x([0-9A-Fa-f]{8}) - 0x([0-9A-Fa-f]{8}) : (\d+)', line)
+        if match:
+            trace.histo.append((int(match.group(1), 16), int(match.group(2), 16), int(match.group(3))))
+            continue
+
+        match = re.match(r'\s*0x([0-9A-Fa-f]{8})\s+0x([0-9A-Fa-f]{8})\s+0x([0-9A-Fa-f]{8})\s+(Pool|Pages|Temp)\s+(\w+)', line)
+        if match:
+            trace.entries.append((int(match.group(1), 16), int(match.group(2), 16),
+                                  int(match.group(3), 16), match.group(4), match.group(5)))
+
+    return traces
+
+
+def parse_map(map_file):
+    # Collect the function symbols of a GCC or MSFT map file
+    symbols = {}
+    with open(map_file, 'r', errors='ignore') as fd:
+        lines = fd.read().splitlines()
+
+    if len(lines) and lines[0].strip().find('Archive member included') != -1:
+        #GCC
+        #                0x0000000000001d55                IoRead8
+        pattern = r'\s+0x([0-9a-fA-F]{8,16})\s+([_a-zA-Z][_a-zA-Z0-9]*)\s*$'
+        addr_idx, name_idx = 1, 2
+    else:
+        #MSFT
+        #0001:00000190       _IoRead8                     00007a50 f   BaseIoLibIntrinsic:IoLibMsc.obj
+        pattern = r'^\s[0-9a-fA-F]{4}:[0-9a-fA-F]{8}\s+(\w+)\s+([0-9a-fA-F]{8,16})\s+f\s'
+        addr_idx, name_idx = 2, 1
+
+    for line in lines:
+        match = re.match(pattern, line)
+        if match:
+            name = match.group(name_idx)
+            if name.startswith('_') and name[1:] == ANCHOR_SYMBOL:
+                name = name[1:]
+            symbols[int(match.group(addr_idx), 16)] = name
+
+    addrs = sorted(symbols.keys())
+    return addrs, [symbols[addr] for addr in addrs]
+
+
+def resolve(symbols, delta, caller):
+    # Find the nearest symbol before the caller address
+    addrs, names = symbols
+    idx = bisect.bisect_right(addrs, caller - delta) - 1
+    if idx < 0:
+        return '0x%08X' % caller
+    return names[idx]
+
+
+def report(trace, maps, top):
+    print('[%s] %s' % (trace.name, trace.summary))
+    for stage in trace.peaks:
+        print('  Stage %-8s peak 0x%08X' % (stage, trace.peaks[stage]))
+    if trace.histo:
+        print('  Size histogram:')
+        for low, high, count in trace.histo:
+            print('    0x%08X - 0x%08X : %d' % (low, high, count))
+
+    # Relocation delta of each stage from the anchor address
+    deltas = {}
+    for stage, symbols in maps.items():
+        if stage not in trace.anchors:
+            continue
+        addrs, names = symbols
+        if ANCHOR_SYMBOL not in names:
+            print('  %s is not found in the map file of stage %s' % (ANCHOR_SYMBOL, stage))
+            continue
+        deltas[stage] = trace.anchors[stage] - addrs[names.index(ANCHOR_SYMBOL)]
+
+    callers = {}
+    for caller, base, size, alloc_type, stage in trace.entries:
+        if stage in deltas:
+            name = resolve(maps[stage], deltas[stage], caller)
+        else:
+            name = '0x%08X' % caller
+        key = (stage, name, alloc_type)
+        count, total = callers.get(key, (0, 0))
+        callers[key] = (count + 1, total + size)
+
+    if not callers:
+        return
+
+    print('  %-8s %-40s %-6s %8s %12s' % ('Stage', 'Caller', 'Type', 'Count', 'Size'))
+    items = sorted(callers.items(), key=lambda x: x[1][1], reverse=True)
+    for (stage, name, alloc_type), (count, total) in items[:top] if top else items:
+        print('  %-8s %-40s %-6s %8d   0x%08X' % (stage, name, alloc_type, count, total))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-i', dest='input', type=str, required=True, help='Serial log containing the shell alloc command output')
+    parser.add_argument('-m', dest='maps', type=str, action='append', default=[],
+                        help='Map file of a stage as STAGE=FILE, STAGE is 1B, 2 or PAYLOAD. Can be repeated')
+    parser.add_argument('-t', dest='top', type=int, default=0, help='Only report the top callers by size')
+    args = parser.parse_args()
+
+    maps = {}
+    for item in args.maps:
+        if '=' not in item:
+            parser.error("map file should be given as STAGE=FILE")
+        stage, map_file = item.split('=', 1)
+        maps[stage] = parse_map(map_file)
+
+    traces = parse_log(args.input)
+    if not traces:
+        print('No memory allocation trace is found in %s' % args.input)
+        return 1
+
+    for trace in traces.values():
+        report(trace, maps, args.top)
+        print('')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -85,6 +85,8 @@ IPP_CRYPTO_OPTIMIZATION_MASK = {
     "SHA256_NI"       : 0x0002,
     "SHA384_W7"       : 0x0004,
     "SHA384_G9"       : 0x0008,
+    "SM3_AVX"         : 0x0010,
+    "SHA384_MB4"      : 0x0020,
     }
 
 IPP_CRYPTO_ALG_MASK = {
@@ -432,10 +434,11 @@ def get_redundant_info (comp_name):
     return comp_name, part_name
 
 
-def get_payload_list (payloads):
+def get_payload_list (payloads, default_algo = 'Lz4'):
     pld_tmp  = dict()
     pld_lst  = []
     pld_num  = len(payloads)
+    alg_lst  = ['Lz4', 'Lzma', 'Lzmb', 'Tiano', 'Dummy']
 
     for idx, pld in enumerate(payloads):
         items    = pld.split(':')
@@ -448,9 +451,12 @@ def get_payload_list (payloads):
             pld_tmp['name'] = 'PLD%d' % idx if pld_num > 1 else ''
 
         if item_cnt > 2 and items[2].strip():
-            pld_tmp['algo'] = items[2]
+            algo = items[2].strip()
         else:
-            pld_tmp['algo'] = 'Lz4'
+            algo = default_algo
+        pld_tmp['algo'] = algo[0].upper() + algo[1:].lower()
+        if pld_tmp['algo'] not in alg_lst:
+            raise Exception ("Unsupported payload compression '%s', use one of %s !" % (algo, ', '.join(alg_lst)))
 
         pld_lst.append(dict(pld_tmp))
 
@@ -111,8 +111,12 @@ class LZ_HEADER(Structure):
         b'LZDM' : 'Dummy',
         b'LZ4 ' : 'Lz4',
         b'LZMA' : 'Lzma',
+        b'LZMB' : 'Lzmb',
     }
 
+# Decompressed size of each block in a chunked LZMA (LZMB) stream
+LZMB_BLOCK_SIZE = 0x100000
+
 def print_bytes (data, indent=0, offset=0, show_ascii = False):
     bytes_per_line = 16
     printable = ' ' + string.ascii_letters + string.digits + string.punctuation
@@ -324,6 +328,58 @@ def gen_pub_key (in_key, pub_key = None):
 
     return key
 
+def lzmb_compress (in_file, out_file, tool_dir = ''):
+    # Compress fixed size blocks into independent LZMA streams so that they
+    # can be decompressed in parallel. The block index is placed in front:
+    #   UINT32 BlockSize, UINT32 BlockCount, UINT32 BlockOffset[BlockCount + 1]
+    in_data  = get_file_data(in_file)
+    blocks   = [in_data[i:i + LZMB_BLOCK_SIZE] for i in range(0, len(in_data), LZMB_BLOCK_SIZE)]
+    temp_in  = os.path.splitext(out_file)[0] + '.blk'
+    temp_out = os.path.splitext(out_file)[0] + '.blz'
+    streams  = []
+    for block in blocks:
+        gen_file_from_object (temp_in, block)
+        cmdline = [
+            os.path.join (tool_dir, "LzmaCompress"),
+            "-e",
+            "-o", temp_out,
+            temp_in]
+        run_process (cmdline, False, True)
+        streams.append (get_file_data(temp_out))
+    os.remove(temp_in)
+    os.remove(temp_out)
+
+    offset = 8 + (len(streams) + 1) * 4
+    index  = [LZMB_BLOCK_SIZE, len(streams)]
+    for stream in streams:
+        index.append (offset)
+        offset += len(stream)
+    index.append (offset)
+
+    data = bytearray (struct.pack('<%dI' % len(index), *index))
+    for stream in streams:
+        data.extend (stream)
+    return data
+
+def lzmb_decompress (in_data, out_file, tool_dir = ''):
+    block_size, block_count = struct.unpack_from('<II', in_data, 0)
+    offsets  = struct.unpack_from('<%dI' % (block_count + 1), in_data, 8)
+    temp_in  = os.path.splitext(out_file)[0] + '.blz'
+    temp_out = os.path.splitext(out_file)[0] + '.blk'
+    data     = bytearray ()
+    for idx in range(block_count):
+        gen_file_from_object (temp_in, in_data[offsets[idx]:offsets[idx + 1]])
+        cmdline = [
+            os.path.join (tool_dir, "LzmaCompress"),
+            "-d",
+            "-o", temp_out,
+            temp_in]
+        run_process (cmdline, False, True)
+        data.extend (get_file_data(temp_out))
+    os.remove(temp_in)
+    os.remove(temp_out)
+    gen_file_from_object (out_file, data)
+
 def decompress (in_file, out_file, tool_dir = ''):
     if not os.path.isfile(in_file):
         raise Exception ("Invalid input file '%s' !" % in_file)
@@ -341,6 +397,10 @@ def decompress (in_file, out_file, tool_dir = ''):
         fo.close()
         return
 
+    if lz_hdr.signature == b"LZMB":
+        lzmb_decompress (di[offset:offset + lz_hdr.compressed_len], out_file, tool_dir)
+        return
+
     temp   = os.path.splitext(out_file)[0] + '.tmp'
     if lz_hdr.signature == b"LZMA":
         alg = "Lzma"
@@ -398,6 +458,8 @@ def compress (in_file, alg, svn=0, out_path = '', tool_dir = ''):
 
     if alg == "Lzma":
         sig = "LZMA"
+    elif alg == "Lzmb":
+        sig = "LZMB"
     elif alg == "Tiano":
         sig = "LZUF"
     elif alg == "Lz4":
@@ -440,6 +502,8 @@ def compress (in_file, alg, svn=0, out_path = '', tool_dir = ''):
                 in_file]
             run_process (cmdline, False, True)
             compress_data = get_file_data(out_file)
+        elif sig == "LZMB":
+            compress_data = lzmb_compress (in_file, out_file, tool_dir)
     else:
         compress_data = bytearray()
 
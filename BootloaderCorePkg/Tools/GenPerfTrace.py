@@ -0,0 +1,504 @@
+#!/usr/bin/env python3
+## @ GenPerfTrace.py
+# Convert Slim Bootloader boot performance data into a Chrome trace and
+# compare the boot performance of two boots.
+#
+# The performance data can be read from a serial log containing the tables
+# printed by PrintMeasurePoint () or the shell 'perf' command, or from a
+# memory dump containing the loader HOB list.
+#
+# Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import re
+import sys
+import json
+import uuid
+import argparse
+from   ctypes import *
+
+sys.dont_write_bytecode = True
+
+
+# Descriptions of DefPerfIdToStr (), LinuxPerfIdToStr () and FspPerfIdToStr ()
+perf_id_str = {
+    0x1000 : 'Reset vector',
+    0x1010 : 'Stage1A entry point',
+    0x1040 : 'Board PostTempRamInit hook',
+    0x1060 : 'Stage1A continuation',
+    0x1080 : 'Load Stage1B',
+    0x10A0 : 'Verify Stage1B',
+    0x10B0 : 'Decompress Stage1B',
+    0x2000 : 'Stage1B entry point',
+    0x2020 : 'Board PreMemoryInit hook',
+    0x2030 : 'FSP MemoryInit',
+    0x2040 : 'Board PostMemoryInit hook',
+    0x2050 : 'Board PreTempRamExit hook',
+    0x2060 : 'FSP TempRamExit',
+    0x2070 : 'Board PostTempRamExit hook',
+    0x2080 : 'Load Stage2',
+    0x2090 : 'Copy Stage2 to memory',
+    0x20A0 : 'Verify Stage2',
+    0x20B0 : 'Decompress Stage2',
+    0x20C0 : 'Extend Stage2 hash',
+    0x20D0 : 'Rebase Stage2',
+    0x3000 : 'Stage2 entry point',
+    0x3010 : 'Board PreSiliconInit hook',
+    0x3020 : 'Save NVS data',
+    0x3030 : 'FSP SiliconInit',
+    0x3040 : 'Board PostSiliconInit hook',
+    0x3050 : 'Display splash',
+    0x3060 : 'MP wake up',
+    0x3080 : 'MP init run',
+    0x3090 : 'Board PrePciEnumeration hook',
+    0x30A0 : 'PCI enumeration',
+    0x30B0 : 'Board PostPciEnumeration hook',
+    0x30C0 : 'FSP PostPciEnumeration notify',
+    0x30D0 : 'ACPI init',
+    0x30E0 : 'Board PrePayloadLoading hook',
+    0x3100 : 'Load payload',
+    0x3110 : 'Locate payload',
+    0x3120 : 'Copy payload to memory',
+    0x3130 : 'Verify payload',
+    0x3140 : 'Decompress payload',
+    0x3150 : 'Extend payload hash',
+    0x31A0 : 'Board PostPayloadLoading hook',
+    0x31B0 : 'Decode payload format',
+    0x31C0 : 'MP init done',
+    0x31D0 : 'FSP ReadyToBoot notify',
+    0x31E0 : 'FSP EndOfFirmware notify',
+    0x31F0 : 'End of stage2',
+    0x4000 : 'Payload entry point',
+    0x4010 : 'OS loader main entry',
+    0x4020 : 'Shell exit',
+    0x4040 : 'Load image entry',
+    0x4050 : 'Boot device init',
+    0x4055 : 'Boot device tuning',
+    0x4060 : 'Parse partition info',
+    0x4070 : 'Load boot images',
+    0x4080 : 'Verify IAS image',
+    0x40A0 : 'Process IAS type',
+    0x40B0 : 'Process ELF/MultiBoot',
+    0x40E0 : 'Kernel setup',
+    0x40F0 : 'FSP ReadyToBoot/EndOfFirmware notify',
+    0x4100 : 'TPM IndicateReadyToBoot',
+}
+
+fsp_id_str = {
+    0xF000 : 'TempRamInit entry',
+    0xF07F : 'TempRamInit exit',
+    0xD000 : 'MemoryInit entry',
+    0xD07F : 'MemoryInit exit',
+    0xB000 : 'TempRamExit entry',
+    0xB07F : 'TempRamExit exit',
+    0x9000 : 'SiliconInit entry',
+    0x907F : 'SiliconInit exit',
+}
+
+stage_name = {
+    0x1 : 'Stage1A',
+    0x2 : 'Stage1B',
+    0x3 : 'Stage2',
+    0x4 : 'Payload',
+}
+
+TRACE_PID      = 1
+TRACE_TID_FSP  = 10
+TRACE_TID_SPAN = 20
+
+EFI_HOB_TYPE_GUID_EXTENSION = 0x0004
+BOOT_SPAN_OPEN              = 0x01
+
+gLoaderPerformanceInfoGuid                = uuid.UUID('868204be-23d0-4ff9-ac34-b995ac04b1b9')
+gLoaderBootSpanInfoGuid                   = uuid.UUID('e9001e7c-711d-4c59-8496-7468dc44500b')
+gEdkiiFpdtExtendedFirmwarePerformanceGuid = uuid.UUID('3b387bfd-7abc-4cf2-a0ca-b6a16c1b1b25')
+
+
+class EFI_HOB_GUID_TYPE(Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('HobType',   c_uint16),
+        ('HobLength', c_uint16),
+        ('Reserved',  c_uint32),
+        ('Name',      ARRAY(c_uint8, 16)),
+        ]
+
+
+class PERFORMANCE_INFO(Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('Revision',  c_uint8),
+        ('Reserved0', ARRAY(c_uint8, 3)),
+        ('Count',     c_uint16),
+        ('Flags',     c_uint16),
+        ('Frequency', c_uint32),
+        ]
+
+
+class BOOT_SPAN_INFO(Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('Signature',   c_uint32),
+        ('Revision',    c_uint8),
+        ('Flags',       c_uint8),
+        ('Current',     c_uint16),
+        ('FreqKhz',     c_uint32),
+        ('TotalLength', c_uint32),
+        ('Count',       c_uint32),
+        ('Reserved',    c_uint32),
+        ]
+
+
+class BOOT_SPAN_RECORD(Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('Signature', ARRAY(c_char, 4)),
+        ('Id',        c_uint16),
+        ('Parent',    c_uint16),
+        ('Depth',     c_uint8),
+        ('Flags',     c_uint8),
+        ('Reserved',  c_uint16),
+        ('DeviceId',  c_uint32),
+        ('StartTsc',  c_uint64),
+        ('EndTsc',    c_uint64),
+        ('Bytes',     c_uint64),
+        ]
+
+
+class FPDT_PEI_EXT_PERF_HEADER(Structure):
+    _pack_ = 1
+    _fields_ = [
+        ('SizeOfAllEntries', c_uint32),
+        ('LoadImageCount',   c_uint32),
+        ('HobIsFull',        c_uint32),
+        ]
+
+
+class FPDT_RECORD_HEADER(Structure):
+    # Common leading fields of all EDK2 extended FPDT records
+    _pack_ = 1
+    _fields_ = [
+        ('Type',       c_uint16),
+        ('Length',     c_uint8),
+        ('Revision',   c_uint8),
+        ('ProgressID', c_uint16),
+        ('ApicID',     c_uint32),
+        ('Timestamp',  c_uint64),
+        ('Guid',       ARRAY(c_uint8, 16)),
+        ]
+
+
+class BootPerfData:
+    def __init__(self, name):
+        self.name   = name
+        # (id, time in us)
+        self.points = []
+        # (id, time in us, token, guid)
+        self.fsp    = []
+        # dict with id, sig, dev, bytes, depth, start, end in us
+        self.spans  = []
+
+
+def get_id_str (id):
+    if id in perf_id_str:
+        return perf_id_str[id]
+    if id in fsp_id_str:
+        return fsp_id_str[id]
+    return '0x%04X' % id
+
+
+def find_guid_hobs (data, guid):
+    hobs = []
+    name = guid.bytes_le
+    pos  = data.find (name)
+    while pos >= 0:
+        if pos >= 8:
+            hob = EFI_HOB_GUID_TYPE.from_buffer_copy (data, pos - 8)
+            if hob.HobType == EFI_HOB_TYPE_GUID_EXTENSION and hob.HobLength >= sizeof(hob) and \
+               pos - 8 + hob.HobLength <= len(data):
+                hobs.append (data[pos + 16 : pos - 8 + hob.HobLength])
+        pos = data.find (name, pos + 1)
+    return hobs
+
+
+def tsc_to_us (tsc, freq_khz):
+    return tsc * 1000.0 / freq_khz
+
+
+def parse_dump (data, perf):
+    # Loader performance HOB
+    hobs = find_guid_hobs (data, gLoaderPerformanceInfoGuid)
+    if len(hobs) > 0:
+        hob  = hobs[-1]
+        info = PERFORMANCE_INFO.from_buffer_copy (hob)
+        offset = sizeof(info)
+        for idx in range(min(info.Count, (len(hob) - offset) // 8)):
+            val = c_uint64.from_buffer_copy (hob, offset + idx * 8).value
+            perf.points.append ((val >> 48, tsc_to_us (val & 0xFFFFFFFFFFFF, info.Frequency)))
+
+    # Boot span HOB
+    hobs = find_guid_hobs (data, gLoaderBootSpanInfoGuid)
+    if len(hobs) > 0:
+        hob  = hobs[-1]
+        info = BOOT_SPAN_INFO.from_buffer_copy (hob)
+        offset = sizeof(info)
+        for idx in range(min(info.Count, (len(hob) - offset) // sizeof(BOOT_SPAN_RECORD))):
+            span = BOOT_SPAN_RECORD.from_buffer_copy (hob, offset + idx * sizeof(BOOT_SPAN_RECORD))
+            if span.Flags & BOOT_SPAN_OPEN:
+                continue
+            perf.spans.append ({
+                'id'    : span.Id,
+                'sig'   : span.Signature.decode('ascii', 'replace'),
+                'dev'   : span.DeviceId,
+                'bytes' : span.Bytes,
+                'depth' : span.Depth,
+                'start' : tsc_to_us (span.StartTsc, info.FreqKhz),
+                'end'   : tsc_to_us (span.EndTsc, info.FreqKhz),
+                })
+
+    # FSP performance HOBs, FSP might create more than one
+    for hob in find_guid_hobs (data, gEdkiiFpdtExtendedFirmwarePerformanceGuid):
+        hdr    = FPDT_PEI_EXT_PERF_HEADER.from_buffer_copy (hob)
+        offset = sizeof(hdr)
+        end    = min(offset + hdr.SizeOfAllEntries, len(hob))
+        while offset + sizeof(FPDT_RECORD_HEADER) <= end:
+            rec = FPDT_RECORD_HEADER.from_buffer_copy (hob, offset)
+            if rec.Length == 0:
+                break
+            guid = str(uuid.UUID(bytes_le = bytes(rec.Guid)))
+            perf.fsp.append ((rec.ProgressID, rec.Timestamp / 1000.0, fsp_id_str.get(rec.ProgressID, ''), guid))
+            offset += rec.Length
+
+
+def parse_log (text, perf):
+    point_re = re.compile(r'\b([0-9A-Fa-f]{4})\s+\|\s+(\d+) ms\s+\|\s+(-?\d+) ms\s*(\|\s*(.*))?$')
+    fsp_re   = re.compile(r'\b([0-9A-Fa-f]{1,4})\s+\|\s+(\d+) ms\s+\|\s*(.*?)\s*\|\s*([0-9A-Fa-f]{8}-[0-9A-Fa-f-]{27})\s*$')
+    span_re  = re.compile(r'\b([0-9A-Fa-f]{4})\s+\|\s+(\d+) ms\s+\|\s+(\d+) us\s+\|\s(.{4})\s\|\s+([0-9A-Fa-f]{8})\s+\|\s+(\d+)\s+\| ( *)(.*)$')
+
+    #
+    # Each print of a table starts with its header. The payload prints the
+    # bootloader table again with its own points, so only the last table of
+    # each kind is kept.
+    #
+    points = []
+    fsp    = []
+    spans  = []
+    for line in text.splitlines():
+        if re.search(r'Id\s+\|\s+Time \(ms\)\s+\|\s+Delta \(ms\)', line):
+            points = []
+            continue
+        if re.search(r'Id\s+\|\s+Time \(ms\)\s+\|\s+Token', line):
+            fsp = []
+            continue
+        if re.search(r'Id\s+\|\s+Start \(ms\)\s+\|\s+Time \(us\)', line):
+            spans = []
+            continue
+
+        match = span_re.search (line)
+        if match:
+            start = int(match.group(2)) * 1000.0
+            spans.append ({
+                'id'    : int(match.group(1), 16),
+                'sig'   : match.group(4),
+                'dev'   : int(match.group(5), 16),
+                'bytes' : int(match.group(6)),
+                'depth' : len(match.group(7)) // 2,
+                'start' : start,
+                'end'   : start + int(match.group(3)),
+                })
+            continue
+
+        match = point_re.search (line)
+        if match:
+            points.append ((int(match.group(1), 16), int(match.group(2)) * 1000.0))
+            continue
+
+        match = fsp_re.search (line)
+        if match:
+            fsp.append ((int(match.group(1), 16), int(match.group(2)) * 1000.0, match.group(3), match.group(4).lower()))
+
+    perf.points.extend (points)
+    perf.fsp.extend (fsp)
+    perf.spans.extend (spans)
+
+
+def load_perf_data (path):
+    perf = BootPerfData (os.path.basename(path))
+    fd   = open (path, 'rb')
+    data = fd.read()
+    fd.close ()
+
+    if data.find (gLoaderPerformanceInfoGuid.bytes_le) >= 0:
+        parse_dump (data, perf)
+    else:
+        parse_log (data.decode('ascii', 'replace'), perf)
+
+    if len(perf.points) + len(perf.fsp) + len(perf.spans) == 0:
+        raise Exception ("No boot performance data is found in '%s' !" % path)
+
+    return perf
+
+
+def get_phases (perf):
+    #
+    # A measure point marks the end of the step described by its Id, so the
+    # step starts at the previous point. The n-th occurrence of an Id is
+    # keyed separately since some points are added more than once.
+    #
+    phases = []
+    count  = {}
+    prev   = None
+    for id, time in perf.points:
+        if prev is not None:
+            idx = count.get(id, 0)
+            count[id] = idx + 1
+            phases.append (((id, idx), prev, time))
+        prev = time
+    return phases
+
+
+def create_trace (args):
+    perf   = load_perf_data (args.input)
+    events = []
+
+    events.append ({'name' : 'process_name', 'ph' : 'M', 'pid' : TRACE_PID, 'args' : {'name' : 'Slim Bootloader'}})
+    for tid, name in list(stage_name.items()) + [(TRACE_TID_FSP, 'FSP'), (TRACE_TID_SPAN, 'Spans')]:
+        events.append ({'name' : 'thread_name', 'ph' : 'M', 'pid' : TRACE_PID, 'tid' : tid, 'args' : {'name' : name}})
+
+    if len(perf.points) > 0:
+        id, time = perf.points[0]
+        events.append ({'name' : get_id_str (id), 'cat' : 'point', 'ph' : 'i', 's' : 't',
+                        'ts' : time, 'pid' : TRACE_PID, 'tid' : id >> 12})
+    for (id, idx), start, end in get_phases (perf):
+        events.append ({'name' : get_id_str (id), 'cat' : 'phase', 'ph' : 'X',
+                        'ts' : start, 'dur' : end - start, 'pid' : TRACE_PID, 'tid' : id >> 12,
+                        'args' : {'id' : '0x%04X' % id}})
+
+    # FSP records come in entry and exit pairs, xx00 and xx7F
+    entry = {}
+    for id, time, token, guid in perf.fsp:
+        if (id & 0xFF) == 0x00:
+            entry[id] = time
+        elif (id & 0xFF) == 0x7F and (id & 0xFF00) in entry:
+            start = entry.pop(id & 0xFF00)
+            name  = fsp_id_str.get(id, token).replace(' exit', '')
+            events.append ({'name' : name, 'cat' : 'fsp', 'ph' : 'X', 'ts' : start, 'dur' : time - start,
+                            'pid' : TRACE_PID, 'tid' : TRACE_TID_FSP, 'args' : {'guid' : guid}})
+        else:
+            events.append ({'name' : token if token else '0x%04X' % id, 'cat' : 'fsp', 'ph' : 'i', 's' : 't',
+                            'ts' : time, 'pid' : TRACE_PID, 'tid' : TRACE_TID_FSP,
+                            'args' : {'id' : '0x%04X' % id, 'guid' : guid}})
+
+    for span in perf.spans:
+        dur  = span['end'] - span['start']
+        info = {'id' : '0x%04X' % span['id'], 'component' : span['sig'],
+                'device' : '0x%08X' % span['dev'], 'bytes' : span['bytes']}
+        if span['bytes'] > 0 and dur > 0:
+            info['MB/s'] = round(span['bytes'] / dur, 2)
+        events.append ({'name' : get_id_str (span['id']), 'cat' : 'span', 'ph' : 'X',
+                        'ts' : span['start'], 'dur' : dur, 'pid' : TRACE_PID, 'tid' : TRACE_TID_SPAN,
+                        'args' : info})
+
+    out_file = args.output if args.output else os.path.splitext(args.input)[0] + '.json'
+    fd = open (out_file, 'w')
+    json.dump ({'traceEvents' : events, 'displayTimeUnit' : 'ms'}, fd, indent = 1)
+    fd.close ()
+    print ("Chrome trace with %d events is generated at '%s'" % (len(events), out_file))
+
+
+def get_durations (perf):
+    durations = {}
+    for key, start, end in get_phases (perf):
+        durations[('phase',) + key] = end - start
+    for span in perf.spans:
+        key = ('span', span['id'], span['sig'], span['dev'])
+        durations[key] = durations.get(key, 0) + span['end'] - span['start']
+    if len(perf.points) > 0:
+        durations[('total',)] = perf.points[-1][1]
+    return durations
+
+
+def get_key_str (key):
+    if key[0] == 'total':
+        return 'Total boot time'
+    if key[0] == 'phase':
+        desc = get_id_str (key[1])
+        if key[2] > 0:
+            desc += ' (#%d)' % (key[2] + 1)
+        return '%04X  %s' % (key[1], desc)
+    return '%04X  %s [%s %08X]' % (key[1], get_id_str (key[1]), key[2], key[3])
+
+
+def diff_perf (args):
+    base = load_perf_data (args.base)
+    new  = load_perf_data (args.new)
+    base_dur = get_durations (base)
+    new_dur  = get_durations (new)
+
+    keys = [key for key in base_dur if key in new_dur]
+    keys.sort (key = lambda x: (x[0] != 'total', x))
+    regressions = 0
+    print ('Comparing %s (base) with %s (new)\n' % (base.name, new.name))
+    print (' Base (ms) |  New (ms) | Delta (ms) |  Delta  | Description')
+    print ('-----------+-----------+------------+---------+------------------------------------')
+    for key in keys:
+        old_ms = base_dur[key] / 1000.0
+        new_ms = new_dur[key] / 1000.0
+        delta  = new_ms - old_ms
+        pct    = (delta * 100.0 / old_ms) if old_ms > 0 else (100.0 if delta > 0 else 0.0)
+        flag   = ''
+        if delta >= args.min_ms and pct >= args.min_pct:
+            flag = '  << REGRESSION'
+            regressions += 1
+        elif not args.verbose and key[0] != 'total':
+            continue
+        print (' %9.3f | %9.3f | %+10.3f | %+6.1f%% | %s%s' % (old_ms, new_ms, delta, pct, get_key_str (key), flag))
+    print ('-----------+-----------+------------+---------+------------------------------------')
+
+    for name, missing in [('base', [key for key in new_dur if key not in base_dur]),
+                          ('new',  [key for key in base_dur if key not in new_dur])]:
+        for key in missing:
+            print ('Not in %s boot: %s' % (name, get_key_str (key)))
+
+    if regressions > 0:
+        print ('\n%d regression(s) found (threshold: %.1f ms and %.1f%%)' % (regressions, args.min_ms, args.min_pct))
+        return 1
+
+    print ('\nNo regression found')
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    sub_parser = parser.add_subparsers(help='command')
+
+    # Command for trace
+    cmd_trace = sub_parser.add_parser('trace', help='generate a Chrome trace event file')
+    cmd_trace.add_argument('-i', dest='input',  type=str, required=True, help='Serial log or memory dump file')
+    cmd_trace.add_argument('-o', dest='output', type=str, default='', help='Output JSON file, default is the input file with .json extension')
+    cmd_trace.set_defaults(func=create_trace)
+
+    # Command for diff
+    cmd_diff = sub_parser.add_parser('diff', help='compare the boot performance of two boots')
+    cmd_diff.add_argument('-b', dest='base', type=str, required=True, help='Serial log or memory dump file of the base boot')
+    cmd_diff.add_argument('-n', dest='new',  type=str, required=True, help='Serial log or memory dump file of the new boot')
+    cmd_diff.add_argument('-m', dest='min_ms',  type=float, default=2.0,  help='Minimum increase in ms to report a regression')
+    cmd_diff.add_argument('-p', dest='min_pct', type=float, default=10.0, help='Minimum increase in percent to report a regression')
+    cmd_diff.add_argument('-v', dest='verbose', action='store_true', help='Show all phases, not only regressions')
+    cmd_diff.set_defaults(func=diff_perf)
+
+    # Parse arguments and run sub-command
+    args = parser.parse_args()
+    try:
+        func = args.func
+    except AttributeError:
+        parser.error("too few arguments")
+
+    sys.exit(func(args))
+
+
+if __name__ == '__main__':
+    main()
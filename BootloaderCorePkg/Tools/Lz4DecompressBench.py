@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+## @ Lz4DecompressBench.py
+# Measure the decompression speed of the Slim Bootloader LZ4 decoder on the host.
+#
+# BootloaderCommonPkg Lz4DecompressLib is built into a host shared library
+# together with its NASM wide copy routines. The LZ4 streams found in the
+# given images (e.g. SlimBootloader.bin, Stage2.fd.lz or a container) are
+# then decompressed with the generic byte oriented copy, which is the path
+# used before the wide copy was added, and with the SSE2 and AVX2 wide copy
+# paths supported by the host CPU. Files without any LZ4 stream, such as a
+# raw payload, are compressed with Lz4 first.
+#
+# The host needs gcc and nasm, and an x86_64 CPU.
+#
+# Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import sys
+import shutil
+import platform
+import argparse
+import tempfile
+from   ctypes import *
+
+sys.dont_write_bytecode = True
+from   CommonUtility import *
+
+
+# Minimal base types needed to build Lz4DecompressLib.c on the host
+BENCH_BASE_H = r'''
+#ifndef __BENCH_BASE_H__
+#define __BENCH_BASE_H__
+typedef unsigned long long  UINT64;
+typedef unsigned long       UINTN;
+typedef unsigned int        UINT32;
+typedef int                 INT32;
+typedef unsigned short      UINT16;
+typedef unsigned char       UINT8;
+typedef char                CHAR8;
+typedef UINTN               RETURN_STATUS;
+#define VOID                void
+#define CONST               const
+#define IN
+#define OUT
+#define NULL                ((void *) 0)
+#define EFIAPI              __attribute__((ms_abi))
+#define RETURN_SUCCESS            0
+#define RETURN_INVALID_PARAMETER  (0x8000000000000000ULL | 2)
+#define ASSERT(Expression)        ((void) 0)
+#define CopyMem(d,s,l)            __builtin_memmove ((d), (s), (l))
+#endif
+'''
+
+# Timing loop and wide copy size selection for the decoder
+BENCH_RUN_C = r'''
+#include <stdint.h>
+#include <time.h>
+
+#define EFIAPI  __attribute__((ms_abi))
+
+uint64_t EFIAPI Lz4Decompress (const void *Source, uint64_t SourceSize, void *Destination, void *Scratch);
+
+static uint32_t mWideCopySize;
+
+uint32_t EFIAPI BenchGetWideCopySize (void)
+{
+  return mWideCopySize;
+}
+
+uint32_t BenchHostWideCopySize (void)
+{
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2")) {
+    return 32;
+  }
+  if (__builtin_cpu_supports ("sse2")) {
+    return 16;
+  }
+  return 0;
+}
+
+int BenchRun (const void *Source, uint64_t SourceSize, void *Destination, uint32_t WideSize, uint32_t Count, uint64_t *TimeNs)
+{
+  struct timespec  Start;
+  struct timespec  End;
+  uint32_t         Index;
+
+  mWideCopySize = WideSize;
+  clock_gettime (CLOCK_MONOTONIC, &Start);
+  for (Index = 0; Index < Count; Index++) {
+    if (Lz4Decompress (Source, SourceSize, Destination, 0) != 0) {
+      return -1;
+    }
+  }
+  clock_gettime (CLOCK_MONOTONIC, &End);
+  *TimeNs = (uint64_t)(End.tv_sec - Start.tv_sec) * 1000000000ULL + End.tv_nsec - Start.tv_nsec;
+  return 0;
+}
+'''
+
+LZ4_LIB_DIR = os.path.join('BootloaderCommonPkg', 'Library', 'Lz4DecompressLib')
+
+# Decoder copy paths, the wide copy size in bytes and the name to report
+COPY_PATHS = [
+    (0,  'Generic'),
+    (16, 'SSE2'),
+    (32, 'AVX2'),
+]
+
+
+def build_decoder (sbl_dir, out_dir, cflags):
+    lib_dir = os.path.join(sbl_dir, LZ4_LIB_DIR)
+    if not os.path.exists(os.path.join(lib_dir, 'Lz4DecompressLib.c')):
+        raise Exception ("Could not find Lz4DecompressLib in '%s' !" % sbl_dir)
+
+    inc_dir = os.path.join(out_dir, 'Include')
+    os.makedirs(os.path.join(inc_dir, 'Library'))
+    gen_file_from_object (os.path.join(inc_dir, 'BenchBase.h'), BENCH_BASE_H.encode())
+    for name in ['PiPei.h', 'Library/BaseLib.h', 'Library/DebugLib.h', 'Library/BaseMemoryLib.h']:
+        gen_file_from_object (os.path.join(inc_dir, name), b'#include <BenchBase.h>\n')
+    gen_file_from_object (os.path.join(out_dir, 'BenchRun.c'), BENCH_RUN_C.encode())
+    gen_file_from_object (os.path.join(out_dir, 'Prefix.inc'), b'%define ASM_PFX(Name) Name\n')
+
+    # The firmware reads CR4 to check the OS support, which faults in user mode,
+    # so the decoder gets the wide copy size from the benchmark instead.
+    obj_list = [os.path.join(out_dir, 'Lz4DecompressLib.o'), os.path.join(out_dir, 'BenchRun.o'),
+                os.path.join(out_dir, 'Lz4WideCopy.o')]
+    run_process (['gcc', '-c', '-fPIC'] + cflags + ['-I', inc_dir, '-DLz4GetWideCopySize=BenchGetWideCopySize',
+                  '-o', obj_list[0], os.path.join(lib_dir, 'Lz4DecompressLib.c')])
+    run_process (['gcc', '-c', '-fPIC'] + cflags + ['-o', obj_list[1], os.path.join(out_dir, 'BenchRun.c')])
+    run_process (['nasm', '-f', 'elf64', '-P', os.path.join(out_dir, 'Prefix.inc'),
+                  '-o', obj_list[2], os.path.join(lib_dir, 'X64', 'Lz4WideCopy.nasm')])
+    lib_file = os.path.join(out_dir, 'Lz4Bench.so')
+    run_process (['gcc', '-shared', '-o', lib_file] + obj_list)
+
+    lib = CDLL(lib_file)
+    lib.BenchHostWideCopySize.restype = c_uint32
+    lib.BenchRun.argtypes = [c_char_p, c_uint64, c_void_p, c_uint32, c_uint32, POINTER(c_uint64)]
+    lib.BenchRun.restype  = c_int
+    return lib
+
+
+def find_lz4_streams (bin_data):
+    # Look for the LZ_HEADER of every LZ4 stream in the image
+    streams = []
+    hdr_len = sizeof(LZ_HEADER)
+    offset  = bin_data.find(b'LZ4 ')
+    while offset >= 0:
+        if offset + hdr_len + 4 <= len(bin_data):
+            lz_hdr = LZ_HEADER.from_buffer_copy (bin_data[offset:offset + hdr_len])
+            start  = offset + hdr_len
+            end    = start + lz_hdr.compressed_len
+            if lz_hdr.length > 0 and lz_hdr.compressed_len > 4 and end <= len(bin_data) and \
+               bytes_to_value (bin_data[start:start + 4]) == lz_hdr.length:
+                streams.append ((offset, bytes(bin_data[start:end]), lz_hdr.length))
+                offset = bin_data.find(b'LZ4 ', end)
+                continue
+        offset = bin_data.find(b'LZ4 ', offset + 1)
+    return streams
+
+
+def get_lz4_streams (in_file, out_dir, tool_dir):
+    streams = find_lz4_streams (get_file_data(in_file))
+    if streams:
+        return [('%s@0x%X' % (os.path.basename(in_file), offset), data, length) for offset, data, length in streams]
+
+    # Not compressed, compress the whole file the same way as the build does
+    lz_file  = compress (in_file, 'Lz4', out_path = os.path.join(out_dir, os.path.basename(in_file) + '.lz'), tool_dir = tool_dir)
+    lz_data  = get_file_data(lz_file)
+    lz_hdr   = LZ_HEADER.from_buffer_copy (lz_data[:sizeof(LZ_HEADER)])
+    start    = sizeof(LZ_HEADER)
+    return [('%s (Lz4)' % os.path.basename(in_file), bytes(lz_data[start:start + lz_hdr.compressed_len]), lz_hdr.length)]
+
+
+def bench_stream (lib, data, length, copy_paths, count, rounds):
+    dest     = create_string_buffer(length)
+    results  = []
+    expected = None
+    for wide_size, name in copy_paths:
+        best = 0
+        memset (dest, 0, length)
+        for loop in range(rounds):
+            time_ns = c_uint64(0)
+            if lib.BenchRun (data, len(data), dest, wide_size, count, byref(time_ns)) != 0:
+                raise Exception ("%s decoder failed to decompress the stream !" % name)
+            if time_ns.value and (best == 0 or time_ns.value < best):
+                best = time_ns.value
+        # All copy paths must produce the same output
+        output = dest.raw
+        if expected is None:
+            expected = output
+        elif output != expected:
+            raise Exception ("%s decoder output does not match the generic decoder !" % name)
+        results.append (length * count * 1000.0 / best if best else 0.0)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-i', dest='input', type=str, nargs='+', required=True, help='Images or files to decompress')
+    parser.add_argument('-s', dest='sbl_dir', type=str, default=os.path.join(os.path.dirname(os.path.realpath(__file__)), '..', '..'),
+                        help='Slim Bootloader source directory')
+    parser.add_argument('-t', dest='tool_dir', type=str, default='', help='Directory containing the Lz4Compress tool')
+    parser.add_argument('-n', dest='count', type=int, default=20, help='Decompressions of each stream per round')
+    parser.add_argument('-r', dest='rounds', type=int, default=3, help='Rounds to run, the fastest one is reported')
+    parser.add_argument('-O', dest='opt', type=str, default='s', help='Optimization level to build the decoder with')
+    args = parser.parse_args()
+
+    if platform.machine().lower() not in ['x86_64', 'amd64'] or os.name == 'nt':
+        print('The benchmark needs an x86_64 Linux host')
+        return 1
+
+    out_dir = tempfile.mkdtemp (prefix = 'Lz4Bench')
+    try:
+        lib = build_decoder (os.path.abspath(args.sbl_dir), out_dir, ['-O' + args.opt, '-fno-strict-aliasing'])
+        host_wide  = lib.BenchHostWideCopySize ()
+        copy_paths = [(wide_size, name) for wide_size, name in COPY_PATHS if wide_size <= host_wide]
+
+        streams = []
+        for in_file in args.input:
+            streams.extend (get_lz4_streams (in_file, out_dir, args.tool_dir))
+
+        title = '  %-40s %10s %10s' % ('Stream', 'Packed', 'Unpacked')
+        for wide_size, name in copy_paths:
+            title += ' %12s' % (name + ' MB/s')
+        print(title)
+
+        totals = [0.0] * len(copy_paths)
+        total_len = 0
+        for name, data, length in streams:
+            results = bench_stream (lib, data, length, copy_paths, args.count, args.rounds)
+            line = '  %-40s %10d %10d' % (name[-40:], len(data), length)
+            for idx, speed in enumerate(results):
+                line += ' %12.1f' % speed
+                totals[idx] += length / speed if speed else 0
+            total_len += length
+            print(line)
+
+        # Overall speed weighted by the size of each stream
+        line = '  %-40s %10s %10d' % ('Total', '', total_len)
+        for idx in range(len(copy_paths)):
+            line += ' %12.1f' % (total_len / totals[idx] if totals[idx] else 0.0)
+        print(line)
+        for idx in range(1, len(copy_paths)):
+            if totals[idx]:
+                print('  %s speedup over generic: %.2fx' % (copy_paths[idx][1], totals[0] / totals[idx]))
+    finally:
+        shutil.rmtree (out_dir, ignore_errors = True)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
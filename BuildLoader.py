@@ -175,6 +175,8 @@ class BaseBoard(object):
         self.ENABLE_PAYLOD_MODULE  = 0
         self.ENABLE_FAST_BOOT      = 0
         self.ENABLE_LEGACY_EF_SEG  = 1
+        self.ENABLE_SPECULATIVE_DECOMPRESS = 0
+        self.ENABLE_PARALLEL_LOAD  = 0
         # 0: Disable  1: Enable  2: Auto (disable for UEFI payload, enable for others)
         self.ENABLE_SMM_REBASE     = 0
 
@@ -216,6 +218,10 @@ class BaseBoard(object):
         self.PAYLOAD_LOAD_BASE     = 0
         self.FWUPDATE_LOAD_BASE    = 0
 
+        # Default compression for extra payloads: Lz4, Lzma, Lzmb, Tiano or Dummy
+        # Lzmb components are decompressed in parallel when loaded together
+        self.EPAYLOAD_COMPRESS_ALGO = 'Lz4'
+
         # OS Loader FD/FV sizes
         self.OS_LOADER_FD_SIZE     = 0x0004F000
 
@@ -275,7 +281,7 @@ class Build(object):
         self._fsp_basename                 = 'FspDbg'  if board.FSPDEBUG_MODE else 'FspRel'
         self._key_dir                      = self._board._KEY_DIR
         self._img_list                     = board.GetImageLayout()
-        self._pld_list                     = get_payload_list (board._PAYLOAD_NAME.split(';'))
+        self._pld_list                     = get_payload_list (board._PAYLOAD_NAME.split(';'), board.EPAYLOAD_COMPRESS_ALGO)
         self._comp_list                    = []
         self._region_list                  = []
 
@@ -1435,7 +1441,7 @@ def main():
     buildp.add_argument('-fd', '--fspdebug', action='store_true', help='Use debug FSP binary')
     buildp.add_argument('-a',  '--arch', choices=['ia32', 'x64'], help='Specify the ARCH for build. Default is to build IA32 image.', default ='ia32')
     buildp.add_argument('-no', '--noopt', action='store_true', help='No compile/link optimization for debugging purpose. Not enabled in Release build.')
-    buildp.add_argument('-p',  '--payload' , dest='payload', type=str, help='Payload file name', default ='OsLoader.efi')
+    buildp.add_argument('-p',  '--payload' , dest='payload', type=str, help="Payload file name, extra payloads are added as ';file:name:algo' with algo Lz4, Lzma, Lzmb, Tiano or Dummy", default ='OsLoader.efi')
     buildp.add_argument('board', metavar='board', choices=board_names, help='Board Name (%s)' % ', '.join(board_names))
     buildp.add_argument('-k', '--keygen', action='store_true', help='Generate default keys for signing')
     buildp.add_argument('-t', '--toolchain', dest='toolchain', type=str, default='', help='Perferred toolchain name')
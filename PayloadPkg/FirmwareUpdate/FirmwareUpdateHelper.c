@@ -22,6 +22,16 @@
 #include "FirmwareUpdateHelper.h"
 #include <Service/SpiFlashService.h>
 
+#define FWU_BLOCK_CLEAN       0
+#define FWU_BLOCK_PROGRAM     1
+#define FWU_BLOCK_ERASE       2
+
+//
+// Unchanged bytes between two changed ones are written again when the gap
+// is shorter than this, to save SPI write cycles
+//
+#define FWU_WRITE_MERGE_GAP   0x100
+
 SPI_FLASH_SERVICE   *mFwuSpiService = NULL;
 
 /**
@@ -256,11 +266,121 @@ GetVersionfromFv (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the flash linear address of the BIOS region.
+
+  It is used to align erase operations to the flash erase blocks.
+
+  @retval  The BIOS region base address, 0 if it is not available.
+**/
+STATIC
+UINT32
+GetBiosRegionBase (
+  VOID
+  )
+{
+  EFI_STATUS    Status;
+  UINT32        RegionBase;
+
+  Status = BootMediaGetRegion (FlashRegionBios, &RegionBase, NULL);
+  if (EFI_ERROR (Status)) {
+    RegionBase = 0;
+  }
+
+  return RegionBase;
+}
+
+/**
+  Get the action required to change a flash block to the new data.
+
+  NOR flash programming can only change bits from 1 to 0, so a block
+  needs to be erased only when any bit has to change from 0 to 1.
+
+  @param[in] Current          The current data in the flash block.
+  @param[in] Data             The new data for the flash block.
+  @param[in] Length           The length of the block.
+
+  @retval  FWU_BLOCK_CLEAN    The block has the new data already.
+  @retval  FWU_BLOCK_PROGRAM  The block can be programmed without erase.
+  @retval  FWU_BLOCK_ERASE    The block has to be erased and programmed.
+**/
+STATIC
+UINT8
+GetBlockAction (
+  IN  CONST UINT8   *Current,
+  IN  CONST UINT8   *Data,
+  IN  UINT32        Length
+  )
+{
+  UINT32        Index;
+  UINT8         Action;
+
+  Action = FWU_BLOCK_CLEAN;
+  for (Index = 0; Index < Length; Index++) {
+    if (Current[Index] != Data[Index]) {
+      if ((Current[Index] & Data[Index]) != Data[Index]) {
+        return FWU_BLOCK_ERASE;
+      }
+      Action = FWU_BLOCK_PROGRAM;
+    }
+  }
+
+  return Action;
+}
+
+/**
+  Erase a span of the boot media.
+
+  The span is split so that the whole erase blocks in it are erased with
+  64KB erase cycles, and only the ends use 4KB erase cycles.
+
+  @param[in] Address          The boot media address to erase, 4KB aligned.
+  @param[in] Length           The length to erase, multiple of 4KB.
+  @param[in] RegionBase       The flash linear address of the BIOS region.
+
+  @retval  EFI_SUCCESS        Erase successfully.
+  @retval  others             Error happening when erasing.
+**/
+STATIC
+EFI_STATUS
+EraseRegionSpan (
+  IN  UINT64    Address,
+  IN  UINT32    Length,
+  IN  UINT32    RegionBase
+  )
+{
+  EFI_STATUS    Status;
+  UINT32        FlashAddress;
+  UINT32        EraseLen;
+
+  while (Length > 0) {
+    FlashAddress = RegionBase + (UINT32)Address;
+    if (((FlashAddress & (SIZE_64KB - 1)) == 0) && (Length >= SIZE_64KB)) {
+      EraseLen = Length & ~(SIZE_64KB - 1);
+    } else {
+      EraseLen = MIN (Length, SIZE_64KB - (FlashAddress & (SIZE_64KB - 1)));
+    }
+
+    Status = BootMediaErase ((UINT32)Address, EraseLen);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "ERROR: in BootMediaErase. Status = 0x%x\n", Status));
+      return Status;
+    }
+    Address += EraseLen;
+    Length  -= EraseLen;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Update a region block.
 
-  This is the acture function to update boot meia. It will erase boot device,
-  write new data to boot device, and verify the written data.
+  This is the acture function to update boot meia. The whole block is read
+  and compared first to plan the update. Adjacent 4KB blocks that need erase
+  are merged and erased with the largest erase size possible, blocks that
+  only need bits cleared are programmed without erase, and only the changed
+  bytes are written. The updated span is verified at the end.
 
   @param[in] Address          The boot media address to be update.
   @param[in] Buffer           The source buffer to write to the boot media.
@@ -281,80 +401,101 @@ UpdateRegionBlock (
   UINT8         *ReadBuffer;
   UINT32        Count;
   UINT32        BlockLen;
+  UINT32        RunStart;
+  UINT32        DirtyStart;
+  UINT32        DirtyEnd;
+  UINT32        First;
+  UINT32        Last;
+  UINT8         Action;
   UINT8         *Src;
 
-  ReadBuffer = NULL;
-
   if (Length == 0) {
     return EFI_SUCCESS;
   }
 
-  ReadBuffer = AllocatePages (EFI_SIZE_TO_PAGES (SIZE_4KB));
+  ReadBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Length));
   if (ReadBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  BlockLen   = SIZE_4KB;
   Src = (UINT8 *)Buffer;
+  Status = BootMediaRead (Address, Length, ReadBuffer);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "BootMediaRead.  readaddr: 0x%llx, Status = 0x%x\n", Address, Status));
+    goto End;
+  }
 
   //
-  // Read, compare, erase, write, read, compare
+  // Erase the merged spans of blocks that have bits to set
   //
-  for (Count = 0; Count < Length; Count += BlockLen) {
-    //
-    // If updating region less than 4K bytes,
-    // adjust the block length to size remaining, i.e less than 4k
-    //
-    if (Count + BlockLen > Length) {
-      BlockLen = Length - Count;
-    }
-    Status = BootMediaRead(Address + Count, BlockLen, ReadBuffer);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "BootMediaRead.  readaddr: 0x%llx, Status = 0x%x\n", Address + Count, Status));
-      goto End;
+  RunStart   = Length;
+  DirtyStart = Length;
+  DirtyEnd   = 0;
+  for (Count = 0; Count < Length + SIZE_4KB; Count += SIZE_4KB) {
+    Action = FWU_BLOCK_CLEAN;
+    if (Count < Length) {
+      BlockLen = MIN (Length - Count, SIZE_4KB);
+      Action   = GetBlockAction (ReadBuffer + Count, Src + Count, BlockLen);
+      if (Action != FWU_BLOCK_CLEAN) {
+        DirtyStart = MIN (DirtyStart, Count);
+        DirtyEnd   = Count + BlockLen;
+      }
+      DEBUG ((DEBUG_INIT, "%c", (Action == FWU_BLOCK_ERASE) ? 'x' : ((Action == FWU_BLOCK_PROGRAM) ? 'w' : '.')));
     }
 
-    if (CompareMem (Src + Count, ReadBuffer, BlockLen) == 0) {
-      DEBUG ((DEBUG_INIT, "."));
-      continue;
+    if (Action == FWU_BLOCK_ERASE) {
+      if (RunStart == Length) {
+        RunStart = Count;
+      }
+    } else if (RunStart != Length) {
+      Status = EraseRegionSpan (Address + RunStart, Count - RunStart, GetBiosRegionBase ());
+      if (EFI_ERROR (Status)) {
+        goto End;
+      }
+      SetMem (ReadBuffer + RunStart, MIN (Count, Length) - RunStart, 0xFF);
+      RunStart = Length;
     }
+  }
 
-    //
-    // Erase the boot media
-    // Block length for erase is always 4K bytes
-    //
-    DEBUG ((DEBUG_INIT, "x"));
-    Status = BootMediaErase ((UINT32) (Address + Count),  SIZE_4KB);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "ERROR: in BootMediaErase. Status = 0x%x\n", Status));
-      goto End;
-    }
+  if (DirtyStart >= DirtyEnd) {
+    Status = EFI_SUCCESS;
+    goto End;
+  }
 
-    //
-    // Write to the boot media
-    //
-    Status = BootMediaWrite ((UINT32) (Address + Count),  BlockLen, Src + Count);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "ERROR: in BootDeviceWrite. Status = 0x%x\n", Status));
-      goto End;
+  //
+  // Write only the changed bytes, merged over adjacent blocks
+  //
+  First = Length;
+  Last  = 0;
+  for (Count = DirtyStart; Count < DirtyEnd; Count++) {
+    if (ReadBuffer[Count] != Src[Count]) {
+      if (First == Length) {
+        First = Count;
+      }
+      Last = Count;
     }
-
-    //
-    // Verify the written data
-    //
-    Status = BootMediaRead (Address + Count, BlockLen, ReadBuffer);
-    if (CompareMem (Src + Count, ReadBuffer, BlockLen) != 0) {
-      DEBUG ((DEBUG_ERROR, "Verify Error !\n"));
-      Status = EFI_DEVICE_ERROR;
-      goto End;
+    if ((First != Length) && ((Count + 1 == DirtyEnd) || (Count - Last >= FWU_WRITE_MERGE_GAP))) {
+      Status = BootMediaWrite ((UINT32) (Address + First), Last - First + 1, Src + First);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "ERROR: in BootDeviceWrite. Status = 0x%x\n", Status));
+        goto End;
+      }
+      First = Length;
     }
   }
 
-End:
-  if (ReadBuffer != NULL) {
-    FreePages (ReadBuffer, EFI_SIZE_TO_PAGES (SIZE_4KB));
+  //
+  // Verify the written data
+  //
+  Status = BootMediaRead (Address + DirtyStart, DirtyEnd - DirtyStart, ReadBuffer + DirtyStart);
+  if (EFI_ERROR (Status) || (CompareMem (Src + DirtyStart, ReadBuffer + DirtyStart, DirtyEnd - DirtyStart) != 0)) {
+    DEBUG ((DEBUG_ERROR, "Verify Error !\n"));
+    Status = EFI_DEVICE_ERROR;
   }
 
+End:
+  FreePages (ReadBuffer, EFI_SIZE_TO_PAGES (Length));
+
   return Status;
 }
 
@@ -382,24 +523,21 @@ UpdateBootRegion (
   UINT32        UpdatedSize;
   UINT64        UpdateAddress;
   UINT8         *Buffer;
+  UINT32        RegionBase;
 
   //
-  // Here write 64KB every time in order to show update process.
+  // Here write up to 64KB every time in order to show update process.
+  // Each step ends at a 64KB flash boundary so that whole erase blocks
+  // could be erased at once.
   //
   UpdateAddress   = UpdateRegion->ToUpdateAddress;
   Buffer          = UpdateRegion->SourceAddress;
+  RegionBase      = GetBiosRegionBase ();
 
   UpdatedSize = 0;
   while (UpdatedSize < UpdateRegion->UpdateSize) {
-    if (UpdateRegion->UpdateSize < SIZE_4KB) {
-      UpdateBlockSize = UpdateRegion->UpdateSize;
-    } else {
-      if (UpdatedSize + SIZE_64KB > UpdateRegion->UpdateSize) {
-        UpdateBlockSize = UpdateRegion->UpdateSize - UpdatedSize;
-      } else {
-        UpdateBlockSize = SIZE_64KB;
-      }
-    }
+    UpdateBlockSize = SIZE_64KB - ((RegionBase + (UINT32)UpdateAddress) & (SIZE_64KB - 1));
+    UpdateBlockSize = MIN (UpdateBlockSize, UpdateRegion->UpdateSize - UpdatedSize);
     DEBUG ((DEBUG_INIT, "Updating 0x%08llx, Size:0x%05x\n", UpdateAddress, UpdateBlockSize));
     Status = UpdateRegionBlock (UpdateAddress, Buffer, UpdateBlockSize);
     if (EFI_ERROR (Status)) {
@@ -108,6 +108,7 @@ GetBootImageFromRawPartition (
   UINT8                      SwPart;
   UINT64                     Address;
   CONTAINER_HDR             *ContainerHdr;
+  MEDIA_READ_TOKEN           ReadToken;
 
   SwPart   = BootOption->Image[LoadedImage->LoadImageType].LbaImage.SwPart;
   LbaAddr  = BootOption->Image[LoadedImage->LoadImageType].LbaImage.LbaAddr;
@@ -206,25 +207,32 @@ GetBootImageFromRawPartition (
     DEBUG ((DEBUG_INFO, "Allocate memory (size:0x%x) fail.\n", AlignedImageSize));
     return EFI_OUT_OF_RESOURCES;
   }
-  CopyMem (Buffer, BlockData, AlignedHeaderSize);
 
   //
-  // Free temporary pages used for image header
-  //
-  FreePages (BlockData, EFI_SIZE_TO_PAGES (AlignedHeaderSize));
-
-  //
-  // Read the rest of the IAS image into the buffer
+  // Start reading the rest of the IAS image into the buffer, and move
+  // the header while the device transfers
   //
   Address =  LogicBlkDev.StartBlock + LbaAddr + AlignedHeaderBlkCnt;
 
-  Status = MediaReadBlocks (
+  Status = MediaReadBlocksAsync (
              BootOption->HwPart,
              Address,
              (AlignedImageSize - AlignedHeaderSize),
-             (VOID *)((UINTN)Buffer + AlignedHeaderSize)
+             (VOID *)((UINTN)Buffer + AlignedHeaderSize),
+             &ReadToken
              );
 
+  CopyMem (Buffer, BlockData, AlignedHeaderSize);
+
+  //
+  // Free temporary pages used for image header
+  //
+  FreePages (BlockData, EFI_SIZE_TO_PAGES (AlignedHeaderSize));
+
+  if (!EFI_ERROR (Status)) {
+    Status = MediaWaitBlocks (&ReadToken);
+  }
+
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Read rest of image error - %r\n", Status));
     FreePages (Buffer, EFI_SIZE_TO_PAGES (AlignedImageSize));
@@ -342,6 +350,90 @@ Done:
 }
 
 
+/**
+  Read a bzImage file, placing the kernel body at its load address.
+
+  Only the setup sectors are kept in a buffer. The protected mode kernel
+  is read from the file straight to the address it will run from, so it
+  is not copied again before booting.
+
+  @param[in]  FileHandle      Handle of the opened kernel file.
+  @param[in]  FileSize        Size of the kernel file.
+  @param[out] ImageData       Pointer to receive the setup sectors address and size.
+
+  @retval  EFI_SUCCESS        The kernel was placed at its load address.
+  @retval  EFI_UNSUPPORTED    The file is not a bzImage or the file system
+                              could not read part of a file.
+  @retval  Others             The file could not be read.
+**/
+STATIC
+EFI_STATUS
+ReadBzImageFile (
+  IN  EFI_HANDLE             FileHandle,
+  IN  UINTN                  FileSize,
+  OUT IMAGE_DATA            *ImageData
+  )
+{
+  EFI_STATUS  Status;
+  UINT8      *Setup;
+  UINTN       SetupPages;
+  UINT32      SetupSize;
+  UINTN       KernelBase;
+
+  //
+  // Keep at least 8KB so that image type checks on the setup buffer stay in range
+  //
+  SetupPages = EFI_SIZE_TO_PAGES (SIZE_8KB);
+  Setup      = AllocatePages (SetupPages);
+  if (Setup == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = ReadFilePart (FileHandle, 0, MIN (FileSize, EFI_PAGE_SIZE), Setup);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  KernelBase = GetBzImageKernelBase (Setup, &SetupSize);
+  if ((KernelBase == 0) || (SetupSize >= FileSize)) {
+    Status = EFI_UNSUPPORTED;
+    goto Done;
+  }
+
+  if (SetupSize > EFI_PAGES_TO_SIZE (SetupPages)) {
+    FreePages (Setup, SetupPages);
+    SetupPages = EFI_SIZE_TO_PAGES (SetupSize);
+    Setup      = AllocatePages (SetupPages);
+    if (Setup == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    Status = ReadFilePart (FileHandle, 0, SetupSize, Setup);
+  } else if (SetupSize > EFI_PAGE_SIZE) {
+    Status = ReadFilePart (FileHandle, EFI_PAGE_SIZE, SetupSize - EFI_PAGE_SIZE, Setup + EFI_PAGE_SIZE);
+  }
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+  ZeroMem (Setup + SetupSize, EFI_PAGES_TO_SIZE (SetupPages) - SetupSize);
+
+  Status = ReadFilePart (FileHandle, SetupSize, FileSize - SetupSize, (VOID *)KernelBase);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  DEBUG ((DEBUG_INFO, "Kernel placed at 0x%p [size 0x%x]\n", KernelBase, FileSize - SetupSize));
+  FreeImageData (ImageData);
+  ImageData->Addr      = Setup;
+  ImageData->Size      = (UINT32)EFI_PAGES_TO_SIZE (SetupPages);
+  ImageData->AllocType = ImageAllocateTypePage;
+
+Done:
+  if (EFI_ERROR (Status)) {
+    FreePages (Setup, SetupPages);
+  }
+  return Status;
+}
+
 /**
   Load a file from media and fill in the loaded file information.
 
@@ -349,6 +441,8 @@ Done:
   @param[in]  ConfigFile      Configuration file buffer.
   @param[in]  FileInfo        Pointer to the file informatino in buffer.
   @param[out] ImageData       Pointer to receive the loaded file address and size.
+  @param[out] KernelPlaced    If not NULL, try to read the file as a bzImage and
+                              return if the kernel was placed at its load address.
 
   @retval  RETURN_SUCCESS     If image was loaded successfully
   @retval  Others             If image was not loaded.
@@ -359,7 +453,8 @@ LoadLinuxFile (
   IN  EFI_HANDLE             FsHandle,
   IN  CHAR8                 *ConfigFile,
   IN  STR_SLICE             *FileInfo,
-  OUT IMAGE_DATA            *ImageData
+  OUT IMAGE_DATA            *ImageData,
+  OUT BOOLEAN               *KernelPlaced  OPTIONAL
   )
 {
   EFI_STATUS  Status;
@@ -396,6 +491,19 @@ LoadLinuxFile (
     goto Done;
   }
 
+  if (KernelPlaced != NULL) {
+    *KernelPlaced = FALSE;
+    Status = ReadBzImageFile (FileHandle, FileSize, ImageData);
+    if (!EFI_ERROR (Status)) {
+      *KernelPlaced = TRUE;
+      goto Done;
+    }
+    if (Status != EFI_UNSUPPORTED) {
+      DEBUG ((DEBUG_INFO, "Load kernel '%s' failed, Status = %r\n", FileName, Status));
+      goto Done;
+    }
+  }
+
   FileBuffer = AllocatePages (EFI_SIZE_TO_PAGES(FileSize));
   if (FileBuffer == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -454,6 +562,7 @@ GetTraditionalLinux (
   MENU_ENTRY                 *MenuEntry;
   EFI_HANDLE                 FileHandle;
   BOOLEAN                    DefBootOption;
+  BOOLEAN                    KernelPlaced;
   UINT32                     Size;
 
   ConfigFile     = NULL;
@@ -541,12 +650,14 @@ GetTraditionalLinux (
   }
 
   // Load kernel image
-  Status = LoadLinuxFile (FsHandle, ConfigFile, &LinuxBootCfg.MenuEntry[EntryIdx].Kernel, &LinuxImage->BootFile);
+  KernelPlaced = FALSE;
+  Status = LoadLinuxFile (FsHandle, ConfigFile, &LinuxBootCfg.MenuEntry[EntryIdx].Kernel, &LinuxImage->BootFile, &KernelPlaced);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Load kernel failed!\n"));
     Status = RETURN_LOAD_ERROR;
     goto Done;
   }
+  LinuxImage->Flags = KernelPlaced ? LINUX_IMAGE_KERNEL_PLACED : 0;
 
   // Update command line
   Size = LinuxBootCfg.MenuEntry[EntryIdx].Command.Len;
@@ -564,7 +675,7 @@ GetTraditionalLinux (
   }
 
   // Load InitRd, optional
-  Status = LoadLinuxFile (FsHandle, ConfigFile, &LinuxBootCfg.MenuEntry[EntryIdx].InitRd, &LinuxImage->InitrdFile);
+  Status = LoadLinuxFile (FsHandle, ConfigFile, &LinuxBootCfg.MenuEntry[EntryIdx].InitRd, &LinuxImage->InitrdFile, NULL);
   if (EFI_ERROR (Status)) {
     if ((Status == EFI_NOT_FOUND) && ((LinuxBootCfg.MenuEntry[EntryIdx].InitRd.Len == 0) || DefBootOption)) {
       return RETURN_SUCCESS;
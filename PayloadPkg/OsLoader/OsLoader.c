@@ -201,7 +201,10 @@ ParseContainerImage (
   UINT64                      ComponentName;
   LOADER_COMPRESSED_HEADER   *LzHdr;
   IMAGE_DATA                  File[MAX_IAS_SUB_IMAGE];
+  LOAD_COMPONENT_REQUEST      Request[MAX_IAS_SUB_IMAGE];
   UINT8                       Index;
+  UINT8                       Count;
+  BOOLEAN                     IsParallel;
 
   ContainerHdr = (CONTAINER_HDR  *)LoadedImage->ImageData.Addr;
   if (ContainerHdr->Signature != CONTAINER_BOOT_SIGNATURE) {
@@ -215,6 +218,9 @@ ParseContainerImage (
   }
 
   ZeroMem (File, sizeof (File));
+  ZeroMem (Request, sizeof (Request));
+  IsParallel = FeaturePcdGet (PcdParallelLoadEnabled) &&
+               ((ContainerHdr->Flags & CONTAINER_HDR_FLAG_MONO_SIGNING) == 0);
 
   DEBUG ((DEBUG_INFO, "CONTAINER size = 0x%x, image type = 0x%x, # of components = %d\n", LoadedImage->ImageData.Size, ContainerHdr->ImageType, ContainerHdr->Count));
 
@@ -242,6 +248,10 @@ ParseContainerImage (
       File[Index].Addr = (UINT8 *)LzHdr + sizeof(LOADER_COMPRESSED_HEADER);
       File[Index].Size = LzHdr->Size;
       File[Index].AllocType = ImageAllocateTypePointer;
+    } else if (IsParallel) {
+      // Collect the component and load all of them together below
+      Request[Index].ContainerSig  = ContainerHdr->Signature;
+      Request[Index].ComponentName = (UINT32) ComponentName;
     } else {
       //
       // Use Load to decompress to a new aligned page
@@ -255,6 +265,29 @@ ParseContainerImage (
     Index++;
   } while ((Status == EFI_SUCCESS) && (Index < ARRAY_SIZE (File)));
 
+  if (IsParallel && (Index > 0)) {
+    LoadComponents (Request, Index);
+    for (Count = 0; Count < Index; Count++) {
+      if (EFI_ERROR (Request[Count].Status)) {
+        break;
+      }
+      File[Count].Addr      = Request[Count].Buffer;
+      File[Count].Size      = Request[Count].Length;
+      File[Count].AllocType = ImageAllocateTypePage;
+    }
+
+    // Stop at the first failure like the sequential load does
+    if (Count < Index) {
+      DEBUG ((DEBUG_INFO, "Component %d load error - %r\n", Count, Request[Count].Status));
+      while (--Index > Count) {
+        if (!EFI_ERROR (Request[Index].Status)) {
+          FreePages (Request[Index].Buffer, EFI_SIZE_TO_PAGES (Request[Index].Length));
+        }
+      }
+      Index = Count + 1;
+    }
+  }
+
   Status = UnregisterContainer (ContainerHdr->Signature);
   DEBUG ((DEBUG_INFO, "Unregister done - %r!\n", Status));
 
@@ -454,9 +487,16 @@ SetupBootImage (
   } else {
     DEBUG ((DEBUG_INFO, "Assume BzImage...\n"));
     LinuxImage = &LoadedImage->Image.Linux;
-    Status = LoadBzImage (LinuxImage->BootFile.Addr,
-                          LinuxImage->InitrdFile.Addr, LinuxImage->InitrdFile.Size,
-                          LinuxImage->CmdFile.Addr,    LinuxImage->CmdFile.Size);
+    if ((LinuxImage->Flags & LINUX_IMAGE_KERNEL_PLACED) != 0) {
+      // Kernel body was already read to its load address
+      Status = SetupBzImage (LinuxImage->BootFile.Addr,
+                             LinuxImage->InitrdFile.Addr, LinuxImage->InitrdFile.Size,
+                             LinuxImage->CmdFile.Addr,    LinuxImage->CmdFile.Size);
+    } else {
+      Status = LoadBzImage (LinuxImage->BootFile.Addr,
+                            LinuxImage->InitrdFile.Addr, LinuxImage->InitrdFile.Size,
+                            LinuxImage->CmdFile.Addr,    LinuxImage->CmdFile.Size);
+    }
     if (!EFI_ERROR (Status)) {
       LoadedImage->Flags  = (LoadedImage->Flags  & ~LOADED_IMAGE_MULTIBOOT) | LOADED_IMAGE_LINUX;
     }
@@ -625,6 +665,8 @@ BeforeOSJump (
     LogBufHdr = (DEBUG_LOG_BUFFER_HEADER *) GetDebugLogBufferPtr ();
     SerialPortWrite ((UINT8 *)"\nLOGBUF:", 8);
     SerialPortWrite ((UINT8 *)LogBufHdr->Buffer, LogBufHdr->UsedLength - LogBufHdr->HeaderLength);
+  } else {
+    DebugLogBufferFlush (TRUE);
   }
 
 }
@@ -748,6 +790,7 @@ InitBootDevice (
   UINTN                     BootMediumPciBase;
   UINT8                     DeviceType;
   UINT8                     DeviceInstance;
+  UINT16                    Span;
 
   AddMeasurePoint (0x4040);
 
@@ -773,7 +816,9 @@ InitBootDevice (
   }
 
   DEBUG ((DEBUG_INFO, "Getting boot image from %a\n", GetBootDeviceNameString(DeviceType)));
+  Span   = BeginSpan (0x4050, SIGNATURE_32 ('M', 'D', 'I', 'A'), (DeviceType << 8) | DeviceInstance);
   Status = MediaInitialize (BootMediumPciBase, DevInitAll);
+  EndSpan (Span, 0);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to init media - %r\n", Status));
     return Status;
@@ -1091,6 +1136,7 @@ BootOsImage (
   EFI_HANDLE        HwPartHandle;
   EFI_HANDLE        FsHandle;
   EFI_HANDLE        LoadedImageHandle;
+  UINT16            Span;
 
   HwPartHandle      = NULL;
   FsHandle          = NULL;
@@ -1127,7 +1173,9 @@ BootOsImage (
   //
   // Load Boot Image
   //
+  Span   = BeginSpan (0x4070, SIGNATURE_32 ('O', 'S', 'L', 'D'), (OsBootOption->DevType << 8) | OsBootOption->DevInstance);
   Status = LoadBootImages (OsBootOption, HwPartHandle, FsHandle, &LoadedImageHandle);
+  EndSpan (Span, 0);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "Failed to Load Boot Image\n"));
     goto Exit;
@@ -1280,12 +1328,21 @@ PayloadMain (
   UINTN                  ShellTimeout;
   UINT8                  CurrIdx;
   UINT8                  BootIdx;
+  SYS_CPU_TASK_HOB      *SysCpuTaskHob;
 
   mEntryStack = Param;
 
   DEBUG ((DEBUG_INFO, "\n\n====================Os Loader====================\n\n"));
   AddMeasurePoint (0x4010);
 
+  if (FeaturePcdGet (PcdParallelLoadEnabled)) {
+    // Use the APs parked by Stage2 to load container components
+    SysCpuTaskHob = (SYS_CPU_TASK_HOB *)GetGuidHobData (NULL, NULL, &gLoaderMpCpuTaskInfoGuid);
+    if (SysCpuTaskHob != NULL) {
+      MpTaskInit ((SYS_CPU_TASK *)(UINTN)SysCpuTaskHob->SysCpuTask);
+    }
+  }
+
   //
   // Get Boot Image Info
   //
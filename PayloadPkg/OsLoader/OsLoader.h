@@ -48,6 +48,7 @@
 #include <Library/LinuxLib.h>
 #include <Library/ThunkLib.h>
 #include <Library/ContainerLib.h>
+#include <Library/MpTaskLib.h>
 #include <Library/DebugLogBufferLib.h>
 #include <Guid/SeedInfoHobGuid.h>
 #include <Guid/OsConfigDataHobGuid.h>
@@ -86,6 +87,9 @@
 #define LOADED_IMAGE_RUN_EXTRA   BIT7
 #define LOADED_IMAGE_ELF         BIT8
 
+// For LINUX_IMAGE Flags
+#define LINUX_IMAGE_KERNEL_PLACED  BIT0
+
 #define MAX_EXTRA_FILE_NUMBER    16
 
 #define MAX_BOOT_MENU_ENTRY      8
@@ -121,7 +125,7 @@ typedef struct {
   IMAGE_DATA              BootFile;
   IMAGE_DATA              CmdFile;
   IMAGE_DATA              InitrdFile;
-  UINT16                  Reserved;
+  UINT16                  Flags;
   UINT16                  ExtraBlobNumber;
   IMAGE_DATA              ExtraBlob[MAX_EXTRA_FILE_NUMBER];
 } LINUX_IMAGE;
@@ -10,6 +10,7 @@
 
 import os
 import sys
+import shutil
 import struct
 from   ctypes import Structure, c_char, c_uint32, c_uint8, c_uint64, c_uint16, sizeof, ARRAY
 from   test_base import *
@@ -68,6 +69,17 @@ def main():
     # check test result
     ret = check_result (output, get_check_lines())
 
+    # boot again with the config file in a nested directory
+    if ret == 0 and os.path.exists(os.path.join(os_dir, 'config.cfg')):
+        nested_dir = os_dir.rstrip('/\\') + '_nested'
+        if os.path.exists(nested_dir):
+            shutil.rmtree (nested_dir)
+        shutil.copytree (os_dir, nested_dir)
+        os.makedirs (os.path.join(nested_dir, 'boot', 'grub'))
+        shutil.move (os.path.join(nested_dir, 'config.cfg'), os.path.join(nested_dir, 'boot', 'grub', 'grub.cfg'))
+        lines = run_qemu(bios_img, nested_dir, timeout = 10)
+        ret = check_result (lines, get_check_lines())
+
     print ('\nLinux Boot test %s !\n' % ('PASSED' if ret == 0 else 'FAILED'))
 
     return ret
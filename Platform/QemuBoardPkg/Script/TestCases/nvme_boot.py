@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+## @ nvme_boot.py
+#
+# Test boot linux from an NVMe drive on QEMU
+#
+# Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+##
+
+import os
+import sys
+from   test_base import *
+
+# 8KB commands, so that loading the kernel keeps several commands outstanding
+NVME_MDTS = 1
+
+def get_check_lines ():
+    lines = [
+              "===== Intel Slim Bootloader STAGE1A =====",
+              "===== Intel Slim Bootloader STAGE1B =====",
+              "===== Intel Slim Bootloader STAGE2 ======",
+              "Jump to payload",
+              "NVMe namespace, I/O queue depth",
+              "Starting Kernel ...",
+              "Linux version",
+              "Freeing unused kernel image",
+              'Welcome to "Minimal Linux"',
+            ]
+    return lines
+
+def check_queue_depth (output):
+    for line in output:
+        if "NVMe namespace, I/O queue depth" in line:
+            depth = int(line.split()[-1])
+            if depth > 1:
+                return 0
+            print ("NVMe I/O queue depth %d is not greater than 1 !" % depth)
+            return -1
+    print ("Failed locating NVMe I/O queue depth !")
+    return -1
+
+def usage():
+    print("usage:\n  python %s bios_image os_image_dir\n" % sys.argv[0])
+    print("  bios_image  :  QEMU Slim Bootloader firmware image.")
+    print("                 This image can be generated through the normal Slim Bootloader build process.")
+    print("  os_image_dir:  Directory containing bootable OS image.")
+    print("                 This image can be generated using GenContainer.py tool.")
+    print("")
+
+
+def main():
+    if sys.version_info.major < 3:
+        print ("This script needs Python3 !")
+        return -1
+
+    if len(sys.argv) != 3:
+        usage()
+        return -2
+
+    bios_img = sys.argv[1]
+    os_dir   = sys.argv[2]
+
+    print("NVMe boot test for Slim BootLoader")
+
+    # download and unzip OS image
+    tmp_dir = os.path.dirname(os_dir) + '/temp'
+    create_dirs ([tmp_dir, os_dir])
+    local_file = tmp_dir + '/QemuLinux.zip'
+    download_url (
+        'https://github.com/slimbootloader/slimbootloader/files/4463548/QemuLinux.zip',
+        local_file
+    )
+    unzip_file (local_file, os_dir)
+
+    # boot from the NVMe boot option with a deep I/O queue and small commands
+    lines = run_qemu(bios_img, os_dir, timeout = 15, nvme_mdts = NVME_MDTS)
+
+    # check test result
+    ret = check_result (lines, get_check_lines())
+    if ret == 0:
+        ret = check_queue_depth (lines)
+
+    print ('\nNVMe Boot test %s !\n' % ('PASSED' if ret == 0 else 'FAILED'))
+
+    return ret
+
+if __name__ == '__main__':
+    sys.exit(main())
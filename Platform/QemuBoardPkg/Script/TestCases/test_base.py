@@ -47,17 +47,22 @@ def create_dirs (dirs):
             os.mkdir (dir_name)
 
 
-def run_qemu (bios_img, fwu_path, fwu_mode=False, boot_order='', timeout=0):
+def run_qemu (bios_img, fwu_path, fwu_mode=False, boot_order='', timeout=0, nvme_mdts=0):
     if os.name == 'nt':
         path = r"C:\Program Files\qemu\qemu-system-x86_64"
     else:
         path = r"qemu-system-x86_64"
+    # attach the drive to an NVMe controller instead of AHCI if nvme_mdts is set
+    if nvme_mdts:
+        disk_dev = "nvme,serial=deadbeef,mdts=%d,drive=mydrive" % nvme_mdts
+    else:
+        disk_dev = "ide-hd,drive=mydrive"
     cmd_list = [
         path, "-nographic",  "-machine", "q35,accel=tcg",
         "-cpu", "max", "-serial", "mon:stdio",
         "-m", "256M", "-drive",
         "id=mydrive,if=none,format=raw,file=fat:rw:%s" % fwu_path, "-device",
-        "ide-hd,drive=mydrive", "-boot", "order=d%s" % ('an' if fwu_mode else boot_order),
+        disk_dev, "-boot", "order=d%s" % ('an' if fwu_mode else boot_order),
         "-no-reboot", "-drive", "file=%s,if=pflash,format=raw" % bios_img
     ]
 
@@ -37,6 +37,7 @@ def main():
     test_cases = [
       ('firmware_update.py',  [tst_img, fwu_dir]),
       ('linux_boot.py'     ,  [tst_img, img_dir]),
+      ('nvme_boot.py'      ,  [tst_img, img_dir]),
       ('uefi_upld_boot.py' ,  [tst_img, tmp_dir]),
       ('cfgdata_update.py' ,  [tst_img, tmp_dir]),
     ]
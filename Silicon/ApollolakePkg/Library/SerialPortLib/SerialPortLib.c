@@ -8,6 +8,7 @@
 #include <Base.h>
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
+#include <Library/SerialPortLib.h>
 #include <Library/PlatformHookLib.h>
 
 //---------------------------------------------
@@ -33,6 +34,7 @@
 //---------------------------------------------
 #define LSR_TXRDY               0x20
 #define LSR_RXDA                0x01
+#define IIR_FIFO_ENABLED        0xC0
 #define DLAB                    0x01
 #define UART_MAGIC              0x55
 
@@ -176,6 +178,8 @@ SerialPortWrite (
   )
 {
   UINTN  Result;
+  UINTN  FifoSize;
+  UINTN  Count;
   UINT8  Data;
   UINT8  OldValue;
   UINT8  FifoLeft;
@@ -184,8 +188,17 @@ SerialPortWrite (
     return 0;
   }
 
+  //
+  // The transmitter empty bit is set when the whole FIFO is empty,
+  // so a FIFO full of data can be written each time it is set.
+  //
+  FifoSize = 1;
+  if ((SerialPortReadRegister (EIR_OFFSET) & IIR_FIFO_ENABLED) == IIR_FIFO_ENABLED) {
+    FifoSize = FIFO_SIZE;
+  }
+
   OldValue = SerialPortReadRegister (SCR_OFFSET);
-  FifoLeft = OldValue & FIFO_MASK;
+  FifoLeft = (UINT8)MIN (OldValue & FIFO_MASK, FifoSize - 1);
   if (NumberOfBytes > 40) {
     //
     // It is a long line, drain the FIFO first
@@ -194,7 +207,7 @@ SerialPortWrite (
   }
 
   Result = NumberOfBytes;
-  while (NumberOfBytes--) {
+  while (NumberOfBytes > 0) {
     //
     // Wait for the serail port to be ready.
     //
@@ -202,11 +215,15 @@ SerialPortWrite (
       do {
         Data = SerialPortReadRegister (LSR_OFFSET);
       } while ((Data & LSR_TXRDY) == 0);
-      FifoLeft = FIFO_MASK;
-    } else {
-      FifoLeft--;
+      FifoLeft = (UINT8)FifoSize;
+    }
+
+    Count = MIN (NumberOfBytes, FifoLeft);
+    NumberOfBytes -= Count;
+    FifoLeft      -= (UINT8)Count;
+    while (Count-- > 0) {
+      SerialPortWriteRegister (0, *Buffer++);
     }
-    SerialPortWriteRegister (0, *Buffer++);
   }
   SerialPortWriteRegister (SCR_OFFSET, (OldValue & UART_MAGIC_MASK) | FifoLeft);
 
@@ -279,3 +296,33 @@ SerialPortPoll (
   return FALSE;
 }
 
+/**
+  Retrieve the status of the control bits on a serial device.
+
+  Only the input and output buffer status is reported.
+
+  @param Control                A pointer to return the current control signals from the serial device.
+
+  @retval RETURN_SUCCESS        The control bits were read from the serial device.
+
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortGetControl (
+  OUT UINT32 *Control
+  )
+{
+  UINT8  Data;
+
+  Data     = SerialPortReadRegister (LSR_OFFSET);
+  *Control = 0;
+  if ((Data & LSR_TXRDY) != 0) {
+    *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+  if ((Data & LSR_RXDA) == 0) {
+    *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
+  }
+
+  return RETURN_SUCCESS;
+}
+